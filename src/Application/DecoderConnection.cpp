@@ -13,6 +13,10 @@
 #include <Codecs/FastEncodedHeaderAnalyzer.h>
 #include <Codecs/TemplateRegistry.h>
 #include <Codecs/DataSource.h>
+#include <Codecs/DataSourceBuffer.h>
+#include <Codecs/Decoder.h>
+#include <Common/Allocator.h>
+#include <Common/MemoryFootprint.h>
 
 #include <Communication/MulticastReceiver.h>
 #include <Communication/TCPReceiver.h>
@@ -40,6 +44,7 @@ DecoderConnection::DecoderConnection()
 , verboseFile_(0)
 , ownEchoFile_(false)
 , ownVerboseFile_(false)
+, allocator_(0)
 {
 }
 
@@ -303,6 +308,7 @@ DecoderConnection::configure(
 
   assembler_->setReset(configuration.reset());
   assembler_->setStrict(configuration.strict());
+  assembler_->setAllocator(allocator_);
 
   switch(configuration.receiverType())
   {
@@ -384,3 +390,54 @@ DecoderConnection::decoder() const
   return assembler_->decoder();
 }
 
+void
+DecoderConnection::footprint(MemoryFootprint & footprint, bool includeRegistry) const
+{
+  if(includeRegistry && registry_)
+  {
+    registry_->footprint(footprint);
+  }
+  if(receiver_)
+  {
+    receiver_->connectionFootprint(footprint);
+  }
+}
+
+size_t
+DecoderConnection::warmUp(
+  Messages::ValueMessageBuilder & builder,
+  const unsigned char * sample,
+  size_t size,
+  size_t passes,
+  size_t workingBufferCapacity)
+{
+  receiver().prefaultBuffers();
+  decoder().prefault(workingBufferCapacity);
+
+  size_t messageCount = 0;
+  if(sample == 0 || size == 0)
+  {
+    return messageCount;
+  }
+  Codecs::Decoder sampleDecoder(registry());
+  sampleDecoder.setStrict(false);
+  sampleDecoder.prefault(workingBufferCapacity);
+  for(size_t nPass = 0; nPass < passes; ++nPass)
+  {
+    sampleDecoder.reset();
+    Codecs::DataSourceBuffer source(sample, size);
+    try
+    {
+      while(source.messageAvailable() > 0)
+      {
+        sampleDecoder.decodeMessage(source, builder);
+        ++messageCount;
+      }
+    }
+    catch (const std::exception &)
+    {
+      // The sample is not expected to be perfect.  Go on to the next pass.
+    }
+  }
+  return messageCount;
+}
@@ -8,6 +8,8 @@
 #include <Messages/ValueMessageBuilder.h>
 
 #include <Common/Exceptions.h>
+#include <Common/Allocator_fwd.h>
+#include <Common/MemoryFootprint_fwd.h>
 #include <Codecs/TemplateRegistry_fwd.h>
 #include <Codecs/HeaderAnalyzer_fwd.h>
 #include <Codecs/Decoder_fwd.h>
@@ -25,6 +27,17 @@ namespace QuickFAST{
       ~DecoderConnection();
       void configure(Messages::ValueMessageBuilder & builder, Application::DecoderConfiguration &configuration);
 
+      /// @brief Use an Allocator for this connection's decoded messages.
+      ///
+      /// Only messages and their fields are built with it; the receiver's buffers,
+      /// the decoder and its dictionaries use Allocator::bufferAllocator().
+      /// Must be called before configure().
+      /// @param allocator must outlive the connection and any messages it delivers.
+      void setAllocator(Allocator * allocator)
+      {
+        allocator_ = allocator;
+      }
+
       Codecs::TemplateRegistryPtr & registry()
       {
         if(!registry_)
@@ -79,12 +92,60 @@ namespace QuickFAST{
 
       Codecs::Decoder & decoder() const;
 
+      /// @brief Add the memory held by this connection to a footprint.
+      ///
+      /// Includes the template registry, the decoder's dictionary and working buffer,
+      /// the receiver's buffer pool and queued data, and the Allocator set by
+      /// setAllocator() (if any.)  May be called from any thread while the connection
+      /// is running: the decoder and Allocator figures are the snapshot most recently
+      /// taken by the decoding thread (see Receiver::connectionFootprint().)
+      /// With many connections sharing one registry, gather the registry separately
+      /// (see TemplateRegistry::footprint()) and pass includeRegistry = false so it
+      /// is not counted once per connection.
+      /// @param footprint accumulates the result.
+      /// @param includeRegistry controls whether the template registry is counted.
+      void footprint(MemoryFootprint & footprint, bool includeRegistry = true) const;
+
+      /// @brief Prepare to decode at full speed before live data arrives.
+      ///
+      /// Call after configure() and before the receiver is run (i.e. before the market opens.)
+      ///  - Touches all receive buffers, the decoder's dictionary, and its working buffer so
+      ///    the first packets do not cause page faults.  The working buffer is sized to
+      ///    workingBufferCapacity.  The templates do not limit the length of string or byte
+      ///    vector fields, so the application must say how large a field value it expects.
+      ///    A field larger than this still decodes; the working buffer grows when it arrives.
+      ///  - Decodes a sample of recorded traffic into builder using a separate Decoder.
+      ///    This exercises the same decoding and building code the live data will use
+      ///    without disturbing the live decoder's dictionary.
+      ///
+      /// To warm the application's code as well, builder should be of the same type as the
+      /// builder passed to configure(), set up so the sample messages are not acted upon
+      /// (for example a GenericMessageBuilder whose consumer discards them.)
+      ///
+      /// The sample is a series of FAST encoded messages with no headers.
+      /// Decoding errors in the sample (for example when the recording started in mid-stream)
+      /// end the current pass but are otherwise ignored.
+      /// @param builder receives the sample messages.
+      /// @param sample points to the recorded data.  May be zero if no sample is available.
+      /// @param size is the number of bytes in the sample.
+      /// @param passes is the number of times to decode the sample.
+      /// @param workingBufferCapacity is the largest field value expected, in bytes.
+      ///        Zero leaves the working buffer at its current size.
+      /// @returns the number of sample messages decoded.
+      size_t warmUp(
+        Messages::ValueMessageBuilder & builder,
+        const unsigned char * sample,
+        size_t size,
+        size_t passes = 1,
+        size_t workingBufferCapacity = 0);
+
     private:
       std::istream * fastFile_;
       std::ostream * echoFile_;
       std::ostream * verboseFile_ ;
       bool ownEchoFile_;
       bool ownVerboseFile_;
+      Allocator * allocator_;
 
       Codecs::TemplateRegistryPtr registry_;
       boost::scoped_ptr<boost::asio::io_service> ioService_;
@@ -0,0 +1,181 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "ColumnarBatch.h"
+#include <Common/Exceptions.h>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+ColumnarBatch::Column::Column(
+  const Messages::FieldIdentityCPtr & identity,
+  ValueType::Type type,
+  size_t width,
+  size_t capacity)
+  : identity_(identity)
+  , type_(type)
+  , width_(width)
+  , values_(0)
+  , validity_(0)
+  , exponents_(0)
+{
+  // variable width columns need one more offset than there are rows.
+  values_ = align(valueStorage_, (capacity + 1) * width_);
+  validity_ = align(validityStorage_, (capacity + 7) / 8);
+  if(type_ == ValueType::DECIMAL)
+  {
+    exponents_ = align(exponentStorage_, capacity * sizeof(exponent_t));
+  }
+}
+
+uchar *
+ColumnarBatch::Column::align(std::vector<uchar> & storage, size_t size)
+{
+  storage.assign(size + alignment, 0);
+  uchar * start = &storage[0];
+  size_t misalignment = reinterpret_cast<size_t>(start) % alignment;
+  if(misalignment != 0)
+  {
+    start += alignment - misalignment;
+  }
+  return start;
+}
+
+size_t
+ColumnarBatch::Column::validCount(size_t rows)const
+{
+  size_t count = 0;
+  for(size_t row = 0; row < rows; ++row)
+  {
+    if(isValid(row))
+    {
+      ++count;
+    }
+  }
+  return count;
+}
+
+void
+ColumnarBatch::Column::setDecimal(size_t row, const Decimal & value)
+{
+  reinterpret_cast<mantissa_t *>(values_)[row] = value.getMantissa();
+  reinterpret_cast<exponent_t *>(exponents_)[row] = value.getExponent();
+  setValid(row);
+}
+
+void
+ColumnarBatch::Column::setBytes(size_t row, const uchar * value, size_t length)
+{
+  uint32 * offsets = reinterpret_cast<uint32 *>(values_);
+  bytes_.insert(bytes_.end(), value, value + length);
+  offsets[row + 1] = uint32(bytes_.size());
+  setValid(row);
+}
+
+void
+ColumnarBatch::Column::finishRow(size_t row)
+{
+  if(isValid(row))
+  {
+    return;
+  }
+  if(isVariableWidth())
+  {
+    uint32 * offsets = reinterpret_cast<uint32 *>(values_);
+    offsets[row + 1] = offsets[row];
+  }
+  else
+  {
+    memset(values_ + row * width_, 0, width_);
+    if(exponents_ != 0)
+    {
+      exponents_[row] = 0;
+    }
+  }
+}
+
+void
+ColumnarBatch::Column::discardRow(size_t row)
+{
+  if(isValid(row) && isVariableWidth())
+  {
+    bytes_.resize(offsets()[row]);
+  }
+  validity_[row >> 3] &= uchar(~(1 << (row & 7)));
+}
+
+void
+ColumnarBatch::Column::clear(size_t rows)
+{
+  memset(validity_, 0, (rows + 7) / 8);
+  bytes_.clear();
+}
+
+ColumnarBatch::ColumnarBatch(template_id_t templateId, size_t capacity)
+  : templateId_(templateId)
+  , capacity_(capacity)
+  , rows_(0)
+{
+  if(capacity_ == 0)
+  {
+    throw UsageError("Coding Error", "ColumnarBatch capacity must not be zero.");
+  }
+}
+
+ColumnarBatch::~ColumnarBatch()
+{
+}
+
+const ColumnarBatch::Column *
+ColumnarBatch::findColumn(const std::string & name)const
+{
+  for(size_t nColumn = 0; nColumn < columns_.size(); ++nColumn)
+  {
+    if(columns_[nColumn]->name() == name)
+    {
+      return columns_[nColumn].get();
+    }
+  }
+  return 0;
+}
+
+size_t
+ColumnarBatch::addColumn(
+  const Messages::FieldIdentityCPtr & identity,
+  ValueType::Type type,
+  size_t width)
+{
+  ColumnPtr column(new Column(identity, type, width, capacity_));
+  columns_.push_back(column);
+  return columns_.size() - 1;
+}
+
+void
+ColumnarBatch::endRow()
+{
+  for(size_t nColumn = 0; nColumn < columns_.size(); ++nColumn)
+  {
+    columns_[nColumn]->finishRow(rows_);
+  }
+  ++rows_;
+}
+
+void
+ColumnarBatch::discardRow()
+{
+  for(size_t nColumn = 0; nColumn < columns_.size(); ++nColumn)
+  {
+    columns_[nColumn]->discardRow(rows_);
+  }
+}
+
+void
+ColumnarBatch::clear()
+{
+  for(size_t nColumn = 0; nColumn < columns_.size(); ++nColumn)
+  {
+    columns_[nColumn]->clear(rows_ + 1);
+  }
+  rows_ = 0;
+}
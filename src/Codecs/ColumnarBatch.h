@@ -0,0 +1,294 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef COLUMNARBATCH_H
+#define COLUMNARBATCH_H
+#include "ColumnarBatch_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+#include <Common/Decimal.h>
+#include <Messages/FieldIdentity.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief Decoded messages from one template stored as one array per field.
+    ///
+    /// Each row of the batch is one message.  Each column holds one field of every
+    /// message in the batch:
+    ///  - integer fields are stored as contiguous values of the field's own width.
+    ///  - decimal fields are stored as an int64 mantissa array and a separate int8
+    ///    exponent array.
+    ///  - ascii, utf8 and byte vector fields are stored as size()+1 uint32 offsets
+    ///    into a single array of bytes.  Row n occupies bytes [offset[n], offset[n+1]).
+    ///  - sequences are stored as a uint32 entry count.  The entries are not kept.
+    ///  - fields in groups and static template references appear as columns of the
+    ///    containing message.
+    ///
+    /// Every column has a validity bitmap with one bit per row, least significant bit
+    /// first.  A bit is clear if the field was not present in that message; the value
+    /// in that row is zero (or an empty string).
+    ///
+    /// Value arrays and bitmaps are allocated for the full capacity when the column is
+    /// created and are aligned to ColumnarBatch::alignment bytes, so they can be handed
+    /// to vectorized code without copying.
+    class QuickFAST_Export ColumnarBatch
+    {
+    public:
+      /// @brief Alignment of the value arrays and validity bitmaps.
+      static const size_t alignment = 64;
+
+      /// @brief One field of every message in the batch.
+      class QuickFAST_Export Column
+      {
+      public:
+        /// @brief Construct an empty column
+        /// @param identity identifies the field
+        /// @param type is the type of the field
+        /// @param width is the size of one value in bytes
+        /// @param capacity is the maximum number of rows
+        Column(
+          const Messages::FieldIdentityCPtr & identity,
+          ValueType::Type type,
+          size_t width,
+          size_t capacity);
+
+        /// @brief Identify the field stored in this column.
+        const Messages::FieldIdentityCPtr & identity()const
+        {
+          return identity_;
+        }
+
+        /// @brief The name of the field stored in this column.
+        const std::string & name()const
+        {
+          return identity_->name();
+        }
+
+        /// @brief The type of the field stored in this column.
+        ValueType::Type type()const
+        {
+          return type_;
+        }
+
+        /// @brief Size of one entry in values() in bytes.
+        size_t width()const
+        {
+          return width_;
+        }
+
+        /// @brief True if values() holds offsets into bytes()
+        bool isVariableWidth()const
+        {
+          return type_ == ValueType::ASCII
+            || type_ == ValueType::UTF8
+            || type_ == ValueType::BYTEVECTOR;
+        }
+
+        /// @brief The values, mantissas, counts or offsets for this column.
+        const uchar * values()const
+        {
+          return values_;
+        }
+
+        /// @brief The values as an array of VALUE.
+        ///
+        /// VALUE must match width(), i.e. int32 or uint32 for a four byte column.
+        template<typename VALUE>
+        const VALUE * valuesAs()const
+        {
+          return reinterpret_cast<const VALUE *>(values_);
+        }
+
+        /// @brief The offsets of the rows in bytes() for a variable width column.
+        const uint32 * offsets()const
+        {
+          return reinterpret_cast<const uint32 *>(values_);
+        }
+
+        /// @brief The data for a variable width column.
+        const uchar * bytes()const
+        {
+          return bytes_.empty() ? 0 : &bytes_[0];
+        }
+
+        /// @brief The exponents of a decimal column.
+        const exponent_t * exponents()const
+        {
+          return reinterpret_cast<const exponent_t *>(exponents_);
+        }
+
+        /// @brief The validity bitmap; bit (row % 8) of byte (row / 8).
+        const uchar * validity()const
+        {
+          return validity_;
+        }
+
+        /// @brief Was the field present in a row?
+        /// @param row selects the message
+        bool isValid(size_t row)const
+        {
+          return (validity_[row >> 3] & (1 << (row & 7))) != 0;
+        }
+
+        /// @brief Count the rows in which the field was present.
+        /// @param rows is the number of rows in the batch.
+        size_t validCount(size_t rows)const;
+
+        /// @brief Store a fixed width value.
+        /// @param row selects the message
+        /// @param value is the value to store; sizeof(VALUE) must equal width().
+        template<typename VALUE>
+        void set(size_t row, VALUE value)
+        {
+          reinterpret_cast<VALUE *>(values_)[row] = value;
+          setValid(row);
+        }
+
+        /// @brief Store a decimal value
+        /// @param row selects the message
+        /// @param value is the value to store.
+        void setDecimal(size_t row, const Decimal & value);
+
+        /// @brief Store a variable width value.
+        ///
+        /// Rows must be stored in order.
+        /// @param row selects the message
+        /// @param value points to the data
+        /// @param length is the number of bytes at value.
+        void setBytes(size_t row, const uchar * value, size_t length);
+
+        /// @brief Complete a row.
+        ///
+        /// Fill in the value for a field that was not present.
+        /// @param row selects the message
+        void finishRow(size_t row);
+
+        /// @brief Forget anything stored in a row.
+        /// @param row selects the message
+        void discardRow(size_t row);
+
+        /// @brief Forget all rows, keeping the storage.
+        /// @param rows is the number of rows currently in the batch.
+        void clear(size_t rows);
+
+      private:
+        void setValid(size_t row)
+        {
+          validity_[row >> 3] |= uchar(1 << (row & 7));
+        }
+        static uchar * align(std::vector<uchar> & storage, size_t size);
+
+      private:
+        Messages::FieldIdentityCPtr identity_;
+        ValueType::Type type_;
+        size_t width_;
+        std::vector<uchar> valueStorage_;
+        uchar * values_;
+        std::vector<uchar> validityStorage_;
+        uchar * validity_;
+        std::vector<uchar> exponentStorage_;
+        uchar * exponents_;
+        std::vector<uchar> bytes_;
+      };
+
+      /// @brief Construct an empty batch.
+      /// @param templateId identifies the template for all messages in the batch.
+      /// @param capacity is the maximum number of rows.
+      ColumnarBatch(template_id_t templateId, size_t capacity);
+      ~ColumnarBatch();
+
+      /// @brief The template of the messages in this batch.
+      template_id_t templateId()const
+      {
+        return templateId_;
+      }
+
+      /// @brief The maximum number of rows.
+      size_t capacity()const
+      {
+        return capacity_;
+      }
+
+      /// @brief The number of rows (messages) in the batch.
+      size_t size()const
+      {
+        return rows_;
+      }
+
+      /// @brief Is the batch empty?
+      bool empty()const
+      {
+        return rows_ == 0;
+      }
+
+      /// @brief Is there room for another row?
+      bool full()const
+      {
+        return rows_ >= capacity_;
+      }
+
+      /// @brief The number of columns.
+      ///
+      /// Columns appear in the order the fields were first seen.
+      size_t columnCount()const
+      {
+        return columns_.size();
+      }
+
+      /// @brief Access a column.
+      /// @param index must be less than columnCount().
+      const Column & column(size_t index)const
+      {
+        return *columns_[index];
+      }
+
+      /// @brief Find a column by field name.
+      /// @param name is the name of the field
+      /// @returns the first column for the field, or zero if there is none.
+      const Column * findColumn(const std::string & name)const;
+
+      /// @brief Access a column for update.
+      /// @param index must be less than columnCount().
+      Column & mutableColumn(size_t index)
+      {
+        return *columns_[index];
+      }
+
+      /// @brief Add a column.
+      ///
+      /// Rows that were completed before the column was added are not valid.
+      /// @param identity identifies the field
+      /// @param type is the type of the field
+      /// @param width is the size of one value in bytes
+      /// @returns the index of the new column.
+      size_t addColumn(
+        const Messages::FieldIdentityCPtr & identity,
+        ValueType::Type type,
+        size_t width);
+
+      /// @brief Complete the current row.
+      void endRow();
+
+      /// @brief Forget the current row.
+      void discardRow();
+
+      /// @brief Forget all rows, keeping the columns and their storage.
+      void clear();
+
+    private:
+      ColumnarBatch(const ColumnarBatch &);
+      ColumnarBatch & operator=(const ColumnarBatch &);
+
+    private:
+      template_id_t templateId_;
+      size_t capacity_;
+      size_t rows_;
+      typedef boost::shared_ptr<Column> ColumnPtr;
+      std::vector<ColumnPtr> columns_;
+    };
+  }
+}
+#endif // COLUMNARBATCH_H
@@ -0,0 +1,277 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "ColumnarBatchBuilder.h"
+#include <Codecs/Context.h>
+#include <Common/Exceptions.h>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+ColumnarBatchBuilder::ColumnarBatchBuilder(
+  ColumnarBatchConsumer & consumer,
+  size_t batchSize)
+  : consumer_(consumer)
+  , batchSize_(batchSize)
+  , decoder_(0)
+  , cursor_(0)
+  , batchCount_(0)
+  , continue_(true)
+  , messageOpen_(false)
+{
+  if(batchSize_ == 0)
+  {
+    throw UsageError("Coding Error", "ColumnarBatchBuilder batch size must not be zero.");
+  }
+}
+
+ColumnarBatchBuilder::~ColumnarBatchBuilder()
+{
+}
+
+bool
+ColumnarBatchBuilder::flush()
+{
+  if(batch_ && !batch_->empty())
+  {
+    ++batchCount_;
+    continue_ = consumer_.consumeBatch(*batch_) && continue_;
+    batch_->clear();
+  }
+  return continue_;
+}
+
+ColumnarBatch::Column &
+ColumnarBatchBuilder::column(
+  const Messages::FieldIdentityCPtr & identity,
+  ValueType::Type type,
+  size_t width)
+{
+  ColumnarBatch & batch = *batch_;
+  size_t row = batch.size();
+  size_t count = batch.columnCount();
+  // Fields usually arrive in column order, so start looking where the last one was found.
+  for(size_t nColumn = 0; nColumn < count; ++nColumn)
+  {
+    size_t index = cursor_ + nColumn;
+    if(index >= count)
+    {
+      index -= count;
+    }
+    ColumnarBatch::Column & candidate = batch.mutableColumn(index);
+    if(candidate.identity().get() == identity.get() && !candidate.isValid(row))
+    {
+      cursor_ = index + 1;
+      return candidate;
+    }
+  }
+  size_t index = batch.addColumn(identity, type, width);
+  cursor_ = index + 1;
+  return batch.mutableColumn(index);
+}
+
+const std::string &
+ColumnarBatchBuilder::getApplicationType()const
+{
+  return applicationType_;
+}
+
+const std::string &
+ColumnarBatchBuilder::getApplicationTypeNs()const
+{
+  return applicationTypeNamespace_;
+}
+
+void
+ColumnarBatchBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int64 value)
+{
+  store(identity, type, value);
+}
+
+void
+ColumnarBatchBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint64 value)
+{
+  store(identity, type, value);
+}
+
+void
+ColumnarBatchBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int32 value)
+{
+  store(identity, type, value);
+}
+
+void
+ColumnarBatchBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint32 value)
+{
+  store(identity, type, value);
+}
+
+void
+ColumnarBatchBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int16 value)
+{
+  store(identity, type, value);
+}
+
+void
+ColumnarBatchBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint16 value)
+{
+  store(identity, type, value);
+}
+
+void
+ColumnarBatchBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int8 value)
+{
+  store(identity, type, value);
+}
+
+void
+ColumnarBatchBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uchar value)
+{
+  store(identity, type, value);
+}
+
+void
+ColumnarBatchBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const Decimal& value)
+{
+  column(identity, type, sizeof(mantissa_t)).setDecimal(batch_->size(), value);
+}
+
+void
+ColumnarBatchBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length)
+{
+  column(identity, type, sizeof(uint32)).setBytes(batch_->size(), value, length);
+}
+
+Messages::ValueMessageBuilder &
+ColumnarBatchBuilder::startMessage(
+  const std::string & applicationType,
+  const std::string & applicationTypeNamespace,
+  size_t /*size*/)
+{
+  if(decoder_ == 0)
+  {
+    throw UsageError("Coding Error", "ColumnarBatchBuilder used without calling setDecoder().");
+  }
+  template_id_t templateId = decoder_->getTemplateId();
+  if(!batch_ || batch_->templateId() != templateId)
+  {
+    flush();
+    ColumnarBatchPtr & batch = batches_[templateId];
+    if(!batch)
+    {
+      batch.reset(new ColumnarBatch(templateId, batchSize_));
+    }
+    batch_ = batch;
+  }
+  else if(messageOpen_)
+  {
+    // the previous message was abandoned part way through.
+    batch_->discardRow();
+  }
+  messageOpen_ = true;
+  applicationType_ = applicationType;
+  applicationTypeNamespace_ = applicationTypeNamespace;
+  cursor_ = 0;
+  return *this;
+}
+
+bool
+ColumnarBatchBuilder::endMessage(Messages::ValueMessageBuilder & /*messageBuilder*/)
+{
+  messageOpen_ = false;
+  batch_->endRow();
+  if(batch_->full())
+  {
+    flush();
+  }
+  bool result = continue_;
+  continue_ = true;
+  return result;
+}
+
+bool
+ColumnarBatchBuilder::ignoreMessage(Messages::ValueMessageBuilder & /*messageBuilder*/)
+{
+  messageOpen_ = false;
+  batch_->discardRow();
+  bool result = continue_;
+  continue_ = true;
+  return result;
+}
+
+Messages::ValueMessageBuilder &
+ColumnarBatchBuilder::startSequence(
+  Messages::FieldIdentityCPtr & identity,
+  const std::string & /*applicationType*/,
+  const std::string & /*applicationTypeNamespace*/,
+  size_t /*fieldCount*/,
+  Messages::FieldIdentityCPtr & /*lengthIdentity*/,
+  size_t length)
+{
+  store(identity, ValueType::SEQUENCE, uint32(length));
+  return entryBuilder_;
+}
+
+void
+ColumnarBatchBuilder::endSequence(
+  Messages::FieldIdentityCPtr & /*identity*/,
+  Messages::ValueMessageBuilder & /*sequenceBuilder*/)
+{
+}
+
+Messages::ValueMessageBuilder &
+ColumnarBatchBuilder::startSequenceEntry(
+  const std::string & /*applicationType*/,
+  const std::string & /*applicationTypeNamespace*/,
+  size_t /*size*/)
+{
+  return entryBuilder_;
+}
+
+void
+ColumnarBatchBuilder::endSequenceEntry(Messages::ValueMessageBuilder & /*entry*/)
+{
+}
+
+Messages::ValueMessageBuilder &
+ColumnarBatchBuilder::startGroup(
+  Messages::FieldIdentityCPtr & /*identity*/,
+  const std::string & /*applicationType*/,
+  const std::string & /*applicationTypeNamespace*/,
+  size_t /*size*/)
+{
+  // The group's fields become columns of the message.
+  return *this;
+}
+
+void
+ColumnarBatchBuilder::endGroup(
+  Messages::FieldIdentityCPtr & /*identity*/,
+  Messages::ValueMessageBuilder & /*groupBuilder*/)
+{
+}
+
+bool
+ColumnarBatchBuilder::wantLog(unsigned short level)
+{
+  return consumer_.wantLog(level);
+}
+
+bool
+ColumnarBatchBuilder::logMessage(unsigned short level, const std::string & logMessage)
+{
+  return consumer_.logMessage(level, logMessage);
+}
+
+bool
+ColumnarBatchBuilder::reportDecodingError(const std::string & errorMessage)
+{
+  return consumer_.reportDecodingError(errorMessage);
+}
+
+bool
+ColumnarBatchBuilder::reportCommunicationError(const std::string & errorMessage)
+{
+  return consumer_.reportCommunicationError(errorMessage);
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef COLUMNARBATCHBUILDER_H
+#define COLUMNARBATCHBUILDER_H
+#include "ColumnarBatch_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Codecs/ColumnarBatch.h>
+#include <Codecs/ColumnarBatchConsumer.h>
+#include <Codecs/Context_fwd.h>
+#include <Messages/ValueMessageBuilder.h>
+#include <Messages/NullMessageBuilder.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief Decode runs of messages into ColumnarBatches.
+    ///
+    /// Consecutive messages that use the same template are collected into a
+    /// ColumnarBatch, one column per field.  The batch is passed to the
+    /// ColumnarBatchConsumer when it is full, when a message arrives that uses
+    /// a different template, or when flush() is called.  Call flush() when decoding
+    /// ends to deliver the last partial batch.
+    ///
+    /// The builder must be told which Decoder it is used with (see setDecoder())
+    /// because the current template ID selects the batch.  Columns are created as
+    /// fields are first seen; each template keeps its batch (and the batch's storage)
+    /// for the life of the builder so switching templates does not allocate.
+    ///
+    /// Sequences are recorded only as an entry count.  Their entries are decoded
+    /// (to keep the dictionaries correct) and discarded.
+    class QuickFAST_Export ColumnarBatchBuilder : public Messages::ValueMessageBuilder
+    {
+    public:
+      /// @brief The default number of messages per batch.
+      static const size_t defaultBatchSize = 1024;
+
+      /// @brief Construct
+      /// @param consumer receives the batches.
+      /// @param batchSize is the maximum number of messages in a batch.
+      explicit ColumnarBatchBuilder(
+        ColumnarBatchConsumer & consumer,
+        size_t batchSize = defaultBatchSize);
+      virtual ~ColumnarBatchBuilder();
+
+      /// @brief Identify the Decoder that is driving this builder.
+      /// @param decoder provides the ID of the template being decoded.
+      void setDecoder(const Context & decoder)
+      {
+        decoder_ = &decoder;
+      }
+
+      /// @brief Deliver the current batch to the consumer, even if it is not full.
+      /// @returns the consumer's result (or true if the batch was empty).
+      bool flush();
+
+      /// @brief How many batches have been delivered.
+      size_t batchCount()const
+      {
+        return batchCount_;
+      }
+
+      //////////////////////////
+      // Implement ValueMessageBuilder
+      virtual const std::string & getApplicationType()const;
+      virtual const std::string & getApplicationTypeNs()const;
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int64 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint64 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int32 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint32 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int16 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint16 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int8 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uchar value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const Decimal& value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length);
+
+      virtual Messages::ValueMessageBuilder & startMessage(
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t size);
+      virtual bool endMessage(Messages::ValueMessageBuilder & messageBuilder);
+      virtual bool ignoreMessage(Messages::ValueMessageBuilder & messageBuilder);
+
+      virtual Messages::ValueMessageBuilder & startSequence(
+        Messages::FieldIdentityCPtr & identity,
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t fieldCount,
+        Messages::FieldIdentityCPtr & lengthIdentity,
+        size_t length);
+      virtual void endSequence(
+        Messages::FieldIdentityCPtr & identity,
+        Messages::ValueMessageBuilder & sequenceBuilder);
+      virtual Messages::ValueMessageBuilder & startSequenceEntry(
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t size);
+      virtual void endSequenceEntry(Messages::ValueMessageBuilder & entry);
+      virtual Messages::ValueMessageBuilder & startGroup(
+        Messages::FieldIdentityCPtr & identity,
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t size);
+      virtual void endGroup(
+        Messages::FieldIdentityCPtr & identity,
+        Messages::ValueMessageBuilder & groupBuilder);
+
+      ///////////////////
+      // Implement Logger
+      virtual bool wantLog(unsigned short level);
+      virtual bool logMessage(unsigned short level, const std::string & logMessage);
+      virtual bool reportDecodingError(const std::string & errorMessage);
+      virtual bool reportCommunicationError(const std::string & errorMessage);
+
+    private:
+      ColumnarBatch::Column & column(
+        const Messages::FieldIdentityCPtr & identity,
+        ValueType::Type type,
+        size_t width);
+
+      template<typename VALUE>
+      void store(const Messages::FieldIdentityCPtr & identity, ValueType::Type type, VALUE value)
+      {
+        column(identity, type, sizeof(VALUE)).set(batch_->size(), value);
+      }
+
+    private:
+      ColumnarBatchConsumer & consumer_;
+      size_t batchSize_;
+      const Context * decoder_;
+      typedef std::map<template_id_t, ColumnarBatchPtr> BatchMap;
+      BatchMap batches_;
+      ColumnarBatchPtr batch_;
+      size_t cursor_;
+      size_t batchCount_;
+      bool continue_;
+      bool messageOpen_;
+      std::string applicationType_;
+      std::string applicationTypeNamespace_;
+      Messages::NullMessageBuilder entryBuilder_;
+    };
+  }
+}
+#endif // COLUMNARBATCHBUILDER_H
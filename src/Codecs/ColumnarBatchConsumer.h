@@ -0,0 +1,33 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef COLUMNARBATCHCONSUMER_H
+#define COLUMNARBATCHCONSUMER_H
+#include "ColumnarBatch_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Common/Logger.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief interface to be implemented by a consumer of ColumnarBatches.
+    ///
+    /// See ColumnarBatchBuilder.
+    class ColumnarBatchConsumer : public Common::Logger
+    {
+    public:
+      virtual ~ColumnarBatchConsumer(){}
+
+      /// @brief Accept a batch of decoded messages.
+      ///
+      /// The batch and its arrays are reused for the next batch, so they are
+      /// valid only for the life of this call.
+      /// @param batch contains messages that were all encoded with the same template.
+      /// @returns true if decoding should continue; false to stop decoding
+      virtual bool consumeBatch(const ColumnarBatch & batch) = 0;
+    };
+  }
+}
+#endif /* COLUMNARBATCHCONSUMER_H */
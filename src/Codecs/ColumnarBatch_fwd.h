@@ -0,0 +1,18 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef COLUMNARBATCH_FWD_H
+#define COLUMNARBATCH_FWD_H
+namespace QuickFAST{
+  namespace Codecs{
+    class ColumnarBatch;
+    /// @brief A smart pointer to a ColumnarBatch.
+    typedef boost::shared_ptr<ColumnarBatch> ColumnarBatchPtr;
+    class ColumnarBatchConsumer;
+    class ColumnarBatchBuilder;
+  }
+}
+#endif // COLUMNARBATCH_FWD_H
@@ -6,11 +6,15 @@
 #include "Context.h"
 #include <Codecs/TemplateRegistry.h>
 #include <Common/Exceptions.h>
+#include <Common/MemoryFootprint.h>
 #include <Messages/FieldIdentity.h>
 
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Codecs;
 
+const size_t Context::dictionaryPageBits;
+const size_t Context::dictionaryPageSize;
+
 Context::Context(Codecs::TemplateRegistryCPtr registry)
 : verboseOut_(0)
 , logOut_(0)
@@ -18,8 +22,7 @@ Context::Context(Codecs::TemplateRegistryCPtr registry)
 , templateId_(~0)
 , strict_(true)
 , indexedDictionarySize_(registry->dictionarySize())
-//, indexedDictionary_(new Messages::FieldCPtr[indexedDictionarySize_])
-, indexedDictionary_(new Value[indexedDictionarySize_])
+, dictionaryPages_((indexedDictionarySize_ + dictionaryPageSize - 1) >> dictionaryPageBits)
 {
 }
 
@@ -30,9 +33,13 @@ Context::~Context()
 void
 Context::reset(bool resetTemplateId /*= true*/)
 {
-  for(size_t nDict = 0; nDict < indexedDictionarySize_; ++nDict)
+  for(size_t nPage = 0; nPage < allocatedPages_.size(); ++nPage)
   {
-    indexedDictionary_[nDict].erase();
+    Value * page = dictionaryPages_[allocatedPages_[nPage]].get();
+    for(size_t nEntry = 0; nEntry < dictionaryPageSize; ++nEntry)
+    {
+      page[nEntry].erase();
+    }
   }
   if(resetTemplateId)
   {
@@ -40,6 +47,47 @@ Context::reset(bool resetTemplateId /*= true*/)
   }
 }
 
+void
+Context::prefault(size_t workingBufferCapacity)
+{
+  workingBuffer_.prefault(workingBufferCapacity);
+  for(size_t nPage = 0; nPage < dictionaryPages_.size(); ++nPage)
+  {
+    if(!dictionaryPages_[nPage])
+    {
+      (void)allocateDictionaryPage(nPage);
+    }
+  }
+  reset();
+}
+
+Value *
+Context::allocateDictionaryPage(size_t page)
+{
+  dictionaryPages_[page].reset(new Value[dictionaryPageSize]);
+  allocatedPages_.push_back(page);
+  return dictionaryPages_[page].get();
+}
+
+void
+Context::footprint(MemoryFootprint & footprint) const
+{
+  size_t strings = 0;
+  for(size_t nPage = 0; nPage < allocatedPages_.size(); ++nPage)
+  {
+    const Value * page = dictionaryPages_[allocatedPages_[nPage]].get();
+    for(size_t nEntry = 0; nEntry < dictionaryPageSize; ++nEntry)
+    {
+      strings += page[nEntry].heapBytes();
+    }
+  }
+  footprint.add("dictionary.entries",
+    dictionaryPages_.capacity() * sizeof(DictionaryPage)
+    + allocatedPages_.capacity() * sizeof(size_t)
+    + allocatedPages_.size() * dictionaryPageSize * sizeof(Value));
+  footprint.add("dictionary.strings", strings);
+  workingBuffer_.footprint(footprint);
+}
 
 bool
 Context::findTemplate(const std::string & name, const std::string & nameSpace, TemplateCPtr & result) const
@@ -11,6 +11,7 @@
 #include <Common/Value.h>
 #include <Common/Exceptions.h>
 #include <Common/WorkingBuffer.h>
+#include <Common/MemoryFootprint_fwd.h>
 #include <Codecs/TemplateRegistry_fwd.h>
 #include <Codecs/Template_fwd.h>
 #include <Messages/FieldIdentity_fwd.h>
@@ -31,6 +32,11 @@ namespace QuickFAST
       };
       /// @brief Template ID defined in SCP to mean: reset the xcoder.
       static const template_id_t SCPResetTemplateId = 120;
+
+      /// @brief log2 of the number of dictionary entries allocated together.
+      static const size_t dictionaryPageBits = 5;
+      /// @brief The number of dictionary entries allocated together.
+      static const size_t dictionaryPageSize = size_t(1) << dictionaryPageBits;
     public:
       /// @brief Construct with a TemplateRegistry containing all templates to be used.
       /// @param registry A registry containing all templates to be used to decode messages.
@@ -61,6 +67,13 @@ namespace QuickFAST
       ///        however there are cases when you don't.
       void reset(bool resetTemplateId = true);
 
+      /// @brief Touch the dictionary and the working buffer so they will not fault when first used.
+      ///
+      /// Materializes every page of the dictionary (see dictionaryEntriesInUse())
+      /// and resets it, so this should be called before decoding starts.
+      /// @param workingBufferCapacity is the largest field value expected.
+      void prefault(size_t workingBufferCapacity);
+
       /// @brief Remember the id of the template driving the Xcoding.
       void setTemplateId(const template_id_t & templateId)
       {
@@ -95,26 +108,39 @@ namespace QuickFAST
       /// @returns true if a valid entry was found
       bool findDictionaryField(size_t index, Value *& value);
 
+      /// @brief How many dictionary entries have been allocated.
+      ///
+      /// The dictionary is allocated in pages of dictionaryPageSize entries.  A page
+      /// is allocated the first time one of its entries is assigned a value, and only
+      /// allocated pages are cleared by reset().  The DictionaryIndexer numbers the
+      /// entries template by template so a Context that sees only a few of the
+      /// templates in a large registry allocates and resets only a few pages.
+      /// @returns the number of entries in the allocated pages.
+      size_t dictionaryEntriesInUse()const
+      {
+        return allocatedPages_.size() * dictionaryPageSize;
+      }
+
+      /// @brief Add the bytes held by this Context to a footprint.
+      ///
+      /// Counts the allocated dictionary pages, string values in the dictionary
+      /// that are too long to be held inside a Value, and the working buffer.
+      /// The cost is proportional to dictionaryEntriesInUse().
+      /// @param footprint accumulates the result.
+      void footprint(MemoryFootprint & footprint)const;
+
       /// @brief Sets the value in the dictionary to NULL
       /// @param index identifies the dictionary entry corresponding to this field
       void setDictionaryValueNull(size_t index)
       {
-        if(index > indexedDictionarySize_)
-        {
-          throw TemplateDefinitionError("Illegal dictionary index.");
-        }
-        indexedDictionary_[index].setNull();
+        dictionaryEntry(index).setNull();
       }
 
       /// @brief Sets the value in the dictionary to be undefined
       /// @param index identifies the dictionary entry corresponding to this field
       void setDictionaryValueUndefined(size_t index)
       {
-        if(index > indexedDictionarySize_)
-        {
-          throw TemplateDefinitionError("Illegal dictionary index.");
-        }
-        indexedDictionary_[index].setUndefined();
+        dictionaryEntry(index).setUndefined();
       }
 
       /// @brief Sets the value in the dictionary
@@ -123,11 +149,7 @@ namespace QuickFAST
       template<typename VALUE_TYPE>
       void setDictionaryValue(size_t index, const VALUE_TYPE & value)
       {
-        if(index > indexedDictionarySize_)
-        {
-          throw TemplateDefinitionError("Illegal dictionary index.");
-        }
-        indexedDictionary_[index].setValue(value);
+        dictionaryEntry(index).setValue(value);
       }
 
       /// @brief Sets the string value in the dictionary
@@ -136,11 +158,7 @@ namespace QuickFAST
       /// @param length is the lenght of the string pointed to by value
       void setDictionaryValue(size_t index, const unsigned char * value, size_t length)
       {
-        if(index > indexedDictionarySize_)
-        {
-          throw TemplateDefinitionError("Illegal dictionary index.");
-        }
-        indexedDictionary_[index].setValue(value, length);
+        dictionaryEntry(index).setValue(value, length);
       }
 
       /// @brief Get a value from the dictionary
@@ -149,20 +167,16 @@ namespace QuickFAST
       template<typename VALUE_TYPE>
       DictionaryStatus getDictionaryValue(size_t index, VALUE_TYPE & value)
       {
-        if(index > indexedDictionarySize_)
-        {
-          throw TemplateDefinitionError("Illegal dictionary index.");
-        }
-        Value & entry = indexedDictionary_[index];
-        if(!entry.isDefined())
+        const Value * entry = findDictionaryEntry(index);
+        if(entry == 0 || !entry->isDefined())
         {
           return UNDEFINED_VALUE;
         }
-        if(entry.isNull())
+        if(entry->isNull())
         {
           return NULL_VALUE;
         }
-        (void)entry.getValue(value);
+        (void)entry->getValue(value);
         return OK_VALUE;
       }
 
@@ -172,20 +186,16 @@ namespace QuickFAST
       /// @param length is the length of the string pointed to by value
       DictionaryStatus getDictionaryValue(size_t index, const unsigned char *& value, size_t &length)
       {
-        if(index > indexedDictionarySize_)
-        {
-          throw TemplateDefinitionError("Illegal dictionary index.");
-        }
-        Value & entry = indexedDictionary_[index];
-        if(!entry.isDefined())
+        const Value * entry = findDictionaryEntry(index);
+        if(entry == 0 || !entry->isDefined())
         {
           return UNDEFINED_VALUE;
         }
-        if(entry.isNull())
+        if(entry->isNull())
         {
           return NULL_VALUE;
         }
-        (void)entry.getValue(value, length);
+        (void)entry->getValue(value, length);
         return OK_VALUE;
       }
 
@@ -336,6 +346,41 @@ namespace QuickFAST
       Context(const Context &);
       Context & operator = (const Context &);
 
+      /// @brief Find a dictionary entry without allocating it.
+      /// @returns zero if the page containing the entry has not been allocated.
+      const Value * findDictionaryEntry(size_t index)const
+      {
+        checkDictionaryIndex(index);
+        const Value * page = dictionaryPages_[index >> dictionaryPageBits].get();
+        if(page == 0)
+        {
+          return 0;
+        }
+        return page + (index & (dictionaryPageSize - 1));
+      }
+
+      /// @brief Find a dictionary entry, allocating its page if necessary.
+      Value & dictionaryEntry(size_t index)
+      {
+        checkDictionaryIndex(index);
+        Value * page = dictionaryPages_[index >> dictionaryPageBits].get();
+        if(page == 0)
+        {
+          page = allocateDictionaryPage(index >> dictionaryPageBits);
+        }
+        return page[index & (dictionaryPageSize - 1)];
+      }
+
+      void checkDictionaryIndex(size_t index)const
+      {
+        if(index >= indexedDictionarySize_)
+        {
+          throw TemplateDefinitionError("Illegal dictionary index.");
+        }
+      }
+
+      Value * allocateDictionaryPage(size_t page);
+
     protected:
       /// if an ostream is supplied make the Xcoder noisy
       std::ostream * verboseOut_;
@@ -352,8 +397,12 @@ namespace QuickFAST
       bool strict_;
     private:
       size_t indexedDictionarySize_;
-      typedef boost::scoped_array<Value> IndexedDictionary;
-      IndexedDictionary indexedDictionary_;
+      typedef boost::shared_array<Value> DictionaryPage;
+      typedef std::vector<DictionaryPage> DictionaryPages;
+      /// pages of the dictionary; empty until first used.
+      DictionaryPages dictionaryPages_;
+      /// indexes into dictionaryPages_ of the pages that have been allocated.
+      std::vector<size_t> allocatedPages_;
       WorkingBuffer workingBuffer_;
     };
   }
@@ -291,6 +291,19 @@ namespace QuickFAST{
         return used_;
       }
 
+      /// @brief Count the bytes in a range of buffers.
+      /// @param first is the handle of the first buffer to count (see startBuffer())
+      /// @returns the number of bytes in buffers from first through the last buffer used.
+      size_t byteCount(BufferHandle first = 0) const
+      {
+        size_t count = 0;
+        for(size_t pos = first; pos < used_; ++pos)
+        {
+          count += buffers_[pos].size();
+        }
+        return count;
+      }
+
       /// @brief indexed access to a buffer in the set.
       /// @param index should be < size()
       const WorkingBuffer & operator[](size_t index)const
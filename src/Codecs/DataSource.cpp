@@ -63,6 +63,7 @@ DataSource::doEcho(bool ok, uchar byte)
     }
     if(verboseFields_)
     {
+      echoString_.reserve(echoString_.size() + 1, Allocator::bufferAllocator());
       echoString_ += byte;
     }
   }
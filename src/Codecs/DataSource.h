@@ -81,6 +81,20 @@ namespace QuickFAST{
         }
       }
 
+      /// @brief Look at the unread bytes in the current buffer without consuming them.
+      ///
+      /// The next buffer is not requested.  Use skipContiguous() to consume the bytes.
+      /// The pointer remains valid only until the next call to any method that reads
+      /// from this DataSource.
+      /// @param[out] buffer points to the next unread byte.
+      /// @returns the number of unread bytes in the current buffer (possibly zero.)
+      inline
+      size_t peekContiguous(const uchar *& buffer)const
+      {
+        buffer = buffer_ + position_;
+        return size_ - position_;
+      }
+
       /// @brief Get the next byte.
       ///
       /// @param[out] byte where to store the byte.
@@ -110,6 +124,35 @@ namespace QuickFAST{
         return ok;
       }
 
+      /// @brief Get the next run of bytes that are contiguous in the current buffer.
+      ///
+      /// If the current buffer is exhausted the next buffer is requested.
+      /// The bytes are consumed.  The pointer remains valid only until the next call
+      /// to any method that reads from this DataSource.
+      /// @param maximum is the largest number of bytes wanted.
+      /// @param[out] chunk points to the first byte.
+      /// @returns the number of bytes available at chunk (<= maximum); zero means end of data.
+      inline
+      size_t getContiguous(size_t maximum, const uchar *& chunk)
+      {
+        if(position_ >= size_)
+        {
+          if(!getBuffer(buffer_, size_))
+          {
+            return 0;
+          }
+          position_ = 0;
+        }
+        size_t available = size_ - position_;
+        if(available > maximum)
+        {
+          available = maximum;
+        }
+        chunk = buffer_ + position_;
+        skipContiguous(available);
+        return available;
+      }
+
       /// @brief A FYI from the decoder to tell the DataSource about a message boundary.
       /// No action is required but some data sources can do interesting things with
       /// the information
@@ -7,50 +7,177 @@
 using namespace QuickFAST;
 using namespace QuickFAST::Codecs;
 
-DataSourceBlockedStream::DataSourceBlockedStream(std::istream & stream)
+const size_t DataSourceBlockedStream::defaultReadAheadBufferSize;
+const size_t DataSourceBlockedStream::defaultMaxBlockSize;
+
+DataSourceBlockedStream::DataSourceBlockedStream(
+  std::istream & stream,
+  size_t readAheadBuffers,
+  size_t readAheadBufferSize)
 : stream_(stream)
 , bufferCapacity_(0)
+, maxBlockSize_(defaultMaxBlockSize)
+, ahead_(0)
+, aheadSize_(0)
+, aheadPos_(0)
 {
+  if(readAheadBuffers > 1)
+  {
+    readAhead_.reset(new StreamReadAhead(stream, readAheadBufferSize, readAheadBuffers));
+  }
 }
 
 DataSourceBlockedStream::~DataSourceBlockedStream()
 {
 }
 
-bool
-DataSourceBlockedStream::getBuffer(const uchar *& buffer, size_t & size)
+void
+DataSourceBlockedStream::reserve(size_t blockSize)
 {
-  if(!stream_.good() || stream_.eof())
+  if(blockSize > bufferCapacity_)
   {
-    return false;
+    buffer_.reset(new unsigned char[blockSize]);
+    bufferCapacity_ = blockSize;
   }
-  size_t blockSize = 0;
-  uchar b = 0;
-  b = uchar(stream_.get());
-  while((b & stopBit) == 0 && stream_.good() && !stream_.eof())
+}
+
+void
+DataSourceBlockedStream::addHeaderByte(size_t & blockSize, uchar byte)const
+{
+  if(blockSize > (maxBlockSize_ >> dataShift))
   {
-    // todo: overflow check
-    blockSize <<= dataShift;
-    blockSize += b;
-    b = uchar(stream_.get());
+    throw EncodingError("[ERR D2] Block size exceeds the maximum.");
   }
+  blockSize = (blockSize << dataShift) | (byte & dataBits);
+}
 
-  blockSize <<= dataShift;
-  blockSize += (b & dataBits);
-  /// todo: sanity check on block size?
-  if(blockSize > bufferCapacity_)
+bool
+DataSourceBlockedStream::getBuffer(const uchar *& buffer, size_t & size)
+{
+  if(readAhead_)
   {
-    buffer_.reset(new unsigned char[blockSize]);
-    bufferCapacity_ = blockSize;
+    return getBlock(buffer, size);
   }
-  if(!stream_.good() || stream_.eof())
+  if(!stream_.good())
   {
     return false;
   }
+  size_t blockSize = 0;
+  do
+  {
+    blockSize = 0;
+    std::istream::int_type next = stream_.get();
+    if(next == std::istream::traits_type::eof())
+    {
+      // end of data between blocks.
+      return false;
+    }
+    uchar b = uchar(next);
+    addHeaderByte(blockSize, b);
+    while((b & stopBit) == 0)
+    {
+      next = stream_.get();
+      if(next == std::istream::traits_type::eof())
+      {
+        throw EncodingError("[ERR U03] End of file: Block header truncated.");
+      }
+      b = uchar(next);
+      addHeaderByte(blockSize, b);
+    }
+    // skip empty blocks
+  } while(blockSize == 0);
+  if(blockSize > maxBlockSize_)
+  {
+    throw EncodingError("[ERR D2] Block size exceeds the maximum.");
+  }
+  reserve(blockSize);
   stream_.read(reinterpret_cast<char *>(buffer_.get()), blockSize);
   size = (size_t)stream_.gcount();
+  if(size < blockSize)
+  {
+    throw EncodingError("[ERR U03] End of file: Block truncated.");
+  }
   buffer = buffer_.get();
   return true;
 }
 
+bool
+DataSourceBlockedStream::nextByte(uchar & byte)
+{
+  if(aheadPos_ >= aheadSize_)
+  {
+    // releases the previous read-ahead buffer.  The decoder is done with it.
+    if(!readAhead_->next(ahead_, aheadSize_))
+    {
+      return false;
+    }
+    aheadPos_ = 0;
+  }
+  byte = ahead_[aheadPos_++];
+  return true;
+}
 
+bool
+DataSourceBlockedStream::getBlock(const uchar *& buffer, size_t & size)
+{
+  size_t blockSize = 0;
+  do
+  {
+    blockSize = 0;
+    uchar b = 0;
+    if(!nextByte(b))
+    {
+      // end of data between blocks.
+      return false;
+    }
+    addHeaderByte(blockSize, b);
+    while((b & stopBit) == 0)
+    {
+      if(!nextByte(b))
+      {
+        throw EncodingError("[ERR U03] End of file: Block header truncated.");
+      }
+      addHeaderByte(blockSize, b);
+    }
+    // skip empty blocks
+  } while(blockSize == 0);
+  if(blockSize > maxBlockSize_)
+  {
+    throw EncodingError("[ERR D2] Block size exceeds the maximum.");
+  }
+
+  if(aheadSize_ - aheadPos_ >= blockSize)
+  {
+    // the whole block is in the read-ahead buffer
+    buffer = ahead_ + aheadPos_;
+    size = blockSize;
+    aheadPos_ += blockSize;
+    return true;
+  }
+
+  // the block spans read-ahead buffers.  Assemble it.
+  reserve(blockSize);
+  size = 0;
+  while(size < blockSize)
+  {
+    if(aheadPos_ >= aheadSize_)
+    {
+      if(!readAhead_->next(ahead_, aheadSize_))
+      {
+        aheadPos_ = aheadSize_ = 0;
+        throw EncodingError("[ERR U03] End of file: Block truncated.");
+      }
+      aheadPos_ = 0;
+    }
+    size_t count = aheadSize_ - aheadPos_;
+    if(count > blockSize - size)
+    {
+      count = blockSize - size;
+    }
+    std::memcpy(buffer_.get() + size, ahead_ + aheadPos_, count);
+    size += count;
+    aheadPos_ += count;
+  }
+  buffer = buffer_.get();
+  return true;
+}
@@ -8,12 +8,27 @@
 #define DATASOURCEBLOCKEDSTREAM_H
 #include "DataSource.h"
 #include <Common/QuickFAST_Export.h>
+#include <Codecs/StreamReadAhead.h>
 namespace QuickFAST{
   namespace Codecs{
     /// @brief A data source that reads input from an istream containing block headers.
+    ///
+    /// If readAheadBuffers is two or more the stream is read in large buffers by a
+    /// helper thread (see StreamReadAhead) and the block headers are parsed from the
+    /// prefetched bytes.  A block that lies within one read-ahead buffer is delivered
+    /// in place; a block that spans buffers is copied.
+    ///
+    /// A block header larger than the maximum block size, or a header or block cut
+    /// short by the end of the stream, throws EncodingError.  End of stream between
+    /// blocks is the normal end of data.
     class QuickFAST_Export DataSourceBlockedStream : public DataSource
     {
     public:
+      /// Default size for the read-ahead buffers
+      const static size_t defaultReadAheadBufferSize = 256 * 1024;
+      /// Default limit on the size of a block
+      const static size_t defaultMaxBlockSize = 16 * 1024 * 1024;
+
       /// @brief Wrap a standard istream into a DataSource
       ///
       /// The input stream should be opened in binary mode
@@ -21,13 +36,33 @@ namespace QuickFAST{
       /// system and stream type. (i.e. specify std::ios::binary
       /// when you open a ofstream on Windows.)
       /// @param stream supplies the data
-      explicit DataSourceBlockedStream(std::istream & stream);
+      /// @param readAheadBuffers is the number of buffers to read ahead (0 to read synchronously.)
+      /// @param readAheadBufferSize is the size of each read-ahead buffer.
+      explicit DataSourceBlockedStream(
+        std::istream & stream,
+        size_t readAheadBuffers = 0,
+        size_t readAheadBufferSize = defaultReadAheadBufferSize);
 
       /// @brief a typical virtual destructor.
       virtual ~DataSourceBlockedStream();
 
+      /// @brief Limit the size of a block.
+      ///
+      /// The buffer holding a block is allocated at the size given in its header
+      /// so corrupt data must not be allowed to request an arbitrary amount of memory.
+      /// @param maxBlockSize is the largest block accepted.
+      void setMaxBlockSize(size_t maxBlockSize)
+      {
+        maxBlockSize_ = maxBlockSize;
+      }
+
       virtual bool getBuffer(const uchar *& buffer, size_t & size);
 
+    private:
+      void addHeaderByte(size_t & blockSize, uchar byte)const;
+      bool getBlock(const uchar *& buffer, size_t & size);
+      bool nextByte(uchar & byte);
+      void reserve(size_t blockSize);
     private:
       DataSourceBlockedStream();
       DataSourceBlockedStream(const DataSourceBlockedStream & );
@@ -36,6 +71,12 @@ namespace QuickFAST{
       std::istream & stream_;
       boost::scoped_array<uchar> buffer_;
       size_t bufferCapacity_;
+      size_t maxBlockSize_;
+
+      boost::scoped_ptr<StreamReadAhead> readAhead_;
+      const uchar * ahead_;  // current read-ahead buffer
+      size_t aheadSize_;
+      size_t aheadPos_;
     };
   }
 }
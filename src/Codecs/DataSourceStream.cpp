@@ -6,7 +6,10 @@
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Codecs;
 
-DataSourceStream::DataSourceStream(std::istream & stream, size_t bufferSize)
+DataSourceStream::DataSourceStream(
+  std::istream & stream,
+  size_t bufferSize,
+  size_t readAheadBuffers)
 : stream_(stream)
 , pos_(0)
 , end_(0)
@@ -19,7 +22,14 @@ DataSourceStream::DataSourceStream(std::istream & stream, size_t bufferSize)
   {
     capacity_ = end_;
   }
-  buffer_.reset(new unsigned char[capacity_]);
+  if(readAheadBuffers > 1 && capacity_ > 0)
+  {
+    readAhead_.reset(new StreamReadAhead(stream, capacity_, readAheadBuffers));
+  }
+  else
+  {
+    buffer_.reset(new unsigned char[capacity_]);
+  }
 }
 
 DataSourceStream::~DataSourceStream()
@@ -29,6 +39,15 @@ DataSourceStream::~DataSourceStream()
 bool
 DataSourceStream::getBuffer(const uchar *& buffer, size_t & size)
 {
+  if(readAhead_)
+  {
+    if(!readAhead_->next(buffer, size))
+    {
+      return false;
+    }
+    pos_ += size;
+    return true;
+  }
   size = 0;
   if(stream_.good() && !stream_.eof())
   {
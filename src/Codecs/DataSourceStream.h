@@ -8,9 +8,14 @@
 #define DATASOURCESTREAM_H
 #include "DataSource.h"
 #include <Common/QuickFAST_Export.h>
+#include <Codecs/StreamReadAhead.h>
 namespace QuickFAST{
   namespace Codecs{
     /// A data source that reads input from an istream.
+    ///
+    /// If readAheadBuffers is two or more the stream is read by a helper thread
+    /// (see StreamReadAhead) which fills the next buffers while the decoder consumes
+    /// the current one.  Use large buffers in this mode.
     class QuickFAST_Export DataSourceStream : public DataSource
     {
     public:
@@ -25,7 +30,11 @@ namespace QuickFAST{
       /// when you open a ofstream on Windows.)
       /// @param stream supplies the data
       /// @param bufferSize specifies how large a buffer to allocate to read the data
-      explicit DataSourceStream(std::istream & stream, size_t bufferSize = defaultBufferSize);
+      /// @param readAheadBuffers is the number of buffers to read ahead (0 to read synchronously.)
+      explicit DataSourceStream(
+        std::istream & stream,
+        size_t bufferSize = defaultBufferSize,
+        size_t readAheadBuffers = 0);
 
       /// @brief a typical virtual destructor.
       virtual ~DataSourceStream();
@@ -45,6 +54,7 @@ namespace QuickFAST{
 
       boost::scoped_array<uchar> buffer_;
       size_t capacity_; // size of buffer
+      boost::scoped_ptr<StreamReadAhead> readAhead_;
     };
   }
 }
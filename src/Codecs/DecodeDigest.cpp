@@ -0,0 +1,161 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "DecodeDigest.h"
+#include <Common/Exceptions.h>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+namespace
+{
+  const uint64 seed = 0xCBF29CE484222325ULL;
+  const char * const signature = "QuickFAST-digest";
+}
+
+DecodeDigest::DecodeDigest(size_t checkpointInterval)
+  : checkpointInterval_(checkpointInterval)
+  , keepMessages_(false)
+  , messageCount_(0)
+  , running_(seed)
+{
+  if(checkpointInterval_ == 0)
+  {
+    throw UsageError("Coding Error", "DecodeDigest checkpoint interval must not be zero.");
+  }
+}
+
+bool
+DecodeDigest::findDifference(const DecodeDigest & other, size_t & first, size_t & last)const
+{
+  if(checkpointInterval_ != other.checkpointInterval_)
+  {
+    throw UsageError("Coding Error", "DecodeDigest: can't compare digests with different checkpoint intervals.");
+  }
+  if(messageCount_ == other.messageCount_ && finalDigest() == other.finalDigest())
+  {
+    return false;
+  }
+
+  // Checkpoints agree up to the first difference and disagree from then on.
+  size_t low = 0;
+  size_t high = std::min(checkpoints_.size(), other.checkpoints_.size());
+  bool checkpointDiffers = false;
+  while(low < high)
+  {
+    size_t middle = low + (high - low) / 2;
+    if(checkpoints_[middle] == other.checkpoints_[middle])
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+      checkpointDiffers = true;
+    }
+  }
+  size_t shorter = std::min(messageCount_, other.messageCount_);
+  first = low * checkpointInterval_;
+  if(checkpointDiffers)
+  {
+    last = first + checkpointInterval_;
+  }
+  else
+  {
+    last = std::max(messageCount_, other.messageCount_);
+  }
+
+  if(hasMessages() && other.hasMessages())
+  {
+    size_t end = std::min(last, shorter);
+    for(size_t nMessage = first; nMessage < end; ++nMessage)
+    {
+      if(messages_[nMessage] != other.messages_[nMessage])
+      {
+        first = nMessage;
+        last = nMessage + 1;
+        return true;
+      }
+    }
+    // one run is a prefix of the other
+    first = shorter;
+    last = shorter + 1;
+  }
+  return true;
+}
+
+void
+DecodeDigest::clear()
+{
+  messageCount_ = 0;
+  running_ = seed;
+  checkpoints_.clear();
+  messages_.clear();
+}
+
+void
+DecodeDigest::write(std::ostream & out)const
+{
+  size_t messages = hasMessages() ? messages_.size() : 0;
+  out << signature
+    << ' ' << checkpointInterval_
+    << ' ' << messageCount_
+    << ' ' << checkpoints_.size()
+    << ' ' << messages
+    << std::hex
+    << ' ' << finalDigest()
+    << ' ' << running_
+    << std::endl;
+  for(size_t nCheckpoint = 0; nCheckpoint < checkpoints_.size(); ++nCheckpoint)
+  {
+    out << checkpoints_[nCheckpoint] << std::endl;
+  }
+  for(size_t nMessage = 0; nMessage < messages; ++nMessage)
+  {
+    out << messages_[nMessage] << std::endl;
+  }
+  out << std::dec;
+}
+
+bool
+DecodeDigest::read(std::istream & in)
+{
+  std::string header;
+  size_t interval = 0;
+  size_t count = 0;
+  size_t checkpointCount = 0;
+  size_t messages = 0;
+  uint64 final = 0;
+  uint64 running = 0;
+  in >> header >> interval >> count >> checkpointCount >> messages >> std::hex >> final >> running;
+  if(!in || header != signature || interval == 0
+    || checkpointCount != count / interval
+    || (messages != 0 && messages != count))
+  {
+    in >> std::dec;
+    return false;
+  }
+  std::vector<uint64> checkpoints(checkpointCount);
+  for(size_t nCheckpoint = 0; in && nCheckpoint < checkpointCount; ++nCheckpoint)
+  {
+    in >> checkpoints[nCheckpoint];
+  }
+  std::vector<uint64> digests(messages);
+  for(size_t nMessage = 0; in && nMessage < messages; ++nMessage)
+  {
+    in >> digests[nMessage];
+  }
+  in >> std::dec;
+  if(!in || mix(running, count) != final)
+  {
+    return false;
+  }
+  checkpointInterval_ = interval;
+  keepMessages_ = messages != 0;
+  messageCount_ = count;
+  running_ = running;
+  checkpoints_.swap(checkpoints);
+  messages_.swap(digests);
+  return true;
+}
@@ -0,0 +1,159 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef DECODEDIGEST_H
+#define DECODEDIGEST_H
+#include "DecodeDigest_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief A compact summary of a decoding run for regression checks.
+    ///
+    /// A DigestBuilder hashes every decoded message and passes the result to
+    /// addMessage().  The message digests are chained into a running digest;
+    /// every checkpointInterval() messages the running digest is recorded as
+    /// a checkpoint.  Because each checkpoint depends on every message before it,
+    /// once two runs differ all later checkpoints differ too, so findDifference()
+    /// can locate the first differing message by binary search over the checkpoints.
+    ///
+    /// The digest of each message may also be kept (setKeepMessages()) so the
+    /// difference can be pinned to a single message rather than to a range.
+    ///
+    /// write() and read() save and restore the digest so a run can be
+    /// compared with one made earlier.
+    class QuickFAST_Export DecodeDigest
+    {
+    public:
+      /// @brief The default number of messages between checkpoints.
+      static const size_t defaultCheckpointInterval = 4096;
+
+      /// @brief Construct
+      /// @param checkpointInterval is the number of messages between checkpoints.
+      /// @throws UsageError if checkpointInterval is zero.
+      explicit DecodeDigest(size_t checkpointInterval = defaultCheckpointInterval);
+
+      /// @brief Keep the digest of every message.
+      ///
+      /// Costs eight bytes per message.  Must be set before the first message.
+      /// @param keep enables keeping message digests.
+      void setKeepMessages(bool keep)
+      {
+        keepMessages_ = keep;
+      }
+
+      /// @brief Record the digest of the next message.
+      /// @param digest is the message digest calculated by the DigestBuilder.
+      void addMessage(uint64 digest)
+      {
+        running_ = mix(running_, digest);
+        ++messageCount_;
+        if(keepMessages_)
+        {
+          messages_.push_back(digest);
+        }
+        if(messageCount_ % checkpointInterval_ == 0)
+        {
+          checkpoints_.push_back(running_);
+        }
+      }
+
+      /// @brief How many messages between checkpoints.
+      size_t checkpointInterval()const
+      {
+        return checkpointInterval_;
+      }
+
+      /// @brief How many messages have been recorded.
+      size_t messageCount()const
+      {
+        return messageCount_;
+      }
+
+      /// @brief The digest of the entire run.
+      uint64 finalDigest()const
+      {
+        return mix(running_, messageCount_);
+      }
+
+      /// @brief How many checkpoints have been recorded.
+      size_t checkpointCount()const
+      {
+        return checkpoints_.size();
+      }
+
+      /// @brief Access a checkpoint.
+      ///
+      /// Checkpoint n covers the first (n + 1) * checkpointInterval() messages.
+      /// @param index is 0 <= index < checkpointCount()
+      uint64 checkpoint(size_t index)const
+      {
+        return checkpoints_[index];
+      }
+
+      /// @brief Were message digests kept?
+      /// @returns true if messageDigest() is available for every message.
+      bool hasMessages()const
+      {
+        return keepMessages_ && messages_.size() == messageCount_;
+      }
+
+      /// @brief Access the digest of a single message.
+      /// @param index is 0 <= index < messageCount() if hasMessages()
+      uint64 messageDigest(size_t index)const
+      {
+        return messages_[index];
+      }
+
+      /// @brief Find the first message that differs between two runs.
+      ///
+      /// The range is one message wide if both digests kept their messages,
+      /// otherwise it is at most one checkpoint interval wide.  If one run is a
+      /// prefix of the other, the range starts after the shorter run.
+      /// @param other is the digest of the other run.
+      /// @param[out] first is the first message that may differ.
+      /// @param[out] last is one past the last message that may differ.
+      /// @returns false if the runs are the same.
+      /// @throws UsageError if the checkpoint intervals differ.
+      bool findDifference(const DecodeDigest & other, size_t & first, size_t & last)const;
+
+      /// @brief Forget all messages.
+      void clear();
+
+      /// @brief Write the digest as text.
+      /// @param out is the stream to which the digest will be written.
+      void write(std::ostream & out)const;
+
+      /// @brief Replace the contents of this digest with one written by write().
+      /// @param in is the stream from which the digest will be read.
+      /// @returns false if the stream does not contain a valid digest.
+      bool read(std::istream & in);
+
+      /// @brief Combine a value into a hash.
+      ///
+      /// A fast, non-cryptographic multiply and shift mix.
+      /// @param hash is the current hash value.
+      /// @param value is the value to be combined.
+      /// @returns the new hash value.
+      static uint64 mix(uint64 hash, uint64 value)
+      {
+        hash ^= value;
+        hash *= 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 29;
+        return hash;
+      }
+
+    private:
+      size_t checkpointInterval_;
+      bool keepMessages_;
+      size_t messageCount_;
+      uint64 running_;
+      std::vector<uint64> checkpoints_;
+      std::vector<uint64> messages_;
+    };
+  }
+}
+#endif // DECODEDIGEST_H
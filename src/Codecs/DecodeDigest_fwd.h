@@ -0,0 +1,15 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef DECODEDIGEST_FWD_H
+#define DECODEDIGEST_FWD_H
+namespace QuickFAST{
+  namespace Codecs{
+    class DecodeDigest;
+    class DigestBuilder;
+  }
+}
+#endif // DECODEDIGEST_FWD_H
@@ -4,18 +4,103 @@
 #include <Common/QuickFASTPch.h>
 
 #include "Decoder.h"
+#include <Codecs/StaticMessageBuilder.h>
 #include <Codecs/DataSource.h>
 #include <Codecs/PresenceMap.h>
 #include <Codecs/TemplateRegistry.h>
 #include <Codecs/FieldInstruction.h>
+#include <Codecs/FieldInstructionTemplateRef.h>
+#include <Codecs/LazyMessageView.h>
 #include <Messages/ValueMessageBuilder.h>
+#include <Messages/NullMessageBuilder.h>
 #include <Common/Profiler.h>
 
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Codecs;
 
+namespace
+{
+  /// @brief Pass a field through to the message builder while capturing its value.
+  ///
+  /// Used to evaluate filter predicates.  Only scalar fields are tested.  The field
+  /// instruction calls these methods through the static type (see Decoder::decodeStaticField())
+  /// so the value reaches the message builder with one virtual call, as it does when the
+  /// field is not tested.
+  class PredicateCapture
+  {
+  public:
+    explicit PredicateCapture(Messages::ValueMessageBuilder & target)
+      : target_(target)
+    {
+    }
+
+    const Value & value()const
+    {
+      return value_;
+    }
+
+    template<typename VALUE>
+    void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const VALUE value)
+    {
+      value_.setValue(value);
+      target_.addValue(identity, type, value);
+    }
+
+    void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length)
+    {
+      value_.setValue(value, length);
+      target_.addValue(identity, type, value, length);
+    }
+
+    void addInternedValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length, uint32 id)
+    {
+      value_.setValue(value, length);
+      target_.addInternedValue(identity, type, value, length, id);
+    }
+
+    void invalidUtf8(Messages::FieldIdentityCPtr & identity, size_t errorOffset)
+    {
+      target_.invalidUtf8(identity, errorOffset);
+    }
+
+    bool startByteVector(Messages::FieldIdentityCPtr & identity, ValueType::Type type, size_t length)
+    {
+      chunks_.clear();
+      return target_.startByteVector(identity, type, length);
+    }
+
+    void appendByteVector(Messages::FieldIdentityCPtr & identity, const unsigned char * chunk, size_t size)
+    {
+      chunks_.append(reinterpret_cast<const char *>(chunk), size);
+      target_.appendByteVector(identity, chunk, size);
+    }
+
+    void endByteVector(Messages::FieldIdentityCPtr & identity, ValueType::Type type)
+    {
+      value_.setValue(chunks_);
+      target_.endByteVector(identity, type);
+    }
+
+    /// Fields that cannot be tested go straight to the message builder.
+    Messages::ValueMessageBuilder & valueMessageBuilder()
+    {
+      return target_;
+    }
+
+  private:
+    Messages::ValueMessageBuilder & target_;
+    /// Stays undefined if the field is absent, so every predicate fails.
+    Value value_;
+    /// A byte vector delivered in chunks
+    std::string chunks_;
+  };
+}
+
 Decoder::Decoder(Codecs::TemplateRegistryPtr registry)
 : Context(registry)
+, utf8Policy_(UTF8_ACCEPT)
+, invalidUtf8Count_(0)
+, byteVectorChunkThreshold_(0)
 {
 }
 
@@ -23,6 +108,110 @@ Decoder::Decoder(Codecs::TemplateRegistryPtr registry)
 //{
 //}
 
+size_t
+Decoder::internField(const Messages::FieldIdentity & identity)
+{
+  std::vector<const FieldInstruction *> found;
+  TemplateRegistryCPtr registry = getTemplateRegistry();
+  for(TemplateRegistry::const_iterator it = registry->begin(); it != registry->end(); ++it)
+  {
+    findInternedFields(*it->second, identity, found);
+  }
+  std::sort(found.begin(), found.end());
+  found.erase(std::unique(found.begin(), found.end()), found.end());
+  size_t count = 0;
+  for(size_t nFound = 0; nFound < found.size(); ++nFound)
+  {
+    InternedField field;
+    field.instruction_ = found[nFound];
+    field.lastId_ = 0;
+    field.hasLast_ = false;
+    std::vector<InternedField>::iterator pos = std::lower_bound(interned_.begin(), interned_.end(), field);
+    if(pos == interned_.end() || pos->instruction_ != field.instruction_)
+    {
+      interned_.insert(pos, field);
+    }
+    ++count;
+  }
+  return count;
+}
+
+void
+Decoder::findInternedFields(
+  const SegmentBody & segment,
+  const Messages::FieldIdentity & identity,
+  std::vector<const FieldInstruction *> & found)
+{
+  size_t instructionCount = segment.size();
+  for(size_t nField = 0; nField < instructionCount; ++nField)
+  {
+    const FieldInstructionCPtr & instruction = segment.getInstruction(nField);
+    if(instruction->fieldInstructionType() == ValueType::ASCII && *instruction->getIdentity() == identity)
+    {
+      found.push_back(instruction.get());
+    }
+    SegmentBodyPtr nested;
+    if(instruction->getSegmentBody(nested))
+    {
+      findInternedFields(*nested, identity, found);
+    }
+    const FieldInstructionStaticTemplateRef * templateRef =
+      dynamic_cast<const FieldInstructionStaticTemplateRef *>(instruction.get());
+    TemplateCPtr target;
+    if(templateRef != 0 && templateRef->getTarget(*this, target))
+    {
+      findInternedFields(*target, identity, found);
+    }
+  }
+}
+
+bool
+Decoder::intern(const FieldInstruction & instruction, const uchar * value, size_t length, uint32 & id)
+{
+  InternedField key;
+  key.instruction_ = &instruction;
+  std::vector<InternedField>::iterator field = std::lower_bound(interned_.begin(), interned_.end(), key);
+  if(field == interned_.end() || field->instruction_ != &instruction)
+  {
+    return false;
+  }
+  if(field->hasLast_ && internTable_.matches(field->lastId_, value, length))
+  {
+    id = field->lastId_;
+    return true;
+  }
+  if(!internTable_.intern(value, length, id))
+  {
+    return false;
+  }
+  field->lastId_ = id;
+  field->hasLast_ = true;
+  return true;
+}
+
+void
+Decoder::setLazyMessages(bool lazy)
+{
+  if(!lazy)
+  {
+    lazyView_.reset();
+  }
+  else if(!lazyView_)
+  {
+    lazyView_.reset(new LazyMessageView(*this));
+  }
+}
+
+void
+Decoder::setFilter(const MessageFilterPtr & filter)
+{
+  if(filter)
+  {
+    filter->resolve(*getTemplateRegistry());
+  }
+  filter_ = filter;
+}
+
 
 void
 Decoder::decodeMessage(
@@ -33,6 +222,90 @@ Decoder::decodeMessage(
   source.beginMessage();
 
   Codecs::PresenceMap pmap(getTemplateRegistry()->presenceMapBits());
+  Codecs::TemplateCPtr templatePtr;
+  if(decodeMessageHeader(source, pmap, templatePtr))
+  {
+    const MessageFilter::TemplatePredicates * predicates = 0;
+    if(filter_)
+    {
+      if(!filter_->isResolved())
+      {
+        // predicates were added after setFilter()
+        filter_->resolve(*getTemplateRegistry());
+      }
+      predicates = filter_->findTemplate(templateId_);
+      if(predicates == 0 && !filter_->getAcceptUnfilteredTemplates())
+      {
+        // Nothing in this message is wanted, but the dictionaries still need it.
+        skipSegmentBody(source, pmap, templatePtr, 0);
+        filter_->countRejected();
+        return;
+      }
+    }
+    if(lazyView_ && predicates == 0 && templatePtr->isViewable() && !templatePtr->getIgnore()
+      && messageBuilder.acceptsLazyMessages())
+    {
+      lazyView_->scan(source, pmap, templatePtr);
+      if(filter_)
+      {
+        filter_->countAccepted();
+      }
+      if(messageBuilder.lazyMessage(*lazyView_))
+      {
+        return;
+      }
+      Messages::ValueMessageBuilder & bodyBuilder(
+        messageBuilder.startMessage(
+          templatePtr->getApplicationType(),
+          templatePtr->getApplicationTypeNamespace(),
+          templatePtr->fieldCount()));
+      lazyView_->decodeTo(bodyBuilder);
+      messageBuilder.endMessage(bodyBuilder);
+      return;
+    }
+    Messages::ValueMessageBuilder & bodyBuilder(
+      messageBuilder.startMessage(
+        templatePtr->getApplicationType(),
+        templatePtr->getApplicationTypeNamespace(),
+        templatePtr->fieldCount()));
+
+    bool accepted = true;
+    if(predicates != 0)
+    {
+      accepted = decodeFilteredSegmentBody(source, pmap, templatePtr, bodyBuilder, *predicates);
+    }
+    else
+    {
+      decodeSegmentBody(source, pmap, templatePtr, bodyBuilder);
+    }
+    if(filter_)
+    {
+      if(accepted)
+      {
+        filter_->countAccepted();
+      }
+      else
+      {
+        filter_->countRejected();
+      }
+    }
+    if(!accepted || templatePtr->getIgnore())
+    {
+      messageBuilder.ignoreMessage(bodyBuilder);
+    }
+    else
+    {
+      messageBuilder.endMessage(bodyBuilder);
+    }
+  }
+}
+
+bool
+Decoder::decodeMessageHeader(
+  DataSource & source,
+  PresenceMap & pmap,
+  TemplateCPtr & templatePtr)
+{
   if(this->verboseOut_)
   {
     pmap.setVerbose(verboseOut_);
@@ -54,28 +327,13 @@ Decoder::decodeMessage(
   {
     (*verboseOut_) << "Template ID: " << getTemplateId() << std::endl;
   }
-  Codecs::TemplateCPtr templatePtr;
   if(getTemplateRegistry()->getTemplate(templateId_, templatePtr))
   {
     if(templatePtr->getReset())
     {
       reset(false);
     }
-    Messages::ValueMessageBuilder & bodyBuilder(
-      messageBuilder.startMessage(
-        templatePtr->getApplicationType(),
-        templatePtr->getApplicationTypeNamespace(),
-        templatePtr->fieldCount()));
-
-    decodeSegmentBody(source, pmap, templatePtr, bodyBuilder);
-    if(templatePtr->getIgnore())
-    {
-      messageBuilder.ignoreMessage(bodyBuilder);
-    }
-    else
-    {
-      messageBuilder.endMessage(bodyBuilder);
-    }
+    return true;
   }
   else if(templateId_ == SCPResetTemplateId)
   {
@@ -87,7 +345,7 @@ Decoder::decodeMessage(
     error += boost::lexical_cast<std::string>(getTemplateId());
     reportError("[ERR D9]", error);
   }
-  return;
+  return false;
 }
 
 void
@@ -187,3 +445,192 @@ Decoder::decodeSegmentBody(
     (void)instruction->decode(source, pmap, *this, messageBuilder);
   }
 }
+
+bool
+Decoder::decodeFilteredSegmentBody(
+  DataSource & source,
+  Codecs::PresenceMap & pmap,
+  const Codecs::SegmentBodyCPtr & segment,
+  Messages::ValueMessageBuilder & messageBuilder,
+  const MessageFilter::TemplatePredicates & predicates)
+{
+  size_t instructionCount = segment->size();
+  size_t nField = 0;
+  bool accepted = true;
+  for(; accepted && nField < instructionCount; ++nField)
+  {
+    PROFILE_POINT("decode field");
+    const Codecs::FieldInstructionCPtr & instruction = segment->getInstruction(nField);
+    if(verboseOut_)
+    {
+      (*verboseOut_) <<std::endl << "Decode instruction[" <<nField << "]: " << instruction->getIdentity()->name() << std::endl;
+    }
+    source.beginField(instruction->getIdentity()->name());
+    const std::vector<MessageFilter::Predicate> * fieldPredicates = predicates.find(nField);
+    if(fieldPredicates == 0)
+    {
+      (void)instruction->decode(source, pmap, *this, messageBuilder);
+    }
+    else
+    {
+      PredicateCapture capture(messageBuilder);
+      decodeStaticField(source, pmap, *instruction, capture);
+      for(std::vector<MessageFilter::Predicate>::const_iterator it = fieldPredicates->begin();
+        accepted && it != fieldPredicates->end();
+        ++it)
+      {
+        accepted = it->test(capture.value());
+      }
+    }
+  }
+
+  if(!accepted)
+  {
+    if(verboseOut_)
+    {
+      (*verboseOut_) << std::endl << "Message rejected by filter." << std::endl;
+    }
+    // Finish the message to keep the dictionaries in step, but build nothing.
+    skipSegmentBody(source, pmap, segment, nField);
+  }
+  return accepted;
+}
+
+void
+Decoder::skipSegmentBody(
+  DataSource & source,
+  Codecs::PresenceMap & pmap,
+  const Codecs::SegmentBodyCPtr & segment,
+  size_t firstField)
+{
+  Messages::NullMessageBuilder nullBuilder;
+  size_t instructionCount = segment->size();
+  for(size_t nField = firstField; nField < instructionCount; ++nField)
+  {
+    PROFILE_POINT("skip field");
+    const Codecs::FieldInstructionCPtr & instruction = segment->getInstruction(nField);
+    source.beginField(instruction->getIdentity()->name());
+    if(!skipField(source, pmap, *instruction))
+    {
+      (void)instruction->decode(source, pmap, *this, nullBuilder);
+    }
+  }
+}
+
+bool
+Decoder::skipField(
+  DataSource & source,
+  Codecs::PresenceMap & pmap,
+  const FieldInstruction & instruction)
+{
+  FieldOpCPtr fieldOp = instruction.getFieldOp();
+  FieldOp::OpType opType = fieldOp->opType();
+  size_t pmapBit = 0;
+  if((opType != FieldOp::NOP && opType != FieldOp::CONSTANT && opType != FieldOp::DEFAULT)
+    || fieldOp->getPMapBit(pmapBit))
+  {
+    // the field uses the dictionary (or is unusual enough to leave to the field instruction).
+    return false;
+  }
+  bool mandatory = instruction.isMandatory();
+  ValueType::Type type = instruction.fieldInstructionType();
+  switch(type)
+  {
+  case ValueType::INT8:
+  case ValueType::UINT8:
+  case ValueType::INT16:
+  case ValueType::UINT16:
+  case ValueType::INT32:
+  case ValueType::UINT32:
+  case ValueType::INT64:
+  case ValueType::UINT64:
+  case ValueType::ASCII:
+  case ValueType::UTF8:
+  case ValueType::BYTEVECTOR:
+    break;
+  case ValueType::DECIMAL:
+  {
+    // An exponent or mantissa with its own operator may use a dictionary.
+    const FieldInstructionDecimal & decimal = static_cast<const FieldInstructionDecimal &>(instruction);
+    FieldInstructionCPtr component;
+    if(decimal.getExponentInstruction(component) || decimal.getMantissaInstruction(component))
+    {
+      return false;
+    }
+    break;
+  }
+  default:
+    return false;
+  }
+
+  if(opType == FieldOp::CONSTANT)
+  {
+    // nothing in the stream.  Optional constants use a presence map bit.
+    if(!mandatory)
+    {
+      pmap.checkNextField();
+    }
+    return true;
+  }
+  if(opType == FieldOp::DEFAULT && !pmap.checkNextField())
+  {
+    return true;
+  }
+  switch(type)
+  {
+  case ValueType::DECIMAL:
+    // exponent then mantissa.  A NULL exponent means there is no mantissa.
+    if(!skipEntity(source, instruction) || mandatory)
+    {
+      skipEntity(source, instruction);
+    }
+    break;
+  case ValueType::UTF8:
+  case ValueType::BYTEVECTOR:
+  {
+    uint32 length;
+    FieldInstruction::decodeUnsignedInteger(source, *this, length, instruction.getIdentity()->name());
+    if(!mandatory)
+    {
+      if(length == 0)
+      {
+        break;
+      }
+      --length;
+    }
+    size_t remaining = length;
+    while(remaining > 0)
+    {
+      const uchar * chunk = 0;
+      size_t size = source.getContiguous(remaining, chunk);
+      if(size == 0)
+      {
+        reportFatal("[ERR U03]", "End of file: Too few bytes in ByteVector.", *instruction.getIdentity());
+      }
+      remaining -= size;
+    }
+    break;
+  }
+  default:
+    // integers and ASCII strings.
+    skipEntity(source, instruction);
+    break;
+  }
+  return true;
+}
+
+bool
+Decoder::skipEntity(DataSource & source, const FieldInstruction & instruction)
+{
+  uchar byte = 0;
+  size_t count = 0;
+  do
+  {
+    if(!source.getByte(byte))
+    {
+      reportFatal("[ERR U03]", "Unexpected end of data.", *instruction.getIdentity());
+    }
+    ++count;
+  } while((byte & 0x80) == 0);
+  return count == 1 && byte == 0x80;
+}
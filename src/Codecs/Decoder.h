@@ -13,12 +13,19 @@
 #include <Codecs/PresenceMap_fwd.h>
 #include <Codecs/Template.h>
 #include <Codecs/SegmentBody_fwd.h>
+#include <Codecs/MessageFilter.h>
+#include <Codecs/LazyMessageView_fwd.h>
+#include <Codecs/FieldInstruction_fwd.h>
 #include <Messages/ValueMessageBuilder_fwd.h>
+#include <Common/InternTable.h>
 
 #include <Common/Exceptions.h>
 
 namespace QuickFAST{
   namespace Codecs{
+    template<typename Builder>
+    class StaticMessageBuilder;
+
     /// @brief Decode incoming FAST messages.
     ///
     /// Create an instance of the Decoder providing a registry of the templates
@@ -27,10 +34,153 @@ namespace QuickFAST{
     class QuickFAST_Export Decoder : public Context
     {
     public:
+      /// @brief How to handle unicode string fields that are not valid UTF-8.
+      enum Utf8Policy
+      {
+        /// Do not validate.  Deliver the value as received.  This is the default.
+        UTF8_ACCEPT,
+        /// Report an error (a decoding error for the message.)
+        UTF8_REJECT,
+        /// Replace invalid sequences with U+FFFD before delivering the value.
+        UTF8_REPLACE,
+        /// Deliver the value as received, then call ValueMessageBuilder::invalidUtf8().
+        UTF8_FLAG
+      };
+
       /// @brief Construct with a TemplateRegistry containing all templates to be used.
       /// @param registry A registry containing all templates to be used to decode messages.
       explicit Decoder(TemplateRegistryPtr registry);
 
+      /// @brief Validate unicode string fields as they are decoded.
+      ///
+      /// Dictionary entries always hold the value as received so delta and tail
+      /// operators work correctly regardless of the policy.
+      /// @param policy determines what happens to invalid values.
+      void setUtf8Policy(Utf8Policy policy)
+      {
+        utf8Policy_ = policy;
+      }
+
+      /// @brief How are invalid UTF-8 values handled.
+      Utf8Policy getUtf8Policy()const
+      {
+        return utf8Policy_;
+      }
+
+      /// @brief Statistic: How many invalid UTF-8 values have been found.
+      size_t invalidUtf8Count()const
+      {
+        return invalidUtf8Count_;
+      }
+
+      /// @brief Count an invalid UTF-8 value.
+      void countInvalidUtf8()
+      {
+        ++invalidUtf8Count_;
+      }
+
+      /// @brief Deliver large byte vector fields to the builder in pieces.
+      ///
+      /// Byte vectors of at least this many bytes are passed to the builder via
+      /// ValueMessageBuilder::startByteVector(), appendByteVector() and endByteVector()
+      /// directly from the DataSource's buffers rather than being assembled in the
+      /// working buffer first.  Smaller byte vectors and builders that decline the
+      /// offer receive the value in a single addValue() call.
+      ///
+      /// Only byte vectors with no operator or the default operator are eligible.
+      /// Copy, delta and tail need the complete value for the dictionary.
+      /// @param threshold is the minimum size to be streamed; zero (the default) disables streaming.
+      void setByteVectorChunkThreshold(size_t threshold)
+      {
+        byteVectorChunkThreshold_ = threshold;
+      }
+
+      /// @brief The smallest byte vector that will be delivered in pieces (zero means never.)
+      size_t getByteVectorChunkThreshold()const
+      {
+        return byteVectorChunkThreshold_;
+      }
+
+      /// @brief Intern the values of an ASCII field.
+      ///
+      /// Each distinct value of the field is assigned a small integer id that is stable
+      /// for the life of this Decoder.  The value is delivered to the builder
+      /// via ValueMessageBuilder::addInternedValue() along with its id.
+      ///
+      /// All ASCII fields with this identity in any template in the registry are affected.
+      /// All interned fields share one table so the same value has the same id
+      /// regardless of which field it appears in.
+      /// @param identity identifies the field.
+      /// @returns the number of field instructions that will be interned.
+      size_t internField(const Messages::FieldIdentity & identity);
+
+      /// @brief Limit the number of distinct values that will be interned.
+      ///
+      /// Once the table is full new values are delivered via addValue() without an id.
+      /// Must be called before any values are interned.
+      /// @param limit is the maximum number of distinct values.
+      void setInternLimit(size_t limit)
+      {
+        internTable_ = InternTable(limit);
+      }
+
+      /// @brief Access the table of interned values, for example to look up a value by id.
+      const InternTable & getInternTable()const
+      {
+        return internTable_;
+      }
+
+      /// @brief Are any fields being interned?
+      bool isInterning()const
+      {
+        return !interned_.empty();
+      }
+
+      /// @brief Find the id of a value decoded by a field instruction.
+      ///
+      /// The id most recently found for each instruction is remembered and checked first,
+      /// so a value repeated by the copy operator does not need to be hashed.
+      /// @param instruction decoded the value.
+      /// @param value points to the value.
+      /// @param length is the number of bytes in the value.
+      /// @param[out] id is the id of the value.
+      /// @returns false if the instruction is not interned or the table is full.
+      bool intern(const FieldInstruction & instruction, const uchar * value, size_t length, uint32 & id);
+
+      /// @brief Deliver messages as LazyMessageViews when possible.
+      ///
+      /// Messages using a template that TemplateRegistry::finalize() found to be
+      /// viewable are offered to the builder via ValueMessageBuilder::lazyMessage()
+      /// if the builder's acceptsLazyMessages() is true.  The builder is asked for
+      /// each such message.  If the builder declines a
+      /// message, it is decoded as usual (from the encoded bytes located by the
+      /// view.)  Ignored templates and templates being tested by a filter are
+      /// always decoded as usual.
+      /// @param lazy true enables lazy messages.
+      void setLazyMessages(bool lazy);
+
+      /// @brief Are lazy messages enabled?
+      bool getLazyMessages()const
+      {
+        return bool(lazyView_);
+      }
+
+      /// @brief Apply a filter to the messages being decoded.
+      ///
+      /// Once a field tested by the filter fails, the rest of the message is decoded
+      /// only to keep the dictionaries up to date.  No further values are passed to the
+      /// message builder and the message is finished via ignoreMessage().
+      /// The filter is resolved against this decoder's template registry now, and
+      /// again before the next message if predicates are added to it later.
+      /// @param filter the filter to apply. An empty pointer disables filtering.
+      void setFilter(const MessageFilterPtr & filter);
+
+      /// @brief Access the filter being applied to the messages (if any).
+      const MessageFilterPtr & getFilter()const
+      {
+        return filter_;
+      }
+
       /// @brief Decode the next message.
       /// @param[in] source where to read the incoming message(s).
       /// @param[out] message an empty message into which the decoded fields will be stored.
@@ -38,6 +188,45 @@ namespace QuickFAST{
         DataSource & source,
         Messages::ValueMessageBuilder & message);
 
+      /// @brief Decode the next message into a builder whose type is known at compile time.
+      ///
+      /// The integer, decimal, string and byte vector fields in the body of the message
+      /// are decoded without virtual dispatch on the field operator and are passed to the
+      /// builder via direct (non-virtual) calls to Builder's methods which the compiler
+      /// can inline.  startMessage(), endMessage() and ignoreMessage() are called the same way.
+      /// Groups, sequences and template references, and everything inside them, are still
+      /// delivered through the ValueMessageBuilder interface.
+      /// If a message filter, a lazy message view or a verbose stream is set on this
+      /// decoder, or if Builder::startMessage() returns a different builder for the body,
+      /// the whole message falls back to the general, fully virtual path.
+      /// Builder must be the most-derived type of the builder.
+      ///
+      /// The type must be given explicitly: decoder.decodeMessage<MyBuilder>(source, builder);
+      /// Defined in StaticMessageBuilder.h which must be included to use this method.
+      /// @param[in] source where to read the incoming message(s).
+      /// @param[out] builder receives the decoded fields.
+      template<typename Builder>
+      void decodeMessage(
+        DataSource & source,
+        typename StaticMessageBuilder<Builder>::Target & builder);
+
+      /// @brief Decode the next message using a compile-time template description.
+      ///
+      /// If the message uses the template the description is bound to, its body is
+      /// decoded by code generated for the description and integer fields are passed
+      /// to Builder::addValue() directly.  Other messages are decoded as usual.
+      /// Builder must be the most-derived type of the builder.
+      ///
+      /// Defined in StaticTemplate.h which must be included to use this method.
+      /// @param[in] source where to read the incoming message(s).
+      /// @param[in] description is a StaticTemplate bound to this decoder's registry.
+      /// @param[out] builder receives the decoded fields.
+      template<typename Description, typename Builder>
+      void decodeStaticMessage(
+        DataSource & source,
+        const Description & description,
+        Builder & builder);
+
       /// @brief Decode a group field.
       ///
       /// If the application type of the group matches the application type of the
@@ -77,6 +266,116 @@ namespace QuickFAST{
         PresenceMap & pmap,
         const SegmentBodyCPtr & segment,
         Messages::ValueMessageBuilder & messageBuilder);
+
+    private:
+      /// @brief Decode the presence map and template ID that start a message.
+      /// @param[in] source supplies the FAST encoded data.
+      /// @param[out] pmap receives the presence map.
+      /// @param[out] templatePtr is the template for the message.
+      /// @returns true if there is a message body to decode.
+      bool decodeMessageHeader(
+        DataSource & source,
+        PresenceMap & pmap,
+        TemplateCPtr & templatePtr);
+
+      /// @brief Decode the body of a message with direct calls to the builder for scalar fields.
+      /// @param[in] source supplies the FAST encoded data.
+      /// @param[in] pmap is used to determine which fields are present
+      /// @param[in] segment defines the expected fields
+      /// @param[in] builder receives the decoded fields
+      template<typename Builder>
+      void decodeStaticSegmentBody(
+        DataSource & source,
+        PresenceMap & pmap,
+        const SegmentBodyCPtr & segment,
+        StaticMessageBuilder<Builder> & builder);
+
+      /// @brief Decode one field with direct calls to a builder of known type.
+      ///
+      /// Scalar fields call the builder through its static type.  Anything else
+      /// is passed to builder.valueMessageBuilder().
+      /// @param[in] source supplies the FAST encoded data.
+      /// @param[in] pmap is used to determine which fields are present
+      /// @param[in] instruction defines the field
+      /// @param[in] builder receives the decoded value
+      template<typename BUILDER>
+      void decodeStaticField(
+        DataSource & source,
+        PresenceMap & pmap,
+        const FieldInstruction & instruction,
+        BUILDER & builder);
+
+      /// @brief Decode the body of a message, testing fields against the filter.
+      /// @param[in] source supplies the FAST encoded data.
+      /// @param[in] pmap is used to determine which fields are present
+      /// @param[in] segment defines the expected fields
+      /// @param[in] messageBuilder to which the decoded fields will be added
+      /// @param[in] predicates are the tests to be applied to fields in this template
+      /// @returns true if the message satisfied all predicates.
+      bool decodeFilteredSegmentBody(
+        DataSource & source,
+        PresenceMap & pmap,
+        const SegmentBodyCPtr & segment,
+        Messages::ValueMessageBuilder & messageBuilder,
+        const MessageFilter::TemplatePredicates & predicates);
+
+      /// @brief Finish decoding a segment whose values are not wanted.
+      ///
+      /// Only the dictionaries need to be kept up to date.  Scalar fields with no
+      /// operator or with a constant or default operator do not use the dictionary
+      /// so they are stepped over without being decoded.  Everything else is decoded
+      /// into a NullMessageBuilder.
+      /// @param[in] source supplies the FAST encoded data.
+      /// @param[in] pmap is used to determine which fields are present
+      /// @param[in] segment defines the expected fields
+      /// @param[in] firstField is the position in the segment of the first field to be skipped.
+      void skipSegmentBody(
+        DataSource & source,
+        PresenceMap & pmap,
+        const SegmentBodyCPtr & segment,
+        size_t firstField);
+
+      /// @brief Step over a scalar field that does not use the dictionary.
+      /// @param[in] source supplies the FAST encoded data.
+      /// @param[in] pmap is used to determine which fields are present
+      /// @param[in] instruction defines the field
+      /// @returns false if the field must be decoded instead.
+      bool skipField(
+        DataSource & source,
+        PresenceMap & pmap,
+        const FieldInstruction & instruction);
+
+      /// @brief Step over one stop bit encoded entity.
+      /// @param[in] source supplies the FAST encoded data.
+      /// @param[in] instruction is used to report errors.
+      /// @returns true if the entity was a lone NULL byte (0x80).
+      bool skipEntity(DataSource & source, const FieldInstruction & instruction);
+
+    private:
+      MessageFilterPtr filter_;
+      Utf8Policy utf8Policy_;
+      size_t invalidUtf8Count_;
+      size_t byteVectorChunkThreshold_;
+      LazyMessageViewPtr lazyView_;
+
+      void findInternedFields(
+        const SegmentBody & segment,
+        const Messages::FieldIdentity & identity,
+        std::vector<const FieldInstruction *> & found);
+
+      struct InternedField
+      {
+        const FieldInstruction * instruction_;
+        uint32 lastId_;
+        bool hasLast_;
+        bool operator < (const InternedField & rhs)const
+        {
+          return instruction_ < rhs.instruction_;
+        }
+      };
+      /// sorted by instruction address
+      std::vector<InternedField> interned_;
+      InternTable internTable_;
     };
   }
 }
@@ -0,0 +1,233 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "DigestBuilder.h"
+#include <Common/Decimal.h>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+namespace
+{
+  const std::string noType;
+  // distinguish structure from values.
+  const uint64 entryMarker = 0x454E545259ULL; // "ENTRY"
+  const uint64 groupMarker = 0x47524F5550ULL; // "GROUP"
+}
+
+DigestBuilder::DigestBuilder(DecodeDigest & digest)
+  : digest_(digest)
+  , hash_(0)
+  , valueCount_(0)
+  , messageDigest_(0)
+  , errorCount_(0)
+  , applicationType_(&noType)
+  , applicationTypeNamespace_(&noType)
+{
+}
+
+DigestBuilder::~DigestBuilder()
+{
+}
+
+uint64
+DigestBuilder::hashBytes(uint64 hash, const uchar * value, size_t length)
+{
+  size_t pos = 0;
+  for(; pos + sizeof(uint64) <= length; pos += sizeof(uint64))
+  {
+    uint64 word;
+    std::memcpy(&word, value + pos, sizeof(word));
+    hash = DecodeDigest::mix(hash, word);
+  }
+  uint64 tail = 0;
+  for(size_t shift = 0; pos < length; ++pos, shift += 8)
+  {
+    tail |= uint64(value[pos]) << shift;
+  }
+  return DecodeDigest::mix(hash, tail ^ (uint64(length) << 56));
+}
+
+const std::string &
+DigestBuilder::getApplicationType()const
+{
+  return *applicationType_;
+}
+
+const std::string &
+DigestBuilder::getApplicationTypeNs()const
+{
+  return *applicationTypeNamespace_;
+}
+
+void
+DigestBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int64 value)
+{
+  hashValue(identity, type, uint64(value));
+}
+
+void
+DigestBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint64 value)
+{
+  hashValue(identity, type, value);
+}
+
+void
+DigestBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int32 value)
+{
+  hashValue(identity, type, uint64(int64(value)));
+}
+
+void
+DigestBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint32 value)
+{
+  hashValue(identity, type, value);
+}
+
+void
+DigestBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int16 value)
+{
+  hashValue(identity, type, uint64(int64(value)));
+}
+
+void
+DigestBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint16 value)
+{
+  hashValue(identity, type, value);
+}
+
+void
+DigestBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int8 value)
+{
+  hashValue(identity, type, uint64(int64(value)));
+}
+
+void
+DigestBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uchar value)
+{
+  hashValue(identity, type, value);
+}
+
+void
+DigestBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const Decimal& value)
+{
+  hashValue(identity, type, uint64(value.getMantissa()));
+  hash_ = DecodeDigest::mix(hash_, uint64(int64(value.getExponent())));
+}
+
+void
+DigestBuilder::addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length)
+{
+  hashField(identity, type);
+  hash_ = hashBytes(hash_, value, length);
+}
+
+Messages::ValueMessageBuilder &
+DigestBuilder::startMessage(
+  const std::string & applicationType,
+  const std::string & applicationTypeNamespace,
+  size_t /*size*/)
+{
+  applicationType_ = &applicationType;
+  applicationTypeNamespace_ = &applicationTypeNamespace;
+  valueCount_ = 0;
+  hash_ = hashBytes(0, reinterpret_cast<const uchar *>(applicationType.data()), applicationType.size());
+  return *this;
+}
+
+bool
+DigestBuilder::endMessage(Messages::ValueMessageBuilder & /*messageBuilder*/)
+{
+  messageDigest_ = DecodeDigest::mix(hash_, valueCount_);
+  digest_.addMessage(messageDigest_);
+  applicationType_ = &noType;
+  applicationTypeNamespace_ = &noType;
+  return true;
+}
+
+bool
+DigestBuilder::ignoreMessage(Messages::ValueMessageBuilder & /*messageBuilder*/)
+{
+  applicationType_ = &noType;
+  applicationTypeNamespace_ = &noType;
+  return true;
+}
+
+Messages::ValueMessageBuilder &
+DigestBuilder::startSequence(
+  Messages::FieldIdentityCPtr & identity,
+  const std::string & /*applicationType*/,
+  const std::string & /*applicationTypeNamespace*/,
+  size_t /*fieldCount*/,
+  Messages::FieldIdentityCPtr & /*lengthIdentity*/,
+  size_t length)
+{
+  hashValue(identity, ValueType::SEQUENCE, length);
+  return *this;
+}
+
+void
+DigestBuilder::endSequence(
+  Messages::FieldIdentityCPtr & /*identity*/,
+  Messages::ValueMessageBuilder & /*sequenceBuilder*/)
+{
+}
+
+Messages::ValueMessageBuilder &
+DigestBuilder::startSequenceEntry(
+  const std::string & /*applicationType*/,
+  const std::string & /*applicationTypeNamespace*/,
+  size_t /*size*/)
+{
+  hash_ = DecodeDigest::mix(hash_, entryMarker);
+  return *this;
+}
+
+void
+DigestBuilder::endSequenceEntry(Messages::ValueMessageBuilder & /*entry*/)
+{
+}
+
+Messages::ValueMessageBuilder &
+DigestBuilder::startGroup(
+  Messages::FieldIdentityCPtr & identity,
+  const std::string & /*applicationType*/,
+  const std::string & /*applicationTypeNamespace*/,
+  size_t /*size*/)
+{
+  hashValue(identity, ValueType::GROUP, groupMarker);
+  return *this;
+}
+
+void
+DigestBuilder::endGroup(
+  Messages::FieldIdentityCPtr & /*identity*/,
+  Messages::ValueMessageBuilder & /*groupBuilder*/)
+{
+}
+
+bool
+DigestBuilder::wantLog(unsigned short /*level*/)
+{
+  return false;
+}
+
+bool
+DigestBuilder::logMessage(unsigned short /*level*/, const std::string & /*logMessage*/)
+{
+  return true;
+}
+
+bool
+DigestBuilder::reportDecodingError(const std::string & /*errorMessage*/)
+{
+  ++errorCount_;
+  return true;
+}
+
+bool
+DigestBuilder::reportCommunicationError(const std::string & /*errorMessage*/)
+{
+  return false;
+}
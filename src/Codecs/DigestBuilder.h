@@ -0,0 +1,136 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef DIGESTBUILDER_H
+#define DIGESTBUILDER_H
+#include "DecodeDigest_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Codecs/DecodeDigest.h>
+#include <Messages/ValueMessageBuilder.h>
+#include <Messages/FieldIdentity.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief Hash decoded messages into a DecodeDigest rather than building them.
+    ///
+    /// Each value is combined into the message digest with its type and the name of
+    /// its field, so a value that moves to a different field changes the digest even
+    /// when optional fields are absent.  Sequence lengths and the start of each sequence
+    /// entry and group are hashed too, and the number of values is added at the end of
+    /// the message, so the digest reflects the structure of the message as well as its
+    /// values.  Integers are hashed as 64 bit values; strings, byte vectors and field
+    /// names eight bytes at a time.
+    ///
+    /// Use it in place of an interpreting builder to check that a change to the
+    /// decoder produces the same messages as before: save the digest of a known good
+    /// run with DecodeDigest::write() and compare later runs with
+    /// DecodeDigest::findDifference().
+    ///
+    /// Decoding errors are counted and decoding continues.  Messages that are
+    /// ignored are not added to the digest.
+    class QuickFAST_Export DigestBuilder : public Messages::ValueMessageBuilder
+    {
+    public:
+      /// @brief Construct
+      /// @param digest receives the digest of every message.
+      explicit DigestBuilder(DecodeDigest & digest);
+      virtual ~DigestBuilder();
+
+      /// @brief The digest of the most recently completed message.
+      uint64 messageDigest()const
+      {
+        return messageDigest_;
+      }
+
+      /// @brief How many decoding errors have been reported.
+      size_t errorCount()const
+      {
+        return errorCount_;
+      }
+
+      //////////////////////////
+      // Implement ValueMessageBuilder
+      virtual const std::string & getApplicationType()const;
+      virtual const std::string & getApplicationTypeNs()const;
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int64 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint64 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int32 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint32 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int16 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint16 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int8 value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uchar value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const Decimal& value);
+      virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length);
+
+      virtual Messages::ValueMessageBuilder & startMessage(
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t size);
+      virtual bool endMessage(Messages::ValueMessageBuilder & messageBuilder);
+      virtual bool ignoreMessage(Messages::ValueMessageBuilder & messageBuilder);
+
+      virtual Messages::ValueMessageBuilder & startSequence(
+        Messages::FieldIdentityCPtr & identity,
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t fieldCount,
+        Messages::FieldIdentityCPtr & lengthIdentity,
+        size_t length);
+      virtual void endSequence(
+        Messages::FieldIdentityCPtr & identity,
+        Messages::ValueMessageBuilder & sequenceBuilder);
+      virtual Messages::ValueMessageBuilder & startSequenceEntry(
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t size);
+      virtual void endSequenceEntry(Messages::ValueMessageBuilder & entry);
+      virtual Messages::ValueMessageBuilder & startGroup(
+        Messages::FieldIdentityCPtr & identity,
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t size);
+      virtual void endGroup(
+        Messages::FieldIdentityCPtr & identity,
+        Messages::ValueMessageBuilder & groupBuilder);
+
+      ///////////////////
+      // Implement Logger
+      virtual bool wantLog(unsigned short level);
+      virtual bool logMessage(unsigned short level, const std::string & logMessage);
+      virtual bool reportDecodingError(const std::string & errorMessage);
+      virtual bool reportCommunicationError(const std::string & errorMessage);
+
+    private:
+      void hashField(const Messages::FieldIdentityCPtr & identity, ValueType::Type type)
+      {
+        const std::string & name = identity->name();
+        hash_ = hashBytes(hash_, reinterpret_cast<const uchar *>(name.data()), name.size());
+        hash_ = DecodeDigest::mix(hash_, uint64(type));
+        ++valueCount_;
+      }
+
+      void hashValue(const Messages::FieldIdentityCPtr & identity, ValueType::Type type, uint64 value)
+      {
+        hashField(identity, type);
+        hash_ = DecodeDigest::mix(hash_, value);
+      }
+
+      static uint64 hashBytes(uint64 hash, const uchar * value, size_t length);
+
+    private:
+      DecodeDigest & digest_;
+      uint64 hash_;
+      size_t valueCount_;
+      uint64 messageDigest_;
+      size_t errorCount_;
+      // The decoder's strings; valid while a message is being decoded.
+      const std::string * applicationType_;
+      const std::string * applicationTypeNamespace_;
+    };
+  }
+}
+#endif // DIGESTBUILDER_H
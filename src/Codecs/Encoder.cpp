@@ -9,15 +9,99 @@
 #include <Codecs/PresenceMap.h>
 #include <Codecs/TemplateRegistry.h>
 #include <Codecs/FieldInstruction.h>
+#include <Codecs/ResetIndex.h>
 
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Codecs;
 
 Encoder::Encoder(Codecs::TemplateRegistryPtr registry)
 : Context(registry)
+, autoResetMessages_(0)
+, autoResetBytes_(0)
+, autoResetMilliseconds_(0)
+, alignResets_(false)
+, atPacketStart_(false)
+, packetsSignaled_(false)
+, resetIndex_(0)
+, messagesSinceReset_(0)
+, bytesSinceReset_(0)
+, messagesEncoded_(0)
+, bytesEncoded_(0)
+, resetCount_(0)
+, resetMessages_(0)
+, resetBytes_(0)
 {
 }
 
+void
+Encoder::setAutoReset(size_t messages, size_t bytes, size_t milliseconds)
+{
+  autoResetMessages_ = messages;
+  autoResetBytes_ = bytes;
+  autoResetMilliseconds_ = milliseconds;
+  if(milliseconds != 0)
+  {
+    lastReset_ = boost::posix_time::microsec_clock::universal_time();
+  }
+}
+
+void
+Encoder::encodeReset(DataDestination & destination)
+{
+  size_t offset = bytesEncoded_;
+  DataDestination::BufferHandle buffer = destination.startBuffer();
+  Codecs::PresenceMap pmap(1);
+  pmap.setNextField(true);
+  pmap.encode(destination);
+  FieldInstruction::encodeUnsignedInteger(destination, getWorkingBuffer(), SCPResetTemplateId);
+  size_t bytes = destination.byteCount(buffer);
+  reset(true);
+  ++resetMessages_;
+  resetBytes_ += bytes;
+  bytesEncoded_ += bytes;
+  noteReset(offset, true);
+}
+
+bool
+Encoder::resetIsDue() const
+{
+  if(alignResets_ && packetsSignaled_ && !atPacketStart_)
+  {
+    return false;
+  }
+  if(autoResetMessages_ != 0 && messagesSinceReset_ >= autoResetMessages_)
+  {
+    return true;
+  }
+  if(autoResetBytes_ != 0 && bytesSinceReset_ >= autoResetBytes_)
+  {
+    return true;
+  }
+  if(autoResetMilliseconds_ != 0 && messagesSinceReset_ != 0)
+  {
+    boost::posix_time::time_duration elapsed =
+      boost::posix_time::microsec_clock::universal_time() - lastReset_;
+    return size_t(elapsed.total_milliseconds()) >= autoResetMilliseconds_;
+  }
+  return false;
+}
+
+void
+Encoder::noteReset(size_t offset, bool inserted)
+{
+  ++resetCount_;
+  messagesSinceReset_ = 0;
+  bytesSinceReset_ = 0;
+  if(autoResetMilliseconds_ != 0)
+  {
+    lastReset_ = boost::posix_time::microsec_clock::universal_time();
+  }
+  if(resetIndex_ != 0)
+  {
+    resetIndex_->record(messagesEncoded_, offset, inserted);
+  }
+}
+
 void
 Encoder::encodeMessages(
   DataDestination & destination,
@@ -50,35 +134,10 @@ Encoder::encodeSegment(
   Codecs::TemplateCPtr templatePtr;
   if(getTemplateRegistry()->getTemplate(templateId, templatePtr))
   {
-    if(templatePtr->getReset())
-    {
-      reset(true);
-    }
-
     Codecs::PresenceMap pmap(templatePtr->presenceMapBitCount());
-
-    DataDestination::BufferHandle header = destination.startBuffer();
-    destination.startBuffer();
-    // can we "copy" the template ID?
-    if(templateId == templateId_)
-    {
-      pmap.setNextField(false);
-    }
-    else
-    {
-      pmap.setNextField(true);
-      FieldInstruction::encodeUnsignedInteger(destination, getWorkingBuffer(), templateId);
-      templateId_ = templateId;
-    }
-
+    DataDestination::BufferHandle header = encodeSegmentHeader(destination, templateId, templatePtr, pmap);
     encodeSegmentBody(destination, pmap, templatePtr, accessor);
-    DataDestination::BufferHandle savedBuffer = destination.getBuffer();
-    destination.selectBuffer(header);
-    static Messages::FieldIdentity pmapIdentity("PMAP", "Message");
-    destination.startField(pmapIdentity);
-    pmap.encode(destination);
-    destination.endField(pmapIdentity);
-    destination.selectBuffer(savedBuffer);
+    encodeSegmentTrailer(destination, header, pmap);
   }
   else
   {
@@ -86,6 +145,61 @@ Encoder::encodeSegment(
   }
 }
 
+DataDestination::BufferHandle
+Encoder::encodeSegmentHeader(
+  DataDestination & destination,
+  template_id_t templateId,
+  const TemplateCPtr & templatePtr,
+  Codecs::PresenceMap & pmap)
+{
+  if(templatePtr->getReset())
+  {
+    reset(true);
+    noteReset(bytesEncoded_, false);
+  }
+  else if(resetIsDue())
+  {
+    encodeReset(destination);
+  }
+  atPacketStart_ = false;
+
+  DataDestination::BufferHandle header = destination.startBuffer();
+  destination.startBuffer();
+  // can we "copy" the template ID?
+  if(templateId == templateId_)
+  {
+    pmap.setNextField(false);
+  }
+  else
+  {
+    pmap.setNextField(true);
+    FieldInstruction::encodeUnsignedInteger(destination, getWorkingBuffer(), templateId);
+    templateId_ = templateId;
+  }
+  return header;
+}
+
+void
+Encoder::encodeSegmentTrailer(
+  DataDestination & destination,
+  DataDestination::BufferHandle header,
+  Codecs::PresenceMap & pmap)
+{
+  DataDestination::BufferHandle savedBuffer = destination.getBuffer();
+  destination.selectBuffer(header);
+  static Messages::FieldIdentity pmapIdentity("PMAP", "Message");
+  destination.startField(pmapIdentity);
+  pmap.encode(destination);
+  destination.endField(pmapIdentity);
+  destination.selectBuffer(savedBuffer);
+
+  size_t bytes = destination.byteCount(header);
+  ++messagesEncoded_;
+  ++messagesSinceReset_;
+  bytesEncoded_ += bytes;
+  bytesSinceReset_ += bytes;
+}
+
 void
 Encoder::encodeGroup(
   DataDestination & destination,
@@ -9,11 +9,14 @@
 #include "Encoder_fwd.h"
 #include <Common/QuickFAST_Export.h>
 #include <Codecs/Context.h>
-#include <Codecs/DataDestination_fwd.h>
+#include <Codecs/DataDestination.h>
 #include <Codecs/PresenceMap_fwd.h>
 #include <Codecs/Template.h>
 #include <Codecs/SegmentBody_fwd.h>
+#include <Codecs/ResetIndex_fwd.h>
+#include <Codecs/PushEncoder_fwd.h>
 #include <Messages/MessageAccessor.h>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 
 #include <Common/Exceptions.h>
 
@@ -24,6 +27,10 @@ namespace QuickFAST{
     /// Create an instance of the Encoder providing a registry of the templates
     /// to be used to encode the message, then call encodeMessage to encode
     /// each message from a DataDestination.
+    ///
+    /// Receivers can only start decoding, or recover from lost data, where the
+    /// dictionaries are reset.  Use setAutoReset() to have the Encoder insert
+    /// resets periodically and setResetIndex() to record where they occur.
     class QuickFAST_Export Encoder : public Context
     {
     public:
@@ -31,6 +38,86 @@ namespace QuickFAST{
       /// @param registry A registry containing all templates to be used to encode messages.
       Encoder(Codecs::TemplateRegistryPtr registry);
 
+      /// @brief Insert dictionary resets automatically.
+      ///
+      /// A reset is due when any of the limits has been reached since the last reset.
+      /// If the template of the next message resets the dictionaries (reset="Y") nothing
+      /// is added; otherwise an SCP reset message (template ID 120 with no fields) is
+      /// written ahead of the message.  Decoders reset their dictionaries when they see it.
+      /// If the registry defines template 120 it should have no fields.
+      ///
+      /// Zero disables a limit.  All limits are zero by default.
+      /// @param messages is the number of messages between resets.
+      /// @param bytes is the number of encoded bytes between resets.
+      /// @param milliseconds is the time between resets.
+      void setAutoReset(size_t messages, size_t bytes = 0, size_t milliseconds = 0);
+
+      /// @brief Insert automatic resets only at the start of a packet.
+      ///
+      /// When enabled, a reset that is due waits for the first message encoded after
+      /// startPacket() so a receiver joining late can start with any packet that
+      /// begins with a reset.
+      /// Alignment takes effect with the first call to startPacket().  Until then
+      /// nothing marks the packet boundaries, so resets are inserted as if alignment
+      /// were off rather than waiting forever.
+      /// @param align enables alignment.
+      void setAlignResets(bool align)
+      {
+        alignResets_ = align;
+      }
+
+      /// @brief Notification that the next message will begin a new packet.
+      ///
+      /// Only needed when setAlignResets(true) is in effect.
+      void startPacket()
+      {
+        atPacketStart_ = true;
+        packetsSignaled_ = true;
+      }
+
+      /// @brief Record every reset in an index.
+      /// @param index will receive the reset points.  Zero stops recording.
+      ///        The index must outlive the Encoder or be replaced before it is destroyed.
+      void setResetIndex(ResetIndex * index)
+      {
+        resetIndex_ = index;
+      }
+
+      /// @brief Write an SCP reset message and reset the dictionaries.
+      /// @param destination receives the reset message.
+      void encodeReset(DataDestination & destination);
+
+      /// @brief Statistic: how many messages have been encoded.
+      size_t messagesEncoded()const
+      {
+        return messagesEncoded_;
+      }
+
+      /// @brief Statistic: how many bytes have been encoded, including reset messages.
+      size_t bytesEncoded()const
+      {
+        return bytesEncoded_;
+      }
+
+      /// @brief Statistic: how many times the dictionaries have been reset by encodeReset()
+      /// or by a template with reset="Y"
+      size_t resetCount()const
+      {
+        return resetCount_;
+      }
+
+      /// @brief Statistic: how many SCP reset messages have been written.
+      size_t resetMessages()const
+      {
+        return resetMessages_;
+      }
+
+      /// @brief Statistic: how many bytes were used by SCP reset messages.
+      size_t resetBytes()const
+      {
+        return resetBytes_;
+      }
+
       /// @brief Encode messages until the accessor is satisfied.
       ///
       /// MessageAccessor::pickTemplate() will be called to select a template.
@@ -52,6 +139,20 @@ namespace QuickFAST{
         template_id_t templateId,
         const Messages::MessageAccessor & accessor);
 
+      /// @brief Encode the next message using a compile-time template description.
+      ///
+      /// If the description is bound to this encoder's template for Description::id
+      /// the fields are encoded by code generated for the description.  Otherwise
+      /// the message is encoded as usual.  Defined in StaticTemplate.h.
+      /// @param[out] destination where to write the encoded messages.
+      /// @param[in] description is a bound StaticTemplate.
+      /// @param[in] accessor to the fields to be encoded.
+      template<typename Description>
+      void encodeStaticMessage(
+        DataDestination & destination,
+        const Description & description,
+        const Messages::MessageAccessor & accessor);
+
       /// @brief Encode a group field.
       ///
       /// @param[in] destination to which FAST data goes.
@@ -86,6 +187,54 @@ namespace QuickFAST{
         const Codecs::SegmentBodyCPtr & segment,
         const Messages::MessageAccessor & accessor);
     private:
+      /// PushEncoder writes messages through encodeSegmentHeader() and encodeSegmentTrailer()
+      friend class PushEncoder;
+
+      /// @brief Start encoding a message: handle reset and the template ID.
+      /// @param[in] destination receives the FAST encoded data.
+      /// @param[in] templateId identifies the template
+      /// @param[in] templatePtr is the template
+      /// @param[in] pmap is the message's presence map.
+      /// @returns the DataDestination::BufferHandle for the presence map.
+      DataDestination::BufferHandle encodeSegmentHeader(
+        DataDestination & destination,
+        template_id_t templateId,
+        const TemplateCPtr & templatePtr,
+        Codecs::PresenceMap & pmap);
+
+      /// @brief Finish encoding a message by writing the presence map.
+      /// @param[in] destination receives the FAST encoded data.
+      /// @param[in] header was returned by encodeSegmentHeader()
+      /// @param[in] pmap is the message's presence map.
+      void encodeSegmentTrailer(
+        DataDestination & destination,
+        DataDestination::BufferHandle header,
+        Codecs::PresenceMap & pmap);
+
+      /// @brief Is an automatic reset due before the next message?
+      bool resetIsDue()const;
+
+      /// @brief Start counting toward the next automatic reset.
+      /// @param offset is the position of the reset in the encoded stream.
+      /// @param inserted is true if an SCP reset message was written.
+      void noteReset(size_t offset, bool inserted);
+
+    private:
+      size_t autoResetMessages_;
+      size_t autoResetBytes_;
+      size_t autoResetMilliseconds_;
+      bool alignResets_;
+      bool atPacketStart_;
+      bool packetsSignaled_;
+      ResetIndex * resetIndex_;
+      size_t messagesSinceReset_;
+      size_t bytesSinceReset_;
+      boost::posix_time::ptime lastReset_;
+      size_t messagesEncoded_;
+      size_t bytesEncoded_;
+      size_t resetCount_;
+      size_t resetMessages_;
+      size_t resetBytes_;
     };
   }
 }
@@ -8,6 +8,8 @@
 #include <Codecs/FieldOpNop.h>
 #include <Codecs/Decoder.h>
 #include <Codecs/Encoder.h>
+#include <Codecs/SegmentBody.h>
+#include <Common/MemoryFootprint.h>
 
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Codecs;
@@ -54,6 +56,15 @@ FieldInstruction::isPossiblyRecursive() const
   return false;
 }
 
+void
+FieldInstruction::qualifyIdentity(const std::string & prefix)
+{
+  identity_ = new Messages::FieldIdentity(
+    prefix + '.' + identity_->getLocalName(),
+    identity_->getNamespace(),
+    identity_->id());
+}
+
 void
 FieldInstruction::setPresence(bool mandatory)
 {
@@ -325,8 +336,8 @@ FieldInstruction::indexDictionaries(
     dictionaryName,
    typeName,
     typeNamespace,
-    identity_->getLocalName(),
-    identity_->getNamespace());
+    mutableIdentity_->getLocalName(),
+    mutableIdentity_->getNamespace());
 }
 
 void
@@ -810,6 +821,32 @@ FieldInstruction::getSegmentBody(SegmentBodyPtr & /*segment*/) const
   return false;
 }
 
+void
+FieldInstruction::footprint(MemoryFootprint & footprint) const
+{
+  footprint.add("registry.instructions", sizeof(FieldInstruction));
+  footprint.addString("registry.strings", applicationType_);
+  footprint.addString("registry.strings", applicationTypeNamespace_);
+  footprint.addString("registry.strings", qualifiedApplicationType_);
+  if(identity_)
+  {
+    footprint.add("registry.identities", sizeof(Messages::FieldIdentity));
+    footprint.addString("registry.identities", identity_->name());
+    footprint.addString("registry.identities", identity_->getLocalName());
+    footprint.addString("registry.identities", identity_->getNamespace());
+    footprint.addString("registry.identities", identity_->id());
+  }
+  if(fieldOp_)
+  {
+    fieldOp_->footprint(footprint);
+  }
+  SegmentBodyPtr segment;
+  if(getSegmentBody(segment) && segment)
+  {
+    segment->footprint(footprint);
+  }
+}
+
 void
 FieldInstruction::display(std::ostream & output, size_t indent) const
 {
@@ -90,6 +90,14 @@ namespace QuickFAST{
         mutableIdentity_->setNamespace(fieldNamespace);
       }
 
+      /// @brief Qualify the name of this field with the name of an enclosing element.
+      ///
+      /// Used when a group is flattened into its parent.  Only the identity that appears
+      /// in messages changes; dictionary keys still come from the name in the template.
+      /// Call during finalize, after the name has been set.
+      /// @param prefix is added to the front of the localname followed by a '.'
+      void qualifyIdentity(const std::string & prefix);
+
       /// @brief Indicate that the field is mandatory in the application record.
       /// Default if not specified is true.
       /// @param mandatory true for presence="mandatory"; false for presence="optional"
@@ -609,6 +617,14 @@ namespace QuickFAST{
         return presenceMapBitsUsed_;
       }
 
+      /// @brief Add the bytes held by this instruction to a footprint.
+      ///
+      /// Includes the field identity, the field operator and, for groups and
+      /// sequences, the nested segment.  The instruction itself is counted as a
+      /// FieldInstruction; members added by the derived classes are not counted.
+      /// @param footprint accumulates the result.
+      void footprint(MemoryFootprint & footprint) const;
+
       /// @brief Write the fieldInstruction in human readable form.
       ///
       /// @param output is the stream to which the display will be written
@@ -58,51 +58,21 @@ FieldInstructionAscii::decodeAsciiFromSource(
 void
 FieldInstructionAscii::decodeNop(
   Codecs::DataSource & source,
-  Codecs::PresenceMap & /*pmap*/,
+  Codecs::PresenceMap & pmap,
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & builder) const
 {
-  PROFILE_POINT("ascii::decodeNop");
-  // note NOP never uses pmap.  It uses a null value instead for optional fields
-  // so it's always safe to do the basic decode.
-  WorkingBuffer & buffer = decoder.getWorkingBuffer();
-  if(decodeAsciiFromSource(source, isMandatory(), buffer))
-  {
-    builder.addValue(identity_, ValueType::ASCII, buffer.begin(), buffer.size());
-  }
+  decodeNopImpl(source, pmap, decoder, builder);
 }
 
 void
 FieldInstructionAscii::decodeConstant(
-  Codecs::DataSource & /*source*/,
+  Codecs::DataSource & source,
   Codecs::PresenceMap & pmap,
-  Codecs::Decoder & /*decoder*/,
+  Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & builder) const
 {
-  PROFILE_POINT("ascii::decodeConstant");
-  if(isMandatory())
-  {
-    builder.addValue(
-      identity_,
-      ValueType::ASCII,
-      reinterpret_cast<const uchar *>(fieldOp_->getValue().c_str()),
-      fieldOp_->getValue().size());
-  }
-  else
-  {
-    if(pmap.checkNextField())
-    {
-      builder.addValue(
-        identity_,
-        ValueType::ASCII,
-        reinterpret_cast<const uchar *>(fieldOp_->getValue().c_str()),
-        fieldOp_->getValue().size());
-    }
-    else
-    {
-      // not present. Nothing to do
-    }
-  }
+  decodeConstantImpl(source, pmap, decoder, builder);
 }
 
 void
@@ -112,35 +82,7 @@ FieldInstructionAscii::decodeDefault(
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & builder) const
 {
-  PROFILE_POINT("ascii::decodeDefault");
-  if(pmap.checkNextField())
-  {
-    WorkingBuffer & buffer = decoder.getWorkingBuffer();
-    if(decodeAsciiFromSource(source, isMandatory(), buffer))
-    {
-      builder.addValue(
-        identity_,
-        ValueType::ASCII,
-        buffer.begin(),
-        buffer.size());
-    }
-  }
-  else // pmap says nothing in stream
-  {
-    if(fieldOp_->hasValue())
-    {
-      builder.addValue(
-        identity_,
-        ValueType::ASCII,
-        reinterpret_cast<const uchar *>(fieldOp_->getValue().c_str()),
-        fieldOp_->getValue().size()
-        );
-    }
-    else if(isMandatory())
-    {
-      decoder.reportFatal("[ERR D5]", "Mandatory default operator with no value.", *identity_);
-    }
-  }
+  decodeDefaultImpl(source, pmap, decoder, builder);
 }
 
 void
@@ -150,132 +92,17 @@ FieldInstructionAscii::decodeCopy(
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & builder) const
 {
-  PROFILE_POINT("ascii::decodeCopy");
-  if(pmap.checkNextField())
-  {
-    // field is in the stream, use it
-    WorkingBuffer & buffer = decoder.getWorkingBuffer();
-    if(decodeAsciiFromSource(source, isMandatory(), buffer))
-    {
-      builder.addValue(
-        identity_,
-        ValueType::ASCII,
-        buffer.begin(),
-        buffer.size()
-        );
-      fieldOp_->setDictionaryValue(decoder, buffer.begin(), buffer.size());
-    }
-    else
-    {
-      fieldOp_->setDictionaryValueNull(decoder);
-    }
-  }
-  else // pmap says not in stream
-  {
-    const uchar * value = 0;
-    size_t valueSize = 0;
-    Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, value, valueSize);
-    if(previousStatus == Context::OK_VALUE)
-    {
-      builder.addValue(identity_, ValueType::ASCII, value, valueSize);
-    }
-    else if(previousStatus == Context::UNDEFINED_VALUE && fieldOp_->hasValue())
-    {
-      builder.addValue(
-        identity_,
-        ValueType::ASCII,
-        reinterpret_cast<const uchar *>(fieldOp_->getValue().c_str()),
-        fieldOp_->getValue().size());
-      fieldOp_->setDictionaryValue(decoder, fieldOp_->getValue());
-    }
-    else
-    {
-      if(isMandatory())
-      {
-        decoder.reportFatal("[ERR D6]", "No value available for mandatory copy field.", *identity_);
-      }
-    }
-  }
+  decodeCopyImpl(source, pmap, decoder, builder);
 }
 
 void
 FieldInstructionAscii::decodeDelta(
   Codecs::DataSource & source,
-  Codecs::PresenceMap & /*pmap*/,
+  Codecs::PresenceMap & pmap,
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & builder) const
 {
-  PROFILE_POINT("ascii::decodeDelta");
-  int32 deltaLength;
-  decodeSignedInteger(source, decoder, deltaLength, identity_->name());
-  if(!isMandatory())
-  {
-    if(checkNullInteger(deltaLength))
-    {
-      // NULL delta does not clear previous
-      // so there's nothing to do
-      return;
-    }
-  }
-  std::string deltaValue;
-  WorkingBuffer & buffer = decoder.getWorkingBuffer();
-  if(decodeAsciiFromSource(source, true, buffer))
-  {
-    deltaValue = std::string(
-      reinterpret_cast<const char *>(buffer.begin()),
-      buffer.size());
-  }
-
-
-  std::string previousValue;
-  Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
-  if(previousStatus == Context::UNDEFINED_VALUE)
-  {
-    if(fieldOp_->hasValue())
-    {
-      previousValue = fieldOp_->getValue();
-    }
-  }
-
-  size_t previousLength = previousValue.length();
-  if( deltaLength < 0)
-  {
-    // operate on front of string
-    // compensete for the excess -1 encoding that allows -0 != +0
-    deltaLength = -(deltaLength + 1);
-    // don't chop more than is there
-    if(static_cast<unsigned long>(deltaLength) > previousLength)
-    {
-      decoder.reportError("[ERR D7]", "ASCII tail delta front length exceeds length of previous string.", *identity_);
-      deltaLength = QuickFAST::int32(previousLength);
-    }
-    std::string value = deltaValue + previousValue.substr(deltaLength);
-    builder.addValue(
-      identity_,
-      ValueType::ASCII,
-      reinterpret_cast<const uchar *>(value.c_str()),
-      value.size());
-    fieldOp_->setDictionaryValue(decoder, value);
-  }
-  else
-  { // operate on end of string
-    // don't chop more than is there
-    if(static_cast<unsigned long>(deltaLength) > previousLength)
-    {
-#if 0 // handy when debugging
-      std::cout << "decode ascii delta length: " << deltaLength << " previous: " << previousLength << std::endl;
-#endif
-      decoder.reportError("[ERR D7]", "ASCII tail delta back length exceeds length of previous string.", *identity_);
-      deltaLength = QuickFAST::uint32(previousLength);
-    }
-    std::string value = previousValue.substr(0, previousLength - deltaLength) + deltaValue;
-    builder.addValue(
-      identity_,
-      ValueType::ASCII,
-      reinterpret_cast<const uchar *>(value.c_str()),
-      value.size());
-    fieldOp_->setDictionaryValue(decoder, value);
-  }
+  decodeDeltaImpl(source, pmap, decoder, builder);
 }
 
 void
@@ -285,72 +112,7 @@ FieldInstructionAscii::decodeTail(
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & builder) const
 {
-  PROFILE_POINT("ascii::decodeTail");
-  if(pmap.checkNextField())
-  {
-    // field is in the stream, use it
-    WorkingBuffer & buffer = decoder.getWorkingBuffer();
-    if(decodeAsciiFromSource(source, isMandatory(), buffer))
-    {
-      const std::string tailValue(reinterpret_cast<const char *>(buffer.begin()), buffer.size());
-      size_t tailLength = tailValue.length();
-      std::string previousValue;
-      Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
-      if(previousStatus == Context::UNDEFINED_VALUE)
-      {
-        if(fieldOp_->hasValue())
-        {
-          previousValue = fieldOp_->getValue();
-          fieldOp_->setDictionaryValue(decoder, previousValue);
-        }
-      }
-      size_t previousLength = previousValue.length();
-      if(tailLength > previousLength)
-      {
-        tailLength = previousLength;
-      }
-      std::string value(previousValue.substr(0, previousLength - tailLength) + tailValue);
-      builder.addValue(
-        identity_,
-        ValueType::ASCII,
-        reinterpret_cast<const uchar *>(value.c_str()),
-        value.size());
-      fieldOp_->setDictionaryValue(decoder, value);
-    }
-    else // null
-    {
-      fieldOp_->setDictionaryValueNull(decoder);
-    }
-  }
-  else // pmap says not in stream
-  {
-    std::string previousValue;
-    Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
-    if(previousStatus == Context::OK_VALUE)
-    {
-      Messages::FieldCPtr field = Messages::FieldAscii::create(previousValue);
-      builder.addValue(identity_,
-        ValueType::ASCII,
-        reinterpret_cast<const uchar *>(previousValue.c_str()),
-        previousValue.size());
-    }
-    else if(fieldOp_->hasValue())
-    {
-      builder.addValue(
-        identity_,
-        ValueType::ASCII,
-        reinterpret_cast<const uchar *>(fieldOp_->getValue().c_str()),
-        fieldOp_->getValue().size());
-      fieldOp_->setDictionaryValue(decoder, fieldOp_->getValue());
-    }
-    else
-    {
-      if(isMandatory())
-      {
-        decoder.reportFatal("[ERR D6]", "No value available for mandatory copy field.", *identity_);
-      }
-    }
-  }
+  decodeTailImpl(source, pmap, decoder, builder);
 }
 
 void
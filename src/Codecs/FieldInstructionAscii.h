@@ -7,6 +7,8 @@
 #ifndef FIELDINSTRUCTIONASCII_H
 #define FIELDINSTRUCTIONASCII_H
 #include <Codecs/FieldInstruction.h>
+#include <Codecs/Decoder.h>
+#include <Messages/ValueMessageBuilder.h>
 namespace QuickFAST{
   namespace Codecs{
     /// @brief Implement &lt;string charset="ascii"> field instruction.
@@ -63,6 +65,56 @@ namespace QuickFAST{
         Codecs::Decoder & decoder,
         Messages::ValueMessageBuilder & builder) const;
 
+      /// @brief Decode the field, passing the value directly to a builder of a known type.
+      ///
+      /// Equivalent to decode() but the field operator is selected by a switch rather
+      /// than by virtual calls, and the builder is called through its static type.
+      /// Used by Decoder::decodeMessage<Builder>().
+      /// @param[in] source for the FAST data
+      /// @param[in] pmap indicating field presence
+      /// @param[in] decoder driving this process
+      /// @param[out] builder receives the value.
+      template<typename BUILDER>
+      void decodeStatic(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const
+      {
+        size_t pmapBit = 0;
+        switch(fieldOp_->opType())
+        {
+        case FieldOp::NOP:
+          decodeNopImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::CONSTANT:
+          decodeConstantImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::DEFAULT:
+          decodeDefaultImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::COPY:
+          if(!fieldOp_->getPMapBit(pmapBit))
+          {
+            decodeCopyImpl(source, pmap, decoder, builder);
+            break;
+          }
+          // a specific presence map bit is not valid for ascii strings.  Let the usual path report it.
+          fieldOp_->decode(*this, source, pmap, decoder, builder.valueMessageBuilder());
+          break;
+        case FieldOp::DELTA:
+          decodeDeltaImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::TAIL:
+          decodeTailImpl(source, pmap, decoder, builder);
+          break;
+        default:
+          // not valid for ascii strings.  Let the usual path report it.
+          fieldOp_->decode(*this, source, pmap, decoder, builder.valueMessageBuilder());
+          break;
+        }
+      }
+
       virtual void encodeNop(
         Codecs::DataDestination & destination,
         Codecs::PresenceMap & pmap,
@@ -101,6 +153,49 @@ namespace QuickFAST{
 
       virtual ValueType::Type fieldInstructionType() const;
 
+    private:
+      template<typename BUILDER>
+      void decodeNopImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeConstantImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeDefaultImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeCopyImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeDeltaImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeTailImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
     private:
       /// @brief helper decoder.
       /// @param source where the data comes from
@@ -115,6 +210,18 @@ namespace QuickFAST{
         bool mandatory,
         WorkingBuffer & buffer) const;
 
+      /// @brief Pass a decoded value to the builder, interning it if the decoder says so.
+      /// @param decoder holds the intern table.
+      /// @param builder receives the value.
+      /// @param value points to the value.
+      /// @param length is the number of bytes in the value.
+      template<typename BUILDER>
+      void addDecodedValue(
+        Codecs::Decoder & decoder,
+        BUILDER & builder,
+        const uchar * value,
+        size_t length) const;
+
       void interpretValue(const std::string & value);
 
 
@@ -122,6 +229,296 @@ namespace QuickFAST{
       Messages::FieldCPtr initialValue_;
 
     };
+
+    template<typename BUILDER>
+    void
+    FieldInstructionAscii::addDecodedValue(
+      Codecs::Decoder & decoder,
+      BUILDER & builder,
+      const uchar * value,
+      size_t length) const
+    {
+      uint32 id;
+      if(decoder.isInterning() && decoder.intern(*this, value, length, id))
+      {
+        builder.addInternedValue(identity_, ValueType::ASCII, value, length, id);
+      }
+      else
+      {
+        builder.addValue(identity_, ValueType::ASCII, value, length);
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionAscii::decodeNopImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & /*pmap*/,
+      Codecs::Decoder & decoder,
+      BUILDER & builder) const
+    {
+      PROFILE_POINT("ascii::decodeNop");
+      // note NOP never uses pmap.  It uses a null value instead for optional fields
+      // so it's always safe to do the basic decode.
+      WorkingBuffer & buffer = decoder.getWorkingBuffer();
+      if(decodeAsciiFromSource(source, isMandatory(), buffer))
+      {
+        addDecodedValue(decoder, builder, buffer.begin(), buffer.size());
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionAscii::decodeConstantImpl(
+      Codecs::DataSource & /*source*/,
+      Codecs::PresenceMap & pmap,
+      Codecs::Decoder & decoder,
+      BUILDER & builder) const
+    {
+      PROFILE_POINT("ascii::decodeConstant");
+      if(isMandatory())
+      {
+        addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(fieldOp_->getValue().c_str()),
+          fieldOp_->getValue().size());
+      }
+      else
+      {
+        if(pmap.checkNextField())
+        {
+          addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(fieldOp_->getValue().c_str()),
+            fieldOp_->getValue().size());
+        }
+        else
+        {
+          // not present. Nothing to do
+        }
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionAscii::decodeDefaultImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & pmap,
+      Codecs::Decoder & decoder,
+      BUILDER & builder) const
+    {
+      PROFILE_POINT("ascii::decodeDefault");
+      if(pmap.checkNextField())
+      {
+        WorkingBuffer & buffer = decoder.getWorkingBuffer();
+        if(decodeAsciiFromSource(source, isMandatory(), buffer))
+        {
+          addDecodedValue(decoder, builder, buffer.begin(),
+            buffer.size());
+        }
+      }
+      else // pmap says nothing in stream
+      {
+        if(fieldOp_->hasValue())
+        {
+          addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(fieldOp_->getValue().c_str()),
+            fieldOp_->getValue().size()
+            );
+        }
+        else if(isMandatory())
+        {
+          decoder.reportFatal("[ERR D5]", "Mandatory default operator with no value.", *identity_);
+        }
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionAscii::decodeCopyImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & pmap,
+      Codecs::Decoder & decoder,
+      BUILDER & builder) const
+    {
+      PROFILE_POINT("ascii::decodeCopy");
+      if(pmap.checkNextField())
+      {
+        // field is in the stream, use it
+        WorkingBuffer & buffer = decoder.getWorkingBuffer();
+        if(decodeAsciiFromSource(source, isMandatory(), buffer))
+        {
+          addDecodedValue(decoder, builder, buffer.begin(),
+            buffer.size()
+            );
+          fieldOp_->setDictionaryValue(decoder, buffer.begin(), buffer.size());
+        }
+        else
+        {
+          fieldOp_->setDictionaryValueNull(decoder);
+        }
+      }
+      else // pmap says not in stream
+      {
+        const uchar * value = 0;
+        size_t valueSize = 0;
+        Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, value, valueSize);
+        if(previousStatus == Context::OK_VALUE)
+        {
+          addDecodedValue(decoder, builder, value, valueSize);
+        }
+        else if(previousStatus == Context::UNDEFINED_VALUE && fieldOp_->hasValue())
+        {
+          addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(fieldOp_->getValue().c_str()),
+            fieldOp_->getValue().size());
+          fieldOp_->setDictionaryValue(decoder, fieldOp_->getValue());
+        }
+        else
+        {
+          if(isMandatory())
+          {
+            decoder.reportFatal("[ERR D6]", "No value available for mandatory copy field.", *identity_);
+          }
+        }
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionAscii::decodeDeltaImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & /*pmap*/,
+      Codecs::Decoder & decoder,
+      BUILDER & builder) const
+    {
+      PROFILE_POINT("ascii::decodeDelta");
+      int32 deltaLength;
+      decodeSignedInteger(source, decoder, deltaLength, identity_->name());
+      if(!isMandatory())
+      {
+        if(checkNullInteger(deltaLength))
+        {
+          // NULL delta does not clear previous
+          // so there's nothing to do
+          return;
+        }
+      }
+      std::string deltaValue;
+      WorkingBuffer & buffer = decoder.getWorkingBuffer();
+      if(decodeAsciiFromSource(source, true, buffer))
+      {
+        deltaValue = std::string(
+          reinterpret_cast<const char *>(buffer.begin()),
+          buffer.size());
+      }
+
+
+      std::string previousValue;
+      Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
+      if(previousStatus == Context::UNDEFINED_VALUE)
+      {
+        if(fieldOp_->hasValue())
+        {
+          previousValue = fieldOp_->getValue();
+        }
+      }
+
+      size_t previousLength = previousValue.length();
+      if( deltaLength < 0)
+      {
+        // operate on front of string
+        // compensete for the excess -1 encoding that allows -0 != +0
+        deltaLength = -(deltaLength + 1);
+        // don't chop more than is there
+        if(static_cast<unsigned long>(deltaLength) > previousLength)
+        {
+          decoder.reportError("[ERR D7]", "ASCII tail delta front length exceeds length of previous string.", *identity_);
+          deltaLength = QuickFAST::int32(previousLength);
+        }
+        std::string value = deltaValue + previousValue.substr(deltaLength);
+        addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(value.c_str()),
+          value.size());
+        fieldOp_->setDictionaryValue(decoder, value);
+      }
+      else
+      { // operate on end of string
+        // don't chop more than is there
+        if(static_cast<unsigned long>(deltaLength) > previousLength)
+        {
+    #if 0 // handy when debugging
+          std::cout << "decode ascii delta length: " << deltaLength << " previous: " << previousLength << std::endl;
+    #endif
+          decoder.reportError("[ERR D7]", "ASCII tail delta back length exceeds length of previous string.", *identity_);
+          deltaLength = QuickFAST::uint32(previousLength);
+        }
+        std::string value = previousValue.substr(0, previousLength - deltaLength) + deltaValue;
+        addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(value.c_str()),
+          value.size());
+        fieldOp_->setDictionaryValue(decoder, value);
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionAscii::decodeTailImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & pmap,
+      Codecs::Decoder & decoder,
+      BUILDER & builder) const
+    {
+      PROFILE_POINT("ascii::decodeTail");
+      if(pmap.checkNextField())
+      {
+        // field is in the stream, use it
+        WorkingBuffer & buffer = decoder.getWorkingBuffer();
+        if(decodeAsciiFromSource(source, isMandatory(), buffer))
+        {
+          const std::string tailValue(reinterpret_cast<const char *>(buffer.begin()), buffer.size());
+          size_t tailLength = tailValue.length();
+          std::string previousValue;
+          Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
+          if(previousStatus == Context::UNDEFINED_VALUE)
+          {
+            if(fieldOp_->hasValue())
+            {
+              previousValue = fieldOp_->getValue();
+              fieldOp_->setDictionaryValue(decoder, previousValue);
+            }
+          }
+          size_t previousLength = previousValue.length();
+          if(tailLength > previousLength)
+          {
+            tailLength = previousLength;
+          }
+          std::string value(previousValue.substr(0, previousLength - tailLength) + tailValue);
+          addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(value.c_str()),
+            value.size());
+          fieldOp_->setDictionaryValue(decoder, value);
+        }
+        else // null
+        {
+          fieldOp_->setDictionaryValueNull(decoder);
+        }
+      }
+      else // pmap says not in stream
+      {
+        std::string previousValue;
+        Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
+        if(previousStatus == Context::OK_VALUE)
+        {
+          addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(previousValue.c_str()),
+            previousValue.size());
+        }
+        else if(fieldOp_->hasValue())
+        {
+          addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(fieldOp_->getValue().c_str()),
+            fieldOp_->getValue().size());
+          fieldOp_->setDictionaryValue(decoder, fieldOp_->getValue());
+        }
+        else
+        {
+          if(isMandatory())
+          {
+            decoder.reportFatal("[ERR D6]", "No value available for mandatory copy field.", *identity_);
+          }
+        }
+      }
+    }
   }
 }
 #endif // FIELDINSTRUCTIONASCII_H
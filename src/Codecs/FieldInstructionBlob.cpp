@@ -9,6 +9,7 @@
 #include <Codecs/Encoder.h>
 #include <Messages/ValueMessageBuilder.h>
 #include <Messages/Field.h>
+#include <Common/Utf8.h>
 
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Codecs;
@@ -55,53 +56,21 @@ FieldInstructionBlob::decodeBlobFromSource(
 void
 FieldInstructionBlob::decodeNop(
   Codecs::DataSource & source,
-  Codecs::PresenceMap & /*pmap*/,
+  Codecs::PresenceMap & pmap,
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & builder) const
 {
-  PROFILE_POINT("blob::decodeNop");
-  // note NOP never uses pmap.  It uses a null value instead for optional fields
-  // so it's always safe to do the basic decode.
-  WorkingBuffer& buffer = decoder.getWorkingBuffer();
-  if(decodeBlobFromSource(source, decoder, isMandatory(), buffer))
-  {
-    const uchar * value = buffer.begin();
-    size_t valueSize = buffer.size();
-    builder.addValue(identity_, type_, value, valueSize);
-  }
+  decodeNopImpl(source, pmap, decoder, builder);
 }
 
 void
 FieldInstructionBlob::decodeConstant(
-  Codecs::DataSource & /*source*/,
+  Codecs::DataSource & source,
   Codecs::PresenceMap & pmap,
-  Codecs::Decoder & /*decoder*/,
+  Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & builder) const
 {
-  PROFILE_POINT("blob::decodeConstant");
-  if(isMandatory())
-  {
-    const std::string & value = fieldOp_->getValue();
-    builder.addValue(
-      identity_,
-      type_,
-      reinterpret_cast<const uchar *>(value.c_str()), value.size());
-  }
-  else
-  {
-    if(pmap.checkNextField())
-    {
-      const std::string & value = fieldOp_->getValue();
-      builder.addValue(
-        identity_,
-        type_,
-        reinterpret_cast<const uchar *>(value.c_str()), value.size());
-    }
-    else
-    {
-      // not present. Nothing to do
-    }
-  }
+  decodeConstantImpl(source, pmap, decoder, builder);
 }
 
 void
@@ -111,37 +80,7 @@ FieldInstructionBlob::decodeDefault(
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & builder) const
 {
-  PROFILE_POINT("blob::decodeDefault");
-  if(pmap.checkNextField())
-  {
-    WorkingBuffer& buffer = decoder.getWorkingBuffer();
-    if(decodeBlobFromSource(source, decoder, isMandatory(), buffer))
-    {
-      const uchar * value = buffer.begin();
-      size_t valueSize = buffer.size();
-      builder.addValue(
-        identity_,
-        type_,
-        value,
-        valueSize);
-    }
-  }
-  else // pmap says nothing in stream
-  {
-    if(fieldOp_->hasValue())
-    {
-      const std::string & value = fieldOp_->getValue();
-      builder.addValue(
-        identity_,
-        type_,
-        reinterpret_cast<const uchar *>(value.c_str()), value.size());
-    }
-    else if(isMandatory())
-    {
-      decoder.reportFatal("[ERR D5]", "Mandatory default operator with no value.", *identity_);
-    }
-
-  }
+  decodeDefaultImpl(source, pmap, decoder, builder);
 }
 
 void
@@ -151,134 +90,17 @@ FieldInstructionBlob::decodeCopy(
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & builder) const
 {
-  PROFILE_POINT("blob::decodeCopy");
-  if(pmap.checkNextField())
-  {
-    // field is in the stream, use it
-  WorkingBuffer& buffer = decoder.getWorkingBuffer();
-  if(decodeBlobFromSource(source, decoder, isMandatory(), buffer))
-  {
-    const uchar * value = buffer.begin();
-    size_t valueSize = buffer.size();
-      builder.addValue(
-        identity_,
-        type_,
-        value,
-        valueSize);
-      fieldOp_->setDictionaryValue(decoder, value, valueSize);
-    }
-  }
-  else // pmap says not in stream
-  {
-    const uchar * value = 0;
-    size_t valueSize = 0;
-    Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, value, valueSize);
-    if(previousStatus == Context::OK_VALUE)
-    {
-       builder.addValue(identity_, type_, value, valueSize);
-    }
-    else if(fieldOp_->hasValue())
-    {
-      const std::string & initialValue = fieldOp_->getValue();
-      builder.addValue(
-        identity_,
-        type_,
-        reinterpret_cast<const uchar *>(initialValue.c_str()),
-        initialValue.size());
-      fieldOp_->setDictionaryValue(
-        decoder,
-        reinterpret_cast<const uchar *>(initialValue.c_str()),
-        initialValue.size());
-    }
-    else
-    {
-      if(isMandatory())
-      {
-        decoder.reportFatal("[ERR D6]", "No value available for mandatory copy field.", *identity_);
-      }
-    }
-  }
+  decodeCopyImpl(source, pmap, decoder, builder);
 }
 
 void
 FieldInstructionBlob::decodeDelta(
   Codecs::DataSource & source,
-  Codecs::PresenceMap & /*pmap*/,
+  Codecs::PresenceMap & pmap,
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & builder) const
 {
-  PROFILE_POINT("blob::decodeDelta");
-  int32 deltaLength;
-  decodeSignedInteger(source, decoder, deltaLength, identity_->name());
-  if(!isMandatory())
-  {
-    if(checkNullInteger(deltaLength))
-    {
-      // NULL delta does not clear previous
-      // so there's nothing to do
-      return;
-    }
-  }
-
-  std::string deltaValue;
-  WorkingBuffer& buffer = decoder.getWorkingBuffer();
-  if(decodeBlobFromSource(source, decoder, true /*isMandatory()*/, buffer))
-  {
-    const uchar * value = buffer.begin();
-    size_t valueSize = buffer.size();
-    deltaValue = std::string(reinterpret_cast<const char *>(value), valueSize);
-  }
-
-  std::string previousValue;
-  Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
-  if(previousStatus == Context::UNDEFINED_VALUE)
-  {
-    if(fieldOp_->hasValue())
-    {
-      previousValue = fieldOp_->getValue();
-    }
-  }
-  size_t previousLength = previousValue.size();
-
-  if( deltaLength < 0)
-  {
-    // operate on front of string
-    // compensete for the excess -1 encoding that allows -0 != +0
-    deltaLength = -(deltaLength + 1);
-    // don't chop more than is there
-    if(static_cast<unsigned long>(deltaLength) > previousLength)
-    {
-      decoder.reportError("[ERR D7]", "String tail delta front length exceeds length of previous string.", *identity_);
-      deltaLength = QuickFAST::int32(previousLength);
-    }
-    std::string value = deltaValue + previousValue.substr(deltaLength);
-    builder.addValue(
-      identity_,
-      type_,
-      reinterpret_cast<const uchar *>(value.c_str()),
-      value.size());
-    fieldOp_->setDictionaryValue(decoder, value);
-  }
-  else
-  { // operate on end of string
-    // don't chop more than is there
-    if(static_cast<size_t>(deltaLength) > previousLength)
-    {
-#if 0 // handy when debugging
-      std::cout << "decode blob delta length: " << deltaLength << " previous: " << previousLength << std::endl;
-#endif
-      decoder.reportError("[ERR D7]", "String tail delta back length exceeds length of previous string.", *identity_);
-      deltaLength = QuickFAST::uint32(previousLength);
-    }
-
-    std::string value = previousValue.substr(0, previousLength - deltaLength) + deltaValue;
-    builder.addValue(
-      identity_,
-      type_,
-      reinterpret_cast<const uchar *>(value.c_str()),
-      value.size());
-    fieldOp_->setDictionaryValue(decoder, value);
-  }
+  decodeDeltaImpl(source, pmap, decoder, builder);
 }
 
 void
@@ -288,70 +110,7 @@ FieldInstructionBlob::decodeTail(
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & builder) const
 {
-  PROFILE_POINT("blob::decodeTail");
-  if(pmap.checkNextField())
-  {
-    // field is in the stream, use it
-    WorkingBuffer& buffer = decoder.getWorkingBuffer();
-    if(decodeBlobFromSource(source, decoder, isMandatory(), buffer))
-    {
-      size_t tailLength = buffer.size();
-      std::string tailValue(reinterpret_cast<const char *>(buffer.begin()), tailLength);
-
-      std::string previousValue;
-      Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
-      if(previousStatus == Context::UNDEFINED_VALUE)
-      {
-        if(fieldOp_->hasValue())
-        {
-          previousValue = fieldOp_->getValue();
-          fieldOp_->setDictionaryValue(decoder, previousValue);
-        }
-      }
-      size_t previousLength = previousValue.length();
-      if(tailLength > previousLength)
-      {
-        tailLength = previousLength;
-      }
-      std::string value(previousValue.substr(0, previousLength - tailLength) + tailValue);
-      builder.addValue(
-        identity_,
-        type_,
-        reinterpret_cast<const uchar *>(value.c_str()),
-        value.size());
-      fieldOp_->setDictionaryValue(decoder, value);
-    }
-    else // null
-    {
-      fieldOp_->setDictionaryValueNull(decoder);
-    }
-  }
-  else // pmap says not in stream
-  {
-    std::string previousValue;
-    Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
-    if(previousStatus == Context::OK_VALUE)
-    {
-
-      builder.addValue(
-        identity_,
-        type_,
-        reinterpret_cast<const uchar *>(previousValue.c_str()),
-        previousValue.size());
-    }
-    else if(fieldOp_->hasValue())
-    {
-      builder.addValue(identity_, type_, reinterpret_cast<const uchar *>(fieldOp_->getValue().c_str()), fieldOp_->getValue().size());
-      fieldOp_->setDictionaryValue(decoder, fieldOp_->getValue());
-    }
-    else
-    {
-      if(isMandatory())
-      {
-        decoder.reportFatal("[ERR D6]", "No value available for mandatory copy field.", *identity_);
-      }
-    }
-  }
+  decodeTailImpl(source, pmap, decoder, builder);
 }
 
 void
@@ -7,6 +7,9 @@
 #ifndef FIELDINSTRUCTIONBLOB_H
 #define FIELDINSTRUCTIONBLOB_H
 #include <Codecs/FieldInstruction.h>
+#include <Codecs/Decoder.h>
+#include <Messages/ValueMessageBuilder.h>
+#include <Common/Utf8.h>
 namespace QuickFAST{
   namespace Codecs{
     /// @brief A basic implementation for ByteVector and Utf8 field Instructions.
@@ -68,6 +71,56 @@ namespace QuickFAST{
         Codecs::Decoder & decoder,
         Messages::ValueMessageBuilder & builder) const;
 
+      /// @brief Decode the field, passing the value directly to a builder of a known type.
+      ///
+      /// Equivalent to decode() but the field operator is selected by a switch rather
+      /// than by virtual calls, and the builder is called through its static type.
+      /// Used by Decoder::decodeMessage<Builder>().
+      /// @param[in] source for the FAST data
+      /// @param[in] pmap indicating field presence
+      /// @param[in] decoder driving this process
+      /// @param[out] builder receives the value.
+      template<typename BUILDER>
+      void decodeStatic(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const
+      {
+        size_t pmapBit = 0;
+        switch(fieldOp_->opType())
+        {
+        case FieldOp::NOP:
+          decodeNopImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::CONSTANT:
+          decodeConstantImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::DEFAULT:
+          decodeDefaultImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::COPY:
+          if(!fieldOp_->getPMapBit(pmapBit))
+          {
+            decodeCopyImpl(source, pmap, decoder, builder);
+            break;
+          }
+          // a specific presence map bit is not valid for byte vectors.  Let the usual path report it.
+          fieldOp_->decode(*this, source, pmap, decoder, builder.valueMessageBuilder());
+          break;
+        case FieldOp::DELTA:
+          decodeDeltaImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::TAIL:
+          decodeTailImpl(source, pmap, decoder, builder);
+          break;
+        default:
+          // not valid for byte vectors.  Let the usual path report it.
+          fieldOp_->decode(*this, source, pmap, decoder, builder.valueMessageBuilder());
+          break;
+        }
+      }
+
       virtual void encodeNop(
         Codecs::DataDestination & destination,
         Codecs::PresenceMap & pmap,
@@ -108,6 +161,49 @@ namespace QuickFAST{
 
       virtual void addLengthInstruction(FieldInstructionPtr & field);
 
+    protected:
+      template<typename BUILDER>
+      void decodeNopImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeConstantImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeDefaultImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeCopyImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeDeltaImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeTailImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
     protected:
       /// @brief create a populated field of the appropriate type
       /// @param buffer points to the data
@@ -134,6 +230,33 @@ namespace QuickFAST{
         bool mandatory,
         WorkingBuffer & buffer) const;
 
+      /// @brief helper routine to decode blob data that is not needed for the dictionary
+      ///
+      /// Large byte vectors are passed to the builder in pieces directly from the
+      /// source's buffers if the decoder and the builder agree.  Otherwise the value
+      /// is assembled in the working buffer and passed to addDecodedValue().
+      /// @param source supplies the data.
+      /// @param decoder supplies the working buffer and the chunk threshold.
+      /// @param builder receives the value.
+      /// @returns true if a value was present.
+      template<typename BUILDER>
+      bool decodeBlobToBuilder(
+        Codecs::DataSource & source,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      /// @brief Pass a decoded value to the builder applying the decoder's Utf8Policy.
+      /// @param decoder supplies the policy.
+      /// @param builder receives the value.
+      /// @param value points to the value.
+      /// @param length is the number of bytes in the value.
+      template<typename BUILDER>
+      void addDecodedValue(
+        Codecs::Decoder & decoder,
+        BUILDER & builder,
+        const uchar * value,
+        size_t length) const;
+
       /// @brief helper routine to encode a nullable, but not null value
       void encodeNullableBlob(
         Codecs::DataDestination & destination,
@@ -152,6 +275,378 @@ namespace QuickFAST{
       /// @brief a field of the appropriate type containing the intial value specified with the field Op
       Messages::FieldCPtr initialValue_;
     };
+
+    template<typename BUILDER>
+    bool
+    FieldInstructionBlob::decodeBlobToBuilder(
+      Codecs::DataSource & source,
+      Codecs::Decoder & decoder,
+      BUILDER & builder) const
+    {
+      size_t threshold = decoder.getByteVectorChunkThreshold();
+      if(type_ != ValueType::BYTEVECTOR || threshold == 0)
+      {
+        WorkingBuffer& buffer = decoder.getWorkingBuffer();
+        if(!decodeBlobFromSource(source, decoder, isMandatory(), buffer))
+        {
+          return false;
+        }
+        addDecodedValue(decoder, builder, buffer.begin(), buffer.size());
+        return true;
+      }
+
+      PROFILE_POINT("blob::decodeBlobToBuilder");
+      uint32 length;
+      decodeUnsignedInteger(source, decoder, length, identity_->name());
+      if(!isMandatory())
+      {
+        if(checkNullInteger(length))
+        {
+          return false;
+        }
+      }
+      if(length < threshold || !builder.startByteVector(identity_, type_, length))
+      {
+        WorkingBuffer& buffer = decoder.getWorkingBuffer();
+        decodeByteVector(decoder, source, identity_->name(), buffer, length);
+        builder.addValue(identity_, type_, buffer.begin(), buffer.size());
+        return true;
+      }
+      size_t remaining = length;
+      while(remaining > 0)
+      {
+        const uchar * chunk = 0;
+        size_t size = source.getContiguous(remaining, chunk);
+        if(size == 0)
+        {
+          decoder.reportFatal("[ERR U03]", "End of file: Too few bytes in ByteVector.", *identity_);
+        }
+        builder.appendByteVector(identity_, chunk, size);
+        remaining -= size;
+      }
+      builder.endByteVector(identity_, type_);
+      return true;
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionBlob::addDecodedValue(
+      Codecs::Decoder & decoder,
+      BUILDER & builder,
+      const uchar * value,
+      size_t length) const
+    {
+      Decoder::Utf8Policy policy = decoder.getUtf8Policy();
+      if(type_ != ValueType::UTF8 || policy == Decoder::UTF8_ACCEPT)
+      {
+        builder.addValue(identity_, type_, value, length);
+        return;
+      }
+      size_t errorOffset = Utf8::validate(value, length);
+      if(errorOffset == length)
+      {
+        builder.addValue(identity_, type_, value, length);
+        return;
+      }
+      decoder.countInvalidUtf8();
+      switch(policy)
+      {
+      case Decoder::UTF8_REJECT:
+        {
+          decoder.reportError("[ERR R2]", "Value is not valid UTF-8.", *identity_);
+          break;
+        }
+      case Decoder::UTF8_REPLACE:
+        {
+          std::string replaced;
+          Utf8::replaceInvalid(value, length, replaced);
+          builder.addValue(
+            identity_,
+            type_,
+            reinterpret_cast<const uchar *>(replaced.data()),
+            replaced.size());
+          break;
+        }
+      default: // UTF8_FLAG
+        {
+          builder.addValue(identity_, type_, value, length);
+          builder.invalidUtf8(identity_, errorOffset);
+          break;
+        }
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionBlob::decodeNopImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & /*pmap*/,
+      Codecs::Decoder & decoder,
+      BUILDER & builder) const
+    {
+      PROFILE_POINT("blob::decodeNop");
+      // note NOP never uses pmap.  It uses a null value instead for optional fields
+      // so it's always safe to do the basic decode.
+      decodeBlobToBuilder(source, decoder, builder);
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionBlob::decodeConstantImpl(
+      Codecs::DataSource & /*source*/,
+      Codecs::PresenceMap & pmap,
+      Codecs::Decoder & /*decoder*/,
+      BUILDER & builder) const
+    {
+      PROFILE_POINT("blob::decodeConstant");
+      if(isMandatory())
+      {
+        const std::string & value = fieldOp_->getValue();
+        builder.addValue(
+          identity_,
+          type_,
+          reinterpret_cast<const uchar *>(value.c_str()), value.size());
+      }
+      else
+      {
+        if(pmap.checkNextField())
+        {
+          const std::string & value = fieldOp_->getValue();
+          builder.addValue(
+            identity_,
+            type_,
+            reinterpret_cast<const uchar *>(value.c_str()), value.size());
+        }
+        else
+        {
+          // not present. Nothing to do
+        }
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionBlob::decodeDefaultImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & pmap,
+      Codecs::Decoder & decoder,
+      BUILDER & builder) const
+    {
+      PROFILE_POINT("blob::decodeDefault");
+      if(pmap.checkNextField())
+      {
+        decodeBlobToBuilder(source, decoder, builder);
+      }
+      else // pmap says nothing in stream
+      {
+        if(fieldOp_->hasValue())
+        {
+          const std::string & value = fieldOp_->getValue();
+          builder.addValue(
+            identity_,
+            type_,
+            reinterpret_cast<const uchar *>(value.c_str()), value.size());
+        }
+        else if(isMandatory())
+        {
+          decoder.reportFatal("[ERR D5]", "Mandatory default operator with no value.", *identity_);
+        }
+
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionBlob::decodeCopyImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & pmap,
+      Codecs::Decoder & decoder,
+      BUILDER & builder) const
+    {
+      PROFILE_POINT("blob::decodeCopy");
+      if(pmap.checkNextField())
+      {
+        // field is in the stream, use it
+      WorkingBuffer& buffer = decoder.getWorkingBuffer();
+      if(decodeBlobFromSource(source, decoder, isMandatory(), buffer))
+      {
+        const uchar * value = buffer.begin();
+        size_t valueSize = buffer.size();
+          // update the dictionary first: it holds the value as received
+          fieldOp_->setDictionaryValue(decoder, value, valueSize);
+          addDecodedValue(decoder, builder, value, valueSize);
+        }
+      }
+      else // pmap says not in stream
+      {
+        const uchar * value = 0;
+        size_t valueSize = 0;
+        Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, value, valueSize);
+        if(previousStatus == Context::OK_VALUE)
+        {
+           addDecodedValue(decoder, builder, value, valueSize);
+        }
+        else if(fieldOp_->hasValue())
+        {
+          const std::string & initialValue = fieldOp_->getValue();
+          builder.addValue(
+            identity_,
+            type_,
+            reinterpret_cast<const uchar *>(initialValue.c_str()),
+            initialValue.size());
+          fieldOp_->setDictionaryValue(
+            decoder,
+            reinterpret_cast<const uchar *>(initialValue.c_str()),
+            initialValue.size());
+        }
+        else
+        {
+          if(isMandatory())
+          {
+            decoder.reportFatal("[ERR D6]", "No value available for mandatory copy field.", *identity_);
+          }
+        }
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionBlob::decodeDeltaImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & /*pmap*/,
+      Codecs::Decoder & decoder,
+      BUILDER & builder) const
+    {
+      PROFILE_POINT("blob::decodeDelta");
+      int32 deltaLength;
+      decodeSignedInteger(source, decoder, deltaLength, identity_->name());
+      if(!isMandatory())
+      {
+        if(checkNullInteger(deltaLength))
+        {
+          // NULL delta does not clear previous
+          // so there's nothing to do
+          return;
+        }
+      }
+
+      std::string deltaValue;
+      WorkingBuffer& buffer = decoder.getWorkingBuffer();
+      if(decodeBlobFromSource(source, decoder, true /*isMandatory()*/, buffer))
+      {
+        const uchar * value = buffer.begin();
+        size_t valueSize = buffer.size();
+        deltaValue = std::string(reinterpret_cast<const char *>(value), valueSize);
+      }
+
+      std::string previousValue;
+      Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
+      if(previousStatus == Context::UNDEFINED_VALUE)
+      {
+        if(fieldOp_->hasValue())
+        {
+          previousValue = fieldOp_->getValue();
+        }
+      }
+      size_t previousLength = previousValue.size();
+
+      if( deltaLength < 0)
+      {
+        // operate on front of string
+        // compensete for the excess -1 encoding that allows -0 != +0
+        deltaLength = -(deltaLength + 1);
+        // don't chop more than is there
+        if(static_cast<unsigned long>(deltaLength) > previousLength)
+        {
+          decoder.reportError("[ERR D7]", "String tail delta front length exceeds length of previous string.", *identity_);
+          deltaLength = QuickFAST::int32(previousLength);
+        }
+        std::string value = deltaValue + previousValue.substr(deltaLength);
+        fieldOp_->setDictionaryValue(decoder, value);
+        addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(value.c_str()), value.size());
+      }
+      else
+      { // operate on end of string
+        // don't chop more than is there
+        if(static_cast<size_t>(deltaLength) > previousLength)
+        {
+    #if 0 // handy when debugging
+          std::cout << "decode blob delta length: " << deltaLength << " previous: " << previousLength << std::endl;
+    #endif
+          decoder.reportError("[ERR D7]", "String tail delta back length exceeds length of previous string.", *identity_);
+          deltaLength = QuickFAST::uint32(previousLength);
+        }
+
+        std::string value = previousValue.substr(0, previousLength - deltaLength) + deltaValue;
+        fieldOp_->setDictionaryValue(decoder, value);
+        addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(value.c_str()), value.size());
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionBlob::decodeTailImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & pmap,
+      Codecs::Decoder & decoder,
+      BUILDER & builder) const
+    {
+      PROFILE_POINT("blob::decodeTail");
+      if(pmap.checkNextField())
+      {
+        // field is in the stream, use it
+        WorkingBuffer& buffer = decoder.getWorkingBuffer();
+        if(decodeBlobFromSource(source, decoder, isMandatory(), buffer))
+        {
+          size_t tailLength = buffer.size();
+          std::string tailValue(reinterpret_cast<const char *>(buffer.begin()), tailLength);
+
+          std::string previousValue;
+          Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
+          if(previousStatus == Context::UNDEFINED_VALUE)
+          {
+            if(fieldOp_->hasValue())
+            {
+              previousValue = fieldOp_->getValue();
+              fieldOp_->setDictionaryValue(decoder, previousValue);
+            }
+          }
+          size_t previousLength = previousValue.length();
+          if(tailLength > previousLength)
+          {
+            tailLength = previousLength;
+          }
+          std::string value(previousValue.substr(0, previousLength - tailLength) + tailValue);
+          fieldOp_->setDictionaryValue(decoder, value);
+          addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(value.c_str()), value.size());
+        }
+        else // null
+        {
+          fieldOp_->setDictionaryValueNull(decoder);
+        }
+      }
+      else // pmap says not in stream
+      {
+        std::string previousValue;
+        Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
+        if(previousStatus == Context::OK_VALUE)
+        {
+          addDecodedValue(decoder, builder, reinterpret_cast<const uchar *>(previousValue.c_str()), previousValue.size());
+        }
+        else if(fieldOp_->hasValue())
+        {
+          builder.addValue(identity_, type_, reinterpret_cast<const uchar *>(fieldOp_->getValue().c_str()), fieldOp_->getValue().size());
+          fieldOp_->setDictionaryValue(decoder, fieldOp_->getValue());
+        }
+        else
+        {
+          if(isMandatory())
+          {
+            decoder.reportFatal("[ERR D6]", "No value available for mandatory copy field.", *identity_);
+          }
+        }
+      }
+    }
   }
 }
 #endif // FIELDINSTRUCTIONBLOB_H
@@ -61,67 +61,17 @@ FieldInstructionDecimal::decodeNop(
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & accessor) const
 {
-  PROFILE_POINT("decimal::decodeNop");
-
-  if(bool(exponentInstruction_))
-  {
-    Messages::SingleValueBuilder<int32> exponentBuilder;
-    exponentInstruction_->decode(source, pmap, decoder, exponentBuilder);
-    if(!exponentBuilder.isSet())
-    {
-      // null field
-      return;
-    }
-    exponent_t exponent = static_cast<exponent_t>(exponentBuilder.value());
-
-    Messages::SingleValueBuilder<mantissa_t> mantissaBuilder;
-    mantissaInstruction_->decode(source, pmap, decoder, mantissaBuilder);
-    mantissa_t mantissa = 0;
-    if(mantissaBuilder.isSet())
-    {
-      mantissa = mantissaBuilder.value();
-    }
-
-    Decimal value(mantissa, exponent, false);
-    accessor.addValue(identity_, ValueType::DECIMAL, value);
-  }
-  else
-  {
-    exponent_t exponent = 0;
-    decodeSignedInteger(source, decoder, exponent, identity_->name());
-    if(!isMandatory())
-    {
-      if(checkNullInteger(exponent))
-      {
-        return;
-      }
-    }
-    mantissa_t mantissa;
-    decodeSignedInteger(source, decoder, mantissa, identity_->name());
-    Decimal value(mantissa, exponent);
-    accessor.addValue(
-      identity_,
-      ValueType::DECIMAL,
-      value);
-  }
-  return;
+  decodeNopImpl(source, pmap, decoder, accessor);
 }
 
 void
 FieldInstructionDecimal::decodeConstant(
-  Codecs::DataSource & /*source*/,
+  Codecs::DataSource & source,
   Codecs::PresenceMap & pmap,
-  Codecs::Decoder & /*decoder*/,
+  Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & accessor) const
 {
-  PROFILE_POINT("decimal::decodeConstant");
-  if(isMandatory() || pmap.checkNextField())
-  {
-    accessor.addValue(
-      identity_,
-      ValueType::DECIMAL,
-      typedValue_);
-  }
+  decodeConstantImpl(source, pmap, decoder, accessor);
 }
 
 void
@@ -131,40 +81,7 @@ FieldInstructionDecimal::decodeDefault(
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & accessor) const
 {
-  PROFILE_POINT("decimal::decodeDefault");
-  if(pmap.checkNextField())
-  {
-    exponent_t exponent = 0;
-    decodeSignedInteger(source, decoder, exponent, identity_->name());
-    if(!isMandatory())
-    {
-      if(checkNullInteger(exponent))
-      {
-        return;
-      }
-    }
-    mantissa_t mantissa;
-    decodeSignedInteger(source, decoder, mantissa, identity_->name());
-    Decimal value(mantissa, exponent);
-    accessor.addValue(
-      identity_,
-      ValueType::DECIMAL,
-      value);
-  }
-  else // field not in stream
-  {
-    if(typedValueIsDefined_)
-    {
-      accessor.addValue(
-        identity_,
-        ValueType::DECIMAL,
-        typedValue_);
-    }
-    else if(isMandatory())
-    {
-      decoder.reportFatal("[ERR D5]", "Mandatory default operator with no value.", *identity_);
-    }
-  }
+  decodeDefaultImpl(source, pmap, decoder, accessor);
 }
 
 void
@@ -174,107 +91,17 @@ FieldInstructionDecimal::decodeCopy(
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & accessor) const
 {
-  PROFILE_POINT("decimal::decodeCopy");
-  exponent_t exponent = 0;
-  mantissa_t mantissa = 0;
-  if(pmap.checkNextField())
-  {
-    decodeSignedInteger(source, decoder, exponent, identity_->name());
-    if(isMandatory())
-    {
-      decodeSignedInteger(source, decoder, mantissa, identity_->name());
-      Decimal value(mantissa, exponent, false);
-      accessor.addValue(
-        identity_,
-        ValueType::DECIMAL,
-        value);
-      fieldOp_->setDictionaryValue(decoder, value);
-    }
-    else
-    {
-      // not mandatory means it's nullable
-      if(checkNullInteger(exponent))
-      {
-        fieldOp_->setDictionaryValueNull(decoder);
-      }
-      else
-      {
-        decodeSignedInteger(source, decoder, mantissa, identity_->name());
-        Decimal value(mantissa, exponent, false);
-        accessor.addValue(
-          identity_,
-          ValueType::DECIMAL,
-          value);
-        fieldOp_->setDictionaryValue(decoder, value);
-      }
-    }
-
-  }
-  else // pmap says not present, use copy
-  {
-    Decimal value(0,0);
-    Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, value);
-    if(previousStatus == Context::UNDEFINED_VALUE)
-    {
-      // value not found in dictionary
-      // not a problem..  use initial value if it's available
-      if(fieldOp_->hasValue())
-      {
-        accessor.addValue(
-          identity_,
-          ValueType::DECIMAL,
-          typedValue_);
-        fieldOp_->setDictionaryValue(decoder, typedValue_);
-      }
-      else
-      {
-        if(isMandatory())
-        {
-          decoder.reportFatal("[ERR D5]", "Copy operator missing mandatory Decimal field/no initial value", *identity_);
-        }
-      }
-    }
-    else if(previousStatus == Context::OK_VALUE)
-    {
-      accessor.addValue(
-        identity_,
-        ValueType::DECIMAL,
-        value);
-    }
-    //else previous was null so don't put anything in the record
-  }
+  decodeCopyImpl(source, pmap, decoder, accessor);
 }
 
 void
 FieldInstructionDecimal::decodeDelta(
   Codecs::DataSource & source,
-  Codecs::PresenceMap & /*pmap*/,
+  Codecs::PresenceMap & pmap,
   Codecs::Decoder & decoder,
   Messages::ValueMessageBuilder & accessor) const
 {
-  PROFILE_POINT("decimal::decodeDelta");
-  int64 exponentDelta;
-  decodeSignedInteger(source, decoder, exponentDelta, identity_->name(), true);
-  if(!isMandatory())
-  {
-    if(checkNullInteger(exponentDelta))
-    {
-      // nothing in Message; no change to saved value
-      return;
-    }
-  }
-  int64 mantissaDelta;
-  decodeSignedInteger(source, decoder, mantissaDelta, identity_->name(), true);
-
-  Decimal value(typedValue_);
-  (void)fieldOp_->getDictionaryValue(decoder, value);
-  value.setExponent(exponent_t(value.getExponent() + exponentDelta));
-  value.setMantissa(mantissa_t(value.getMantissa() + mantissaDelta));
-  accessor.addValue(
-    identity_,
-    ValueType::DECIMAL,
-    value);
-  fieldOp_->setDictionaryValue(decoder, value);
+  decodeDeltaImpl(source, pmap, decoder, accessor);
 }
 
 void
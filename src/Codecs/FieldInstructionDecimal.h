@@ -9,6 +9,9 @@
 #include <Codecs/FieldInstructionMantissa.h>
 #include <Codecs/FieldInstructionExponent.h>
 #include <Codecs/FieldInstruction.h>
+#include <Codecs/Decoder.h>
+#include <Messages/ValueMessageBuilder.h>
+#include <Messages/SingleValueBuilder.h>
 #include <Common/Decimal.h>
 namespace QuickFAST{
   namespace Codecs{
@@ -117,6 +120,53 @@ namespace QuickFAST{
         Codecs::Decoder & decoder,
         Messages::ValueMessageBuilder & builder) const;
 
+      /// @brief Decode the field, passing the value directly to a builder of a known type.
+      ///
+      /// Equivalent to decode() but the field operator is selected by a switch rather
+      /// than by virtual calls, and the builder is called through its static type.
+      /// Used by Decoder::decodeMessage<Builder>().
+      /// @param[in] source for the FAST data
+      /// @param[in] pmap indicating field presence
+      /// @param[in] decoder driving this process
+      /// @param[out] builder receives the value.
+      template<typename BUILDER>
+      void decodeStatic(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const
+      {
+        size_t pmapBit = 0;
+        switch(fieldOp_->opType())
+        {
+        case FieldOp::NOP:
+          decodeNopImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::CONSTANT:
+          decodeConstantImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::DEFAULT:
+          decodeDefaultImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::COPY:
+          if(!fieldOp_->getPMapBit(pmapBit))
+          {
+            decodeCopyImpl(source, pmap, decoder, builder);
+            break;
+          }
+          // a specific presence map bit is not valid for decimals.  Let the usual path report it.
+          fieldOp_->decode(*this, source, pmap, decoder, builder.valueMessageBuilder());
+          break;
+        case FieldOp::DELTA:
+          decodeDeltaImpl(source, pmap, decoder, builder);
+          break;
+        default:
+          // not valid for decimals.  Let the usual path report it.
+          fieldOp_->decode(*this, source, pmap, decoder, builder.valueMessageBuilder());
+          break;
+        }
+      }
+
       virtual void encodeNop(
         Codecs::DataDestination & destination,
         Codecs::PresenceMap & pmap,
@@ -157,6 +207,42 @@ namespace QuickFAST{
       virtual ValueType::Type fieldInstructionType()const;
       virtual void displayBody(std::ostream & output, size_t indent)const;
 
+    private:
+      template<typename BUILDER>
+      void decodeNopImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeConstantImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeDefaultImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeCopyImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeDeltaImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
     private:
       void encodeDecimal(
         Codecs::DataDestination & destination,
@@ -182,6 +268,234 @@ namespace QuickFAST{
       FieldInstructionPtr mantissaInstruction_;
       FieldInstructionPtr exponentInstruction_;
     };
+
+    template<typename BUILDER>
+    void
+    FieldInstructionDecimal::decodeNopImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & pmap,
+      Codecs::Decoder & decoder,
+      BUILDER & accessor) const
+    {
+      PROFILE_POINT("decimal::decodeNop");
+
+      if(bool(exponentInstruction_))
+      {
+        Messages::SingleValueBuilder<int32> exponentBuilder;
+        exponentInstruction_->decode(source, pmap, decoder, exponentBuilder);
+        if(!exponentBuilder.isSet())
+        {
+          // null field
+          return;
+        }
+        exponent_t exponent = static_cast<exponent_t>(exponentBuilder.value());
+
+        Messages::SingleValueBuilder<mantissa_t> mantissaBuilder;
+        mantissaInstruction_->decode(source, pmap, decoder, mantissaBuilder);
+        mantissa_t mantissa = 0;
+        if(mantissaBuilder.isSet())
+        {
+          mantissa = mantissaBuilder.value();
+        }
+
+        Decimal value(mantissa, exponent, false);
+        accessor.addValue(identity_, ValueType::DECIMAL, value);
+      }
+      else
+      {
+        exponent_t exponent = 0;
+        decodeSignedInteger(source, decoder, exponent, identity_->name());
+        if(!isMandatory())
+        {
+          if(checkNullInteger(exponent))
+          {
+            return;
+          }
+        }
+        mantissa_t mantissa;
+        decodeSignedInteger(source, decoder, mantissa, identity_->name());
+        Decimal value(mantissa, exponent);
+        accessor.addValue(
+          identity_,
+          ValueType::DECIMAL,
+          value);
+      }
+      return;
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionDecimal::decodeConstantImpl(
+      Codecs::DataSource & /*source*/,
+      Codecs::PresenceMap & pmap,
+      Codecs::Decoder & /*decoder*/,
+      BUILDER & accessor) const
+    {
+      PROFILE_POINT("decimal::decodeConstant");
+      if(isMandatory() || pmap.checkNextField())
+      {
+        accessor.addValue(
+          identity_,
+          ValueType::DECIMAL,
+          typedValue_);
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionDecimal::decodeDefaultImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & pmap,
+      Codecs::Decoder & decoder,
+      BUILDER & accessor) const
+    {
+      PROFILE_POINT("decimal::decodeDefault");
+      if(pmap.checkNextField())
+      {
+        exponent_t exponent = 0;
+        decodeSignedInteger(source, decoder, exponent, identity_->name());
+        if(!isMandatory())
+        {
+          if(checkNullInteger(exponent))
+          {
+            return;
+          }
+        }
+        mantissa_t mantissa;
+        decodeSignedInteger(source, decoder, mantissa, identity_->name());
+        Decimal value(mantissa, exponent);
+        accessor.addValue(
+          identity_,
+          ValueType::DECIMAL,
+          value);
+      }
+      else // field not in stream
+      {
+        if(typedValueIsDefined_)
+        {
+          accessor.addValue(
+            identity_,
+            ValueType::DECIMAL,
+            typedValue_);
+        }
+        else if(isMandatory())
+        {
+          decoder.reportFatal("[ERR D5]", "Mandatory default operator with no value.", *identity_);
+        }
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionDecimal::decodeCopyImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & pmap,
+      Codecs::Decoder & decoder,
+      BUILDER & accessor) const
+    {
+      PROFILE_POINT("decimal::decodeCopy");
+      exponent_t exponent = 0;
+      mantissa_t mantissa = 0;
+      if(pmap.checkNextField())
+      {
+        decodeSignedInteger(source, decoder, exponent, identity_->name());
+        if(isMandatory())
+        {
+          decodeSignedInteger(source, decoder, mantissa, identity_->name());
+          Decimal value(mantissa, exponent, false);
+          accessor.addValue(
+            identity_,
+            ValueType::DECIMAL,
+            value);
+          fieldOp_->setDictionaryValue(decoder, value);
+        }
+        else
+        {
+          // not mandatory means it's nullable
+          if(checkNullInteger(exponent))
+          {
+            fieldOp_->setDictionaryValueNull(decoder);
+          }
+          else
+          {
+            decodeSignedInteger(source, decoder, mantissa, identity_->name());
+            Decimal value(mantissa, exponent, false);
+            accessor.addValue(
+              identity_,
+              ValueType::DECIMAL,
+              value);
+            fieldOp_->setDictionaryValue(decoder, value);
+          }
+        }
+
+      }
+      else // pmap says not present, use copy
+      {
+        Decimal value(0,0);
+        Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, value);
+        if(previousStatus == Context::UNDEFINED_VALUE)
+        {
+          // value not found in dictionary
+          // not a problem..  use initial value if it's available
+          if(fieldOp_->hasValue())
+          {
+            accessor.addValue(
+              identity_,
+              ValueType::DECIMAL,
+              typedValue_);
+            fieldOp_->setDictionaryValue(decoder, typedValue_);
+          }
+          else
+          {
+            if(isMandatory())
+            {
+              decoder.reportFatal("[ERR D5]", "Copy operator missing mandatory Decimal field/no initial value", *identity_);
+            }
+          }
+        }
+        else if(previousStatus == Context::OK_VALUE)
+        {
+          accessor.addValue(
+            identity_,
+            ValueType::DECIMAL,
+            value);
+        }
+        //else previous was null so don't put anything in the record
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    FieldInstructionDecimal::decodeDeltaImpl(
+      Codecs::DataSource & source,
+      Codecs::PresenceMap & /*pmap*/,
+      Codecs::Decoder & decoder,
+      BUILDER & accessor) const
+    {
+      PROFILE_POINT("decimal::decodeDelta");
+      int64 exponentDelta;
+      decodeSignedInteger(source, decoder, exponentDelta, identity_->name(), true);
+      if(!isMandatory())
+      {
+        if(checkNullInteger(exponentDelta))
+        {
+          // nothing in Message; no change to saved value
+          return;
+        }
+      }
+      int64 mantissaDelta;
+      decodeSignedInteger(source, decoder, mantissaDelta, identity_->name(), true);
+
+      Decimal value(typedValue_);
+      (void)fieldOp_->getDictionaryValue(decoder, value);
+      value.setExponent(exponent_t(value.getExponent() + exponentDelta));
+      value.setMantissa(mantissa_t(value.getMantissa() + mantissaDelta));
+      accessor.addValue(
+        identity_,
+        ValueType::DECIMAL,
+        value);
+      fieldOp_->setDictionaryValue(decoder, value);
+    }
   }
 }
 #endif // FIELDINSTRUCTIONDECIMAL_H
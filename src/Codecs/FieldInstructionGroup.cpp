@@ -6,6 +6,7 @@
 #include <Codecs/DataSource.h>
 #include <Codecs/Decoder.h>
 #include <Codecs/Encoder.h>
+#include <Codecs/TemplateRegistry.h>
 #include <Messages/Group.h>
 #include <Messages/ValueMessageBuilder.h>
 
@@ -16,10 +17,12 @@ FieldInstructionGroup::FieldInstructionGroup(
   const std::string & name,
   const std::string & fieldNamespace)
   : FieldInstruction(name, fieldNamespace)
+  , flatten_(false)
 {
 }
 
 FieldInstructionGroup::FieldInstructionGroup()
+  : flatten_(false)
 {
 }
 
@@ -30,6 +33,13 @@ FieldInstructionGroup::~FieldInstructionGroup()
 void
 FieldInstructionGroup::finalize(TemplateRegistry & templateRegistry)
 {
+  if(templateRegistry.flattenGroups() && isMandatory() && !flatten_)
+  {
+    // Qualify the names before finalizing the segment so groups
+    // nested in this one are qualified by the full path.
+    flatten_ = true;
+    segmentBody_->qualifyIdentities(identity_->getLocalName());
+  }
   segmentBody_->finalize(templateRegistry);
   FieldInstruction::finalize(templateRegistry);
   // even though the field op is a NOP, an optional group uses a pmap bit
@@ -59,7 +69,7 @@ FieldInstructionGroup::decodeNop(
     {
       decoder.reportFatal("[ERR U08}", "Segment not defined for Group instruction.");
     }
-    if(messageBuilder.getApplicationType() != segmentBody_->getApplicationType())
+    if(!flatten_ && messageBuilder.getApplicationType() != segmentBody_->getApplicationType())
     {
 //      std::cout << "Decoding group into new segment: " << segmentBody_->getApplicationType() << std::endl;
       Messages::ValueMessageBuilder & groupBuilder(
@@ -86,6 +96,7 @@ FieldInstructionGroup::decodeNop(
       // encoded.  In fact, the same message encoded with different
       // templates could be transmitted with different sets of fields
       // in groups.
+      // Flattened groups take this path regardless of application type.
       decoder.decodeGroup(source, segmentBody_, messageBuilder);
     }
   }
@@ -102,6 +113,12 @@ FieldInstructionGroup::encodeNop(
   {
     encoder.reportFatal("[ERR U08}", "Segment not defined for Group instruction.");
   }
+  if(flatten_)
+  {
+    // the group's fields are in the parent under qualified names.
+    encoder.encodeGroup(destination, segmentBody_, messageAccessor);
+    return;
+  }
   // retrieve the field corresponding to this group
   // Note that applications may support merging groups
   // by returning true from getGroup but using the same accessor.
@@ -138,7 +155,7 @@ FieldInstructionGroup::interpretValue(const std::string & /*value*/)
 size_t
 FieldInstructionGroup::fieldCount(const SegmentBody & parent)const
 {
-  if(parent.getApplicationType() == segmentBody_->getApplicationType())
+  if(flatten_ || parent.getApplicationType() == segmentBody_->getApplicationType())
   {
     return segmentBody_->fieldCount();
   }
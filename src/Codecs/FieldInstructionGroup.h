@@ -19,6 +19,9 @@ namespace QuickFAST{
     /// Groups guide decoding by implementing decodeNop.  It uses
     /// the segment to decode fields into the currently active Message Builder.
     ///
+    /// If the TemplateRegistry flattens groups, a mandatory group is always decoded
+    /// into the current builder and its fields are named "group.field".
+    ///
     /// An attempt to use any other instruction with a Group
     /// will lead to a TemplateDefinitionError exception being thrown.
     class QuickFAST_Export FieldInstructionGroup : public FieldInstruction
@@ -79,6 +82,7 @@ namespace QuickFAST{
       void interpretValue(const std::string & value);
     private:
       Codecs::SegmentBodyPtr segmentBody_;
+      bool flatten_;
     };
   }
 }
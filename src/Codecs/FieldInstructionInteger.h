@@ -59,49 +59,165 @@ namespace QuickFAST{
         Codecs::DataSource & source,
         Codecs::PresenceMap & pmap,
         Codecs::Decoder & decoder,
-        Messages::ValueMessageBuilder & builder) const;
+        Messages::ValueMessageBuilder & builder) const
+      {
+        decodeNopImpl(source, pmap, decoder, builder);
+      }
 
       virtual void decodeConstant(
         Codecs::DataSource & source,
         Codecs::PresenceMap & pmap,
         Codecs::Decoder & decoder,
-        Messages::ValueMessageBuilder & builder) const;
+        Messages::ValueMessageBuilder & builder) const
+      {
+        decodeConstantImpl(source, pmap, decoder, builder);
+      }
 
       virtual void decodeDefault(
         Codecs::DataSource & source,
         Codecs::PresenceMap & pmap,
         Codecs::Decoder & decoder,
-        Messages::ValueMessageBuilder & builder) const;
+        Messages::ValueMessageBuilder & builder) const
+      {
+        decodeDefaultImpl(source, pmap, decoder, builder);
+      }
 
       virtual void decodeCopy(
         Codecs::DataSource & source,
         Codecs::PresenceMap & pmap,
         Codecs::Decoder & decoder,
-        Messages::ValueMessageBuilder & builder) const;
+        Messages::ValueMessageBuilder & builder) const
+      {
+        decodeCopyImpl(source, pmap, decoder, builder);
+      }
 
       virtual void decodeCopy(
         Codecs::DataSource & source,
         bool pmapValue,
         Codecs::Decoder & decoder,
-        Messages::ValueMessageBuilder & builder) const;
+        Messages::ValueMessageBuilder & builder) const
+      {
+        decodeCopyImpl(source, pmapValue, decoder, builder);
+      }
 
       virtual void decodeDelta(
         Codecs::DataSource & source,
         Codecs::PresenceMap & pmap,
         Codecs::Decoder & decoder,
-        Messages::ValueMessageBuilder & builder) const;
+        Messages::ValueMessageBuilder & builder) const
+      {
+        decodeDeltaImpl(source, pmap, decoder, builder);
+      }
 
       virtual void decodeIncrement(
         Codecs::DataSource & source,
         Codecs::PresenceMap & pmap,
         Codecs::Decoder & decoder,
-        Messages::ValueMessageBuilder & builder) const;
+        Messages::ValueMessageBuilder & builder) const
+      {
+        decodeIncrementImpl(source, pmap, decoder, builder);
+      }
 
       virtual void decodeIncrement(
         Codecs::DataSource & source,
         bool pmapValue,
         Codecs::Decoder & decoder,
-        Messages::ValueMessageBuilder & builder) const;
+        Messages::ValueMessageBuilder & builder) const
+      {
+        decodeIncrementImpl(source, pmapValue, decoder, builder);
+      }
+
+      /// @brief Decode the field, passing the value directly to a builder of a known type.
+      ///
+      /// Equivalent to decode() but the field operator is selected by a switch rather
+      /// than by virtual calls, and the builder's addValue() is called through
+      /// its static type so it can be inlined.  Used by Decoder::decodeMessage<Builder>().
+      /// @param[in] source for the FAST data
+      /// @param[in] pmap indicating field presence
+      /// @param[in] decoder driving this process
+      /// @param[out] builder receives the value.  It needs only the addValue() methods.
+      template<typename BUILDER>
+      void decodeStatic(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const
+      {
+        size_t pmapBit = 0;
+        bool specificPmapBit = fieldOp_->getPMapBit(pmapBit);
+        decodeOperator(
+          fieldOp_->opType(),
+          specificPmapBit,
+          pmapBit,
+          source,
+          pmap,
+          decoder,
+          builder,
+          builder.valueMessageBuilder());
+      }
+
+      /// @brief Decode the field using operator information looked up in advance.
+      ///
+      /// Used by decodeStatic() and by Static::Field when the operator is known at compile time.
+      /// @param opType is the type of this instruction's FieldOp.
+      /// @param specificPmapBit is true if the FieldOp uses a specific presence map bit
+      /// @param pmapBit is that bit.
+      /// @param[in] source for the FAST data
+      /// @param[in] pmap indicating field presence
+      /// @param[in] decoder driving this process
+      /// @param[out] builder receives the value.  It needs only the addValue() methods.
+      /// @param[out] messageBuilder is the same builder via its virtual interface.
+      template<typename BUILDER>
+      void decodeOperator(
+        FieldOp::OpType opType,
+        bool specificPmapBit,
+        size_t pmapBit,
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder,
+        Messages::ValueMessageBuilder & messageBuilder) const
+      {
+        switch(opType)
+        {
+        case FieldOp::NOP:
+          decodeNopImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::CONSTANT:
+          decodeConstantImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::DEFAULT:
+          decodeDefaultImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::COPY:
+          if(specificPmapBit)
+          {
+            decodeCopyImpl(source, pmap.checkSpecificField(pmapBit), decoder, builder);
+          }
+          else
+          {
+            decodeCopyImpl(source, pmap, decoder, builder);
+          }
+          break;
+        case FieldOp::DELTA:
+          decodeDeltaImpl(source, pmap, decoder, builder);
+          break;
+        case FieldOp::INCREMENT:
+          if(specificPmapBit)
+          {
+            decodeIncrementImpl(source, pmap.checkSpecificField(pmapBit), decoder, builder);
+          }
+          else
+          {
+            decodeIncrementImpl(source, pmap, decoder, builder);
+          }
+          break;
+        default:
+          // tail is not valid for integers.  Let the usual path report it.
+          fieldOp_->decode(*this, source, pmap, decoder, messageBuilder);
+          break;
+        }
+      }
 
       virtual void encodeNop(
         Codecs::DataDestination & destination,
@@ -141,6 +257,63 @@ namespace QuickFAST{
 
       virtual ValueType::Type fieldInstructionType()const;
 
+    private:
+      template<typename BUILDER>
+      void decodeNopImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeConstantImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeDefaultImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeCopyImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeCopyImpl(
+        Codecs::DataSource & source,
+        bool pmapValue,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeDeltaImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeIncrementImpl(
+        Codecs::DataSource & source,
+        Codecs::PresenceMap & pmap,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
+      template<typename BUILDER>
+      void decodeIncrementImpl(
+        Codecs::DataSource & source,
+        bool pmapValue,
+        Codecs::Decoder & decoder,
+        BUILDER & builder) const;
+
     private:
       FieldInstructionInteger(const FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED> &);
       FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED> & operator=(const FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED> &);
@@ -211,13 +384,14 @@ namespace QuickFAST{
     }
 
     template<typename INTEGER_TYPE, ValueType::Type VALUE_TYPE, bool SIGNED>
+    template<typename BUILDER>
     void
     FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED>::
-    decodeNop(
+    decodeNopImpl(
       Codecs::DataSource & source,
       Codecs::PresenceMap & /*pmap*/,
       Codecs::Decoder & decoder,
-      Messages::ValueMessageBuilder & builder) const
+      BUILDER & builder) const
     {
       PROFILE_POINT("int::decodeNop");
 
@@ -253,13 +427,14 @@ namespace QuickFAST{
     }
 
     template<typename INTEGER_TYPE, ValueType::Type VALUE_TYPE, bool SIGNED>
+    template<typename BUILDER>
     void
     FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED>::
-    decodeConstant(
+    decodeConstantImpl(
       Codecs::DataSource & /*source*/,
       Codecs::PresenceMap & pmap,
       Codecs::Decoder & /*decoder*/,
-      Messages::ValueMessageBuilder & builder) const
+      BUILDER & builder) const
     {
       PROFILE_POINT("int::decodeConstant");
       if(!isMandatory() && !pmap.checkNextField())
@@ -276,25 +451,27 @@ namespace QuickFAST{
     }
 
     template<typename INTEGER_TYPE, ValueType::Type VALUE_TYPE, bool SIGNED>
+    template<typename BUILDER>
     void
     FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED>::
-    decodeCopy(
+    decodeCopyImpl(
       Codecs::DataSource & source,
       Codecs::PresenceMap & pmap,
       Codecs::Decoder & decoder,
-      Messages::ValueMessageBuilder & builder) const
+      BUILDER & builder) const
     {
-      decodeCopy(source, pmap.checkNextField(), decoder, builder);
+      decodeCopyImpl(source, pmap.checkNextField(), decoder, builder);
     }
 
     template<typename INTEGER_TYPE, ValueType::Type VALUE_TYPE, bool SIGNED>
+    template<typename BUILDER>
     void
     FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED>::
-    decodeCopy(
+    decodeCopyImpl(
         Codecs::DataSource & source,
         bool pmapValue,
         Codecs::Decoder & decoder,
-        Messages::ValueMessageBuilder & builder) const
+        BUILDER & builder) const
     {
       PROFILE_POINT("int::decodeCopy");
       if(pmapValue)
@@ -396,13 +573,14 @@ namespace QuickFAST{
     }
 
     template<typename INTEGER_TYPE, ValueType::Type VALUE_TYPE, bool SIGNED>
+    template<typename BUILDER>
     void
     FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED>::
-    decodeDefault(
+    decodeDefaultImpl(
       Codecs::DataSource & source,
       Codecs::PresenceMap & pmap,
       Codecs::Decoder & decoder,
-      Messages::ValueMessageBuilder & builder) const
+      BUILDER & builder) const
     {
       PROFILE_POINT("int::decodeDefault");
       if(pmap.checkNextField())
@@ -455,13 +633,14 @@ namespace QuickFAST{
     }
 
     template<typename INTEGER_TYPE, ValueType::Type VALUE_TYPE, bool SIGNED>
+    template<typename BUILDER>
     void
     FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED>::
-    decodeDelta(
+    decodeDeltaImpl(
       Codecs::DataSource & source,
       Codecs::PresenceMap & /*pmap*/,
       Codecs::Decoder & decoder,
-      Messages::ValueMessageBuilder & builder) const
+      BUILDER & builder) const
     {
       PROFILE_POINT("int::decodeDelta");
       int64 delta;
@@ -494,25 +673,27 @@ namespace QuickFAST{
 
 
     template<typename INTEGER_TYPE, ValueType::Type VALUE_TYPE, bool SIGNED>
+    template<typename BUILDER>
     void
     FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED>::
-    decodeIncrement(
+    decodeIncrementImpl(
       Codecs::DataSource & source,
       Codecs::PresenceMap & pmap,
       Codecs::Decoder & decoder,
-      Messages::ValueMessageBuilder & builder) const
+      BUILDER & builder) const
     {
-      decodeIncrement(source, pmap.checkNextField(), decoder, builder);
+      decodeIncrementImpl(source, pmap.checkNextField(), decoder, builder);
     }
 
     template<typename INTEGER_TYPE, ValueType::Type VALUE_TYPE, bool SIGNED>
+    template<typename BUILDER>
     void
     FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED>::
-    decodeIncrement(
+    decodeIncrementImpl(
         Codecs::DataSource & source,
         bool pmapValue,
         Codecs::Decoder & decoder,
-        Messages::ValueMessageBuilder & builder) const
+        BUILDER & builder) const
     {
       PROFILE_POINT("int::decodeIncrement");
       if(pmapValue)
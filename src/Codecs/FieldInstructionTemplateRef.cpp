@@ -20,12 +20,14 @@ FieldInstructionStaticTemplateRef::FieldInstructionStaticTemplateRef(
   , templateNamespace_(fieldNamespace)
   , isFinalized_(false)
   , fieldCount_(0)
+  , flatten_(false)
 {
 }
 
 FieldInstructionStaticTemplateRef::FieldInstructionStaticTemplateRef()
   : isFinalized_(false)
   , fieldCount_(0)
+  , flatten_(false)
 {
 }
 
@@ -54,6 +56,7 @@ FieldInstructionStaticTemplateRef::finalize(TemplateRegistry & templateRegistry)
   // subtract one for the template ID
   presenceMapBitsUsed_ = target->presenceMapBitCount() - 1;
   fieldCount_ = target->fieldCount();
+  flatten_ = templateRegistry.flattenGroups();
   isFinalized_ = true;
 }
 
@@ -70,7 +73,7 @@ FieldInstructionStaticTemplateRef::decodeNop(
     decoder.reportFatal("[ERR D9]", "Unknown template name for static templateref.", *identity_);
   }
 
-  if(messageBuilder.getApplicationType() != target->getApplicationType())
+  if(!flatten_ && messageBuilder.getApplicationType() != target->getApplicationType())
   {
     Messages::ValueMessageBuilder & groupBuilder(
       messageBuilder.startGroup(
@@ -117,7 +120,7 @@ FieldInstructionStaticTemplateRef::encodeNop(
   // retrieve the field corresponding to this templateRef
   // which if it exists should be a FieldGroup
   const QuickFAST::Messages::MessageAccessor * group;
-  if(accessor.getGroup(*identity_, group))
+  if(!flatten_ && accessor.getGroup(*identity_, group))
   {
     encoder.encodeSegmentBody(
       destination,
@@ -157,6 +160,12 @@ FieldInstructionStaticTemplateRef::fieldInstructionType()const
   return ValueType::TEMPLATEREF;
 }
 
+bool
+FieldInstructionStaticTemplateRef::getTarget(const Context & context, TemplateCPtr & target)const
+{
+  return context.findTemplate(templateName_, templateNamespace_, target);
+}
+
 
 /////////////////////////////////////
 // FieldInstructionDynamicTemplateRef
@@ -10,6 +10,9 @@
 namespace QuickFAST{
   namespace Codecs{
     /// @brief Implement static &lt;templateRef> field instruction.
+    ///
+    /// If the TemplateRegistry flattens groups, the referenced template's fields
+    /// are always decoded into the current builder.
     class QuickFAST_Export FieldInstructionStaticTemplateRef : public FieldInstruction
     {
     public:
@@ -43,6 +46,12 @@ namespace QuickFAST{
         const Messages::MessageAccessor & accessor) const;
       virtual ValueType::Type fieldInstructionType()const;
 
+      /// @brief Find the template to which this instruction refers.
+      /// @param context supplies the templates.
+      /// @param[out] target is set to point to the template.
+      /// @returns true if the template was found.
+      bool getTarget(const Context & context, TemplateCPtr & target)const;
+
     private:
       void interpretValue(const std::string & value);
 
@@ -51,6 +60,7 @@ namespace QuickFAST{
       std::string templateNamespace_;
       bool isFinalized_;
       size_t fieldCount_; // how many fields are in the target template (valid after finalize has been called)
+      bool flatten_; // decode into the parent regardless of application type
     };
 
     /// @brief Implement dynamic &lt;templateRef> field instruction.
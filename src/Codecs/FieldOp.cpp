@@ -6,6 +6,7 @@
 #include <Codecs/DictionaryIndexer.h>
 #include <Codecs/Context.h>
 #include <Common/Exceptions.h>
+#include <Common/MemoryFootprint.h>
 
 using namespace QuickFAST;
 using namespace Codecs;
@@ -99,3 +100,13 @@ FieldOp::opName(OpType type)
   static const std::string unknown("UNKNOWN");
   return unknown;
 }
+
+void
+FieldOp::footprint(MemoryFootprint & footprint) const
+{
+  footprint.add("registry.instructions", sizeof(FieldOp));
+  footprint.addString("registry.strings", value_);
+  footprint.addString("registry.strings", key_);
+  footprint.addString("registry.strings", keyNamespace_);
+  footprint.addString("registry.strings", dictionaryName_);
+}
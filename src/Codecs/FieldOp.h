@@ -105,6 +105,10 @@ namespace QuickFAST{
         return value_;
       }
 
+      /// @brief Add the bytes held by this operator to a footprint.
+      /// @param footprint accumulates the result.
+      void footprint(MemoryFootprint & footprint)const;
+
       /// @brief Implement the value= attribute
       /// @param value from the value= attribute.
       void setValue(const std::string & value)
@@ -123,6 +127,15 @@ namespace QuickFAST{
         pmapBitValid_ = true;
       }
 
+      /// @brief Get the pmap bit to be used for this field (if any)
+      /// @param[out] pmapBit is the bit set by setPMapBit()
+      /// @returns true if a specific bit is to be used.
+      bool getPMapBit(size_t & pmapBit)const
+      {
+        pmapBit = pmapBit_;
+        return pmapBitValid_;
+      }
+
       /// @brief Implement the key= attribute
       /// @param key is the value of the attribute.
       void setKey(const std::string & key)
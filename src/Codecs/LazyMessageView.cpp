@@ -0,0 +1,590 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "LazyMessageView.h"
+#include <Codecs/Decoder.h>
+#include <Codecs/DataSource.h>
+#include <Codecs/DataSourceBuffer.h>
+#include <Codecs/FieldInstruction.h>
+#include <Codecs/FieldInstructionDecimal.h>
+#include <Codecs/FieldOp.h>
+#include <Messages/FieldIdentity.h>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+LazyMessageView::ValueCapture::ValueCapture()
+  : kind_(NONE)
+  , unsigned_(0)
+  , signed_(0)
+{
+}
+
+void
+LazyMessageView::ValueCapture::addValue(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const int64 value)
+{
+  kind_ = SIGNED;
+  signed_ = value;
+}
+
+void
+LazyMessageView::ValueCapture::addValue(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const uint64 value)
+{
+  kind_ = UNSIGNED;
+  unsigned_ = value;
+}
+
+void
+LazyMessageView::ValueCapture::addValue(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const int32 value)
+{
+  kind_ = SIGNED;
+  signed_ = value;
+}
+
+void
+LazyMessageView::ValueCapture::addValue(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const uint32 value)
+{
+  kind_ = UNSIGNED;
+  unsigned_ = value;
+}
+
+void
+LazyMessageView::ValueCapture::addValue(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const int16 value)
+{
+  kind_ = SIGNED;
+  signed_ = value;
+}
+
+void
+LazyMessageView::ValueCapture::addValue(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const uint16 value)
+{
+  kind_ = UNSIGNED;
+  unsigned_ = value;
+}
+
+void
+LazyMessageView::ValueCapture::addValue(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const int8 value)
+{
+  kind_ = SIGNED;
+  signed_ = value;
+}
+
+void
+LazyMessageView::ValueCapture::addValue(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const uchar value)
+{
+  kind_ = UNSIGNED;
+  unsigned_ = value;
+}
+
+void
+LazyMessageView::ValueCapture::addValue(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const Decimal& value)
+{
+  kind_ = DECIMAL;
+  decimal_ = value;
+}
+
+void
+LazyMessageView::ValueCapture::addValue(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const unsigned char * value, size_t length)
+{
+  kind_ = STRING;
+  // The capture is reused by every message, so don't grow into a per-message Allocator.
+  string_.reserve(length, Allocator::bufferAllocator());
+  string_.assign(value, length);
+}
+
+void
+LazyMessageView::ValueCapture::addInternedValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length, uint32 /*id*/)
+{
+  addValue(identity, type, value, length);
+}
+
+bool
+LazyMessageView::ValueCapture::startByteVector(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, size_t /*length*/)
+{
+  // the whole value is needed.
+  return false;
+}
+
+LazyMessageView::LazyMessageView(Decoder & decoder)
+  : decoder_(decoder)
+  , encoded_(0)
+  , present_(1)
+  , captured_(0)
+{
+  present_.setNextField(true);
+}
+
+LazyMessageView::~LazyMessageView()
+{
+}
+
+bool
+LazyMessageView::isViewable(const SegmentBody & segment)
+{
+  size_t instructionCount = segment.size();
+  for(size_t nField = 0; nField < instructionCount; ++nField)
+  {
+    const FieldInstructionCPtr & instruction = segment.getInstruction(nField);
+    FieldOp::OpType opType = instruction->getFieldOp()->opType();
+    if(opType != FieldOp::NOP && opType != FieldOp::CONSTANT)
+    {
+      return false;
+    }
+    switch(instruction->fieldInstructionType())
+    {
+    case ValueType::INT8:
+    case ValueType::UINT8:
+    case ValueType::INT16:
+    case ValueType::UINT16:
+    case ValueType::INT32:
+    case ValueType::UINT32:
+    case ValueType::INT64:
+    case ValueType::UINT64:
+    case ValueType::ASCII:
+    case ValueType::UTF8:
+    case ValueType::BYTEVECTOR:
+      break;
+    case ValueType::DECIMAL:
+    {
+      // An exponent or mantissa with its own operator may use a dictionary.
+      const FieldInstructionDecimal * decimal =
+        dynamic_cast<const FieldInstructionDecimal *>(instruction.get());
+      FieldInstructionCPtr component;
+      if(decimal == 0
+        || decimal->getExponentInstruction(component)
+        || decimal->getMantissaInstruction(component))
+      {
+        return false;
+      }
+      break;
+    }
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+namespace
+{
+  /// @brief Scan a message that lies entirely within the DataSource's current buffer.
+  class InPlaceReader
+  {
+  public:
+    InPlaceReader(const uchar * data, size_t size)
+      : data_(data)
+      , size_(size)
+      , used_(0)
+    {
+    }
+
+    bool getByte(uchar & byte)
+    {
+      if(used_ >= size_)
+      {
+        return false;
+      }
+      byte = data_[used_++];
+      return true;
+    }
+
+    bool getBytes(uint64 length)
+    {
+      if(length > size_ - used_)
+      {
+        return false;
+      }
+      used_ += size_t(length);
+      return true;
+    }
+
+    size_t used()const
+    {
+      return used_;
+    }
+
+    uchar at(size_t offset)const
+    {
+      return data_[offset];
+    }
+
+  private:
+    const uchar * data_;
+    size_t size_;
+    size_t used_;
+  };
+
+  /// @brief Scan a message that spans DataSource buffers, copying the encoded bytes.
+  class CopyReader
+  {
+  public:
+    CopyReader(DataSource & source, std::vector<uchar> & bytes)
+      : source_(source)
+      , bytes_(bytes)
+    {
+    }
+
+    bool getByte(uchar & byte)
+    {
+      if(!source_.getByte(byte))
+      {
+        return false;
+      }
+      bytes_.push_back(byte);
+      return true;
+    }
+
+    bool getBytes(uint64 length)
+    {
+      while(length > 0)
+      {
+        const uchar * chunk = 0;
+        size_t size = source_.getContiguous(size_t(length), chunk);
+        if(size == 0)
+        {
+          return false;
+        }
+        bytes_.insert(bytes_.end(), chunk, chunk + size);
+        length -= size;
+      }
+      return true;
+    }
+
+    size_t used()const
+    {
+      return bytes_.size();
+    }
+
+    uchar at(size_t offset)const
+    {
+      return bytes_[offset];
+    }
+
+  private:
+    DataSource & source_;
+    std::vector<uchar> & bytes_;
+  };
+}
+
+void
+LazyMessageView::scan(DataSource & source, PresenceMap & pmap, const TemplateCPtr & templatePtr)
+{
+  if(!templatePtr->isViewable())
+  {
+    throw UsageError("Coding Error", "LazyMessageView: template cannot be viewed.");
+  }
+  template_ = templatePtr;
+  size_t instructionCount = template_->size();
+  entries_.resize(instructionCount);
+  captured_ = instructionCount;
+
+  const uchar * buffer = 0;
+  size_t available = source.peekContiguous(buffer);
+  InPlaceReader inPlace(buffer, available);
+  if(scanFields(inPlace) == instructionCount)
+  {
+    source.skipContiguous(inPlace.used());
+    encoded_ = buffer;
+  }
+  else
+  {
+    // The message continues in the next buffer.  Start over, keeping a copy.
+    bytes_.clear();
+    CopyReader copy(source, bytes_);
+    size_t failed = scanFields(copy);
+    if(failed < instructionCount)
+    {
+      decoder_.reportFatal("[ERR U03]", "Unexpected end of data in lazy message.",
+        *template_->getInstruction(failed)->getIdentity());
+    }
+    encoded_ = bytes_.empty() ? 0 : &bytes_[0];
+  }
+
+  // constant fields have no encoded bytes, but an optional one uses the presence map.
+  for(size_t nField = 0; nField < instructionCount; ++nField)
+  {
+    const FieldInstruction & instruction = *template_->getInstruction(nField);
+    if(instruction.getFieldOp()->opType() == FieldOp::CONSTANT)
+    {
+      entries_[nField].present_ = instruction.isMandatory() || pmap.checkNextField();
+    }
+  }
+}
+
+template<typename READER>
+size_t
+LazyMessageView::scanFields(READER & reader)
+{
+  size_t instructionCount = entries_.size();
+  for(size_t nField = 0; nField < instructionCount; ++nField)
+  {
+    const FieldInstruction & instruction = *template_->getInstruction(nField);
+    bool mandatory = instruction.isMandatory();
+    Entry & entry = entries_[nField];
+    entry.offset_ = reader.used();
+    entry.present_ = true;
+    if(instruction.getFieldOp()->opType() != FieldOp::CONSTANT)
+    {
+      switch(instruction.fieldInstructionType())
+      {
+      case ValueType::DECIMAL:
+        if(!scanEntity(reader))
+        {
+          return nField;
+        }
+        if(!mandatory && reader.used() == entry.offset_ + 1 && reader.at(entry.offset_) == 0x80)
+        {
+          entry.present_ = false;
+        }
+        else if(!scanEntity(reader))
+        {
+          return nField;
+        }
+        break;
+      case ValueType::UTF8:
+      case ValueType::BYTEVECTOR:
+      {
+        uint64 length = 0;
+        if(!scanUnsigned(reader, length))
+        {
+          return nField;
+        }
+        if(!mandatory)
+        {
+          if(length == 0)
+          {
+            entry.present_ = false;
+            break;
+          }
+          --length;
+        }
+        if(!reader.getBytes(length))
+        {
+          return nField;
+        }
+        break;
+      }
+      default:
+        // integers and ASCII strings: a lone 0x80 is null if the field is optional.
+        if(!scanEntity(reader))
+        {
+          return nField;
+        }
+        entry.present_ = mandatory
+          || reader.used() != entry.offset_ + 1
+          || reader.at(entry.offset_) != 0x80;
+        break;
+      }
+    }
+    entry.length_ = reader.used() - entry.offset_;
+  }
+  return instructionCount;
+}
+
+template<typename READER>
+bool
+LazyMessageView::scanEntity(READER & reader)
+{
+  uchar byte = 0;
+  do
+  {
+    if(!reader.getByte(byte))
+    {
+      return false;
+    }
+  } while((byte & 0x80) == 0);
+  return true;
+}
+
+template<typename READER>
+bool
+LazyMessageView::scanUnsigned(READER & reader, uint64 & value)
+{
+  size_t start = reader.used();
+  if(!scanEntity(reader))
+  {
+    return false;
+  }
+  value = 0;
+  for(size_t pos = start; pos < reader.used(); ++pos)
+  {
+    value = (value << 7) | (reader.at(pos) & 0x7F);
+  }
+  return true;
+}
+
+void
+LazyMessageView::decodeTo(Messages::ValueMessageBuilder & builder)const
+{
+  size_t instructionCount = entries_.size();
+  for(size_t nField = 0; nField < instructionCount; ++nField)
+  {
+    const Entry & entry = entries_[nField];
+    if(entry.present_)
+    {
+      DataSourceBuffer source(encoded_ + entry.offset_, entry.length_);
+      present_.rewind();
+      template_->getInstruction(nField)->decode(source, present_, decoder_, builder);
+    }
+  }
+}
+
+bool
+LazyMessageView::decodeField(size_t index, ValueCapture::Kind kind)const
+{
+  const Entry & entry = entries_[index];
+  if(!entry.present_)
+  {
+    return false;
+  }
+  if(captured_ != index)
+  {
+    DataSourceBuffer source(encoded_ + entry.offset_, entry.length_);
+    present_.rewind();
+    capture_.clear();
+    captured_ = index;
+    template_->getInstruction(index)->decode(source, present_, decoder_, capture_);
+  }
+  return capture_.kind_ == kind;
+}
+
+bool
+LazyMessageView::findField(const Messages::FieldIdentity & identity, size_t & index)const
+{
+  size_t instructionCount = entries_.size();
+  for(size_t nField = 0; nField < instructionCount; ++nField)
+  {
+    if(*template_->getInstruction(nField)->getIdentity() == identity)
+    {
+      index = nField;
+      return true;
+    }
+  }
+  return false;
+}
+
+const FieldInstruction &
+LazyMessageView::getInstruction(size_t index)const
+{
+  return *template_->getInstruction(index);
+}
+
+void
+LazyMessageView::getEncoded(size_t index, const uchar *& bytes, size_t & length)const
+{
+  const Entry & entry = entries_[index];
+  bytes = encoded_ + entry.offset_;
+  length = entry.length_;
+}
+
+bool
+LazyMessageView::getUnsignedInteger(size_t index, uint64 & value)const
+{
+  if(!decodeField(index, ValueCapture::UNSIGNED))
+  {
+    return false;
+  }
+  value = capture_.unsigned_;
+  return true;
+}
+
+bool
+LazyMessageView::getSignedInteger(size_t index, int64 & value)const
+{
+  if(!decodeField(index, ValueCapture::SIGNED))
+  {
+    return false;
+  }
+  value = capture_.signed_;
+  return true;
+}
+
+bool
+LazyMessageView::getDecimal(size_t index, Decimal & value)const
+{
+  if(!decodeField(index, ValueCapture::DECIMAL))
+  {
+    return false;
+  }
+  value = capture_.decimal_;
+  return true;
+}
+
+bool
+LazyMessageView::getString(size_t index, const StringBuffer *& value)const
+{
+  if(!decodeField(index, ValueCapture::STRING))
+  {
+    return false;
+  }
+  value = &capture_.string_;
+  return true;
+}
+
+bool
+LazyMessageView::isPresent(const Messages::FieldIdentity & identity)const
+{
+  size_t index;
+  return findField(identity, index) && isPresent(index);
+}
+
+bool
+LazyMessageView::getUnsignedInteger(const Messages::FieldIdentity & identity, ValueType::Type /*type*/, uint64 & value)const
+{
+  size_t index;
+  return findField(identity, index) && getUnsignedInteger(index, value);
+}
+
+bool
+LazyMessageView::getSignedInteger(const Messages::FieldIdentity & identity, ValueType::Type /*type*/, int64 & value)const
+{
+  size_t index;
+  return findField(identity, index) && getSignedInteger(index, value);
+}
+
+bool
+LazyMessageView::getDecimal(const Messages::FieldIdentity & identity, ValueType::Type /*type*/, Decimal & value)const
+{
+  size_t index;
+  return findField(identity, index) && getDecimal(index, value);
+}
+
+bool
+LazyMessageView::getString(const Messages::FieldIdentity & identity, ValueType::Type /*type*/, const StringBuffer *& value)const
+{
+  size_t index;
+  return findField(identity, index) && getString(index, value);
+}
+
+bool
+LazyMessageView::getGroup(const Messages::FieldIdentity & /*identity*/, const Messages::MessageAccessor *& /*group*/)const
+{
+  // viewable templates have no groups
+  return false;
+}
+
+bool
+LazyMessageView::getSequenceLength(const Messages::FieldIdentity & /*identity*/, size_t & /*length*/)const
+{
+  // viewable templates have no sequences
+  return false;
+}
+
+bool
+LazyMessageView::getSequenceEntry(const Messages::FieldIdentity & /*identity*/, size_t /*index*/, const Messages::MessageAccessor *& /*entry*/)const
+{
+  return false;
+}
+
+const std::string &
+LazyMessageView::getApplicationType()const
+{
+  return template_->getApplicationType();
+}
+
+const std::string &
+LazyMessageView::getApplicationTypeNs()const
+{
+  return template_->getApplicationTypeNamespace();
+}
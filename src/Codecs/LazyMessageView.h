@@ -0,0 +1,210 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef LAZYMESSAGEVIEW_H
+#define LAZYMESSAGEVIEW_H
+#include "LazyMessageView_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Codecs/Decoder_fwd.h>
+#include <Codecs/DataSource_fwd.h>
+#include <Codecs/PresenceMap.h>
+#include <Codecs/Template.h>
+#include <Codecs/FieldInstruction_fwd.h>
+#include <Messages/MessageAccessor.h>
+#include <Messages/NullMessageBuilder.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief A message whose fields are decoded only when they are requested.
+    ///
+    /// When a template has only scalar fields and every field has no operator or
+    /// the constant operator, decoding a field does not depend on any dictionary.
+    /// The Decoder can then locate each field with a quick scan of the stop bits,
+    /// recording where the encoded bytes are, and leave the decoding to the application.
+    /// An application that needs only a few fields of a large message (reference data,
+    /// for example) saves the cost of decoding the rest.
+    ///
+    /// The TemplateRegistry marks qualifying templates when it is finalized
+    /// (see Template::isViewable()).  Use Decoder::setLazyMessages() to enable
+    /// delivery via ValueMessageBuilder::lazyMessage() to builders whose
+    /// acceptsLazyMessages() returns true.
+    ///
+    /// Fields can be found by identity using the MessageAccessor interface, or by
+    /// position in the template using the methods that take an index.
+    /// When the whole message is in the DataSource's current buffer the view refers to
+    /// the encoded bytes where they are.  A message that continues into the next buffer
+    /// (a byte vector split across packets, for example) is copied during the scan
+    /// because the DataSource may release the earlier buffer.  Either way the view is
+    /// valid until the next read from the DataSource, which is to say during
+    /// ValueMessageBuilder::lazyMessage().  Only the most recently decoded value is kept.
+    class QuickFAST_Export LazyMessageView : public Messages::MessageAccessor
+    {
+    public:
+      /// @brief Construct.
+      /// @param decoder is used to decode individual fields.
+      explicit LazyMessageView(Decoder & decoder);
+
+      virtual ~LazyMessageView();
+
+      /// @brief Can messages using this segment be delivered as a LazyMessageView?
+      /// @param segment is the template (or other segment) to be checked.
+      /// @returns true if every field is a scalar with no operator or the constant operator.
+      static bool isViewable(const SegmentBody & segment);
+
+      /// @brief Locate the fields of the next message.
+      ///
+      /// The presence map and template ID have already been read.
+      /// @param source supplies the encoded message.
+      /// @param pmap is the presence map for the message.
+      /// @param templatePtr defines the message.  It must be viewable.
+      void scan(DataSource & source, PresenceMap & pmap, const TemplateCPtr & templatePtr);
+
+      /// @brief Decode every field and pass it to a builder.
+      /// @param builder receives the values.
+      void decodeTo(Messages::ValueMessageBuilder & builder)const;
+
+      /// @brief The template that defines this message.
+      const Template & getTemplate()const
+      {
+        return *template_;
+      }
+
+      /// @brief How many fields are defined for this message.
+      size_t size()const
+      {
+        return entries_.size();
+      }
+
+      /// @brief Find the position of a field.
+      /// @param identity identifies the field.
+      /// @param[out] index is the position of the field.
+      /// @returns true if the field is defined in this message.
+      bool findField(const Messages::FieldIdentity & identity, size_t & index)const;
+
+      /// @brief Access the instruction that defines a field.
+      /// @param index is the position of the field.
+      const FieldInstruction & getInstruction(size_t index)const;
+
+      /// @brief Is a field present?  (Without decoding it.)
+      /// @param index is the position of the field.
+      bool isPresent(size_t index)const
+      {
+        return entries_[index].present_;
+      }
+
+      /// @brief Access the encoded bytes for a field.
+      ///
+      /// Fields with the constant operator have no encoded bytes.
+      /// @param index is the position of the field.
+      /// @param[out] bytes points to the encoded field.
+      /// @param[out] length is the number of bytes in the encoded field.
+      void getEncoded(size_t index, const uchar *& bytes, size_t & length)const;
+
+      /// @brief Decode an unsigned integer field.
+      /// @param index is the position of the field.
+      /// @param[out] value is the decoded value.
+      /// @returns true if the field is present and is an unsigned integer.
+      bool getUnsignedInteger(size_t index, uint64 & value)const;
+
+      /// @brief Decode a signed integer field.
+      /// @param index is the position of the field.
+      /// @param[out] value is the decoded value.
+      /// @returns true if the field is present and is a signed integer.
+      bool getSignedInteger(size_t index, int64 & value)const;
+
+      /// @brief Decode a decimal field.
+      /// @param index is the position of the field.
+      /// @param[out] value is the decoded value.
+      /// @returns true if the field is present and is a decimal.
+      bool getDecimal(size_t index, Decimal & value)const;
+
+      /// @brief Decode a string or byte vector field.
+      /// @param index is the position of the field.
+      /// @param[out] value points to the decoded value.  It is valid until the next field is decoded.
+      /// @returns true if the field is present and is a string or byte vector.
+      bool getString(size_t index, const StringBuffer *& value)const;
+
+      ///////////////////////////
+      // Implement MessageAccessor
+      virtual bool isPresent(const Messages::FieldIdentity & identity)const;
+      virtual bool getUnsignedInteger(const Messages::FieldIdentity & identity, ValueType::Type type, uint64 & value)const;
+      virtual bool getSignedInteger(const Messages::FieldIdentity & identity, ValueType::Type type, int64 & value)const;
+      virtual bool getDecimal(const Messages::FieldIdentity & identity, ValueType::Type type, Decimal & value)const;
+      virtual bool getString(const Messages::FieldIdentity & identity, ValueType::Type type, const StringBuffer *& value)const;
+      virtual bool getGroup(const Messages::FieldIdentity & identity, const Messages::MessageAccessor *& group)const;
+      virtual bool getSequenceLength(const Messages::FieldIdentity & identity, size_t & length)const;
+      virtual bool getSequenceEntry(const Messages::FieldIdentity & identity, size_t index, const Messages::MessageAccessor *& entry)const;
+      virtual const std::string & getApplicationType()const;
+      virtual const std::string & getApplicationTypeNs()const;
+
+    private:
+      /// @brief Capture the value of a single field as it is decoded.
+      class ValueCapture : public Messages::NullMessageBuilder
+      {
+      public:
+        enum Kind {NONE, UNSIGNED, SIGNED, DECIMAL, STRING};
+        ValueCapture();
+        void clear()
+        {
+          kind_ = NONE;
+        }
+        Kind kind_;
+        uint64 unsigned_;
+        int64 signed_;
+        Decimal decimal_;
+        StringBuffer string_;
+
+        virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int64 value);
+        virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint64 value);
+        virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int32 value);
+        virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint32 value);
+        virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int16 value);
+        virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uint16 value);
+        virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const int8 value);
+        virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uchar value);
+        virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const Decimal& value);
+        virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length);
+        virtual void addInternedValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length, uint32 id);
+        virtual bool startByteVector(Messages::FieldIdentityCPtr & identity, ValueType::Type type, size_t length);
+      };
+
+      struct Entry
+      {
+        size_t offset_;
+        size_t length_;
+        bool present_;
+      };
+
+    private:
+      bool decodeField(size_t index, ValueCapture::Kind kind)const;
+      template<typename READER>
+      size_t scanFields(READER & reader);
+      template<typename READER>
+      bool scanEntity(READER & reader);
+      template<typename READER>
+      bool scanUnsigned(READER & reader, uint64 & value);
+
+    private:
+      LazyMessageView(const LazyMessageView &);
+      LazyMessageView & operator=(const LazyMessageView &);
+
+    private:
+      Decoder & decoder_;
+      TemplateCPtr template_;
+      /// the encoded message: in the DataSource's buffer or in bytes_
+      const uchar * encoded_;
+      /// a copy of a message that spans DataSource buffers
+      std::vector<uchar> bytes_;
+      std::vector<Entry> entries_;
+      /// a presence map that says "present" for constant fields
+      mutable PresenceMap present_;
+      mutable ValueCapture capture_;
+      /// index of the field held by capture_ (or size() if none)
+      mutable size_t captured_;
+    };
+  }
+}
+#endif // LAZYMESSAGEVIEW_H
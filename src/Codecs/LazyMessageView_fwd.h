@@ -0,0 +1,16 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef LAZYMESSAGEVIEW_FWD_H
+#define LAZYMESSAGEVIEW_FWD_H
+namespace QuickFAST{
+  namespace Codecs{
+    class LazyMessageView;
+    /// @brief A smart pointer to a LazyMessageView.
+    typedef boost::shared_ptr<LazyMessageView> LazyMessageViewPtr;
+  }
+}
+#endif // LAZYMESSAGEVIEW_FWD_H
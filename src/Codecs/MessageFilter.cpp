@@ -0,0 +1,230 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "MessageFilter.h"
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/Template.h>
+#include <Codecs/FieldInstruction.h>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+namespace
+{
+  /// @brief Compare two values that may have been stored as different types.
+  /// @param lhs the left hand value
+  /// @param rhs the right hand value
+  /// @param result is set to <0, 0, or >0
+  /// @returns false if the values can not be compared.
+  bool compareValues(const Value & lhs, const Value & rhs, int & result)
+  {
+    if(lhs.isString() && rhs.isString())
+    {
+      const unsigned char * lhsData = 0;
+      size_t lhsLength = 0;
+      const unsigned char * rhsData = 0;
+      size_t rhsLength = 0;
+      lhs.getValue(lhsData, lhsLength);
+      rhs.getValue(rhsData, rhsLength);
+      size_t length = std::min(lhsLength, rhsLength);
+      result = (length == 0) ? 0 : std::memcmp(lhsData, rhsData, length);
+      if(result == 0)
+      {
+        result = (lhsLength < rhsLength) ? -1 : ((lhsLength > rhsLength) ? 1 : 0);
+      }
+      return true;
+    }
+    if(!lhs.isNumeric() || !rhs.isNumeric() || lhs.isNull() || rhs.isNull())
+    {
+      return false;
+    }
+
+    if(lhs.isUnsignedInteger() && rhs.isUnsignedInteger())
+    {
+      uint64 l = lhs.getUnsignedInteger();
+      uint64 r = rhs.getUnsignedInteger();
+      result = (l < r) ? -1 : ((l > r) ? 1 : 0);
+      return true;
+    }
+    if(lhs.isSignedInteger() && rhs.isSignedInteger())
+    {
+      int64 l = lhs.getSignedInteger();
+      int64 r = rhs.getSignedInteger();
+      result = (l < r) ? -1 : ((l > r) ? 1 : 0);
+      return true;
+    }
+    if(lhs.isSignedInteger() && rhs.isUnsignedInteger())
+    {
+      int64 l = lhs.getSignedInteger();
+      uint64 r = rhs.getUnsignedInteger();
+      result = (l < 0 || uint64(l) < r) ? -1 : ((uint64(l) > r) ? 1 : 0);
+      return true;
+    }
+    if(lhs.isUnsignedInteger() && rhs.isSignedInteger())
+    {
+      uint64 l = lhs.getUnsignedInteger();
+      int64 r = rhs.getSignedInteger();
+      result = (r < 0 || l > uint64(r)) ? 1 : ((l < uint64(r)) ? -1 : 0);
+      return true;
+    }
+
+    // at least one is a decimal.
+    Decimal l;
+    Decimal r;
+    if(!lhs.getValue(l))
+    {
+      l = lhs.isSignedInteger()
+        ? Decimal(lhs.getSignedInteger(), 0)
+        : Decimal(static_cast<mantissa_t>(lhs.getUnsignedInteger()), 0);
+    }
+    if(!rhs.getValue(r))
+    {
+      r = rhs.isSignedInteger()
+        ? Decimal(rhs.getSignedInteger(), 0)
+        : Decimal(static_cast<mantissa_t>(rhs.getUnsignedInteger()), 0);
+    }
+    result = (l < r) ? -1 : ((l == r) ? 0 : 1);
+    return true;
+  }
+}
+
+bool
+MessageFilter::Predicate::test(const Value & value) const
+{
+  int result = 0;
+  switch(type_)
+  {
+  case EQUALS:
+    return compareValues(value, values_[0], result) && result == 0;
+  case IN:
+    for(std::vector<Value>::const_iterator it = values_.begin();
+      it != values_.end();
+      ++it)
+    {
+      if(compareValues(value, *it, result) && result == 0)
+      {
+        return true;
+      }
+    }
+    return false;
+  case RANGE:
+    if(!compareValues(value, values_[0], result) || result < 0)
+    {
+      return false;
+    }
+    return compareValues(value, values_[1], result) && result <= 0;
+  }
+  return false;
+}
+
+MessageFilter::MessageFilter()
+  : resolved_(true)
+  , acceptUnfiltered_(true)
+  , accepted_(0)
+  , rejected_(0)
+{
+}
+
+MessageFilter::~MessageFilter()
+{
+}
+
+void
+MessageFilter::addEquals(
+  template_id_t templateId,
+  const std::string & fieldName,
+  const Value & value)
+{
+  Predicate predicate;
+  predicate.type_ = EQUALS;
+  predicate.fieldName_ = fieldName;
+  predicate.values_.push_back(value);
+  addPredicate(templateId, predicate);
+}
+
+void
+MessageFilter::addIn(
+  template_id_t templateId,
+  const std::string & fieldName,
+  const std::vector<Value> & values)
+{
+  Predicate predicate;
+  predicate.type_ = IN;
+  predicate.fieldName_ = fieldName;
+  predicate.values_ = values;
+  addPredicate(templateId, predicate);
+}
+
+void
+MessageFilter::addRange(
+  template_id_t templateId,
+  const std::string & fieldName,
+  const Value & low,
+  const Value & high)
+{
+  Predicate predicate;
+  predicate.type_ = RANGE;
+  predicate.fieldName_ = fieldName;
+  predicate.values_.push_back(low);
+  predicate.values_.push_back(high);
+  addPredicate(templateId, predicate);
+}
+
+void
+MessageFilter::addPredicate(template_id_t templateId, const Predicate & predicate)
+{
+  TemplatePredicates & predicates = templates_[templateId];
+  predicates.predicates_.push_back(predicate);
+  // force resolve() to be called again.
+  predicates.byField_.clear();
+  resolved_ = false;
+}
+
+void
+MessageFilter::resolve(const TemplateRegistry & registry)
+{
+  for(TemplateMap::iterator it = templates_.begin(); it != templates_.end(); ++it)
+  {
+    TemplateCPtr templatePtr;
+    if(!registry.getTemplate(it->first, templatePtr))
+    {
+      std::stringstream msg;
+      msg << "Filter refers to unknown template ID: " << it->first;
+      throw TemplateDefinitionError(msg.str());
+    }
+    TemplatePredicates & predicates = it->second;
+    predicates.byField_.clear();
+    predicates.byField_.resize(templatePtr->size());
+    for(std::vector<Predicate>::const_iterator pit = predicates.predicates_.begin();
+      pit != predicates.predicates_.end();
+      ++pit)
+    {
+      size_t index = templatePtr->instructionIndex(pit->fieldName_);
+      if(index >= templatePtr->size())
+      {
+        std::stringstream msg;
+        msg << "Filter refers to unknown field " << pit->fieldName_
+          << " in template ID: " << it->first;
+        throw TemplateDefinitionError(msg.str());
+      }
+      switch(templatePtr->getInstruction(index)->fieldInstructionType())
+      {
+      case ValueType::SEQUENCE:
+      case ValueType::GROUP:
+      case ValueType::TEMPLATEREF:
+      case ValueType::TYPEREF:
+        {
+          std::stringstream msg;
+          msg << "Filter can not be applied to compound field " << pit->fieldName_
+            << " in template ID: " << it->first;
+          throw TemplateDefinitionError(msg.str());
+        }
+      default:
+        break;
+      }
+      predicates.byField_[index].push_back(*pit);
+    }
+  }
+  resolved_ = true;
+}
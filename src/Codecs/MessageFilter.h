@@ -0,0 +1,199 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef MESSAGEFILTER_H
+#define MESSAGEFILTER_H
+#include "MessageFilter_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+#include <Common/Value.h>
+#include <Codecs/TemplateRegistry_fwd.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief A set of predicates to be applied to messages while they are being decoded.
+    ///
+    /// Each predicate names a template and a field within that template.  resolve() translates
+    /// the field name into the position of the field instruction within the template so that
+    /// the Decoder can test the value as soon as the field has been decoded.  The Decoder
+    /// resolves the filter when it is set and again before the next message whenever
+    /// predicates have been added since.
+    ///
+    /// When a predicate fails the Decoder finishes the message only to keep the dictionaries
+    /// up to date: fields that use the dictionary are decoded, but scalar fields with no
+    /// operator or with a constant or default operator are stepped over without being decoded.
+    /// Nothing more is passed to the application's ValueMessageBuilder, and the message is
+    /// finished by calling ignoreMessage() rather than endMessage().
+    ///
+    /// All predicates that apply to a template must succeed for a message to be accepted.
+    /// A field that is absent from the message (an optional field that is NULL) fails
+    /// any predicate applied to it.  Byte vectors are compared as strings, even when the
+    /// builder receives them in chunks.
+    ///
+    /// Predicates may only be applied to scalar fields that appear directly in the template
+    /// -- not to fields within groups, sequences, or referenced templates.
+    class QuickFAST_Export MessageFilter
+    {
+    public:
+      /// @brief The kinds of test a predicate may apply.
+      enum PredicateType
+      {
+        EQUALS, ///< field value equals the given value
+        IN,     ///< field value equals one of the given values
+        RANGE   ///< low <= field value <= high
+      };
+
+      /// @brief A single test applied to a decoded field value.
+      struct Predicate
+      {
+        /// @brief the kind of test
+        PredicateType type_;
+        /// @brief the name of the field to be tested
+        std::string fieldName_;
+        /// @brief value(s) to compare: [0] for EQUALS; all for IN; [0] = low, [1] = high for RANGE
+        std::vector<Value> values_;
+
+        /// @brief apply this predicate to a decoded value
+        /// @param value is the value that was decoded (undefined if the field was absent)
+        /// @returns true if the value satisfies the predicate
+        bool test(const Value & value) const;
+      };
+
+      /// @brief The predicates that apply to one template, indexed by field position.
+      class TemplatePredicates
+      {
+      public:
+        /// @brief Find the predicates for a field in the template.
+        /// @param fieldIndex the position of the field instruction within the template.
+        /// @returns a pointer to the predicates to be applied or 0 if the field is not tested
+        const std::vector<Predicate> * find(size_t fieldIndex) const
+        {
+          if(fieldIndex < byField_.size() && !byField_[fieldIndex].empty())
+          {
+            return &byField_[fieldIndex];
+          }
+          return 0;
+        }
+
+      private:
+        friend class MessageFilter;
+        std::vector<Predicate> predicates_;
+        std::vector<std::vector<Predicate> > byField_;
+      };
+
+    public:
+      MessageFilter();
+      ~MessageFilter();
+
+      /// @brief Accept messages in which the field equals a value.
+      /// @param templateId identifies the template containing the field
+      /// @param fieldName names the field within the template
+      /// @param value the value to be matched
+      void addEquals(
+        template_id_t templateId,
+        const std::string & fieldName,
+        const Value & value);
+
+      /// @brief Accept messages in which the field matches any one of a set of values.
+      /// @param templateId identifies the template containing the field
+      /// @param fieldName names the field within the template
+      /// @param values the values to be matched
+      void addIn(
+        template_id_t templateId,
+        const std::string & fieldName,
+        const std::vector<Value> & values);
+
+      /// @brief Accept messages in which the field lies within a range of values.
+      /// @param templateId identifies the template containing the field
+      /// @param fieldName names the field within the template
+      /// @param low the lowest acceptable value (inclusive)
+      /// @param high the highest acceptable value (inclusive)
+      void addRange(
+        template_id_t templateId,
+        const std::string & fieldName,
+        const Value & low,
+        const Value & high);
+
+      /// @brief Should messages for templates that have no predicates be accepted?
+      ///
+      /// The default is true.  Set it to false to see only messages from templates
+      /// named in the filter.
+      /// @param accept true to accept messages from templates that are not mentioned.
+      void setAcceptUnfilteredTemplates(bool accept)
+      {
+        acceptUnfiltered_ = accept;
+      }
+
+      /// @brief Will messages for templates that have no predicates be accepted?
+      bool getAcceptUnfilteredTemplates()const
+      {
+        return acceptUnfiltered_;
+      }
+
+      /// @brief Translate field names into field positions.
+      ///
+      /// Throws TemplateDefinitionError if a predicate names an unknown template or field
+      /// or a field that cannot be tested.
+      /// @param registry contains the templates to be used for decoding.
+      void resolve(const TemplateRegistry & registry);
+
+      /// @brief Has resolve() been called since the last predicate was added?
+      bool isResolved()const
+      {
+        return resolved_;
+      }
+
+      /// @brief Find the predicates to be applied to a template
+      /// @param templateId identifies the template
+      /// @returns the predicates or 0 if there are none for this template.
+      const TemplatePredicates * findTemplate(template_id_t templateId) const
+      {
+        TemplateMap::const_iterator it = templates_.find(templateId);
+        if(it == templates_.end())
+        {
+          return 0;
+        }
+        return &it->second;
+      }
+
+      /// @brief Count a message that satisfied the filter.
+      void countAccepted()
+      {
+        ++accepted_;
+      }
+
+      /// @brief Count a message that was rejected by the filter.
+      void countRejected()
+      {
+        ++rejected_;
+      }
+
+      /// @brief How many messages have been accepted by the filter.
+      size_t accepted()const
+      {
+        return accepted_;
+      }
+
+      /// @brief How many messages have been rejected by the filter.
+      size_t rejected()const
+      {
+        return rejected_;
+      }
+
+    private:
+      void addPredicate(template_id_t templateId, const Predicate & predicate);
+
+    private:
+      typedef std::map<template_id_t, TemplatePredicates> TemplateMap;
+      TemplateMap templates_;
+      bool resolved_;
+      bool acceptUnfiltered_;
+      size_t accepted_;
+      size_t rejected_;
+    };
+  }
+}
+#endif // MESSAGEFILTER_H
@@ -0,0 +1,18 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef MESSAGEFILTER_FWD_H
+#define MESSAGEFILTER_FWD_H
+namespace QuickFAST{
+  namespace Codecs{
+    class MessageFilter;
+    /// @brief A smart pointer to a MessageFilter.
+    typedef boost::shared_ptr<MessageFilter> MessageFilterPtr;
+    /// @brief A smart pointer to a const MessageFilter.
+    typedef boost::shared_ptr<const MessageFilter> MessageFilterCPtr;
+  }
+}
+#endif // MESSAGEFILTER_FWD_H
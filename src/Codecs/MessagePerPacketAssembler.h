@@ -12,6 +12,7 @@
 #include <Codecs/Decoder.h>
 #include <Codecs/DataSource.h>
 #include <Codecs/HeaderAnalyzer.h>
+#include <Codecs/PCapMergeDecoder_fwd.h>
 #include <Codecs/TemplateRegistry_fwd.h>
 #include <Messages/ValueMessageBuilder_fwd.h>
 
@@ -84,6 +85,8 @@ namespace QuickFAST
       virtual bool getBuffer(const uchar *& buffer, size_t & size);
 
     private:
+      /// PCapMergeDecoder delivers packets that do not arrive via a Receiver.
+      friend class PCapMergeDecoder;
       bool consumeBuffer(const unsigned char * buffer, size_t size);
     private:
       MessagePerPacketAssembler & operator = (const MessagePerPacketAssembler &);
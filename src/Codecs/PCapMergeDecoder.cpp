@@ -0,0 +1,49 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "PCapMergeDecoder.h"
+#include <Codecs/MessagePerPacketAssembler.h>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+PCapMergeDecoder::PCapMergeDecoder()
+  : packetCount_(0)
+{
+}
+
+PCapMergeDecoder::~PCapMergeDecoder()
+{
+}
+
+bool
+PCapMergeDecoder::addChannel(
+  const std::string & filename,
+  MessagePerPacketAssembler & assembler,
+  size_t wordSize)
+{
+  if(!reader_.open(filename, wordSize))
+  {
+    return false;
+  }
+  assemblers_.push_back(&assembler);
+  return true;
+}
+
+bool
+PCapMergeDecoder::run(size_t packetLimit)
+{
+  bool more = true;
+  size_t channel = 0;
+  const unsigned char * buffer = 0;
+  size_t size = 0;
+  while(more
+    && (packetLimit == 0 || packetCount_ < packetLimit)
+    && reader_.read(channel, buffer, size))
+  {
+    ++packetCount_;
+    more = assemblers_[channel]->consumeBuffer(buffer, size);
+  }
+  return more;
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef PCAPMERGEDECODER_H
+#define PCAPMERGEDECODER_H
+#include "PCapMergeDecoder_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Codecs/MessagePerPacketAssembler_fwd.h>
+#include <Communication/PCapMergeReader.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief Decode several PCap captures (one per channel) in global time stamp order.
+    ///
+    /// Each channel is a PCap file paired with the MessagePerPacketAssembler that decodes it.
+    /// Because each assembler owns its own Decoder, each channel keeps its own dictionary.
+    /// Packets are delivered to the assemblers in capture time stamp order across all
+    /// channels, so the messages reach the builder(s) in merged order without having to
+    /// decode each file separately and sort the results.
+    ///
+    /// The same ValueMessageBuilder may be used by all of the assemblers.
+    class QuickFAST_Export PCapMergeDecoder
+    {
+    public:
+      PCapMergeDecoder();
+      ~PCapMergeDecoder();
+
+      /// @brief Add a channel to the merge.
+      ///
+      /// All channels must be added before run() is called.
+      /// @param filename names the PCap file containing the channel's packets
+      /// @param assembler will decode packets from this file.  It must outlive the PCapMergeDecoder.
+      /// @param wordSize is the word size of the platform where the file was captured (0 means native)
+      /// @returns true if the file was opened successfully.
+      bool addChannel(
+        const std::string & filename,
+        MessagePerPacketAssembler & assembler,
+        size_t wordSize = 0);
+
+      /// @brief Decode the packets from all channels in time stamp order.
+      ///
+      /// @param packetLimit stop after this many packets (zero means no limit)
+      /// @returns true if all packets were decoded; false if an assembler asked to stop.
+      bool run(size_t packetLimit = 0);
+
+      /// @brief How many packets have been decoded.
+      size_t packetCount()const
+      {
+        return packetCount_;
+      }
+
+      /// @brief The capture time of the packet most recently decoded.
+      /// @returns microseconds since the epoch.
+      uint64 timestamp()const
+      {
+        return reader_.timestamp();
+      }
+
+      /// @brief Access the underlying merging reader.
+      Communication::PCapMergeReader & reader()
+      {
+        return reader_;
+      }
+
+    private:
+      PCapMergeDecoder(const PCapMergeDecoder &);
+      PCapMergeDecoder & operator=(const PCapMergeDecoder &);
+
+    private:
+      Communication::PCapMergeReader reader_;
+      std::vector<MessagePerPacketAssembler *> assemblers_;
+      size_t packetCount_;
+    };
+  }
+}
+#endif // PCAPMERGEDECODER_H
@@ -0,0 +1,16 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef PCAPMERGEDECODER_FWD_H
+#define PCAPMERGEDECODER_FWD_H
+namespace QuickFAST{
+  namespace Codecs{
+    class PCapMergeDecoder;
+    /// @brief A smart pointer to a PCapMergeDecoder.
+    typedef boost::shared_ptr<PCapMergeDecoder> PCapMergeDecoderPtr;
+  }
+}
+#endif // PCAPMERGEDECODER_FWD_H
@@ -0,0 +1,705 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "PushEncoder.h"
+#include <Codecs/Template.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/SegmentBody.h>
+#include <Codecs/FieldInstruction.h>
+#include <Codecs/FieldInstructionTemplateRef.h>
+#include <Messages/SpecialAccessors.h>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+namespace
+{
+  void usageError(const std::string & description)
+  {
+    std::string message("PushEncoder: " + description);
+    throw UsageError("Coding Error", message.c_str());
+  }
+}
+
+PushEncoder::PushEncoder(Encoder & encoder, DataDestination & destination)
+  : encoder_(encoder)
+  , destination_(destination)
+  , depth_(0)
+  , resolvedDepth_(0)
+  , header_(0)
+{
+  optionalLength_.setPresence(false);
+}
+
+PushEncoder::~PushEncoder()
+{
+}
+
+void
+PushEncoder::startMessage(template_id_t templateId)
+{
+  if(depth_ != 0)
+  {
+    usageError("startMessage() called while a message is in progress.");
+  }
+  Codecs::TemplateCPtr templatePtr;
+  if(!encoder_.getTemplateRegistry()->getTemplate(templateId, templatePtr))
+  {
+    throw EncodingError("[ERR D9] Unknown template ID.");
+  }
+  destination_.startMessage(templateId);
+  Frame & frame = pushFrame(Frame::MESSAGE, templatePtr);
+  // resets (including automatic ones) and the template ID are handled as by the Encoder.
+  header_ = encoder_.encodeSegmentHeader(destination_, templateId, templatePtr, *frame.pmap_);
+}
+
+void
+PushEncoder::addValue(const Messages::FieldIdentity & identity, int64 value)
+{
+  value_.setSigned(value);
+  encodeValue(resolve(identity));
+}
+
+void
+PushEncoder::addValue(const Messages::FieldIdentity & identity, uint64 value)
+{
+  value_.setUnsigned(value);
+  encodeValue(resolve(identity));
+}
+
+void
+PushEncoder::addValue(const Messages::FieldIdentity & identity, int32 value)
+{
+  value_.setSigned(value);
+  encodeValue(resolve(identity));
+}
+
+void
+PushEncoder::addValue(const Messages::FieldIdentity & identity, uint32 value)
+{
+  value_.setUnsigned(value);
+  encodeValue(resolve(identity));
+}
+
+void
+PushEncoder::addValue(const Messages::FieldIdentity & identity, const Decimal & value)
+{
+  value_.setDecimal(value);
+  encodeValue(resolve(identity));
+}
+
+void
+PushEncoder::addValue(const Messages::FieldIdentity & identity, const std::string & value)
+{
+  value_.setString(reinterpret_cast<const uchar *>(value.data()), value.size());
+  encodeValue(resolve(identity));
+}
+
+void
+PushEncoder::addValue(const Messages::FieldIdentity & identity, const uchar * value, size_t length)
+{
+  value_.setString(value, length);
+  encodeValue(resolve(identity));
+}
+
+void
+PushEncoder::addValue(size_t index, int64 value)
+{
+  value_.setSigned(value);
+  encodeValue(resolve(index));
+}
+
+void
+PushEncoder::addValue(size_t index, uint64 value)
+{
+  value_.setUnsigned(value);
+  encodeValue(resolve(index));
+}
+
+void
+PushEncoder::addValue(size_t index, int32 value)
+{
+  value_.setSigned(value);
+  encodeValue(resolve(index));
+}
+
+void
+PushEncoder::addValue(size_t index, uint32 value)
+{
+  value_.setUnsigned(value);
+  encodeValue(resolve(index));
+}
+
+void
+PushEncoder::addValue(size_t index, const Decimal & value)
+{
+  value_.setDecimal(value);
+  encodeValue(resolve(index));
+}
+
+void
+PushEncoder::addValue(size_t index, const std::string & value)
+{
+  value_.setString(reinterpret_cast<const uchar *>(value.data()), value.size());
+  encodeValue(resolve(index));
+}
+
+void
+PushEncoder::addValue(size_t index, const uchar * value, size_t length)
+{
+  value_.setString(value, length);
+  encodeValue(resolve(index));
+}
+
+void
+PushEncoder::encodeValue(const FieldInstruction & instruction)
+{
+  if(!value_.suits(instruction.fieldInstructionType()))
+  {
+    usageError("Value does not match the type of field " + instruction.getIdentity()->name());
+  }
+  advance();
+  encodeInstruction(instruction, *frames_[depth_ - 1].pmap_, value_);
+}
+
+void
+PushEncoder::startGroup(const Messages::FieldIdentity & identity)
+{
+  const FieldInstruction & instruction = resolve(identity);
+  SegmentBodyPtr segment;
+  if(instruction.fieldInstructionType() != ValueType::GROUP || !instruction.getSegmentBody(segment))
+  {
+    usageError(identity.name() + " is not a group.");
+  }
+  advance();
+  if(!instruction.isMandatory())
+  {
+    frames_[depth_ - 1].pmap_->setNextField(true);
+  }
+  startSegment(pushFrame(Frame::GROUP, segment));
+}
+
+void
+PushEncoder::endGroup()
+{
+  finishSegment(top(Frame::GROUP, "endGroup()"));
+  --depth_;
+}
+
+void
+PushEncoder::startSequence(const Messages::FieldIdentity & identity, size_t length)
+{
+  const FieldInstruction & instruction = resolve(identity);
+  SegmentBodyPtr segment;
+  if(instruction.fieldInstructionType() != ValueType::SEQUENCE || !instruction.getSegmentBody(segment))
+  {
+    usageError(identity.name() + " is not a sequence.");
+  }
+  advance();
+  PresenceMap & pmap = *frames_[depth_ - 1].pmap_;
+  value_.setUnsigned(length);
+  FieldInstructionCPtr lengthInstruction;
+  if(segment->getLengthInstruction(lengthInstruction))
+  {
+    encodeInstruction(*lengthInstruction, pmap, value_);
+  }
+  else if(instruction.isMandatory())
+  {
+    mandatoryLength_.encode(destination_, pmap, encoder_, value_);
+  }
+  else
+  {
+    optionalLength_.encode(destination_, pmap, encoder_, value_);
+  }
+  Frame & frame = pushFrame(Frame::SEQUENCE, segment);
+  frame.remaining_ = length;
+}
+
+void
+PushEncoder::startSequenceEntry()
+{
+  Frame & sequence = top(Frame::SEQUENCE, "startSequenceEntry()");
+  if(sequence.remaining_ == 0)
+  {
+    usageError("More sequence entries than the length given to startSequence().");
+  }
+  --sequence.remaining_;
+  SegmentBodyCPtr segment = sequence.segment_;
+  startSegment(pushFrame(Frame::ENTRY, segment));
+}
+
+void
+PushEncoder::endSequenceEntry()
+{
+  finishSegment(top(Frame::ENTRY, "endSequenceEntry()"));
+  --depth_;
+}
+
+void
+PushEncoder::endSequence()
+{
+  Frame & sequence = top(Frame::SEQUENCE, "endSequence()");
+  if(sequence.remaining_ != 0)
+  {
+    usageError("Fewer sequence entries than the length given to startSequence().");
+  }
+  --depth_;
+}
+
+void
+PushEncoder::endMessage()
+{
+  Frame & frame = top(Frame::MESSAGE, "endMessage()");
+  finishFields(frame);
+  encoder_.encodeSegmentTrailer(destination_, header_, *frame.pmap_);
+  depth_ = 0;
+  destination_.endMessage();
+}
+
+void
+PushEncoder::abandonMessage()
+{
+  depth_ = 0;
+  encoder_.reset(true);
+}
+
+PushEncoder::Frame &
+PushEncoder::pushFrame(Frame::Kind kind, const SegmentBodyCPtr & segment)
+{
+  if(depth_ == frames_.size())
+  {
+    frames_.push_back(Frame());
+  }
+  Frame & frame = frames_[depth_];
+  ++depth_;
+  frame.kind_ = kind;
+  frame.segment_ = segment;
+  frame.positions_ = &positionsOf(*segment);
+  frame.next_ = 0;
+  frame.remaining_ = 0;
+  if(kind == Frame::TEMPLATEREF || kind == Frame::SEQUENCE)
+  {
+    // fields are encoded using the parent's presence map
+    frame.pmap_ = frames_[depth_ - 2].pmap_;
+  }
+  else
+  {
+    size_t bitCount = segment->presenceMapBitCount();
+    if(frame.ownPmap_)
+    {
+      frame.ownPmap_->reset(bitCount);
+    }
+    else
+    {
+      frame.ownPmap_.reset(new PresenceMap(bitCount));
+    }
+    frame.pmap_ = frame.ownPmap_.get();
+  }
+  return frame;
+}
+
+PushEncoder::Frame &
+PushEncoder::top(Frame::Kind kind, const char * operation)
+{
+  if(depth_ == 0)
+  {
+    usageError(std::string(operation) + " called with no message in progress.");
+  }
+  // a static templateRef ends implicitly with the segment that contains it.
+  while(frames_[depth_ - 1].kind_ == Frame::TEMPLATEREF)
+  {
+    finishFields(frames_[depth_ - 1]);
+    --depth_;
+  }
+  Frame & frame = frames_[depth_ - 1];
+  if(frame.kind_ != kind)
+  {
+    usageError(std::string(operation) + " does not match the segment in progress.");
+  }
+  return frame;
+}
+
+void
+PushEncoder::startSegment(Frame & frame)
+{
+  // The presence map for the group will go into the current buffer
+  // ahead of the group body.
+  frame.pmapBuffer_ = destination_.getBuffer();
+  if(frame.segment_->presenceMapBitCount() > 0)
+  {
+    destination_.startBuffer();
+  }
+}
+
+void
+PushEncoder::finishSegment(Frame & frame)
+{
+  finishFields(frame);
+  if(frame.segment_->presenceMapBitCount() > 0)
+  {
+    DataDestination::BufferHandle bodyBuffer = destination_.getBuffer();
+    destination_.selectBuffer(frame.pmapBuffer_);
+    static Messages::FieldIdentity pmapIdentity("PMAP", "Group");
+    destination_.startField(pmapIdentity);
+    frame.pmap_->encode(destination_);
+    destination_.endField(pmapIdentity);
+    destination_.selectBuffer(bodyBuffer);
+  }
+}
+
+void
+PushEncoder::finishFields(Frame & frame)
+{
+  Messages::EmptyAccessor absent;
+  size_t count = frame.segment_->size();
+  while(frame.next_ < count)
+  {
+    const FieldInstruction & instruction = *frame.segment_->getInstruction(frame.next_);
+    ++frame.next_;
+    encodeInstruction(instruction, *frame.pmap_, absent);
+  }
+}
+
+void
+PushEncoder::checkFieldExpected()const
+{
+  if(depth_ == 0)
+  {
+    usageError("No message in progress.");
+  }
+  if(frames_[depth_ - 1].kind_ == Frame::SEQUENCE)
+  {
+    usageError("Expecting a sequence entry or the end of the sequence.");
+  }
+}
+
+const FieldInstruction &
+PushEncoder::resolve(const Messages::FieldIdentity & identity)
+{
+  checkFieldExpected();
+  size_t depth = depth_;
+  size_t position = 0;
+  while(!findField(*frames_[depth - 1].positions_, frames_[depth - 1].next_, identity, position))
+  {
+    // Only a static templateRef lets the field be in the enclosing segment.
+    if(frames_[depth - 1].kind_ != Frame::TEMPLATEREF)
+    {
+      usageError("Field " + identity.name() + " is out of order or not in the template.");
+    }
+    --depth;
+  }
+  resolvedDepth_ = depth;
+  path_.clear();
+  const SegmentBody * segment = frames_[depth - 1].segment_.get();
+  for(;;)
+  {
+    path_.push_back(position);
+    const FieldInstruction & instruction = *segment->getInstruction(position);
+    if(matches(instruction, identity))
+    {
+      return instruction;
+    }
+    // findField() found it in the template this instruction refers to.
+    TemplateCPtr target;
+    (void)getStaticTarget(instruction, target);
+    segment = target.get();
+    (void)findField(positionsOf(*segment), 0, identity, position);
+  }
+}
+
+const FieldInstruction &
+PushEncoder::resolve(size_t index)
+{
+  checkFieldExpected();
+  // skip static templateRefs in progress: the index is in the enclosing segment.
+  size_t depth = depth_;
+  while(frames_[depth - 1].kind_ == Frame::TEMPLATEREF)
+  {
+    --depth;
+  }
+  const Frame & frame = frames_[depth - 1];
+  if(index < frame.next_ || index >= frame.segment_->size())
+  {
+    usageError("Field index is out of order or not in the segment.");
+  }
+  resolvedDepth_ = depth;
+  path_.clear();
+  path_.push_back(index);
+  return *frame.segment_->getInstruction(index);
+}
+
+void
+PushEncoder::advance()
+{
+  Messages::EmptyAccessor absent;
+  // A static templateRef ends when a field beyond it arrives.
+  while(depth_ > resolvedDepth_)
+  {
+    finishFields(frames_[depth_ - 1]);
+    --depth_;
+  }
+  for(size_t step = 0; step < path_.size(); ++step)
+  {
+    if(step > 0)
+    {
+      TemplateCPtr target;
+      (void)getStaticTarget(*frames_[depth_ - 1].segment_->getInstruction(path_[step - 1]), target);
+      pushFrame(Frame::TEMPLATEREF, target);
+    }
+    Frame & frame = frames_[depth_ - 1];
+    while(frame.next_ < path_[step])
+    {
+      // skipped fields are absent.
+      encodeInstruction(*frame.segment_->getInstruction(frame.next_), *frame.pmap_, absent);
+      ++frame.next_;
+    }
+    ++frame.next_;
+  }
+}
+
+const PushEncoder::FieldPositions &
+PushEncoder::positionsOf(const SegmentBody & segment)
+{
+  FieldPositionsPtr & positions = positionCache_[&segment];
+  if(!positions)
+  {
+    FieldPositionsPtr found(new FieldPositions);
+    size_t count = segment.size();
+    for(size_t nField = 0; nField < count; ++nField)
+    {
+      const FieldInstruction & instruction = *segment.getInstruction(nField);
+      const Messages::FieldIdentity * identity = instruction.getIdentity().get();
+      found->insert(std::make_pair(identity->name(), std::make_pair(nField, identity)));
+      TemplateCPtr target;
+      if(getStaticTarget(instruction, target))
+      {
+        const FieldPositions & nested = positionsOf(*target);
+        for(FieldPositions::const_iterator it = nested.begin(); it != nested.end(); ++it)
+        {
+          found->insert(std::make_pair(it->first, std::make_pair(nField, it->second.second)));
+        }
+      }
+    }
+    positions = found;
+  }
+  return *positions;
+}
+
+bool
+PushEncoder::findField(
+  const FieldPositions & positions,
+  size_t from,
+  const Messages::FieldIdentity & identity,
+  size_t & position)
+{
+  bool found = false;
+  std::pair<FieldPositions::const_iterator, FieldPositions::const_iterator> range =
+    positions.equal_range(identity.name());
+  for(FieldPositions::const_iterator it = range.first; it != range.second; ++it)
+  {
+    size_t candidate = it->second.first;
+    const Messages::FieldIdentity & candidateIdentity = *it->second.second;
+    if(candidate >= from && (!found || candidate < position) &&
+      (&candidateIdentity == &identity || candidateIdentity == identity))
+    {
+      position = candidate;
+      found = true;
+    }
+  }
+  return found;
+}
+
+bool
+PushEncoder::matches(const FieldInstruction & instruction, const Messages::FieldIdentity & identity)
+{
+  const Messages::FieldIdentityCPtr & fieldIdentity = instruction.getIdentity();
+  return fieldIdentity.get() == &identity || *fieldIdentity == identity;
+}
+
+bool
+PushEncoder::getStaticTarget(const FieldInstruction & instruction, TemplateCPtr & target)const
+{
+  if(instruction.fieldInstructionType() != ValueType::TEMPLATEREF)
+  {
+    return false;
+  }
+  const FieldInstructionStaticTemplateRef * templateRef =
+    dynamic_cast<const FieldInstructionStaticTemplateRef *>(&instruction);
+  return templateRef != 0 && templateRef->getTarget(encoder_, target);
+}
+
+void
+PushEncoder::encodeInstruction(
+  const FieldInstruction & instruction,
+  PresenceMap & pmap,
+  const Messages::MessageAccessor & accessor)
+{
+  destination_.startField(*instruction.getIdentity());
+  instruction.encode(destination_, pmap, encoder_, accessor);
+  destination_.endField(*instruction.getIdentity());
+}
+
+PushEncoder::Frame::Frame()
+  : kind_(MESSAGE)
+  , positions_(0)
+  , next_(0)
+  , remaining_(0)
+  , pmap_(0)
+  , pmapBuffer_(0)
+{
+}
+
+//////////////////////////////
+// PushEncoder::ValueAccessor
+
+PushEncoder::ValueAccessor::ValueAccessor()
+  : kind_(NONE)
+  , unsigned_(0)
+  , signed_(0)
+{
+}
+
+void
+PushEncoder::ValueAccessor::setUnsigned(uint64 value)
+{
+  kind_ = UNSIGNED;
+  unsigned_ = value;
+}
+
+void
+PushEncoder::ValueAccessor::setSigned(int64 value)
+{
+  kind_ = SIGNED;
+  signed_ = value;
+}
+
+void
+PushEncoder::ValueAccessor::setDecimal(const Decimal & value)
+{
+  kind_ = DECIMAL;
+  decimal_ = value;
+}
+
+void
+PushEncoder::ValueAccessor::setString(const uchar * value, size_t length)
+{
+  kind_ = STRING;
+  string_.assign(value, length);
+}
+
+bool
+PushEncoder::ValueAccessor::suits(ValueType::Type type)const
+{
+  switch(type)
+  {
+  case ValueType::INT8:
+  case ValueType::UINT8:
+  case ValueType::INT16:
+  case ValueType::UINT16:
+  case ValueType::INT32:
+  case ValueType::UINT32:
+  case ValueType::INT64:
+  case ValueType::UINT64:
+  case ValueType::LENGTH:
+    return kind_ == SIGNED || kind_ == UNSIGNED;
+  case ValueType::DECIMAL:
+    return kind_ == DECIMAL;
+  case ValueType::ASCII:
+  case ValueType::UTF8:
+  case ValueType::BYTEVECTOR:
+    return kind_ == STRING;
+  default:
+    return false;
+  }
+}
+
+bool
+PushEncoder::ValueAccessor::isPresent(const Messages::FieldIdentity & /*identity*/)const
+{
+  return kind_ != NONE;
+}
+
+bool
+PushEncoder::ValueAccessor::getUnsignedInteger(const Messages::FieldIdentity & /*identity*/, ValueType::Type /*type*/, uint64 & value)const
+{
+  if(kind_ == UNSIGNED)
+  {
+    value = unsigned_;
+    return true;
+  }
+  if(kind_ == SIGNED && signed_ >= 0)
+  {
+    value = uint64(signed_);
+    return true;
+  }
+  return false;
+}
+
+bool
+PushEncoder::ValueAccessor::getSignedInteger(const Messages::FieldIdentity & /*identity*/, ValueType::Type /*type*/, int64 & value)const
+{
+  if(kind_ == SIGNED)
+  {
+    value = signed_;
+    return true;
+  }
+  if(kind_ == UNSIGNED && int64(unsigned_) >= 0)
+  {
+    value = int64(unsigned_);
+    return true;
+  }
+  return false;
+}
+
+bool
+PushEncoder::ValueAccessor::getDecimal(const Messages::FieldIdentity & /*identity*/, ValueType::Type /*type*/, Decimal & value)const
+{
+  if(kind_ == DECIMAL)
+  {
+    value = decimal_;
+    return true;
+  }
+  return false;
+}
+
+bool
+PushEncoder::ValueAccessor::getString(const Messages::FieldIdentity & /*identity*/, ValueType::Type /*type*/, const StringBuffer *& value)const
+{
+  if(kind_ == STRING)
+  {
+    value = &string_;
+    return true;
+  }
+  return false;
+}
+
+bool
+PushEncoder::ValueAccessor::getGroup(const Messages::FieldIdentity & /*identity*/, const Messages::MessageAccessor *& /*group*/)const
+{
+  return false;
+}
+
+bool
+PushEncoder::ValueAccessor::getSequenceLength(const Messages::FieldIdentity & /*identity*/, size_t & /*length*/)const
+{
+  return false;
+}
+
+bool
+PushEncoder::ValueAccessor::getSequenceEntry(const Messages::FieldIdentity & /*identity*/, size_t /*index*/, const Messages::MessageAccessor *& /*entry*/)const
+{
+  return false;
+}
+
+const std::string &
+PushEncoder::ValueAccessor::getApplicationType()const
+{
+  return nada_;
+}
+
+const std::string &
+PushEncoder::ValueAccessor::getApplicationTypeNs()const
+{
+  return nada_;
+}
@@ -0,0 +1,290 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef PUSHENCODER_H
+#define PUSHENCODER_H
+#include "PushEncoder_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Codecs/Encoder.h>
+#include <Codecs/DataDestination.h>
+#include <Codecs/PresenceMap.h>
+#include <Codecs/SegmentBody_fwd.h>
+#include <Codecs/FieldInstructionUInt32.h>
+#include <Messages/MessageAccessor.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief Encode FAST messages as the application supplies the values.
+    ///
+    /// The Encoder pulls values from a MessageAccessor (typically a Message full of
+    /// Fields.)  A PushEncoder works the other way: the application pushes values in
+    /// template order and each one is encoded immediately into the DataDestination.
+    /// No FieldSet or Field objects are created.
+    ///
+    /// The calls mirror those a Decoder makes to a ValueMessageBuilder:
+    /// @code
+    ///   pushEncoder.startMessage(templateId);
+    ///   pushEncoder.addValue(priceIdentity, price);
+    ///   pushEncoder.startSequence(entriesIdentity, 2);
+    ///     pushEncoder.startSequenceEntry();
+    ///     pushEncoder.addValue(sizeIdentity, size);
+    ///     pushEncoder.endSequenceEntry();
+    ///     ...
+    ///   pushEncoder.endSequence();
+    ///   pushEncoder.endMessage();
+    /// @endcode
+    ///
+    /// Fields are identified by their FieldIdentity or by their position in the segment
+    /// being encoded.  Values must arrive in the order the fields appear in the template.  Fields that
+    /// are skipped are encoded as absent, so optional fields may simply be omitted.
+    /// Omitting a mandatory field is reported as an encoding error.  A value for a field
+    /// that does not appear in the rest of the current segment is a UsageError, and
+    /// nothing is encoded for that call.
+    ///
+    /// The fields of a static templateRef are supplied as if they were part of the
+    /// referring segment.  Dynamic templateRefs are not supported (nor are they by the Encoder.)
+    ///
+    /// The presence map for each segment is accumulated as fields are encoded and is
+    /// written ahead of the segment when the segment ends.
+    ///
+    /// Dictionary resets, including those inserted by Encoder::setAutoReset(), and the
+    /// Encoder's statistics apply to pushed messages as they do to encoded ones.
+    ///
+    /// The Encoder supplies the dictionaries, so a PushEncoder and an Encoder (or several
+    /// PushEncoders) using the same Encoder must not be used at the same time.
+    class QuickFAST_Export PushEncoder
+    {
+    public:
+      /// @brief Construct.
+      /// @param encoder provides the templates and dictionaries.
+      /// @param destination receives the encoded messages.
+      PushEncoder(Encoder & encoder, DataDestination & destination);
+
+      ~PushEncoder();
+
+      /// @brief Begin encoding a message.
+      /// @param templateId identifies the template to use.
+      void startMessage(template_id_t templateId);
+
+      /// @brief Encode the next field.
+      /// @param identity identifies the field.
+      /// @param value is the value to be encoded.
+      void addValue(const Messages::FieldIdentity & identity, int64 value);
+
+      /// @brief Encode the next field.
+      /// @param identity identifies the field.
+      /// @param value is the value to be encoded.
+      void addValue(const Messages::FieldIdentity & identity, uint64 value);
+
+      /// @brief Encode the next field.
+      /// @param identity identifies the field.
+      /// @param value is the value to be encoded.
+      void addValue(const Messages::FieldIdentity & identity, int32 value);
+
+      /// @brief Encode the next field.
+      /// @param identity identifies the field.
+      /// @param value is the value to be encoded.
+      void addValue(const Messages::FieldIdentity & identity, uint32 value);
+
+      /// @brief Encode the next field.
+      /// @param identity identifies the field.
+      /// @param value is the value to be encoded.
+      void addValue(const Messages::FieldIdentity & identity, const Decimal & value);
+
+      /// @brief Encode the next field (a string or byte vector.)
+      /// @param identity identifies the field.
+      /// @param value is the value to be encoded.
+      void addValue(const Messages::FieldIdentity & identity, const std::string & value);
+
+      /// @brief Encode the next field (a string or byte vector.)
+      /// @param identity identifies the field.
+      /// @param value points to the value to be encoded.
+      /// @param length is the number of bytes in the value.
+      void addValue(const Messages::FieldIdentity & identity, const uchar * value, size_t length);
+
+      /// @brief Encode the next field.
+      ///
+      /// The index overloads identify the field by the position of its instruction in the
+      /// segment being encoded: the template, or the current group or sequence entry.
+      /// Fields brought in by a static templateRef can only be identified by FieldIdentity.
+      /// @param index is the position of the field in the segment.
+      /// @param value is the value to be encoded.
+      void addValue(size_t index, int64 value);
+
+      /// @brief Encode the next field.
+      /// @param index is the position of the field in the segment.
+      /// @param value is the value to be encoded.
+      void addValue(size_t index, uint64 value);
+
+      /// @brief Encode the next field.
+      /// @param index is the position of the field in the segment.
+      /// @param value is the value to be encoded.
+      void addValue(size_t index, int32 value);
+
+      /// @brief Encode the next field.
+      /// @param index is the position of the field in the segment.
+      /// @param value is the value to be encoded.
+      void addValue(size_t index, uint32 value);
+
+      /// @brief Encode the next field.
+      /// @param index is the position of the field in the segment.
+      /// @param value is the value to be encoded.
+      void addValue(size_t index, const Decimal & value);
+
+      /// @brief Encode the next field (a string or byte vector.)
+      /// @param index is the position of the field in the segment.
+      /// @param value is the value to be encoded.
+      void addValue(size_t index, const std::string & value);
+
+      /// @brief Encode the next field (a string or byte vector.)
+      /// @param index is the position of the field in the segment.
+      /// @param value points to the value to be encoded.
+      /// @param length is the number of bytes in the value.
+      void addValue(size_t index, const uchar * value, size_t length);
+
+      /// @brief Begin a group.
+      ///
+      /// The fields of the group follow, then endGroup().
+      /// @param identity identifies the group.
+      void startGroup(const Messages::FieldIdentity & identity);
+
+      /// @brief Finish the current group.
+      void endGroup();
+
+      /// @brief Begin a sequence.
+      ///
+      /// Exactly length startSequenceEntry()/endSequenceEntry() pairs follow, then endSequence().
+      /// @param identity identifies the sequence.
+      /// @param length is the number of entries that will be supplied.
+      void startSequence(const Messages::FieldIdentity & identity, size_t length);
+
+      /// @brief Begin the next entry of the current sequence.
+      void startSequenceEntry();
+
+      /// @brief Finish the current sequence entry.
+      void endSequenceEntry();
+
+      /// @brief Finish the current sequence.
+      void endSequence();
+
+      /// @brief Finish the message.
+      ///
+      /// Any fields not yet supplied are encoded as absent.
+      void endMessage();
+
+      /// @brief Forget the message in progress.
+      ///
+      /// Use this to recover after an exception.  The partially encoded message
+      /// in the DataDestination should be discarded as well.  The fields encoded so far
+      /// may have changed the dictionaries, so the Encoder is reset; the receiver must
+      /// reset too, for example by encoding the next message after Encoder::encodeReset().
+      void abandonMessage();
+
+    private:
+      /// @brief A MessageAccessor that supplies a single value to a FieldInstruction.
+      class ValueAccessor : public Messages::MessageAccessor
+      {
+      public:
+        ValueAccessor();
+        void setUnsigned(uint64 value);
+        void setSigned(int64 value);
+        void setDecimal(const Decimal & value);
+        void setString(const uchar * value, size_t length);
+        /// @brief Can this value be encoded by a field of the given type?
+        bool suits(ValueType::Type type)const;
+
+        virtual bool isPresent(const Messages::FieldIdentity & identity)const;
+        virtual bool getUnsignedInteger(const Messages::FieldIdentity & identity, ValueType::Type type, uint64 & value)const;
+        virtual bool getSignedInteger(const Messages::FieldIdentity & identity, ValueType::Type type, int64 & value)const;
+        virtual bool getDecimal(const Messages::FieldIdentity & identity, ValueType::Type type, Decimal & value)const;
+        virtual bool getString(const Messages::FieldIdentity & identity, ValueType::Type type, const StringBuffer *& value)const;
+        virtual bool getGroup(const Messages::FieldIdentity & identity, const Messages::MessageAccessor *& group)const;
+        virtual bool getSequenceLength(const Messages::FieldIdentity & identity, size_t & length)const;
+        virtual bool getSequenceEntry(const Messages::FieldIdentity & identity, size_t index, const Messages::MessageAccessor *& entry)const;
+        virtual const std::string & getApplicationType()const;
+        virtual const std::string & getApplicationTypeNs()const;
+
+      private:
+        enum Kind {NONE, UNSIGNED, SIGNED, DECIMAL, STRING};
+        Kind kind_;
+        uint64 unsigned_;
+        int64 signed_;
+        Decimal decimal_;
+        StringBuffer string_;
+        std::string nada_;
+      };
+
+      /// @brief Where each field name appears in a segment: (position, identity)
+      ///
+      /// A field in the template named by a static templateRef is recorded at the
+      /// position of the templateRef.
+      typedef std::multimap<std::string, std::pair<size_t, const Messages::FieldIdentity *> > FieldPositions;
+      typedef boost::shared_ptr<FieldPositions> FieldPositionsPtr;
+      typedef std::map<const SegmentBody *, FieldPositionsPtr> PositionCache;
+
+      struct Frame
+      {
+        enum Kind {MESSAGE, GROUP, SEQUENCE, ENTRY, TEMPLATEREF};
+        Frame();
+        Kind kind_;
+        SegmentBodyCPtr segment_;
+        /// where the fields of segment_ appear
+        const FieldPositions * positions_;
+        /// next instruction in segment_ to be encoded
+        size_t next_;
+        /// for a sequence: how many entries remain
+        size_t remaining_;
+        /// the presence map for this segment (a templateRef shares its parent's)
+        PresenceMap * pmap_;
+        /// where the presence map will be written
+        DataDestination::BufferHandle pmapBuffer_;
+        /// reused from message to message
+        boost::shared_ptr<PresenceMap> ownPmap_;
+      };
+
+    private:
+      void encodeValue(const FieldInstruction & instruction);
+      Frame & pushFrame(Frame::Kind kind, const SegmentBodyCPtr & segment);
+      Frame & top(Frame::Kind kind, const char * operation);
+      void startSegment(Frame & frame);
+      void finishSegment(Frame & frame);
+      void finishFields(Frame & frame);
+      /// @brief Find the instruction for the next field without encoding anything.
+      const FieldInstruction & resolve(const Messages::FieldIdentity & identity);
+      /// @brief Find the instruction at a position in the current segment.
+      const FieldInstruction & resolve(size_t index);
+      void checkFieldExpected()const;
+      /// @brief Move to the instruction found by resolve(), encoding skipped fields as absent.
+      void advance();
+      const FieldPositions & positionsOf(const SegmentBody & segment);
+      static bool findField(const FieldPositions & positions, size_t from, const Messages::FieldIdentity & identity, size_t & position);
+      static bool matches(const FieldInstruction & instruction, const Messages::FieldIdentity & identity);
+      bool getStaticTarget(const FieldInstruction & instruction, TemplateCPtr & target)const;
+      void encodeInstruction(const FieldInstruction & instruction, PresenceMap & pmap, const Messages::MessageAccessor & accessor);
+
+    private:
+      PushEncoder(const PushEncoder &);
+      PushEncoder & operator=(const PushEncoder &);
+
+    private:
+      Encoder & encoder_;
+      DataDestination & destination_;
+      std::vector<Frame> frames_;
+      size_t depth_;
+      /// the frame in which resolve() found the field
+      size_t resolvedDepth_;
+      /// positions of the field found by resolve(): one per static templateRef entered, then the field
+      std::vector<size_t> path_;
+      /// field positions for each segment encoded so far
+      PositionCache positionCache_;
+      DataDestination::BufferHandle header_;
+      ValueAccessor value_;
+      FieldInstructionUInt32 mandatoryLength_;
+      FieldInstructionUInt32 optionalLength_;
+    };
+  }
+}
+#endif // PUSHENCODER_H
@@ -0,0 +1,16 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef PUSHENCODER_FWD_H
+#define PUSHENCODER_FWD_H
+namespace QuickFAST{
+  namespace Codecs{
+    class PushEncoder;
+    /// @brief A smart pointer to a PushEncoder.
+    typedef boost::shared_ptr<PushEncoder> PushEncoderPtr;
+  }
+}
+#endif // PUSHENCODER_FWD_H
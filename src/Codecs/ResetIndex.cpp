@@ -0,0 +1,78 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "ResetIndex.h"
+#include <algorithm>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+namespace
+{
+  bool messageLess(size_t message, const ResetIndex::Entry & entry)
+  {
+    return message < entry.message_;
+  }
+
+  bool offsetLess(size_t offset, const ResetIndex::Entry & entry)
+  {
+    return offset < entry.offset_;
+  }
+}
+
+ResetIndex::ResetIndex()
+{
+}
+
+void
+ResetIndex::record(size_t message, size_t offset, bool inserted)
+{
+  Entry entry;
+  entry.message_ = message;
+  entry.offset_ = offset;
+  entry.inserted_ = inserted;
+  entries_.push_back(entry);
+}
+
+bool
+ResetIndex::findMessage(size_t message, Entry & entry) const
+{
+  std::vector<Entry>::const_iterator it =
+    std::upper_bound(entries_.begin(), entries_.end(), message, messageLess);
+  if(it == entries_.begin())
+  {
+    return false;
+  }
+  entry = *(it - 1);
+  return true;
+}
+
+bool
+ResetIndex::findOffset(size_t offset, Entry & entry) const
+{
+  std::vector<Entry>::const_iterator it =
+    std::upper_bound(entries_.begin(), entries_.end(), offset, offsetLess);
+  if(it == entries_.begin())
+  {
+    return false;
+  }
+  entry = *(it - 1);
+  return true;
+}
+
+void
+ResetIndex::clear()
+{
+  entries_.clear();
+}
+
+void
+ResetIndex::write(std::ostream & out) const
+{
+  for(size_t nEntry = 0; nEntry < entries_.size(); ++nEntry)
+  {
+    const Entry & entry = entries_[nEntry];
+    out << entry.message_ << ' ' << entry.offset_ << ' ' << (entry.inserted_ ? 1 : 0) << std::endl;
+  }
+}
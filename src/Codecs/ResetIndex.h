@@ -0,0 +1,84 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef RESETINDEX_H
+#define RESETINDEX_H
+#include "ResetIndex_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief Record the points in an encoded stream where the dictionaries were reset.
+    ///
+    /// A decoder can start (or recover) at any of these points with an empty dictionary.
+    /// The Encoder adds an entry for every reset it performs when an index has been
+    /// supplied via Encoder::setResetIndex().  Store the index beside the recorded data
+    /// so offline decoders can split the stream into independently decodable pieces.
+    class QuickFAST_Export ResetIndex
+    {
+    public:
+      /// @brief One reset point.
+      struct Entry
+      {
+        /// @brief The number of messages encoded before the reset (counting from zero.)
+        size_t message_;
+        /// @brief The number of bytes encoded before the reset.
+        ///
+        /// If an SCP reset message was inserted this is the offset of that message.
+        size_t offset_;
+        /// @brief True if an SCP reset message was inserted; false if the
+        /// message's template resets the dictionaries itself.
+        bool inserted_;
+      };
+
+      ResetIndex();
+
+      /// @brief Add a reset point.
+      ///
+      /// Entries must be recorded in the order they occur in the stream.
+      /// @param message is the number of messages encoded before the reset.
+      /// @param offset is the number of bytes encoded before the reset.
+      /// @param inserted is true if an SCP reset message was inserted.
+      void record(size_t message, size_t offset, bool inserted);
+
+      /// @brief How many reset points have been recorded.
+      size_t size()const
+      {
+        return entries_.size();
+      }
+
+      /// @brief Access a reset point.
+      /// @param index is 0 <= index < size()
+      const Entry & operator[](size_t index)const
+      {
+        return entries_[index];
+      }
+
+      /// @brief Find the last reset point at or before a message.
+      /// @param message is the number of the message to be decoded (counting from zero.)
+      /// @param[out] entry receives the reset point.
+      /// @returns false if no reset precedes the message.
+      bool findMessage(size_t message, Entry & entry)const;
+
+      /// @brief Find the last reset point at or before a byte offset.
+      /// @param offset is a position in the encoded stream.
+      /// @param[out] entry receives the reset point.
+      /// @returns false if no reset precedes the offset.
+      bool findOffset(size_t offset, Entry & entry)const;
+
+      /// @brief Discard all reset points.
+      void clear();
+
+      /// @brief Write the index, one "message offset inserted" line per reset point.
+      /// @param out is the stream to which the index will be written.
+      void write(std::ostream & out)const;
+
+    private:
+      std::vector<Entry> entries_;
+    };
+  }
+}
+#endif // RESETINDEX_H
@@ -0,0 +1,14 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef RESETINDEX_FWD_H
+#define RESETINDEX_FWD_H
+namespace QuickFAST{
+  namespace Codecs{
+    class ResetIndex;
+  }
+}
+#endif // RESETINDEX_FWD_H
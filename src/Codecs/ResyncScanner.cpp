@@ -0,0 +1,125 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "ResyncScanner.h"
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/DataSourceBuffer.h>
+#include <Messages/NullMessageBuilder.h>
+#include <Common/HighBitScan.h>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+namespace
+{
+  const uchar stopBit = 0x80;
+  const uchar templateIdBit = 0x40;
+  // a template ID is a 32 bit unsigned integer
+  const size_t maxTemplateIdBytes = 5;
+}
+
+ResyncScanner::ResyncScanner(TemplateRegistryPtr registry, size_t confirmMessages)
+  : registry_(registry)
+  , trial_(registry)
+  , confirmMessages_(confirmMessages == 0 ? 1 : confirmMessages)
+  , maxPresenceMapBytes_((registry->presenceMapBits() + 6) / 7)
+  , trialCount_(0)
+{
+  if(maxPresenceMapBytes_ == 0)
+  {
+    maxPresenceMapBytes_ = 1;
+  }
+}
+
+bool
+ResyncScanner::scan(const uchar * buffer, size_t size, size_t & offset)
+{
+  // The data may start with a message (for example if the error was detected
+  // at the end of a field), so the first byte is a candidate.
+  size_t candidate = 0;
+  while(candidate < size)
+  {
+    if(plausibleHeader(buffer + candidate, size - candidate)
+      && trialDecode(buffer + candidate, size - candidate))
+    {
+      offset = candidate;
+      return true;
+    }
+    candidate = findHighBit(buffer, size, candidate) + 1;
+  }
+  return false;
+}
+
+bool
+ResyncScanner::plausibleHeader(const uchar * buffer, size_t size) const
+{
+  // presence map: the first bit says the template ID is present.
+  // After a reset the decoder has no previous template ID to copy.
+  if((buffer[0] & templateIdBit) == 0)
+  {
+    return false;
+  }
+  size_t pos = 0;
+  while((buffer[pos] & stopBit) == 0)
+  {
+    ++pos;
+    if(pos >= size || pos >= maxPresenceMapBytes_)
+    {
+      return false;
+    }
+  }
+  ++pos;
+
+  // template ID: a stop bit encoded unsigned integer with no leading zero bytes.
+  size_t idStart = pos;
+  if(pos < size && buffer[pos] == 0)
+  {
+    return false;
+  }
+  uint64 id = 0;
+  while(pos < size)
+  {
+    uchar byte = buffer[pos++];
+    id = (id << 7) | (byte & ~stopBit);
+    if((byte & stopBit) != 0)
+    {
+      if(id == Context::SCPResetTemplateId)
+      {
+        return true;
+      }
+      TemplateCPtr templatePtr;
+      return registry_->getTemplate(template_id_t(id), templatePtr);
+    }
+    if(pos - idStart >= maxTemplateIdBytes)
+    {
+      return false;
+    }
+  }
+  return false;
+}
+
+bool
+ResyncScanner::trialDecode(const uchar * buffer, size_t size)
+{
+  ++trialCount_;
+  trial_.reset();
+  DataSourceBuffer source(buffer, size);
+  Messages::NullMessageBuilder builder;
+  size_t decoded = 0;
+  try
+  {
+    while(decoded < confirmMessages_ && source.bytesAvailable() > 0)
+    {
+      trial_.decodeMessage(source, builder);
+      ++decoded;
+    }
+  }
+  catch(const std::exception &)
+  {
+    // Running out of data in the middle of a message is not evidence against
+    // the candidate, but a decoding error is.
+    return decoded > 0 && source.bytesAvailable() <= 0;
+  }
+  return decoded > 0;
+}
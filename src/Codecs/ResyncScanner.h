@@ -0,0 +1,73 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef RESYNCSCANNER_H
+#define RESYNCSCANNER_H
+#include "ResyncScanner_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/TemplateRegistry_fwd.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief Find the start of the next message in a corrupted FAST stream.
+    ///
+    /// A message can start only after a byte with the stop bit set.  The scanner skips
+    /// through the data a word at a time looking for stop bits.  At each candidate it checks
+    /// for a plausible message header: a presence map no longer than the registry allows
+    /// with the template ID bit set, followed by the ID of a known template (or the SCP
+    /// reset template.)  A candidate that passes is confirmed by decoding from it, with an
+    /// empty dictionary, into a builder that discards the results.
+    ///
+    /// The candidate is accepted when the trial decodes the requested number of messages
+    /// without error, or decodes at least one message and then runs out of data.
+    ///
+    /// After resynchronizing, decode with a reset dictionary.  Fields that depend on the
+    /// dictionary (copy, delta, increment and tail operators) may have wrong values until
+    /// the next reset in the stream; see Encoder::setAutoReset().
+    class QuickFAST_Export ResyncScanner
+    {
+    public:
+      /// @brief Construct
+      /// @param registry contains the templates used by the stream.
+      /// @param confirmMessages is the number of messages the trial decode must produce.
+      explicit ResyncScanner(TemplateRegistryPtr registry, size_t confirmMessages = 2);
+
+      /// @brief Apply strict decoding rules to the trial decode.
+      /// @param strict should match the live decoder.
+      void setStrict(bool strict)
+      {
+        trial_.setStrict(strict);
+      }
+
+      /// @brief Search for the next message start.
+      /// @param buffer contains the data to be searched.
+      /// @param size is the number of bytes in the buffer.
+      /// @param[out] offset receives the position of the message start.
+      /// @returns true if a message start was found.
+      bool scan(const uchar * buffer, size_t size, size_t & offset);
+
+      /// @brief Statistic: how many candidates passed the header check and were trial decoded.
+      size_t trialCount()const
+      {
+        return trialCount_;
+      }
+
+    private:
+      bool plausibleHeader(const uchar * buffer, size_t size)const;
+      bool trialDecode(const uchar * buffer, size_t size);
+
+    private:
+      TemplateRegistryPtr registry_;
+      Decoder trial_;
+      size_t confirmMessages_;
+      size_t maxPresenceMapBytes_;
+      size_t trialCount_;
+    };
+  }
+}
+#endif // RESYNCSCANNER_H
@@ -5,6 +5,7 @@
 #include "SegmentBody.h"
 #include <Codecs/FieldInstruction.h>
 #include <Common/Exceptions.h>
+#include <Common/MemoryFootprint.h>
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Codecs;
 
@@ -246,3 +247,33 @@ SegmentBody::display(std::ostream & output, size_t indent) const
   /// parent class will display the closing element tag
 }
 
+void
+SegmentBody::qualifyIdentities(const std::string & prefix)
+{
+  for(MutableInstructionVector::iterator it = mutableInstructions_.begin();
+    it != mutableInstructions_.end();
+    ++it)
+  {
+    (*it)->qualifyIdentity(prefix);
+  }
+}
+
+void
+SegmentBody::footprint(MemoryFootprint & footprint) const
+{
+  footprint.add("registry.instructions",
+    sizeof(SegmentBody)
+    + instructions_.capacity() * sizeof(FieldInstructionCPtr)
+    + mutableInstructions_.capacity() * sizeof(FieldInstructionPtr));
+  footprint.addString("registry.strings", applicationType_);
+  footprint.addString("registry.strings", applicationNamespace_);
+  footprint.addString("registry.strings", dictionaryName_);
+  if(lengthInstruction_)
+  {
+    lengthInstruction_->footprint(footprint);
+  }
+  for(size_t nInstruction = 0; nInstruction < instructions_.size(); ++nInstruction)
+  {
+    instructions_[nInstruction]->footprint(footprint);
+  }
+}
@@ -11,6 +11,7 @@
 #include <Codecs/DictionaryIndexer_fwd.h>
 #include <Codecs/SchemaElement.h>
 #include <Common/QuickFAST_Export.h>
+#include <Common/MemoryFootprint_fwd.h>
 
 namespace QuickFAST{
   namespace Codecs{
@@ -141,6 +142,16 @@ namespace QuickFAST{
         const std::string & typeName,
         const std::string & typeNamespace);
 
+      /// @brief Qualify the names of the fields defined directly by this segment.
+      ///
+      /// Used when the segment is flattened into its parent.  @see FieldInstruction::qualifyIdentity()
+      /// @param prefix is added to the front of each field name followed by a '.'
+      void qualifyIdentities(const std::string & prefix);
+
+      /// @brief Add the bytes held by this segment and its instructions to a footprint.
+      /// @param footprint accumulates the result.
+      void footprint(MemoryFootprint & footprint) const;
+
       /// @brief Write the contents of the segment in human readable form.
       ///
       /// @param output is the stream to which the display will be written
@@ -0,0 +1,441 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "ShardedMessageConsumer.h"
+#include <Codecs/Context.h>
+#include <Messages/Field.h>
+#include <Common/Exceptions.h>
+
+using namespace QuickFAST;
+using namespace Codecs;
+
+/// @brief One worker thread and the queue that feeds it.
+class ShardedMessageConsumer::Shard
+{
+public:
+  Shard(MessageConsumer & consumer, size_t queueSize, AtomicCounter & stopRequested)
+    : consumer_(consumer)
+    , queueSize_(queueSize)
+    , stopRequested_(stopRequested)
+    , head_(0)
+    , tail_(0)
+    , stopping_(0)
+    , dispatched_(0)
+    , maxDepth_(0)
+    , fullWaits_(0)
+  {
+    slots_.reserve(queueSize);
+    for(size_t nSlot = 0; nSlot < queueSize; ++nSlot)
+    {
+      slots_.push_back(Messages::MessagePtr(new Messages::Message(20)));
+    }
+  }
+
+  ~Shard()
+  {
+    stop();
+  }
+
+  MessageConsumer & consumer()
+  {
+    return consumer_;
+  }
+
+  void start()
+  {
+    atomic_write_long(&stopping_, 0);
+    thread_.reset(new boost::thread(boost::bind(&Shard::run, this)));
+  }
+
+  void stop()
+  {
+    atomic_write_long(&stopping_, 1);
+    if(bool(thread_))
+    {
+      thread_->join();
+      thread_.reset();
+    }
+  }
+
+  /// @brief Move the message into the queue.  Waits for room if necessary.
+  void push(Messages::Message & message)
+  {
+    long head = head_;
+    size_t depth = queueDepth(head, atomic_read_long(&tail_));
+    if(depth >= queueSize_)
+    {
+      ++fullWaits_;
+      while(depth >= queueSize_)
+      {
+        boost::this_thread::yield();
+        depth = queueDepth(head, atomic_read_long(&tail_));
+      }
+    }
+    slots_[size_t(head) % queueSize_]->swap(message);
+    // release the previously consumed contents of the slot here on the decoding thread.
+    message.clear();
+    atomic_write_long(&head_, advance(head));
+    ++dispatched_;
+    if(depth + 1 > maxDepth_)
+    {
+      maxDepth_ = depth + 1;
+    }
+  }
+
+  size_t dispatched()const
+  {
+    return dispatched_;
+  }
+
+  size_t depth()const
+  {
+    return queueDepth(atomic_read_long(&head_), atomic_read_long(&tail_));
+  }
+
+  size_t maxDepth()const
+  {
+    return maxDepth_;
+  }
+
+  size_t fullWaits()const
+  {
+    return fullWaits_;
+  }
+
+private:
+  // head_ and tail_ count from 0 to 2 * queueSize_ - 1 and wrap, so a full queue
+  // can be told from an empty one without the counts overflowing.
+  long advance(long position)const
+  {
+    ++position;
+    return position == long(2 * queueSize_) ? 0 : position;
+  }
+
+  size_t queueDepth(long head, long tail)const
+  {
+    return size_t(head - tail + long(2 * queueSize_)) % (2 * queueSize_);
+  }
+
+  void run()
+  {
+    size_t idle = 0;
+    for(;;)
+    {
+      long tail = tail_;
+      long head = atomic_read_long(&head_);
+      if(tail == head)
+      {
+        if(atomic_read_long(&stopping_) != 0)
+        {
+          break;
+        }
+        // spin briefly to keep latency low during a burst, then back off.
+        if(++idle < 1000)
+        {
+          boost::this_thread::yield();
+        }
+        else
+        {
+          boost::this_thread::sleep(boost::posix_time::microseconds(100));
+        }
+        continue;
+      }
+      idle = 0;
+      while(tail != head)
+      {
+        Messages::Message & message = *slots_[size_t(tail) % queueSize_];
+        if(stopRequested_ == 0)
+        {
+          try
+          {
+            if(!consumer_.consumeMessage(message))
+            {
+              stopRequested_.CAS(0, 1);
+            }
+          }
+          catch (const std::exception & ex)
+          {
+            consumer_.reportDecodingError(ex.what());
+          }
+        }
+        // The fields are not released here.  Field identities are shared with the
+        // decoder and their reference counts are not thread safe, so the consumed
+        // message is released by push() when the slot is reused.
+        tail = advance(tail);
+        atomic_write_long(&tail_, tail);
+      }
+    }
+  }
+
+private:
+  MessageConsumer & consumer_;
+  size_t queueSize_;
+  AtomicCounter & stopRequested_;
+  std::vector<Messages::MessagePtr> slots_;
+  // head_ is stored only by push() and tail_ only by the worker thread.
+  volatile long head_;
+  volatile long tail_;
+  volatile long stopping_;
+  boost::scoped_ptr<boost::thread> thread_;
+
+  // Statistics: written by the decoding thread only.
+  size_t dispatched_;
+  size_t maxDepth_;
+  size_t fullWaits_;
+};
+
+ShardedMessageConsumer::ShardedMessageConsumer(
+  const std::string & keyFieldName,
+  Common::Logger & logger,
+  size_t queueSize)
+  : keyFieldName_(keyFieldName)
+  , logger_(logger)
+  , queueSize_(queueSize)
+  , decoder_(0)
+  , lastTemplateId_(0)
+  , lastPosition_(0)
+  , started_(false)
+  , stopRequested_(0)
+  , unkeyed_(0)
+{
+  if(queueSize_ == 0)
+  {
+    throw UsageError("Coding Error", "ShardedMessageConsumer: Queue size must not be zero.");
+  }
+}
+
+ShardedMessageConsumer::~ShardedMessageConsumer()
+{
+  stop();
+}
+
+void
+ShardedMessageConsumer::addShard(MessageConsumer & consumer)
+{
+  if(started_)
+  {
+    throw UsageError("Coding Error", "ShardedMessageConsumer: Shards must be added before decoding starts.");
+  }
+  shards_.push_back(ShardPtr(new Shard(consumer, queueSize_, stopRequested_)));
+}
+
+void
+ShardedMessageConsumer::start()
+{
+  if(started_)
+  {
+    return;
+  }
+  if(shards_.empty())
+  {
+    throw UsageError("Coding Error", "ShardedMessageConsumer: No shards defined.");
+  }
+  stopRequested_.CAS(1, 0);
+  started_ = true;
+  for(Shards::iterator it = shards_.begin(); it != shards_.end(); ++it)
+  {
+    (*it)->start();
+  }
+}
+
+void
+ShardedMessageConsumer::stop()
+{
+  if(!started_)
+  {
+    return;
+  }
+  for(Shards::iterator it = shards_.begin(); it != shards_.end(); ++it)
+  {
+    (*it)->stop();
+  }
+  started_ = false;
+}
+
+uint64
+ShardedMessageConsumer::hashKey(const Messages::Field & key)
+{
+  uint64 hash = 0;
+  if(key.isUnsignedInteger())
+  {
+    hash = key.toUnsignedInteger();
+  }
+  else if(key.isSignedInteger())
+  {
+    hash = uint64(key.toSignedInteger());
+  }
+  else if(key.isString())
+  {
+    // FNV-1a
+    const StringBuffer & value = key.toString();
+    hash = 14695981039346656037ULL;
+    for(size_t nByte = 0; nByte < value.size(); ++nByte)
+    {
+      hash ^= value[nByte];
+      hash *= 1099511628211ULL;
+    }
+  }
+  else if(key.isType(ValueType::DECIMAL))
+  {
+    Decimal value = key.toDecimal();
+    hash = uint64(value.getMantissa()) ^ (uint64(value.getExponent()) << 56);
+  }
+  // Spread sequential keys (typical of security IDs) across the shards.
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+size_t
+ShardedMessageConsumer::selectShard(const Messages::Message & message)
+{
+  if(shards_.empty())
+  {
+    throw UsageError("Coding Error", "ShardedMessageConsumer: No shards defined.");
+  }
+  const Messages::MessageField * key = findKey(message, keyPosition());
+  if(key == 0)
+  {
+    ++unkeyed_;
+    return 0;
+  }
+  return size_t(hashKey(*key->getField()) % shards_.size());
+}
+
+ShardedMessageConsumer::KeyPosition &
+ShardedMessageConsumer::keyPosition()
+{
+  template_id_t templateId = 0;
+  if(decoder_ != 0)
+  {
+    templateId = decoder_->getTemplateId();
+  }
+  if(lastPosition_ == 0 || templateId != lastTemplateId_)
+  {
+    KeyPositions::iterator it = keyPositions_.find(templateId);
+    if(it == keyPositions_.end())
+    {
+      KeyPosition position;
+      position.index = 0;
+      it = keyPositions_.insert(KeyPositions::value_type(templateId, position)).first;
+    }
+    lastTemplateId_ = templateId;
+    lastPosition_ = &it->second;
+  }
+  return *lastPosition_;
+}
+
+const Messages::MessageField *
+ShardedMessageConsumer::findKey(const Messages::Message & message, KeyPosition & position)const
+{
+  size_t size = message.size();
+  Messages::FieldSet::const_iterator fields = message.begin();
+  if(position.index < size && fields[position.index].getIdentity() == position.identity)
+  {
+    return &fields[position.index];
+  }
+  if(position.identity)
+  {
+    // an optional field ahead of the key is missing from this message.
+    for(size_t nField = 0; nField < size; ++nField)
+    {
+      if(fields[nField].getIdentity() == position.identity)
+      {
+        position.index = nField;
+        return &fields[nField];
+      }
+    }
+  }
+  // the first message from this template, or the key is not present.
+  for(size_t nField = 0; nField < size; ++nField)
+  {
+    if(fields[nField].getIdentity()->name() == keyFieldName_)
+    {
+      position.index = nField;
+      position.identity = fields[nField].getIdentity();
+      return &fields[nField];
+    }
+  }
+  return 0;
+}
+
+size_t
+ShardedMessageConsumer::dispatched(size_t shard)const
+{
+  return shards_.at(shard)->dispatched();
+}
+
+size_t
+ShardedMessageConsumer::queueDepth(size_t shard)const
+{
+  return shards_.at(shard)->depth();
+}
+
+size_t
+ShardedMessageConsumer::maxQueueDepth(size_t shard)const
+{
+  return shards_.at(shard)->maxDepth();
+}
+
+size_t
+ShardedMessageConsumer::queueFullWaits(size_t shard)const
+{
+  return shards_.at(shard)->fullWaits();
+}
+
+bool
+ShardedMessageConsumer::consumeMessage(Messages::Message & message)
+{
+  if(!started_)
+  {
+    start();
+  }
+  shards_[selectShard(message)]->push(message);
+  return stopRequested_ == 0;
+}
+
+bool
+ShardedMessageConsumer::wantLog(unsigned short level)
+{
+  return logger_.wantLog(level);
+}
+
+bool
+ShardedMessageConsumer::logMessage(unsigned short level, const std::string & logMessage)
+{
+  return logger_.logMessage(level, logMessage);
+}
+
+bool
+ShardedMessageConsumer::reportDecodingError(const std::string & errorMessage)
+{
+  return logger_.reportDecodingError(errorMessage);
+}
+
+bool
+ShardedMessageConsumer::reportCommunicationError(const std::string & errorMessage)
+{
+  return logger_.reportCommunicationError(errorMessage);
+}
+
+void
+ShardedMessageConsumer::decodingStarted()
+{
+  for(Shards::iterator it = shards_.begin(); it != shards_.end(); ++it)
+  {
+    (*it)->consumer().decodingStarted();
+  }
+  start();
+}
+
+void
+ShardedMessageConsumer::decodingStopped()
+{
+  stop();
+  for(Shards::iterator it = shards_.begin(); it != shards_.end(); ++it)
+  {
+    (*it)->consumer().decodingStopped();
+  }
+}
@@ -0,0 +1,164 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef SHARDEDMESSAGECONSUMER_H
+#define SHARDEDMESSAGECONSUMER_H
+#include "ShardedMessageConsumer_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Codecs/MessageConsumer.h>
+#include <Codecs/Context_fwd.h>
+#include <Messages/Message.h>
+#include <Common/AtomicCounter.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief Distribute decoded messages across worker threads by the value of a key field.
+    ///
+    /// Use a ShardedMessageConsumer as the MessageConsumer for a GenericMessageBuilder.
+    /// Each decoded message is examined for the key field (for example SecurityID).
+    /// The value of the key is hashed to select a shard.  Each shard has its own worker
+    /// thread, its own single-producer/single-consumer queue, and its own MessageConsumer.
+    ///
+    /// All messages with the same key go to the same shard, so they are delivered in the
+    /// order in which they were decoded.  Messages with different keys may be processed
+    /// in parallel.  Messages that do not contain the key field go to shard zero.
+    ///
+    /// Messages are moved into preallocated queue slots with Message::swap(), so the
+    /// decoding thread does not copy fields or allocate memory to hand off a message.
+    /// If a shard's queue is full the decoding thread waits for room (ordering is never
+    /// sacrificed) and the wait is counted.
+    ///
+    /// The position of the key field is remembered for each template, so the field is
+    /// found by indexing into the message and checking the identity pointer rather than by
+    /// comparing names.  The field is searched for by name only in the first message
+    /// from a template.  To tell the templates apart the consumer must be told which
+    /// Decoder it is used with (see setDecoder()).  Otherwise one position is shared
+    /// by all messages and it is searched for again whenever the template changes.
+    ///
+    /// The shard consumers' consumeMessage() is called on the worker threads.  The
+    /// consumers may read the message but must not keep copies of field identity
+    /// pointers (their reference counts are shared with the decoder and are not thread safe.)
+    /// decodingStarted() and decodingStopped() are called on the decoding thread
+    /// before the workers start and after they have stopped.
+    class QuickFAST_Export ShardedMessageConsumer : public MessageConsumer
+    {
+    public:
+      /// @brief Construct.
+      /// @param keyFieldName is the name of the field used to select a shard.
+      /// @param logger receives log messages and errors reported by the decoder.
+      /// @param queueSize is the number of messages each shard can hold.
+      ShardedMessageConsumer(
+        const std::string & keyFieldName,
+        Common::Logger & logger,
+        size_t queueSize = 1024);
+      virtual ~ShardedMessageConsumer();
+
+      /// @brief Identify the Decoder that is driving this consumer.
+      /// @param decoder provides the ID of the template of each message.
+      void setDecoder(const Context & decoder)
+      {
+        decoder_ = &decoder;
+      }
+
+      /// @brief Add a shard.
+      ///
+      /// All shards must be added before decoding starts.
+      /// @param consumer will process messages for this shard on the shard's worker thread.
+      void addShard(MessageConsumer & consumer);
+
+      /// @brief Start the worker threads.
+      ///
+      /// Called automatically by decodingStarted().
+      void start();
+
+      /// @brief Wait for all queued messages to be processed, then stop the worker threads.
+      ///
+      /// Called automatically by decodingStopped().
+      void stop();
+
+      /// @brief How many shards are there?
+      size_t shardCount()const
+      {
+        return shards_.size();
+      }
+
+      /// @brief Which shard would handle this message?
+      /// @param message is the message to be examined.
+      /// @returns the index of the shard.
+      size_t selectShard(const Messages::Message & message);
+
+      /// @brief How many messages have been sent to a shard.
+      /// @param shard is the index of the shard.
+      size_t dispatched(size_t shard)const;
+
+      /// @brief How many messages are currently waiting in a shard's queue.
+      /// @param shard is the index of the shard.
+      size_t queueDepth(size_t shard)const;
+
+      /// @brief The largest number of messages that have been waiting in a shard's queue.
+      /// @param shard is the index of the shard.
+      size_t maxQueueDepth(size_t shard)const;
+
+      /// @brief How many times the decoding thread had to wait for room in a shard's queue.
+      /// @param shard is the index of the shard.
+      size_t queueFullWaits(size_t shard)const;
+
+      /// @brief How many messages did not contain the key field.
+      size_t unkeyed()const
+      {
+        return unkeyed_;
+      }
+
+      //////////////////////////
+      // Implement MessageConsumer
+      virtual bool consumeMessage(Messages::Message & message);
+      virtual bool wantLog(unsigned short level);
+      virtual bool logMessage(unsigned short level, const std::string & logMessage);
+      virtual bool reportDecodingError(const std::string & errorMessage);
+      virtual bool reportCommunicationError(const std::string & errorMessage);
+      virtual void decodingStarted();
+      virtual void decodingStopped();
+
+    private:
+      ShardedMessageConsumer(const ShardedMessageConsumer &);
+      ShardedMessageConsumer & operator=(const ShardedMessageConsumer &);
+
+      class Shard;
+      typedef boost::shared_ptr<Shard> ShardPtr;
+      typedef std::vector<ShardPtr> Shards;
+
+      static uint64 hashKey(const Messages::Field & key);
+
+      /// @brief Where the key field was last found in messages from one template.
+      struct KeyPosition
+      {
+        /// Position of the key field in the message.
+        size_t index;
+        /// The key field's identity.  Empty until the field is first found.
+        /// Holding a reference keeps the address from being reused by another identity.
+        Messages::FieldIdentityCPtr identity;
+      };
+      typedef std::map<template_id_t, KeyPosition> KeyPositions;
+
+      KeyPosition & keyPosition();
+      const Messages::MessageField * findKey(const Messages::Message & message, KeyPosition & position)const;
+
+    private:
+      std::string keyFieldName_;
+      Common::Logger & logger_;
+      size_t queueSize_;
+      Shards shards_;
+      const Context * decoder_;
+      KeyPositions keyPositions_;
+      template_id_t lastTemplateId_;
+      KeyPosition * lastPosition_;
+      bool started_;
+      AtomicCounter stopRequested_;
+      size_t unkeyed_;
+    };
+  }
+}
+#endif /* SHARDEDMESSAGECONSUMER_H */
@@ -0,0 +1,16 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef SHARDEDMESSAGECONSUMER_FWD_H
+#define SHARDEDMESSAGECONSUMER_FWD_H
+namespace QuickFAST{
+  namespace Codecs{
+    class ShardedMessageConsumer;
+    /// @brief A smart pointer to a ShardedMessageConsumer.
+    typedef boost::shared_ptr<ShardedMessageConsumer> ShardedMessageConsumerPtr;
+  }
+}
+#endif /* SHARDEDMESSAGECONSUMER_FWD_H */
@@ -0,0 +1,278 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef STATICMESSAGEBUILDER_H
+#define STATICMESSAGEBUILDER_H
+#include <Codecs/Decoder.h>
+#include <Codecs/DataSource.h>
+#include <Codecs/PresenceMap.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/FieldInstructionInt8.h>
+#include <Codecs/FieldInstructionUInt8.h>
+#include <Codecs/FieldInstructionInt16.h>
+#include <Codecs/FieldInstructionUInt16.h>
+#include <Codecs/FieldInstructionInt32.h>
+#include <Codecs/FieldInstructionUInt32.h>
+#include <Codecs/FieldInstructionInt64.h>
+#include <Codecs/FieldInstructionUInt64.h>
+#include <Codecs/FieldInstructionAscii.h>
+#include <Codecs/FieldInstructionBlob.h>
+#include <Codecs/FieldInstructionDecimal.h>
+#include <Messages/ValueMessageBuilder.h>
+#include <Common/Profiler.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief Call a message builder through its static type.
+    ///
+    /// The ValueMessageBuilder methods are virtual so each call made by a field
+    /// instruction is an indirect call that cannot be inlined.  When the type of
+    /// the builder is known, Decoder::decodeMessage<Builder>() wraps the builder
+    /// in one of these and the scalar fields of the message body call Builder's
+    /// methods directly.
+    ///
+    /// Builder must be a concrete ValueMessageBuilder and must be the most-derived
+    /// type of the object: the qualified calls bypass any further overrides.
+    template<typename Builder>
+    class StaticMessageBuilder
+    {
+    public:
+      /// @brief The type of the builder.
+      ///
+      /// Decoder::decodeMessage<Builder>() takes a Target& so the compiler cannot deduce
+      /// Builder and the template is used only when it is named explicitly.
+      typedef Builder Target;
+
+      /// @brief Wrap a builder.
+      /// @param builder is the builder to be called.
+      explicit StaticMessageBuilder(Builder & builder)
+        : builder_(builder)
+      {
+      }
+
+      /// @brief Add a field to the builder without a virtual call.
+      /// @param identity identifies this field
+      /// @param type is the type of data to be added
+      /// @param value is the value to be assigned.
+      template<typename VALUE>
+      void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const VALUE value)
+      {
+        builder_.Builder::addValue(identity, type, value);
+      }
+
+      /// @brief Add a string or byte vector to the builder without a virtual call.
+      /// @param identity identifies this field
+      /// @param type is the type of data to be added
+      /// @param value points to the value.
+      /// @param length is the number of bytes in the value.
+      void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uchar * value, size_t length)
+      {
+        builder_.Builder::addValue(identity, type, value, length);
+      }
+
+      /// @brief Add an interned string to the builder without a virtual call.
+      /// @param identity identifies this field
+      /// @param type is the type of data to be added
+      /// @param value points to the value.
+      /// @param length is the number of bytes in the value.
+      /// @param internId identifies the value in the decoder's intern table.
+      void addInternedValue(Messages::FieldIdentityCPtr & identity, ValueType::Type type, const uchar * value, size_t length, uint32 internId)
+      {
+        builder_.Builder::addInternedValue(identity, type, value, length, internId);
+      }
+
+      /// @brief Start a byte vector delivered in pieces.
+      /// @param identity identifies this field
+      /// @param type is the type of data to be added
+      /// @param length is the total number of bytes.
+      /// @returns true if the builder accepts the value in pieces.
+      bool startByteVector(Messages::FieldIdentityCPtr & identity, ValueType::Type type, size_t length)
+      {
+        return builder_.Builder::startByteVector(identity, type, length);
+      }
+
+      /// @brief Add a piece of a byte vector.
+      /// @param identity identifies this field
+      /// @param value points to the piece.
+      /// @param length is the number of bytes in the piece.
+      void appendByteVector(Messages::FieldIdentityCPtr & identity, const uchar * value, size_t length)
+      {
+        builder_.Builder::appendByteVector(identity, value, length);
+      }
+
+      /// @brief Finish a byte vector delivered in pieces.
+      /// @param identity identifies this field
+      /// @param type is the type of data to be added
+      void endByteVector(Messages::FieldIdentityCPtr & identity, ValueType::Type type)
+      {
+        builder_.Builder::endByteVector(identity, type);
+      }
+
+      /// @brief Report that the value just added is not valid UTF-8.
+      /// @param identity identifies this field
+      /// @param offset is the position of the first invalid byte.
+      void invalidUtf8(Messages::FieldIdentityCPtr & identity, size_t offset)
+      {
+        builder_.Builder::invalidUtf8(identity, offset);
+      }
+
+      /// @brief Start a message without a virtual call.
+      /// @param applicationType is the data type for the message
+      /// @param applicationTypeNamespace qualifies applicationTYpe
+      /// @param size is the maximum number of fields to expect in the message
+      /// @returns the builder for the body of the message.
+      Messages::ValueMessageBuilder & startMessage(
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t size)
+      {
+        return builder_.Builder::startMessage(applicationType, applicationTypeNamespace, size);
+      }
+
+      /// @brief Finish a message without a virtual call.
+      /// @param messageBuilder is the builder returned by startMessage()
+      /// @returns true if decoding should continue
+      bool endMessage(Messages::ValueMessageBuilder & messageBuilder)
+      {
+        return builder_.Builder::endMessage(messageBuilder);
+      }
+
+      /// @brief Discard a message without a virtual call.
+      /// @param messageBuilder is the builder returned by startMessage()
+      /// @returns true if decoding should continue
+      bool ignoreMessage(Messages::ValueMessageBuilder & messageBuilder)
+      {
+        return builder_.Builder::ignoreMessage(messageBuilder);
+      }
+
+      /// @brief Access the builder via its virtual interface.
+      Messages::ValueMessageBuilder & valueMessageBuilder()
+      {
+        return builder_;
+      }
+
+    private:
+      Builder & builder_;
+    };
+
+    template<typename Builder>
+    void
+    Decoder::decodeMessage(
+      DataSource & source,
+      typename StaticMessageBuilder<Builder>::Target & builder)
+    {
+      Messages::ValueMessageBuilder & messageBuilder = builder;
+      if(filter_ || lazyView_ || verboseOut_)
+      {
+        // These features are supported only by the general path.
+        decodeMessage(source, messageBuilder);
+        return;
+      }
+      PROFILE_POINT("decode");
+      source.beginMessage();
+
+      PresenceMap pmap(getTemplateRegistry()->presenceMapBits());
+      TemplateCPtr templatePtr;
+      if(!decodeMessageHeader(source, pmap, templatePtr))
+      {
+        return;
+      }
+      StaticMessageBuilder<Builder> staticBuilder(builder);
+      Messages::ValueMessageBuilder & bodyBuilder(
+        staticBuilder.startMessage(
+          templatePtr->getApplicationType(),
+          templatePtr->getApplicationTypeNamespace(),
+          templatePtr->fieldCount()));
+      if(&bodyBuilder == &messageBuilder)
+      {
+        decodeStaticSegmentBody(source, pmap, templatePtr, staticBuilder);
+      }
+      else
+      {
+        // The body goes to a builder of unknown type.
+        decodeSegmentBody(source, pmap, templatePtr, bodyBuilder);
+      }
+      if(templatePtr->getIgnore())
+      {
+        staticBuilder.ignoreMessage(bodyBuilder);
+      }
+      else
+      {
+        staticBuilder.endMessage(bodyBuilder);
+      }
+    }
+
+    template<typename Builder>
+    void
+    Decoder::decodeStaticSegmentBody(
+      DataSource & source,
+      PresenceMap & pmap,
+      const SegmentBodyCPtr & segment,
+      StaticMessageBuilder<Builder> & builder)
+    {
+      size_t instructionCount = segment->size();
+      for( size_t nField = 0; nField < instructionCount; ++nField)
+      {
+        PROFILE_POINT("decode field");
+        const FieldInstructionCPtr & instruction = segment->getInstruction(nField);
+        source.beginField(instruction->getIdentity()->name());
+        decodeStaticField(source, pmap, *instruction, builder);
+      }
+    }
+
+    template<typename BUILDER>
+    void
+    Decoder::decodeStaticField(
+      DataSource & source,
+      PresenceMap & pmap,
+      const FieldInstruction & instruction,
+      BUILDER & builder)
+    {
+      switch(instruction.fieldInstructionType())
+      {
+      case ValueType::INT8:
+        static_cast<const FieldInstructionInt8 &>(instruction).decodeStatic(source, pmap, *this, builder);
+        break;
+      case ValueType::UINT8:
+        static_cast<const FieldInstructionUInt8 &>(instruction).decodeStatic(source, pmap, *this, builder);
+        break;
+      case ValueType::INT16:
+        static_cast<const FieldInstructionInt16 &>(instruction).decodeStatic(source, pmap, *this, builder);
+        break;
+      case ValueType::UINT16:
+        static_cast<const FieldInstructionUInt16 &>(instruction).decodeStatic(source, pmap, *this, builder);
+        break;
+      case ValueType::INT32:
+        static_cast<const FieldInstructionInt32 &>(instruction).decodeStatic(source, pmap, *this, builder);
+        break;
+      case ValueType::UINT32:
+        static_cast<const FieldInstructionUInt32 &>(instruction).decodeStatic(source, pmap, *this, builder);
+        break;
+      case ValueType::INT64:
+        static_cast<const FieldInstructionInt64 &>(instruction).decodeStatic(source, pmap, *this, builder);
+        break;
+      case ValueType::UINT64:
+        static_cast<const FieldInstructionUInt64 &>(instruction).decodeStatic(source, pmap, *this, builder);
+        break;
+      case ValueType::ASCII:
+        static_cast<const FieldInstructionAscii &>(instruction).decodeStatic(source, pmap, *this, builder);
+        break;
+      case ValueType::UTF8:
+      case ValueType::BYTEVECTOR:
+        static_cast<const FieldInstructionBlob &>(instruction).decodeStatic(source, pmap, *this, builder);
+        break;
+      case ValueType::DECIMAL:
+        static_cast<const FieldInstructionDecimal &>(instruction).decodeStatic(source, pmap, *this, builder);
+        break;
+      default:
+        // groups, sequences and template references
+        instruction.decode(source, pmap, *this, builder.valueMessageBuilder());
+        break;
+      }
+    }
+  }
+}
+#endif // STATICMESSAGEBUILDER_H
@@ -0,0 +1,684 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef STATICTEMPLATE_H
+#define STATICTEMPLATE_H
+#include <Codecs/StaticMessageBuilder.h>
+#include <Codecs/Encoder.h>
+#include <Codecs/DataDestination.h>
+#include <Codecs/FieldInstructionAscii.h>
+#include <Codecs/FieldInstructionUtf8.h>
+#include <Codecs/FieldInstructionByteVector.h>
+#include <Codecs/FieldInstructionDecimal.h>
+#include <Codecs/FieldInstructionSequence.h>
+#include <Codecs/FieldOpNop.h>
+#include <Codecs/FieldOpConstant.h>
+#include <Codecs/FieldOpDefault.h>
+#include <Codecs/FieldOpCopy.h>
+#include <Codecs/FieldOpDelta.h>
+#include <Codecs/FieldOpIncrement.h>
+#include <Codecs/FieldOpTail.h>
+
+/// @brief Declare a field name for use in a static template description.
+///
+/// QUICKFAST_STATIC_NAME(Symbol); declares struct Symbol naming the field "Symbol"
+#define QUICKFAST_STATIC_NAME(NAME)                               \
+  struct NAME                                                     \
+  {                                                               \
+    static const char * name(){ return #NAME; }                   \
+    static const char * value(){ return 0; }                      \
+  }
+
+/// @brief Declare a field name and the value= attribute of its operator.
+///
+/// QUICKFAST_STATIC_NAME_VALUE(Side, "-1"); declares struct Side naming the field "Side" with value "-1"
+#define QUICKFAST_STATIC_NAME_VALUE(NAME, VALUE)                  \
+  struct NAME                                                     \
+  {                                                               \
+    static const char * name(){ return #NAME; }                   \
+    static const char * value(){ return VALUE; }                  \
+  }
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief Building blocks for describing a template in C++.
+    ///
+    /// A template can be described by types rather than XML:
+    /// @code
+    /// QUICKFAST_STATIC_NAME(Seq);
+    /// QUICKFAST_STATIC_NAME(Symbol);
+    /// QUICKFAST_STATIC_NAME_VALUE(Side, "-1");
+    /// QUICKFAST_STATIC_NAME(Quote);
+    /// typedef Static::StaticTemplate<1, Quote, Static::Fields<
+    ///   Static::Field<Seq, Static::UInt32, Static::Increment>,
+    ///   Static::Field<Symbol, Static::Ascii, Static::Copy, Static::Optional>,
+    ///   Static::Field<Side, Static::Int8, Static::Constant> > > QuoteTemplate;
+    /// @endcode
+    /// The compiler generates a decoder and an encoder for the description: one inline
+    /// call per field with the field operator chosen at compile time.  Integer fields go
+    /// straight to the builder's addValue() methods.
+    ///
+    /// The field operators themselves are the usual FieldInstruction/FieldOp code so the
+    /// semantics are identical to templates parsed from XML.  StaticTemplate::createTemplate()
+    /// builds a Template from the description.  Alternatively StaticTemplate::bind()
+    /// checks the description against a template from an XML file (throwing a
+    /// TemplateDefinitionError if they differ) and decodes using that template's instructions.
+    namespace Static{
+
+      ////////////
+      // Field types
+
+      /// @brief &lt;int8>
+      struct Int8 { typedef FieldInstructionInt8 Instruction; enum { integer = true }; };
+      /// @brief &lt;uInt8>
+      struct UInt8 { typedef FieldInstructionUInt8 Instruction; enum { integer = true }; };
+      /// @brief &lt;int16>
+      struct Int16 { typedef FieldInstructionInt16 Instruction; enum { integer = true }; };
+      /// @brief &lt;uInt16>
+      struct UInt16 { typedef FieldInstructionUInt16 Instruction; enum { integer = true }; };
+      /// @brief &lt;int32>
+      struct Int32 { typedef FieldInstructionInt32 Instruction; enum { integer = true }; };
+      /// @brief &lt;uInt32>
+      struct UInt32 { typedef FieldInstructionUInt32 Instruction; enum { integer = true }; };
+      /// @brief &lt;int64>
+      struct Int64 { typedef FieldInstructionInt64 Instruction; enum { integer = true }; };
+      /// @brief &lt;uInt64>
+      struct UInt64 { typedef FieldInstructionUInt64 Instruction; enum { integer = true }; };
+      /// @brief &lt;length> of a sequence
+      struct LengthType { typedef FieldInstructionLength Instruction; enum { integer = true }; };
+      /// @brief &lt;string> or &lt;string charset="ascii">
+      struct Ascii { typedef FieldInstructionAscii Instruction; enum { integer = false }; };
+      /// @brief &lt;string charset="unicode">
+      struct Utf8 { typedef FieldInstructionUtf8 Instruction; enum { integer = false }; };
+      /// @brief &lt;byteVector>
+      struct ByteVector { typedef FieldInstructionByteVector Instruction; enum { integer = false }; };
+      /// @brief &lt;decimal> with a single operator
+      struct Decimal { typedef FieldInstructionDecimal Instruction; enum { integer = false }; };
+
+      ////////////
+      // Presence
+
+      /// @brief presence="mandatory"
+      struct Mandatory { enum { mandatory = true }; };
+      /// @brief presence="optional"
+      struct Optional { enum { mandatory = false }; };
+
+      ////////////
+      // Operators
+      // Each calls the FieldInstruction method for the operator through the instruction's
+      // static type so the call is not virtual.
+
+#define QUICKFAST_STATIC_OPERATOR(OPERATOR, FIELDOP, OPTYPE, METHOD)                  \
+      struct OPERATOR                                                                 \
+      {                                                                               \
+        static const FieldOp::OpType opType = FieldOp::OPTYPE;                        \
+        static FieldOp * create()                                                     \
+        {                                                                             \
+          return new FIELDOP;                                                         \
+        }                                                                             \
+        template<typename INSTRUCTION>                                                \
+        static void decode(                                                           \
+          const INSTRUCTION & instruction,                                            \
+          DataSource & source,                                                        \
+          PresenceMap & pmap,                                                         \
+          Decoder & decoder,                                                          \
+          Messages::ValueMessageBuilder & builder)                                    \
+        {                                                                             \
+          instruction.INSTRUCTION::decode##METHOD(source, pmap, decoder, builder);    \
+        }                                                                             \
+        template<typename INSTRUCTION>                                                \
+        static void encode(                                                           \
+          const INSTRUCTION & instruction,                                            \
+          DataDestination & destination,                                              \
+          PresenceMap & pmap,                                                         \
+          Encoder & encoder,                                                          \
+          const Messages::MessageAccessor & accessor)                                 \
+        {                                                                             \
+          instruction.INSTRUCTION::encode##METHOD(destination, pmap, encoder, accessor); \
+        }                                                                             \
+      }
+
+      /// @brief No operator
+      QUICKFAST_STATIC_OPERATOR(Nop, FieldOpNop, NOP, Nop);
+      /// @brief &lt;constant>
+      QUICKFAST_STATIC_OPERATOR(Constant, FieldOpConstant, CONSTANT, Constant);
+      /// @brief &lt;default>
+      QUICKFAST_STATIC_OPERATOR(Default, FieldOpDefault, DEFAULT, Default);
+      /// @brief &lt;copy>
+      QUICKFAST_STATIC_OPERATOR(Copy, FieldOpCopy, COPY, Copy);
+      /// @brief &lt;delta>
+      QUICKFAST_STATIC_OPERATOR(Delta, FieldOpDelta, DELTA, Delta);
+      /// @brief &lt;increment>
+      QUICKFAST_STATIC_OPERATOR(Increment, FieldOpIncrement, INCREMENT, Increment);
+      /// @brief &lt;tail>
+      QUICKFAST_STATIC_OPERATOR(Tail, FieldOpTail, TAIL, Tail);
+
+#undef QUICKFAST_STATIC_OPERATOR
+
+      /// @brief Report a difference between a description and a template.
+      /// @param ok is false if there is a difference
+      /// @param instruction is the field that differs
+      /// @param problem describes the difference
+      inline void checkField(bool ok, const FieldInstruction & instruction, const std::string & problem)
+      {
+        if(!ok)
+        {
+          throw TemplateDefinitionError(
+            "Static template description does not match field " + instruction.getName() + ": " + problem);
+        }
+      }
+
+      /// @brief Check the operator of a field against its description.
+      template<typename NAME, typename OP>
+      void checkOperator(const FieldInstruction & instruction)
+      {
+        FieldOpCPtr fieldOp = instruction.getFieldOp();
+        size_t pmapBit = 0;
+        checkField(fieldOp->opType() == OP::opType, instruction, "operator differs.");
+        checkField(!fieldOp->getPMapBit(pmapBit), instruction, "a specific presence map bit is not supported.");
+        bool described = NAME::value() != 0;
+        checkField(
+          fieldOp->hasValue() == described && (!described || fieldOp->getValue() == NAME::value()),
+          instruction,
+          "value differs.");
+      }
+
+      /// @brief Select the decoding method for a type.
+      template<bool INTEGER>
+      struct FieldDecoder
+      {
+        /// @brief Decode via the instruction's method for the operator.
+        template<typename OP, typename INSTRUCTION, typename BUILDER>
+        static void decode(
+          const INSTRUCTION & instruction,
+          DataSource & source,
+          PresenceMap & pmap,
+          Decoder & decoder,
+          BUILDER & /*builder*/,
+          Messages::ValueMessageBuilder & messageBuilder)
+        {
+          OP::decode(instruction, source, pmap, decoder, messageBuilder);
+        }
+      };
+
+      /// @brief Integers pass their values to the builder by its static type.
+      template<>
+      struct FieldDecoder<true>
+      {
+        /// @brief Decode with the operator known at compile time.
+        template<typename OP, typename INSTRUCTION, typename BUILDER>
+        static void decode(
+          const INSTRUCTION & instruction,
+          DataSource & source,
+          PresenceMap & pmap,
+          Decoder & decoder,
+          BUILDER & builder,
+          Messages::ValueMessageBuilder & messageBuilder)
+        {
+          instruction.decodeOperator(OP::opType, false, 0, source, pmap, decoder, builder, messageBuilder);
+        }
+      };
+
+      /// @brief Describe a field.
+      /// @param NAME provides name() and value() (see QUICKFAST_STATIC_NAME)
+      /// @param TYPE is one of the field types: Int32, Ascii, Decimal, etc.
+      /// @param OP is one of the operators: Nop, Copy, Delta, etc.
+      /// @param PRESENCE is Mandatory or Optional
+      template<typename NAME, typename TYPE, typename OP = Nop, typename PRESENCE = Mandatory>
+      struct Field
+      {
+        /// @brief The FieldInstruction for this field.
+        typedef typename TYPE::Instruction Instruction;
+
+        /// @brief Create the FieldInstruction
+        static FieldInstructionPtr create()
+        {
+          FieldInstructionPtr instruction(new Instruction(NAME::name(), ""));
+          FieldOpPtr fieldOp(OP::create());
+          if(NAME::value() != 0)
+          {
+            fieldOp->setValue(NAME::value());
+          }
+          instruction->setFieldOp(fieldOp);
+          instruction->setPresence(PRESENCE::mandatory);
+          return instruction;
+        }
+
+        /// @brief Check an instruction against this description.
+        /// @returns the instruction with its static type.
+        static const Instruction * bind(const FieldInstructionCPtr & instruction)
+        {
+          const Instruction * typed = dynamic_cast<const Instruction *>(instruction.get());
+          checkField(typed != 0, *instruction, "type differs.");
+          checkField(instruction->getName() == NAME::name(), *instruction, std::string("expected ") + NAME::name());
+          checkField(instruction->isMandatory() == bool(PRESENCE::mandatory), *instruction, "presence differs.");
+          checkOperator<NAME, OP>(*instruction);
+          return typed;
+        }
+
+        /// @brief Decode this field
+        template<typename BUILDER>
+        static void decode(
+          const Instruction & instruction,
+          DataSource & source,
+          PresenceMap & pmap,
+          Decoder & decoder,
+          BUILDER & builder,
+          Messages::ValueMessageBuilder & messageBuilder)
+        {
+          FieldDecoder<TYPE::integer != 0>::template decode<OP>(
+            instruction, source, pmap, decoder, builder, messageBuilder);
+        }
+
+        /// @brief Encode this field
+        static void encode(
+          const Instruction & instruction,
+          DataDestination & destination,
+          PresenceMap & pmap,
+          Encoder & encoder,
+          const Messages::MessageAccessor & accessor)
+        {
+          OP::encode(instruction, destination, pmap, encoder, accessor);
+        }
+      };
+
+      /// @brief A sequence with no &lt;length> element.
+      struct ImplicitLength
+      {
+        /// @brief Nothing to add to the sequence body.
+        static void create(SegmentBody & /*body*/)
+        {
+        }
+
+        /// @brief Check that the sequence has no &lt;length> element.
+        static void bind(const FieldInstruction & sequence, const SegmentBody & body)
+        {
+          FieldInstructionCPtr length;
+          checkField(!body.getLengthInstruction(length), sequence, "length element differs.");
+        }
+      };
+
+      /// @brief Describe the &lt;length> element of a sequence.
+      /// @param NAME provides name() and value() (see QUICKFAST_STATIC_NAME)
+      /// @param OP is one of the operators: Nop, Copy, Delta, etc.
+      template<typename NAME, typename OP = Nop>
+      struct Length
+      {
+        /// @brief Add the length instruction to the sequence body.
+        static void create(SegmentBody & body)
+        {
+          FieldInstructionPtr length = Field<NAME, LengthType, OP>::create();
+          body.addLengthInstruction(length);
+        }
+
+        /// @brief Check the length instruction.
+        static void bind(const FieldInstruction & sequence, const SegmentBody & body)
+        {
+          FieldInstructionCPtr length;
+          checkField(body.getLengthInstruction(length), sequence, "length element differs.");
+          checkField(length->getName() == NAME::name(), sequence, "length name differs.");
+          checkOperator<NAME, OP>(*length);
+        }
+      };
+
+      template<typename LIST>
+      class FieldChain;
+
+      /// @brief Describe a sequence.
+      ///
+      /// The sequence is decoded and encoded by FieldInstructionSequence.
+      /// @param NAME provides name() (see QUICKFAST_STATIC_NAME)
+      /// @param FIELDS is a Fields<> list describing the entries.
+      /// @param PRESENCE is Mandatory or Optional
+      /// @param LENGTH is ImplicitLength or Length<>.
+      template<typename NAME, typename FIELDS, typename PRESENCE = Mandatory, typename LENGTH = ImplicitLength>
+      struct Sequence
+      {
+        /// @brief The FieldInstruction for this field.
+        typedef FieldInstructionSequence Instruction;
+
+        /// @brief Create the FieldInstruction
+        static FieldInstructionPtr create()
+        {
+          Instruction * sequence = new Instruction(NAME::name(), "");
+          FieldInstructionPtr instruction(sequence);
+          instruction->setPresence(PRESENCE::mandatory);
+          SegmentBodyPtr body(new SegmentBody);
+          body->allowLengthField();
+          body->setMandatoryLength(PRESENCE::mandatory);
+          LENGTH::create(*body);
+          FieldChain<FIELDS>::create(*body);
+          sequence->setSegmentBody(body);
+          return instruction;
+        }
+
+        /// @brief Check an instruction against this description.
+        /// @returns the instruction with its static type.
+        static const Instruction * bind(const FieldInstructionCPtr & instruction)
+        {
+          const Instruction * typed = dynamic_cast<const Instruction *>(instruction.get());
+          checkField(typed != 0, *instruction, "type differs.");
+          checkField(instruction->getName() == NAME::name(), *instruction, std::string("expected ") + NAME::name());
+          checkField(instruction->isMandatory() == bool(PRESENCE::mandatory), *instruction, "presence differs.");
+          checkField(instruction->getFieldOp()->opType() == FieldOp::NOP, *instruction, "operator differs.");
+          SegmentBodyPtr body;
+          checkField(typed->getSegmentBody(body), *instruction, "no entries.");
+          LENGTH::bind(*instruction, *body);
+          FieldChain<FIELDS> entries;
+          entries.bind(*body, 0);
+          return typed;
+        }
+
+        /// @brief Decode this field
+        template<typename BUILDER>
+        static void decode(
+          const Instruction & instruction,
+          DataSource & source,
+          PresenceMap & pmap,
+          Decoder & decoder,
+          BUILDER & /*builder*/,
+          Messages::ValueMessageBuilder & messageBuilder)
+        {
+          instruction.Instruction::decodeNop(source, pmap, decoder, messageBuilder);
+        }
+
+        /// @brief Encode this field
+        static void encode(
+          const Instruction & instruction,
+          DataDestination & destination,
+          PresenceMap & pmap,
+          Encoder & encoder,
+          const Messages::MessageAccessor & accessor)
+        {
+          instruction.Instruction::encodeNop(destination, pmap, encoder, accessor);
+        }
+      };
+
+      /// @brief Marks the unused positions in a Fields<> list.
+      struct End;
+
+      /// @brief A list of Field<> and Sequence<> descriptions.
+      template<
+        typename F1 = End, typename F2 = End, typename F3 = End, typename F4 = End,
+        typename F5 = End, typename F6 = End, typename F7 = End, typename F8 = End,
+        typename F9 = End, typename F10 = End, typename F11 = End, typename F12 = End,
+        typename F13 = End, typename F14 = End, typename F15 = End, typename F16 = End>
+      struct Fields
+      {
+        /// @brief The first field
+        typedef F1 Head;
+        /// @brief The rest of the fields
+        typedef Fields<F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12, F13, F14, F15, F16> Tail;
+      };
+
+      /// @brief The instructions for a list of fields, unrolled at compile time.
+      template<typename LIST>
+      class FieldChain
+      {
+      public:
+        /// @brief The description of the first field
+        typedef typename LIST::Head FieldType;
+
+        FieldChain()
+          : instruction_(0)
+        {
+        }
+
+        /// @brief Add instructions for the fields to a segment.
+        static void create(SegmentBody & body)
+        {
+          FieldInstructionPtr instruction = FieldType::create();
+          body.addInstruction(instruction);
+          FieldChain<typename LIST::Tail>::create(body);
+        }
+
+        /// @brief Check the segment's instructions starting at index against the descriptions.
+        void bind(const SegmentBody & body, size_t index)
+        {
+          if(index >= body.size())
+          {
+            throw TemplateDefinitionError("Static template description has more fields than the template.");
+          }
+          instruction_ = FieldType::bind(body.getInstruction(index));
+          next_.bind(body, index + 1);
+        }
+
+        /// @brief Decode the fields
+        template<typename BUILDER>
+        void decode(
+          DataSource & source,
+          PresenceMap & pmap,
+          Decoder & decoder,
+          BUILDER & builder,
+          Messages::ValueMessageBuilder & messageBuilder) const
+        {
+          source.beginField(instruction_->getIdentity()->name());
+          FieldType::decode(*instruction_, source, pmap, decoder, builder, messageBuilder);
+          next_.decode(source, pmap, decoder, builder, messageBuilder);
+        }
+
+        /// @brief Encode the fields
+        void encode(
+          DataDestination & destination,
+          PresenceMap & pmap,
+          Encoder & encoder,
+          const Messages::MessageAccessor & accessor) const
+        {
+          const Messages::FieldIdentity & identity = *instruction_->getIdentity();
+          destination.startField(identity);
+          FieldType::encode(*instruction_, destination, pmap, encoder, accessor);
+          destination.endField(identity);
+          next_.encode(destination, pmap, encoder, accessor);
+        }
+
+      private:
+        const typename FieldType::Instruction * instruction_;
+        FieldChain<typename LIST::Tail> next_;
+      };
+
+      /// @brief The end of the list.
+      template<>
+      class FieldChain<Fields<> >
+      {
+      public:
+        /// @brief Nothing to add.
+        static void create(SegmentBody & /*body*/)
+        {
+        }
+
+        /// @brief Check that every instruction has been described.
+        void bind(const SegmentBody & body, size_t index)
+        {
+          if(index != body.size())
+          {
+            throw TemplateDefinitionError("Template has more fields than its static description.");
+          }
+        }
+
+        /// @brief Nothing to decode.
+        template<typename BUILDER>
+        void decode(
+          DataSource & /*source*/,
+          PresenceMap & /*pmap*/,
+          Decoder & /*decoder*/,
+          BUILDER & /*builder*/,
+          Messages::ValueMessageBuilder & /*messageBuilder*/) const
+        {
+        }
+
+        /// @brief Nothing to encode.
+        void encode(
+          DataDestination & /*destination*/,
+          PresenceMap & /*pmap*/,
+          Encoder & /*encoder*/,
+          const Messages::MessageAccessor & /*accessor*/) const
+        {
+        }
+      };
+
+      /// @brief Describe a template.
+      /// @param ID is the template id
+      /// @param NAME provides name() (see QUICKFAST_STATIC_NAME)
+      /// @param FIELDS is a Fields<> list.
+      template<template_id_t ID, typename NAME, typename FIELDS>
+      class StaticTemplate
+      {
+      public:
+        /// @brief The template id.
+        static const template_id_t id = ID;
+
+        StaticTemplate()
+        {
+        }
+
+        /// @brief Build a Template from the description.
+        ///
+        /// Add it to a TemplateRegistry, finalize the registry then bind() to it.
+        static TemplatePtr createTemplate()
+        {
+          TemplatePtr result(new Template);
+          result->setId(ID);
+          result->setTemplateName(NAME::name());
+          FieldChain<FIELDS>::create(*result);
+          return result;
+        }
+
+        /// @brief Find the template in a registry and check it against the description.
+        ///
+        /// Decoders and encoders using the registry will use the description for this template.
+        /// @throws TemplateDefinitionError if the template is missing or differs.
+        void bind(const TemplateRegistry & registry)
+        {
+          TemplateCPtr found;
+          if(!registry.getTemplate(ID, found))
+          {
+            throw TemplateDefinitionError(std::string("Static template description: template not found: ") + NAME::name());
+          }
+          if(found->getTemplateName() != NAME::name())
+          {
+            throw TemplateDefinitionError(
+              std::string("Static template description: ") + NAME::name() + " does not match template " + found->getTemplateName());
+          }
+          fields_.bind(*found, 0);
+          template_ = found;
+        }
+
+        /// @brief Has bind() succeeded?
+        bool isBound()const
+        {
+          return bool(template_);
+        }
+
+        /// @brief The template found by bind()
+        const TemplateCPtr & boundTemplate()const
+        {
+          return template_;
+        }
+
+        /// @brief Decode the fields of a message
+        template<typename BUILDER>
+        void decodeBody(
+          DataSource & source,
+          PresenceMap & pmap,
+          Decoder & decoder,
+          BUILDER & builder,
+          Messages::ValueMessageBuilder & messageBuilder) const
+        {
+          fields_.decode(source, pmap, decoder, builder, messageBuilder);
+        }
+
+        /// @brief Encode the fields of a message
+        void encodeBody(
+          DataDestination & destination,
+          PresenceMap & pmap,
+          Encoder & encoder,
+          const Messages::MessageAccessor & accessor) const
+        {
+          fields_.encode(destination, pmap, encoder, accessor);
+        }
+
+      private:
+        FieldChain<FIELDS> fields_;
+        TemplateCPtr template_;
+      };
+    }
+
+    template<typename Description, typename Builder>
+    void
+    Decoder::decodeStaticMessage(
+      DataSource & source,
+      const Description & description,
+      Builder & builder)
+    {
+      Messages::ValueMessageBuilder & messageBuilder = builder;
+      if(filter_ || lazyView_ || verboseOut_ || !description.isBound())
+      {
+        decodeMessage(source, messageBuilder);
+        return;
+      }
+      PROFILE_POINT("decode");
+      source.beginMessage();
+
+      PresenceMap pmap(getTemplateRegistry()->presenceMapBits());
+      TemplateCPtr templatePtr;
+      if(!decodeMessageHeader(source, pmap, templatePtr))
+      {
+        return;
+      }
+      Messages::ValueMessageBuilder & bodyBuilder(
+        builder.Builder::startMessage(
+          templatePtr->getApplicationType(),
+          templatePtr->getApplicationTypeNamespace(),
+          templatePtr->fieldCount()));
+      if(templatePtr != description.boundTemplate())
+      {
+        decodeSegmentBody(source, pmap, templatePtr, bodyBuilder);
+      }
+      else if(&bodyBuilder == &messageBuilder)
+      {
+        StaticMessageBuilder<Builder> staticBuilder(builder);
+        description.decodeBody(source, pmap, *this, staticBuilder, messageBuilder);
+      }
+      else
+      {
+        description.decodeBody(source, pmap, *this, bodyBuilder, bodyBuilder);
+      }
+      if(templatePtr->getIgnore())
+      {
+        builder.Builder::ignoreMessage(bodyBuilder);
+      }
+      else
+      {
+        builder.Builder::endMessage(bodyBuilder);
+      }
+    }
+
+    template<typename Description>
+    void
+    Encoder::encodeStaticMessage(
+      DataDestination & destination,
+      const Description & description,
+      const Messages::MessageAccessor & accessor)
+    {
+      template_id_t templateId = Description::id;
+      TemplateCPtr templatePtr;
+      if(!description.isBound()
+        || !getTemplateRegistry()->getTemplate(templateId, templatePtr)
+        || templatePtr != description.boundTemplate())
+      {
+        encodeMessage(destination, templateId, accessor);
+        return;
+      }
+      destination.startMessage(templateId);
+      PresenceMap pmap(templatePtr->presenceMapBitCount());
+      DataDestination::BufferHandle header = encodeSegmentHeader(destination, templateId, templatePtr, pmap);
+      description.encodeBody(destination, pmap, *this, accessor);
+      encodeSegmentTrailer(destination, header, pmap);
+      destination.endMessage();
+    }
+  }
+}
+#endif // STATICTEMPLATE_H
@@ -0,0 +1,106 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "StreamReadAhead.h"
+#include <Common/Exceptions.h>
+#include <boost/bind.hpp>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+StreamReadAhead::StreamReadAhead(std::istream & stream, size_t bufferSize, size_t bufferCount)
+: stream_(stream)
+, bufferSize_(bufferSize)
+, bufferCount_(bufferCount)
+, sizes_(bufferCount, 0)
+, readIndex_(0)
+, writeIndex_(0)
+, readyCount_(0)
+, holding_(false)
+, endOfStream_(false)
+, stopping_(false)
+, waits_(0)
+{
+  if(bufferCount_ < 2 || bufferSize_ == 0)
+  {
+    throw UsageError("Coding Error", "Read ahead needs at least two non-empty buffers.");
+  }
+  storage_.reset(new uchar[bufferSize_ * bufferCount_]);
+  thread_.reset(new boost::thread(boost::bind(&StreamReadAhead::run, this)));
+}
+
+StreamReadAhead::~StreamReadAhead()
+{
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    stopping_ = true;
+    emptied_.notify_one();
+  }
+  thread_->join();
+}
+
+bool
+StreamReadAhead::next(const uchar *& buffer, size_t & size)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  if(holding_)
+  {
+    holding_ = false;
+    readIndex_ = (readIndex_ + 1) % bufferCount_;
+    emptied_.notify_one();
+  }
+  if(readyCount_ == 0 && !endOfStream_)
+  {
+    ++waits_;
+    while(readyCount_ == 0 && !endOfStream_)
+    {
+      filled_.wait(lock);
+    }
+  }
+  if(readyCount_ == 0)
+  {
+    size = 0;
+    return false;
+  }
+  --readyCount_;
+  holding_ = true;
+  buffer = storage_.get() + readIndex_ * bufferSize_;
+  size = sizes_[readIndex_];
+  return true;
+}
+
+void
+StreamReadAhead::run()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  while(!stopping_ && !endOfStream_)
+  {
+    // wait for a buffer that is neither ready nor held by the consumer.
+    if(readyCount_ + (holding_ ? 1 : 0) >= bufferCount_)
+    {
+      emptied_.wait(lock);
+      continue;
+    }
+    size_t index = writeIndex_;
+    lock.unlock();
+    size_t size = 0;
+    if(stream_.good())
+    {
+      stream_.read(reinterpret_cast<char *>(storage_.get() + index * bufferSize_), bufferSize_);
+      size = size_t(stream_.gcount());
+    }
+    lock.lock();
+    if(size > 0)
+    {
+      sizes_[index] = size;
+      writeIndex_ = (index + 1) % bufferCount_;
+      ++readyCount_;
+    }
+    if(size < bufferSize_)
+    {
+      endOfStream_ = true;
+    }
+    filled_.notify_one();
+  }
+}
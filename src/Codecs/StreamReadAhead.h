@@ -0,0 +1,73 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef STREAMREADAHEAD_H
+#define STREAMREADAHEAD_H
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+#include <boost/thread/condition_variable.hpp>
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief Read an istream on a helper thread into a ring of large buffers.
+    ///
+    /// While the consumer works on one buffer the helper thread fills the others, so
+    /// with two buffers reading is double-buffered, with three it is triple-buffered, etc.
+    ///
+    /// Once the StreamReadAhead has been constructed the stream belongs to the helper
+    /// thread.  Do not touch it until the StreamReadAhead has been destroyed.
+    class QuickFAST_Export StreamReadAhead
+    {
+    public:
+      /// @brief Start reading
+      /// @param stream supplies the data.
+      /// @param bufferSize is the size of each buffer.
+      /// @param bufferCount is the number of buffers (at least two.)
+      StreamReadAhead(std::istream & stream, size_t bufferSize, size_t bufferCount);
+
+      /// @brief Stop the helper thread.
+      ~StreamReadAhead();
+
+      /// @brief Release the current buffer and get the next one, waiting for it to be filled if necessary.
+      ///
+      /// The buffer stays valid until the next call to next() or until this object is destroyed.
+      /// @param buffer receives the address of the data.
+      /// @param size receives the number of bytes available (> 0 if true is returned.)
+      /// @returns false if the end of the stream has been reached.
+      bool next(const uchar *& buffer, size_t & size);
+
+      /// @brief How many times next() had to wait for the helper thread.
+      size_t waits()const
+      {
+        return waits_;
+      }
+
+    private:
+      void run();
+    private:
+      StreamReadAhead(const StreamReadAhead &);
+      StreamReadAhead & operator=(const StreamReadAhead &);
+    private:
+      std::istream & stream_;
+      size_t bufferSize_;
+      size_t bufferCount_;
+      boost::scoped_array<uchar> storage_;
+      std::vector<size_t> sizes_;
+
+      boost::mutex mutex_;
+      boost::condition_variable filled_;
+      boost::condition_variable emptied_;
+      size_t readIndex_;    // next buffer to be consumed (or the one being consumed)
+      size_t writeIndex_;   // next buffer to be filled
+      size_t readyCount_;   // buffers filled and not yet consumed
+      bool holding_;        // the consumer holds the buffer at readIndex_
+      bool endOfStream_;
+      bool stopping_;
+      size_t waits_;
+      boost::scoped_ptr<boost::thread> thread_;
+    };
+  }
+}
+#endif // STREAMREADAHEAD_H
@@ -8,6 +8,7 @@
 #include <Messages/ValueMessageBuilder.h>
 #include <Codecs/DataSourceBuffer.h>
 #include <Codecs/Decoder.h>
+#include <Codecs/ResyncScanner.h>
 
 using namespace QuickFAST;
 using namespace Codecs;
@@ -32,6 +33,12 @@ StreamingAssembler::StreamingAssembler(
   , messageCount_(0)
   , byteCount_(0)
   , messageLimit_(0)
+  , templateRegistry_(templateRegistry)
+  , resyncing_(false)
+  , resyncSkipped_(0)
+  , resyncCount_(0)
+  , resyncBytesSkipped_(0)
+  , resyncMicroseconds_(0)
 {
 }
 
@@ -53,6 +60,10 @@ StreamingAssembler::serviceQueue(
       headerIsComplete_ = headerAnalyzer_.analyzeHeader(*this, blockSize_, skipBlock_);
     }
     more = headerIsComplete_ && !stopping_;
+    if(more && resyncing_)
+    {
+      more = resynchronize();
+    }
 
     if(more)
     {
@@ -97,6 +108,12 @@ StreamingAssembler::serviceQueue(
         catch(std::exception & ex)
         {
           more = builder_.reportDecodingError(ex.what());
+          if(more && resyncScanner_)
+          {
+            resyncing_ = true;
+            resyncSkipped_ = 0;
+            resyncStart_ = boost::posix_time::microsec_clock::universal_time();
+          }
           if(!more)
           {
             stopping_ = true;
@@ -119,10 +136,70 @@ StreamingAssembler::serviceQueue(
   return !stopping_;
 }
 
+void
+StreamingAssembler::setResynchronize(bool resync, size_t confirmMessages)
+{
+  if(resync)
+  {
+    resyncScanner_.reset(new ResyncScanner(templateRegistry_, confirmMessages));
+    resyncScanner_->setStrict(strict_);
+  }
+  else
+  {
+    resyncScanner_.reset();
+    resyncing_ = false;
+  }
+}
+
+bool
+StreamingAssembler::resynchronize()
+{
+  int available = bytesAvailable();
+  if(available <= 0)
+  {
+    return false;
+  }
+  const uchar * data = 0;
+  (void)hasContiguous(0, data);
+  size_t offset = 0;
+  bool found = resyncScanner_->scan(data, size_t(available), offset);
+  if(!found)
+  {
+    // A message that starts in this buffer and ends in the next one is lost.
+    offset = size_t(available);
+  }
+  skipContiguous(offset);
+  resyncSkipped_ += offset;
+  if(!found)
+  {
+    return false;
+  }
+
+  resyncing_ = false;
+  decoder_.reset();
+  boost::posix_time::time_duration lapse =
+    boost::posix_time::microsec_clock::universal_time() - resyncStart_;
+  ++resyncCount_;
+  resyncBytesSkipped_ += resyncSkipped_;
+  resyncMicroseconds_ += size_t(lapse.total_microseconds());
+  if(builder_.wantLog(Common::Logger::QF_LOG_WARNING))
+  {
+    std::stringstream msg;
+    msg << "Resynchronized after skipping " << resyncSkipped_
+      << " bytes in " << lapse.total_microseconds() << " microseconds.";
+    builder_.logMessage(Common::Logger::QF_LOG_WARNING, msg.str());
+  }
+  return true;
+}
+
 void
 StreamingAssembler::receiverStarted(Communication::Receiver & /*receiver*/)
 {
   decoder_.setStrict(strict_);
+  if(resyncScanner_)
+  {
+    resyncScanner_->setStrict(strict_);
+  }
   if(builder_.wantLog(Common::Logger::QF_LOG_INFO))
   {
     builder_.logMessage(Common::Logger::QF_LOG_INFO, "Start receiver.");
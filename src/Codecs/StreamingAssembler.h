@@ -13,7 +13,9 @@
 #include <Codecs/HeaderAnalyzer.h>
 #include <Codecs/Decoder.h>
 #include <Codecs/TemplateRegistry_fwd.h>
+#include <Codecs/ResyncScanner_fwd.h>
 #include <Messages/ValueMessageBuilder_fwd.h>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 
 namespace QuickFAST
 {
@@ -46,6 +48,42 @@ namespace QuickFAST
         messageLimit_ = messageLimit;
       }
 
+      /// @brief Resynchronize after a decoding error.
+      ///
+      /// Normally decoding continues with the byte following the error which usually
+      /// produces a cascade of errors.  With resynchronization enabled, if the builder's
+      /// reportDecodingError() asks to continue, the incoming data is scanned for the
+      /// start of the next message (see ResyncScanner) and decoding resumes there with
+      /// a reset dictionary.
+      ///
+      /// Intended for streams without block headers: the skipped data is not
+      /// passed to the HeaderAnalyzer.
+      /// @param resync enables resynchronization.
+      /// @param confirmMessages is the number of messages that must decode correctly
+      ///        from a candidate message start before it is accepted.
+      void setResynchronize(bool resync, size_t confirmMessages = 2);
+
+      /// @brief Statistic: how many times decoding resumed after resynchronizing.
+      size_t resyncCount()const
+      {
+        return resyncCount_;
+      }
+
+      /// @brief Statistic: how many bytes were discarded while resynchronizing.
+      size_t resyncBytesSkipped()const
+      {
+        return resyncBytesSkipped_;
+      }
+
+      /// @brief Statistic: total time spent resynchronizing in microseconds.
+      ///
+      /// Measured from each decoding error to the point where decoding resumed,
+      /// including any time spent waiting for more data.
+      size_t resyncMicroseconds()const
+      {
+        return resyncMicroseconds_;
+      }
+
       ///////////////////////////
       // Implement Assembler
       virtual void receiverStarted(Communication::Receiver & receiver);
@@ -70,6 +108,10 @@ namespace QuickFAST
       StreamingAssembler(const StreamingAssembler &);
       StreamingAssembler();
 
+      /// @brief Scan the available data for the start of a message.
+      /// @returns true when a message start has been found; false if more data is needed.
+      bool resynchronize();
+
     private:
       HeaderAnalyzer & headerAnalyzer_;
       Messages::ValueMessageBuilder & builder_;
@@ -93,6 +135,15 @@ namespace QuickFAST
       size_t messageCount_;
       size_t byteCount_;
       size_t messageLimit_;
+
+      TemplateRegistryPtr templateRegistry_;
+      boost::scoped_ptr<ResyncScanner> resyncScanner_;
+      bool resyncing_;
+      boost::posix_time::ptime resyncStart_;
+      size_t resyncSkipped_;
+      size_t resyncCount_;
+      size_t resyncBytesSkipped_;
+      size_t resyncMicroseconds_;
     };
   }
 }
@@ -9,6 +9,7 @@
 
 #include <Codecs/TemplateRegistry.h>
 #include <Codecs/Decoder.h>
+#include <Codecs/StaticMessageBuilder.h>
 #include <Codecs/DataSource.h>
 #include <Messages/ValueMessageBuilder.h>
 
@@ -116,31 +117,61 @@ namespace QuickFAST{
         DataSource & source,
         Messages::ValueMessageBuilder & builder)
       {
-        while(source.messageAvailable() > 0 && (messageCountLimit_ == 0 || messageCount_ < messageCountLimit_))
+        while(nextMessage(source))
         {
-          if(resetOnMessage_)
-          {
-            decoder_.reset();
-          }
-//          if(headerBytes_ > 0)
-//          {
-//            std::cout << "Skipping [";
-            for(size_t nHeadByte = 0; nHeadByte < headerBytes_; ++nHeadByte)
-            {
-              uchar byte = 0;
-              if(!source.getByte(byte))
-              {
-                return;
-              }
-//              std::cout << std::hex << std::setw(2) << (unsigned short)byte << std::dec << ' ';
-            }
-//            std::cout << ']' << std::endl;
-//          }
           decoder_.decodeMessage(source, builder);
           messageCount_ += 1;
         }
       }
 
+      /// @brief Run the decoding process with a builder whose type is known.
+      ///
+      /// Like decode(), but uses Decoder::decodeMessage<Builder>() so integer fields
+      /// are delivered to the builder without a virtual call.
+      /// @param source supplies the FAST encoded data.
+      /// @param builder receives the decoded fields.  It must be a concrete type.
+      template<typename Builder>
+      void decodeStatic(
+        DataSource & source,
+        Builder & builder)
+      {
+        while(nextMessage(source))
+        {
+          decoder_.decodeMessage<Builder>(source, builder);
+          messageCount_ += 1;
+        }
+      }
+
+    private:
+      /// @brief Prepare to decode the next message.
+      /// @returns false if there are no more messages to be decoded.
+      bool nextMessage(DataSource & source)
+      {
+        if(source.messageAvailable() <= 0 || (messageCountLimit_ != 0 && messageCount_ >= messageCountLimit_))
+        {
+          return false;
+        }
+        if(resetOnMessage_)
+        {
+          decoder_.reset();
+        }
+//        if(headerBytes_ > 0)
+//        {
+//          std::cout << "Skipping [";
+          for(size_t nHeadByte = 0; nHeadByte < headerBytes_; ++nHeadByte)
+          {
+            uchar byte = 0;
+            if(!source.getByte(byte))
+            {
+              return false;
+            }
+//            std::cout << std::hex << std::setw(2) << (unsigned short)byte << std::dec << ' ';
+          }
+//          std::cout << ']' << std::endl;
+//        }
+        return true;
+      }
+
     private:
       SynchronousDecoder();
       SynchronousDecoder(const SynchronousDecoder &);
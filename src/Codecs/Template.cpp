@@ -5,6 +5,7 @@
 #include "Template.h"
 #include <Codecs/FieldInstruction.h>
 #include <Common/Exceptions.h>
+#include <Common/MemoryFootprint.h>
 using namespace QuickFAST;
 using namespace Codecs;
 
@@ -60,4 +61,12 @@ Template::display(std::ostream & output, size_t indent) const
   output << std::endl << indentString << "</template> <!-- " << templateId_ << "-->";
 }
 
-
+void
+Template::footprint(MemoryFootprint & footprint) const
+{
+  SegmentBody::footprint(footprint);
+  footprint.add("registry.instructions", sizeof(Template) - sizeof(SegmentBody));
+  footprint.addString("registry.strings", templateName_);
+  footprint.addString("registry.strings", templateNamespace_);
+  footprint.addString("registry.strings", namespace_);
+}
@@ -26,6 +26,7 @@ namespace QuickFAST{
         , templateId_(0)
         , reset_(false)
         , ignore_(false)
+        , viewable_(false)
       {
       }
 
@@ -80,6 +81,15 @@ namespace QuickFAST{
         ignore_ = ignore;
       }
 
+      /// @brief Mark this template as suitable for lazy decoding.
+      ///
+      /// Set by TemplateRegistry::finalize().  See LazyMessageView.
+      /// @param viewable true if the template uses no dictionaries.
+      void setViewable(bool viewable)
+      {
+        viewable_ = viewable;
+      }
+
       /// @brief Retrieve the template id
       /// @returns the template id.
       template_id_t getId()const
@@ -120,6 +130,17 @@ namespace QuickFAST{
         return ignore_;
       }
 
+      /// @brief can messages using this template be delivered as a LazyMessageView?
+      /// @returns true if the template has only scalar fields with no operator or constant.
+      bool isViewable()const
+      {
+        return viewable_;
+      }
+
+      /// @brief Add the bytes held by this template to a footprint.
+      /// @param footprint accumulates the result.
+      void footprint(MemoryFootprint & footprint) const;
+
       /// @brief use the namespace to qualify the local name
       /// @param out receives the qualified name
       void qualifyName(std::string &out)const
@@ -149,6 +170,7 @@ namespace QuickFAST{
       std::string namespace_;
       bool reset_; // if true reset dictionaries before Xcoding this template
       bool ignore_; // if true ignore the results of decoding this message.
+      bool viewable_; // if true the message can be delivered as a LazyMessageView
     };
   }
 }
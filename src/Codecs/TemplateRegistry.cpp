@@ -4,7 +4,9 @@
 #include <Common/QuickFASTPch.h>
 #include "TemplateRegistry.h"
 #include <Codecs/Template.h>
+#include <Common/MemoryFootprint.h>
 #include <Codecs/DictionaryIndexer.h>
+#include <Codecs/LazyMessageView.h>
 
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Codecs;
@@ -13,6 +15,7 @@ TemplateRegistry::TemplateRegistry()
 : presenceMapBits_(1) // every template requires 1 bit for the template ID
 , dictionarySize_(0)
 , maxFieldCount_(0)
+, flattenGroups_(false)
 {
 }
 
@@ -23,6 +26,7 @@ TemplateRegistry::TemplateRegistry(
 : presenceMapBits_(pmapBits)
 , dictionarySize_(dictionarySize)
 , maxFieldCount_(fieldCount)
+, flattenGroups_(false)
 {
 
 }
@@ -37,6 +41,7 @@ TemplateRegistry::finalize()
     ++mit)
   {
     (*mit)->finalize(*this);
+    (*mit)->setViewable(LazyMessageView::isViewable(**mit));
   }
 
   DictionaryIndexer indexer;
@@ -165,3 +170,26 @@ TemplateRegistry::display(std::ostream & output, size_t indent) const
   }
   output << std::endl << indentString << "</templates>" << std::endl;
 }
+
+void
+TemplateRegistry::footprint(MemoryFootprint & footprint) const
+{
+  footprint.add("registry.instructions", sizeof(TemplateRegistry)
+    + mutableTemplates_.capacity() * sizeof(TemplatePtr));
+  footprint.addString("registry.strings", name_);
+  footprint.addString("registry.strings", namespace_);
+  footprint.addString("registry.strings", templateNamespace_);
+  footprint.addString("registry.strings", dictionaryName_);
+  for(MutableTemplates::const_iterator it = mutableTemplates_.begin();
+    it != mutableTemplates_.end();
+    ++it)
+  {
+    (*it)->footprint(footprint);
+  }
+  for(TemplateNameMap::const_iterator it = namedTemplates_.begin();
+    it != namedTemplates_.end();
+    ++it)
+  {
+    footprint.addString("registry.strings", it->first);
+  }
+}
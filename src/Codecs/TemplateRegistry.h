@@ -13,6 +13,7 @@
 #include <Common/Types.h>
 #include <Codecs/SchemaElement.h>
 #include <Codecs/Template_fwd.h>
+#include <Common/MemoryFootprint_fwd.h>
 
 namespace QuickFAST{
   namespace Codecs{
@@ -59,6 +60,32 @@ namespace QuickFAST{
       /// @param value smart pointer to the template to be added
       virtual void addTemplate(TemplatePtr value);
 
+      /// @brief Flatten mandatory groups and static template references into their parent.
+      ///
+      /// Normally a group or static templateRef with an application type that differs
+      /// from its parent is delivered to the builder as a nested group (startGroup/endGroup.)
+      /// When flattening is enabled, finalize() arranges for the fields of every mandatory
+      /// group to be decoded directly into the parent's field set with names qualified
+      /// by the group name ("Header.SenderCompID".)  Groups inside a flattened group are
+      /// qualified by the full path.  Static templateRefs are flattened too, but their fields
+      /// keep the names used in the referenced template because that template is shared.
+      /// Optional groups are not affected.
+      ///
+      /// Encoders find the flattened fields by their qualified names in the parent.
+      /// The FAST encoding, including dictionary keys, does not change.
+      /// Must be set before finalize().
+      /// @param flatten enables flattening.
+      void setFlattenGroups(bool flatten)
+      {
+        flattenGroups_ = flatten;
+      }
+
+      /// @brief Should groups be flattened into their parent?  @see setFlattenGroups()
+      bool flattenGroups()const
+      {
+        return flattenGroups_;
+      }
+
       /// @brief do any final processing after parsing is complete.
       virtual void finalize();
 
@@ -89,6 +116,13 @@ namespace QuickFAST{
         return maxFieldCount_;
       }
 
+      /// @brief Add the bytes held by the templates in this registry to a footprint.
+      ///
+      /// Walks every instruction, so gather it once after finalize() rather than
+      /// with each statistics report; the registry does not change afterwards.
+      /// @param footprint accumulates the result.
+      void footprint(MemoryFootprint & footprint) const;
+
       /// @brief Use Template ID to find a template.
       /// @param[in] templateId the desired template
       /// @param[out] valueFound is the result of the search if return is true
@@ -213,6 +247,7 @@ namespace QuickFAST{
       size_t presenceMapBits_;
       size_t dictionarySize_;
       size_t maxFieldCount_;
+      bool flattenGroups_;
       std::string name_;
       std::string namespace_;
       std::string templateNamespace_;
@@ -1061,6 +1061,7 @@ TemplateBuilder::parseOp(const std::string & tag, const AttributeMap& attributes
 XMLTemplateParser::XMLTemplateParser()
 : out_(0)
 , nonstandard_(0)
+, flattenGroups_(false)
 {
   // This can throw an XMLException
   XMLPlatformUtils::Initialize();
@@ -1084,6 +1085,7 @@ XMLTemplateParser::parse(
   TemplateRegistryPtr templateRegistry(
     new TemplateRegistry
     );
+  templateRegistry->setFlattenGroups(flattenGroups_);
 
   TemplateBuilder templateBuilder(templateRegistry, out_, nonstandard_);
   boost::shared_ptr<SAX2XMLReader> reader(XMLReaderFactory::createXMLReader());
@@ -1128,3 +1130,9 @@ XMLTemplateParser::setNonstandard(unsigned long nonstandard)
 {
   nonstandard_ = nonstandard;
 }
+
+void
+XMLTemplateParser::setFlattenGroups(bool flatten)
+{
+  flattenGroups_ = flatten;
+}
@@ -149,6 +149,13 @@ namespace QuickFAST
       /// Some non-standard implementatons of FAST do not comply with the Specification
       /// @param nonstandard is a bitwise OR of the nonstandard featurse that should be allowed
       void setNonstandard(unsigned long nonstandard);
+
+      /// @brief Flatten groups in the parsed templates.
+      ///
+      /// The registry is finalized by parse() so this must be set first.
+      /// @see TemplateRegistry::setFlattenGroups()
+      /// @param flatten enables flattening.
+      void setFlattenGroups(bool flatten);
     private:
       // forbid copy constructor
       XMLTemplateParser(const XMLTemplateParser &);
@@ -157,6 +164,7 @@ namespace QuickFAST
     private:
       std::ostream * out_;
       unsigned long nonstandard_;
+      bool flattenGroups_;
     };
   }
 }
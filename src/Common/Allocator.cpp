@@ -0,0 +1,364 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "Allocator.h"
+#include <Common/MemoryFootprint.h>
+#include <boost/thread/tss.hpp>
+
+using namespace ::QuickFAST;
+
+namespace
+{
+  // The thread_specific_ptr does not own the Allocator.
+  void noCleanup(Allocator *)
+  {
+  }
+
+  // These are created on first use (fields are allocated during static initialization)
+  // and never destroyed (fields are freed during static destruction).
+  boost::thread_specific_ptr<Allocator> & currentAllocator()
+  {
+    static boost::thread_specific_ptr<Allocator> * current = new boost::thread_specific_ptr<Allocator>(noCleanup);
+    return *current;
+  }
+
+  // Set by setBufferAllocator() before connections start; zero means the default.
+  Allocator * bufferAllocatorPtr = 0;
+
+  size_t roundUp(size_t size, size_t unit)
+  {
+    return (size + unit - 1) / unit * unit;
+  }
+
+  // alignment for blocks carved from chunks and slabs.
+  const size_t alignment = 16;
+}
+
+const size_t PoolAllocator::granularity;
+
+Allocator::~Allocator()
+{
+}
+
+void
+Allocator::footprint(MemoryFootprint & /*footprint*/) const
+{
+}
+
+Allocator &
+Allocator::defaultAllocator()
+{
+  static Allocator * heap = new HeapAllocator;
+  return *heap;
+}
+
+Allocator &
+Allocator::bufferAllocator()
+{
+  if(bufferAllocatorPtr == 0)
+  {
+    return defaultAllocator();
+  }
+  return *bufferAllocatorPtr;
+}
+
+Allocator *
+Allocator::setBufferAllocator(Allocator * allocator)
+{
+  Allocator * previous = bufferAllocatorPtr;
+  bufferAllocatorPtr = allocator;
+  return previous;
+}
+
+Allocator &
+Allocator::current()
+{
+  Allocator * allocator = currentAllocator().get();
+  if(allocator == 0)
+  {
+    return defaultAllocator();
+  }
+  return *allocator;
+}
+
+Allocator *
+Allocator::setCurrent(Allocator * allocator)
+{
+  boost::thread_specific_ptr<Allocator> & current = currentAllocator();
+  Allocator * previous = current.get();
+  current.reset(allocator);
+  return previous;
+}
+
+void *
+Allocator::allocateBlock(size_t size)
+{
+  return allocateBlock(size, current());
+}
+
+void *
+Allocator::allocateBlock(size_t size, Allocator & allocator)
+{
+  BlockHeader * header = static_cast<BlockHeader *>(allocator.allocate(size + sizeof(BlockHeader)));
+  header->info_.allocator_ = &allocator;
+  header->info_.size_ = size + sizeof(BlockHeader);
+  return header + 1;
+}
+
+void
+Allocator::freeBlock(void * block)
+{
+  if(block != 0)
+  {
+    BlockHeader * header = static_cast<BlockHeader *>(block) - 1;
+    header->info_.allocator_->deallocate(header, header->info_.size_);
+  }
+}
+
+//////////////////
+// HeapAllocator
+
+HeapAllocator::HeapAllocator()
+{
+}
+
+HeapAllocator::~HeapAllocator()
+{
+}
+
+void *
+HeapAllocator::allocate(size_t size)
+{
+  return ::operator new(size);
+}
+
+void
+HeapAllocator::deallocate(void * block, size_t /*size*/)
+{
+  ::operator delete(block);
+}
+
+//////////////////
+// PoolAllocator
+
+PoolAllocator::PoolAllocator(
+    size_t maxPooledSize,
+    size_t slabSize,
+    Allocator * backing)
+  : maxPooledSize_(roundUp(maxPooledSize, granularity))
+  , slabSize_(slabSize < maxPooledSize_ ? maxPooledSize_ : slabSize)
+  , backing_(backing == 0 ? defaultAllocator() : *backing)
+  , freeLists_(maxPooledSize_ / granularity + 1, 0)
+  , largeBytes_(0)
+  , bytesInUse_(0)
+{
+}
+
+PoolAllocator::~PoolAllocator()
+{
+  for(size_t nSlab = 0; nSlab < slabs_.size(); ++nSlab)
+  {
+    backing_.deallocate(slabs_[nSlab], slabSize_);
+  }
+}
+
+void *
+PoolAllocator::allocate(size_t size)
+{
+  if(size > maxPooledSize_)
+  {
+    void * block = backing_.allocate(size);
+    largeBytes_ += size;
+    bytesInUse_ += size;
+    return block;
+  }
+  size_t sizeClass = (size + granularity - 1) / granularity;
+  FreeBlock * block = freeLists_[sizeClass];
+  if(block == 0)
+  {
+    refill(sizeClass);
+    block = freeLists_[sizeClass];
+  }
+  freeLists_[sizeClass] = block->next_;
+  bytesInUse_ += sizeClass * granularity;
+  return block;
+}
+
+void
+PoolAllocator::deallocate(void * block, size_t size)
+{
+  if(size > maxPooledSize_)
+  {
+    backing_.deallocate(block, size);
+    largeBytes_ -= size;
+    bytesInUse_ -= size;
+    return;
+  }
+  size_t sizeClass = (size + granularity - 1) / granularity;
+  FreeBlock * freeBlock = static_cast<FreeBlock *>(block);
+  freeBlock->next_ = freeLists_[sizeClass];
+  freeLists_[sizeClass] = freeBlock;
+  bytesInUse_ -= sizeClass * granularity;
+}
+
+size_t
+PoolAllocator::slabBytes()const
+{
+  return slabs_.size() * slabSize_;
+}
+
+size_t
+PoolAllocator::bytesInUse()const
+{
+  return bytesInUse_;
+}
+
+void
+PoolAllocator::footprint(MemoryFootprint & footprint) const
+{
+  footprint.add("allocator.reserved", slabs_.size() * slabSize_ + largeBytes_);
+  footprint.add("allocator.inUse", bytesInUse_);
+}
+
+void
+PoolAllocator::refill(size_t sizeClass)
+{
+  uchar * slab = static_cast<uchar *>(backing_.allocate(slabSize_));
+  slabs_.push_back(slab);
+  size_t blockSize = (sizeClass == 0 ? 1 : sizeClass) * granularity;
+  for(size_t offset = 0; offset + blockSize <= slabSize_; offset += blockSize)
+  {
+    FreeBlock * block = reinterpret_cast<FreeBlock *>(slab + offset);
+    block->next_ = freeLists_[sizeClass];
+    freeLists_[sizeClass] = block;
+  }
+}
+
+//////////////////////
+// LockedPoolAllocator
+
+LockedPoolAllocator::LockedPoolAllocator(
+    size_t maxPooledSize,
+    size_t slabSize,
+    Allocator * backing)
+  : PoolAllocator(maxPooledSize, slabSize, backing)
+{
+}
+
+LockedPoolAllocator::~LockedPoolAllocator()
+{
+}
+
+void *
+LockedPoolAllocator::allocate(size_t size)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return PoolAllocator::allocate(size);
+}
+
+void
+LockedPoolAllocator::deallocate(void * block, size_t size)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  PoolAllocator::deallocate(block, size);
+}
+
+size_t
+LockedPoolAllocator::slabBytes()const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return PoolAllocator::slabBytes();
+}
+
+size_t
+LockedPoolAllocator::bytesInUse()const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return PoolAllocator::bytesInUse();
+}
+
+void
+LockedPoolAllocator::footprint(MemoryFootprint & footprint) const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  PoolAllocator::footprint(footprint);
+}
+
+//////////////////
+// ArenaAllocator
+
+ArenaAllocator::ArenaAllocator(size_t chunkSize, Allocator * backing)
+  : chunkSize_(chunkSize)
+  , backing_(backing == 0 ? defaultAllocator() : *backing)
+  , next_(0)
+  , end_(0)
+  , bytesInUse_(0)
+{
+}
+
+ArenaAllocator::~ArenaAllocator()
+{
+  for(size_t nChunk = 0; nChunk < chunks_.size(); ++nChunk)
+  {
+    backing_.deallocate(chunks_[nChunk].base_, chunks_[nChunk].size_);
+  }
+}
+
+void *
+ArenaAllocator::allocate(size_t size)
+{
+  size_t needed = roundUp(size, alignment);
+  if(size_t(end_ - next_) < needed)
+  {
+    addChunk(needed > chunkSize_ ? needed : chunkSize_);
+  }
+  void * block = next_;
+  next_ += needed;
+  bytesInUse_ += needed;
+  return block;
+}
+
+void
+ArenaAllocator::deallocate(void * /*block*/, size_t /*size*/)
+{
+}
+
+void
+ArenaAllocator::footprint(MemoryFootprint & footprint) const
+{
+  size_t reserved = 0;
+  for(size_t nChunk = 0; nChunk < chunks_.size(); ++nChunk)
+  {
+    reserved += chunks_[nChunk].size_;
+  }
+  footprint.add("allocator.reserved", reserved);
+  footprint.add("allocator.inUse", bytesInUse_);
+}
+
+void
+ArenaAllocator::rewind()
+{
+  for(size_t nChunk = 1; nChunk < chunks_.size(); ++nChunk)
+  {
+    backing_.deallocate(chunks_[nChunk].base_, chunks_[nChunk].size_);
+  }
+  if(!chunks_.empty())
+  {
+    chunks_.resize(1);
+    next_ = chunks_[0].base_;
+    end_ = next_ + chunks_[0].size_;
+  }
+  bytesInUse_ = 0;
+}
+
+void
+ArenaAllocator::addChunk(size_t size)
+{
+  Chunk chunk;
+  chunk.base_ = static_cast<uchar *>(backing_.allocate(size));
+  chunk.size_ = size;
+  chunks_.push_back(chunk);
+  next_ = chunk.base_;
+  end_ = next_ + size;
+}
@@ -0,0 +1,395 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+#include "Allocator_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+#include <Common/MemoryFootprint_fwd.h>
+#include <boost/thread/mutex.hpp>
+
+namespace QuickFAST
+{
+  /// @brief Supply the memory used for messages, fields and buffers.
+  ///
+  /// Fields, message field sets, sequence entries and the string buffers they hold get
+  /// their memory from the current thread's Allocator via allocateBlock().  Each block
+  /// remembers the Allocator it came from so it is returned there after the current
+  /// Allocator has changed.  Whether it may be freed by a different thread depends
+  /// on that Allocator (see PoolAllocator, LockedPoolAllocator and ArenaAllocator.)
+  ///
+  /// Storage that outlives a message -- working buffers, receiver buffers and
+  /// dictionary values -- comes from the bufferAllocator(), so an Allocator
+  /// installed while messages are decoded holds only the decoded messages.
+  /// The bufferAllocator() is the defaultAllocator() unless setBufferAllocator()
+  /// replaces it, for example with an Allocator that maps huge pages.
+  ///
+  /// Unless setCurrent() (or an AllocatorScope) installs another one, the current Allocator
+  /// is a HeapAllocator which uses the global operator new.
+  ///
+  /// An Allocator must live longer than every block allocated from it.
+  class QuickFAST_Export Allocator
+  {
+  public:
+    virtual ~Allocator();
+
+    /// @brief Allocate memory.
+    /// @param size is the number of bytes needed.
+    /// @returns memory suitably aligned for any type.  Never zero: failure throws std::bad_alloc
+    virtual void * allocate(size_t size) = 0;
+
+    /// @brief Release memory.
+    /// @param block was returned by allocate()
+    /// @param size is the size that was requested from allocate()
+    virtual void deallocate(void * block, size_t size) = 0;
+
+    /// @brief Add the memory held by this Allocator to a footprint.
+    ///
+    /// Pooling allocators report the memory obtained from their backing Allocator as
+    /// "allocator.reserved" and the part handed out to messages, fields and buffers as
+    /// "allocator.inUse".  The default implementation adds nothing: the HeapAllocator
+    /// does not count its blocks, so install a PoolAllocator or ArenaAllocator to account
+    /// for the memory used by live messages.
+    /// @param footprint accumulates the result.
+    virtual void footprint(MemoryFootprint & footprint) const;
+
+    /// @brief The Allocator used by this thread.
+    static Allocator & current();
+
+    /// @brief Set the Allocator to be used by this thread.
+    /// @param allocator is the new Allocator, or zero to use the default.
+    /// @returns the previous value (zero if it was the default).
+    static Allocator * setCurrent(Allocator * allocator);
+
+    /// @brief The HeapAllocator used when no other Allocator has been set.
+    static Allocator & defaultAllocator();
+
+    /// @brief The Allocator for buffers and dictionary values that outlive a message.
+    static Allocator & bufferAllocator();
+
+    /// @brief Set the Allocator for buffers and dictionary values in all threads.
+    ///
+    /// Buffers are allocated by receiver and decoding threads, so set this before
+    /// any connection is started.  The Allocator must be thread safe and must
+    /// outlive every buffer allocated from it.  Blocks return to the Allocator
+    /// that supplied them, so replacing it later does not affect existing buffers.
+    /// @param allocator is the new Allocator, or zero to use the default.
+    /// @returns the previous value (zero if it was the default).
+    static Allocator * setBufferAllocator(Allocator * allocator);
+
+    /// @brief Allocate a block from the current Allocator.
+    /// @param size is the number of bytes needed.
+    /// @returns memory suitably aligned for any type.
+    static void * allocateBlock(size_t size);
+
+    /// @brief Allocate a block from a specific Allocator.
+    /// @param size is the number of bytes needed.
+    /// @param allocator supplies the memory regardless of the current Allocator.
+    /// @returns memory suitably aligned for any type.
+    static void * allocateBlock(size_t size, Allocator & allocator);
+
+    /// @brief Return a block to the Allocator that supplied it.
+    /// @param block was returned by allocateBlock() or is zero.
+    static void freeBlock(void * block);
+
+  private:
+    /// @brief Precedes each block returned by allocateBlock()
+    union BlockHeader
+    {
+      struct
+      {
+        Allocator * allocator_;
+        size_t size_;
+      } info_;
+      uint64 align_;
+      double alignDouble_;
+    };
+  };
+
+  /// @brief Install an Allocator for the current thread for the lifetime of this object.
+  class QuickFAST_Export AllocatorScope
+  {
+  public:
+    /// @brief Install allocator.
+    /// @param allocator will become the current Allocator.  If zero the current Allocator is unchanged.
+    explicit AllocatorScope(Allocator * allocator)
+      : active_(allocator != 0)
+      , previous_(0)
+    {
+      if(active_)
+      {
+        previous_ = Allocator::setCurrent(allocator);
+      }
+    }
+
+    /// @brief Restore the previous Allocator.
+    ~AllocatorScope()
+    {
+      if(active_)
+      {
+        Allocator::setCurrent(previous_);
+      }
+    }
+  private:
+    AllocatorScope(const AllocatorScope &);
+    AllocatorScope & operator=(const AllocatorScope &);
+  private:
+    bool active_;
+    Allocator * previous_;
+  };
+
+  /// @brief Allocate from the heap using the global operator new.
+  ///
+  /// This is the default Allocator.  It is thread safe.
+  class QuickFAST_Export HeapAllocator : public Allocator
+  {
+  public:
+    HeapAllocator();
+    virtual ~HeapAllocator();
+    virtual void * allocate(size_t size);
+    virtual void deallocate(void * block, size_t size);
+  };
+
+  /// @brief Recycle small blocks through free lists.
+  ///
+  /// Requests up to maxPooledSize bytes are rounded up to a multiple of
+  /// granularity bytes and served from a free list for that size.  The free lists
+  /// are refilled by carving slabs obtained from a backing Allocator.  Larger
+  /// requests go directly to the backing Allocator.
+  ///
+  /// A PoolAllocator belongs to one thread (normally the decoding thread): blocks
+  /// must be allocated and released on that thread, and the free lists are not locked.
+  /// The statistics are also read on that thread (see Receiver::connectionFootprint().)
+  /// ShardedMessageConsumer swaps each message into a queue slot and clears the slot's
+  /// previous contents on the decoding thread, so it works with a PoolAllocator.  If
+  /// blocks are released on another thread use a LockedPoolAllocator.
+  /// Slabs are released when the PoolAllocator is destroyed.
+  class QuickFAST_Export PoolAllocator : public Allocator
+  {
+  public:
+    /// @brief The size classes are multiples of this many bytes.
+    static const size_t granularity = 16;
+
+    /// @brief Construct
+    /// @param maxPooledSize is the largest request to be pooled.
+    /// @param slabSize is the number of bytes to request from the backing allocator at a time.
+    /// @param backing supplies the slabs.  Zero means the default allocator.
+    explicit PoolAllocator(
+      size_t maxPooledSize = 512,
+      size_t slabSize = 64 * 1024,
+      Allocator * backing = 0);
+    virtual ~PoolAllocator();
+    virtual void * allocate(size_t size);
+    virtual void deallocate(void * block, size_t size);
+
+    /// @brief How many bytes have been obtained from the backing allocator for slabs.
+    virtual size_t slabBytes()const;
+
+    /// @brief How many bytes are currently allocated, including requests too big to pool.
+    virtual size_t bytesInUse()const;
+
+    virtual void footprint(MemoryFootprint & footprint) const;
+
+  private:
+    struct FreeBlock
+    {
+      FreeBlock * next_;
+    };
+    void refill(size_t sizeClass);
+  private:
+    PoolAllocator(const PoolAllocator &);
+    PoolAllocator & operator=(const PoolAllocator &);
+  private:
+    size_t maxPooledSize_;
+    size_t slabSize_;
+    Allocator & backing_;
+    std::vector<FreeBlock *> freeLists_;
+    std::vector<void *> slabs_;
+    size_t largeBytes_;
+    size_t bytesInUse_;
+  };
+
+  /// @brief A PoolAllocator whose blocks may be released by any thread.
+  ///
+  /// Every request takes a mutex, so use this only when messages are released on a
+  /// thread other than the one that decoded them.
+  class QuickFAST_Export LockedPoolAllocator : public PoolAllocator
+  {
+  public:
+    /// @brief Construct
+    /// @param maxPooledSize is the largest request to be pooled.
+    /// @param slabSize is the number of bytes to request from the backing allocator at a time.
+    /// @param backing supplies the slabs.  Zero means the default allocator.  It must be
+    ///        thread safe.
+    explicit LockedPoolAllocator(
+      size_t maxPooledSize = 512,
+      size_t slabSize = 64 * 1024,
+      Allocator * backing = 0);
+    virtual ~LockedPoolAllocator();
+    virtual void * allocate(size_t size);
+    virtual void deallocate(void * block, size_t size);
+    virtual size_t slabBytes()const;
+    virtual size_t bytesInUse()const;
+    virtual void footprint(MemoryFootprint & footprint) const;
+
+  private:
+    mutable boost::mutex mutex_;
+  };
+
+  /// @brief Allocate by advancing a pointer through large chunks.
+  ///
+  /// deallocate() does nothing.  All memory is reclaimed at once by rewind(),
+  /// which makes the first chunk available again and releases the others, or when
+  /// the ArenaAllocator is destroyed.  The application must be finished with every
+  /// block (i.e. every message) before calling rewind().  Decoder, receiver and
+  /// dictionary storage never comes from the arena, so rewinding between messages
+  /// is safe while a connection is running.
+  ///
+  /// Chunks come from a backing Allocator so, for example, an arena can be built
+  /// on huge pages by supplying an Allocator that maps them.
+  ///
+  /// An ArenaAllocator is not thread safe: allocate from it on one thread.  Because
+  /// deallocate() does nothing, blocks may be released by any thread.
+  class QuickFAST_Export ArenaAllocator : public Allocator
+  {
+  public:
+    /// @brief Construct
+    /// @param chunkSize is the number of bytes to request from the backing allocator at a time.
+    /// @param backing supplies the chunks.  Zero means the default allocator.
+    explicit ArenaAllocator(size_t chunkSize = 1024 * 1024, Allocator * backing = 0);
+    virtual ~ArenaAllocator();
+    virtual void * allocate(size_t size);
+    virtual void deallocate(void * block, size_t size);
+
+    /// @brief Discard every block allocated from this arena.
+    void rewind();
+
+    /// @brief How many bytes have been handed out since construction or the last rewind().
+    size_t bytesInUse()const
+    {
+      return bytesInUse_;
+    }
+
+    virtual void footprint(MemoryFootprint & footprint) const;
+
+  private:
+    struct Chunk
+    {
+      uchar * base_;
+      size_t size_;
+    };
+    void addChunk(size_t size);
+  private:
+    ArenaAllocator(const ArenaAllocator &);
+    ArenaAllocator & operator=(const ArenaAllocator &);
+  private:
+    size_t chunkSize_;
+    Allocator & backing_;
+    std::vector<Chunk> chunks_;
+    uchar * next_;
+    uchar * end_;
+    size_t bytesInUse_;
+  };
+
+  /// @brief Adapt Allocator::allocateBlock() to the standard library allocator interface.
+  ///
+  /// Containers using this allocator take their memory from the thread's current Allocator.
+  template<typename T>
+  class StlAllocator
+  {
+  public:
+    /// @brief Standard allocator typedef
+    typedef T value_type;
+    /// @brief Standard allocator typedef
+    typedef T * pointer;
+    /// @brief Standard allocator typedef
+    typedef const T * const_pointer;
+    /// @brief Standard allocator typedef
+    typedef T & reference;
+    /// @brief Standard allocator typedef
+    typedef const T & const_reference;
+    /// @brief Standard allocator typedef
+    typedef size_t size_type;
+    /// @brief Standard allocator typedef
+    typedef std::ptrdiff_t difference_type;
+
+    /// @brief Standard allocator rebinding
+    template<typename U>
+    struct rebind
+    {
+      /// @brief the rebound allocator
+      typedef StlAllocator<U> other;
+    };
+
+    StlAllocator()
+    {
+    }
+
+    /// @brief Standard allocator conversion
+    template<typename U>
+    StlAllocator(const StlAllocator<U> &)
+    {
+    }
+
+    /// @brief Standard allocator method
+    pointer address(reference value)const
+    {
+      return &value;
+    }
+
+    /// @brief Standard allocator method
+    const_pointer address(const_reference value)const
+    {
+      return &value;
+    }
+
+    /// @brief Standard allocator method
+    pointer allocate(size_type count, const void * = 0)
+    {
+      return static_cast<pointer>(Allocator::allocateBlock(count * sizeof(T)));
+    }
+
+    /// @brief Standard allocator method
+    void deallocate(pointer block, size_type /*count*/)
+    {
+      Allocator::freeBlock(block);
+    }
+
+    /// @brief Standard allocator method
+    size_type max_size()const
+    {
+      return size_type(-1) / sizeof(T);
+    }
+
+    /// @brief Standard allocator method
+    void construct(pointer place, const T & value)
+    {
+      new (place) T(value);
+    }
+
+    /// @brief Standard allocator method
+    void destroy(pointer place)
+    {
+      place->~T();
+    }
+
+    /// @brief Blocks from any StlAllocator can be freed by any other.
+    template<typename U>
+    bool operator==(const StlAllocator<U> &)const
+    {
+      return true;
+    }
+
+    /// @brief Blocks from any StlAllocator can be freed by any other.
+    template<typename U>
+    bool operator!=(const StlAllocator<U> &)const
+    {
+      return false;
+    }
+  };
+}
+#endif // ALLOCATOR_H
@@ -0,0 +1,18 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef ALLOCATOR_FWD_H
+#define ALLOCATOR_FWD_H
+namespace QuickFAST
+{
+  class Allocator;
+  class AllocatorScope;
+  class HeapAllocator;
+  class PoolAllocator;
+  class LockedPoolAllocator;
+  class ArenaAllocator;
+}
+#endif /* ALLOCATOR_FWD_H */
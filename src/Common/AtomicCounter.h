@@ -41,6 +41,15 @@ namespace QuickFAST
       return atomic_decrement_long(&counter_);
     }
 
+    /// @brief Add atomically
+    /// @param value the amount to add
+    /// @returns the new value
+    inline
+    long operator +=(long value)
+    {
+      return atomic_add_to_long(&counter_, value);
+    }
+
     /// @brief Atomically set the value assuming it hasn't changed from "expected"
     /// @param expected the value that the counter must start with if this is to work
     /// @param value the new value to be stored in the counter
@@ -10,11 +10,13 @@
 #if defined(_WIN32)
 # include "windows.h"
 # if defined(_MSC_VER)
+#   include <intrin.h>
 #   pragma intrinsic(_InterlockedCompareExchange)
+#   pragma intrinsic(_ReadWriteBarrier)
 // No intrinsic compare and swap pointer so we asm it below
 # endif
 #elif defined(__GNUC__)
-#include <sys/atomic_op.h>
+// gcc builtins; no header needed.
 #else // something else.  Solaris maybe?
 #include <sys/atomic.h>
 #endif
@@ -52,7 +54,7 @@ namespace QuickFAST
       (PVOID volatile *)target, value, ifeq);
 # endif
 #elif defined(__GNUC__)
-# if 0 // force ASM on gcc (assume x86 processor)
+# if !defined(__i386__) // the asm below is for 32 bit x86 only
     return __sync_bool_compare_and_swap(target, ifeq, value);
 # else // force ASM on gcc
     bool result;
@@ -100,8 +102,8 @@ namespace QuickFAST
     return ifeq == _InterlockedCompareExchange(target, value, ifeq);
 # endif // cpu type
 #elif defined(__GNUC__)
-# if 0 // force ASM on gcc
-    return __sync_bool_`_swap(target, ifeq, value);
+# if !defined(__i386__) // the asm below is for 32 bit x86 only
+    return __sync_bool_compare_and_swap(target, ifeq, value);
 # else // force ASM on gcc
     bool result;
     asm(
@@ -132,11 +134,11 @@ namespace QuickFAST
 #elif defined(__GNUC__)
     return __sync_add_and_fetch(target, long(1));
 #else
-    return atomic_inc_long(target)
+    return atomic_inc_long_nv((volatile ulong_t *)target);
 #endif
   }
 
-  /// @brief Increment a long integer atomically
+  /// @brief Decrement a long integer atomically
   ///
   /// @param target points to the long to be updated
   inline
@@ -148,8 +150,75 @@ namespace QuickFAST
 #elif defined(__GNUC__)
     return __sync_sub_and_fetch(target, long(1));
 #else
-    return atomic_dec_long(target)
+    return atomic_dec_long_nv((volatile ulong_t *)target);
+#endif
+  }
+
+  /// @brief Add to a long integer atomically
+  ///
+  /// @param target points to the long to be updated
+  /// @param value is the amount to add
+  /// @returns the new value
+  inline
+  long atomic_add_to_long(volatile long * target, long value)
+  {
+#if defined(_WIN32)
+    return _InterlockedExchangeAdd(target, value) + value;
+#elif defined(__GNUC__)
+    return __sync_add_and_fetch(target, value);
+#else
+    return atomic_add_long_nv((volatile ulong_t *)target, value);
+#endif
+  }
+
+  /// @brief Read a long integer stored by another thread with atomic_write_long().
+  ///
+  /// Memory the other thread wrote before storing the value is visible
+  /// after this returns.
+  /// @param target points to the long to be read
+  inline
+  long atomic_read_long(const volatile long * target)
+  {
+    long value = *target;
+#if defined(_WIN32)
+    // x86 does not reorder loads, so only the compiler must be held back.
+    _ReadWriteBarrier();
+#elif defined(__GNUC__)
+# if defined(__i386__) || defined(__x86_64__)
+    // x86 does not reorder loads, so only the compiler must be held back.
+    __asm__ __volatile__("" ::: "memory");
+# else
+    __sync_synchronize();
+# endif
+#else
+    membar_consumer();
+#endif
+    return value;
+  }
+
+  /// @brief Store a long integer to be read by another thread with atomic_read_long().
+  ///
+  /// Memory written before this call is visible to the thread that reads the value.
+  /// Only one thread may store to target.
+  /// @param target points to the long to be updated
+  /// @param value is the new value
+  inline
+  void atomic_write_long(volatile long * target, long value)
+  {
+#if defined(_WIN32)
+    // x86 does not reorder stores, so only the compiler must be held back.
+    _ReadWriteBarrier();
+#elif defined(__GNUC__)
+# if defined(__i386__) || defined(__x86_64__)
+    // x86 does not reorder stores, so only the compiler must be held back.
+    __asm__ __volatile__("" ::: "memory");
+# else
+    __sync_synchronize();
+# endif
+#else
+    membar_producer();
 #endif
+    *target = value;
   }
 
 }
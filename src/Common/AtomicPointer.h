@@ -37,7 +37,7 @@ namespace QuickFAST
     bool CAS(Target * expected, Target * value)
     {
       return CASPtr(
-        static_cast<void * volatile * >(&pointer_),
+        reinterpret_cast<void * volatile * >(&pointer_),
         expected,
         value);
     }
@@ -113,6 +113,21 @@ namespace QuickFAST
       return v;
     }
 
+    /// @brief conditionally swap an unsigned 64 bit integer
+    ///
+    /// @param v the value to be swapped
+    /// @returns the swapped value
+    uint64 operator()(uint64 v) const
+    {
+      if(swap_)
+      {
+        return (uint64((*this)(uint32(v))) << 32)
+             | uint64((*this)(uint32(v >> 32)))
+             ;
+      }
+      return v;
+    }
+
     /// @brief Test the endianness of this machine.
     /// @returns true if big-endian.
     static bool isBigEndian()
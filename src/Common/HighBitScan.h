@@ -0,0 +1,44 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef HIGHBITSCAN_H
+#define HIGHBITSCAN_H
+#include <Common/Types.h>
+#include <cstring>
+
+namespace QuickFAST
+{
+  /// @brief Find the first byte with its high bit set.
+  ///
+  /// Checks eight bytes at a time until a word contains such a byte.  The high bit
+  /// is the FAST stop bit, and it marks every non-ASCII byte in UTF-8.
+  /// @param buffer contains the data to be searched.
+  /// @param size is the number of bytes in the buffer.
+  /// @param start is the position at which to start searching.
+  /// @returns the position of the byte, or size if there is none.
+  inline
+  size_t findHighBit(const uchar * buffer, size_t size, size_t start = 0)
+  {
+    const uint64 highBits = 0x8080808080808080ULL;
+    size_t pos = start;
+    while(pos + sizeof(uint64) <= size)
+    {
+      uint64 word;
+      std::memcpy(&word, buffer + pos, sizeof(word));
+      if((word & highBits) != 0)
+      {
+        break;
+      }
+      pos += sizeof(word);
+    }
+    while(pos < size && (buffer[pos] & 0x80) == 0)
+    {
+      ++pos;
+    }
+    return pos;
+  }
+}
+#endif // HIGHBITSCAN_H
@@ -0,0 +1,202 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef INTERNTABLE_H
+#define INTERNTABLE_H
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+
+namespace QuickFAST
+{
+  /// @brief Assign a small, stable integer id to each distinct string.
+  ///
+  /// The first string interned gets id 0, the next new string gets id 1, etc.
+  /// An id never changes and is never reused (until clear() is called) so it can be used
+  /// as an index into application tables (order books, positions, ...)
+  ///
+  /// Strings are copied into a single growing buffer.  Lookup is by open addressing
+  /// with linear probing in a power-of-two table that is kept no more than half full.
+  class InternTable
+  {
+  public:
+    /// @brief Construct an empty table.
+    /// @param limit is the maximum number of distinct strings to be interned.
+    explicit InternTable(size_t limit = 1000000)
+      : limit_(limit)
+      , mask_(0)
+    {
+    }
+
+    /// @brief Find or add a string.
+    /// @param value points to the string.
+    /// @param length is the number of bytes in the string.
+    /// @param[out] id is the id assigned to the string.
+    /// @returns false if the string is new and the table is full.
+    bool intern(const uchar * value, size_t length, uint32 & id)
+    {
+      uint32 hash = hashOf(value, length);
+      size_t slot = 0;
+      if(lookup(value, length, hash, slot, id))
+      {
+        return true;
+      }
+      if(entries_.size() >= limit_)
+      {
+        return false;
+      }
+      if((entries_.size() + 1) * 2 > slots_.size())
+      {
+        grow();
+        uint32 unused;
+        (void)lookup(value, length, hash, slot, unused);
+      }
+      id = uint32(entries_.size());
+      Entry entry;
+      entry.offset_ = storage_.size();
+      entry.length_ = length;
+      entry.hash_ = hash;
+      entries_.push_back(entry);
+      storage_.insert(storage_.end(), value, value + length);
+      slots_[slot] = id + 1;
+      return true;
+    }
+
+    /// @brief Find a string without adding it.
+    /// @param value points to the string.
+    /// @param length is the number of bytes in the string.
+    /// @param[out] id is the id of the string if it was found.
+    /// @returns true if the string was found.
+    bool find(const uchar * value, size_t length, uint32 & id)const
+    {
+      size_t slot = 0;
+      return lookup(value, length, hashOf(value, length), slot, id);
+    }
+
+    /// @brief Does id identify this string?
+    ///
+    /// Cheaper than find() when the id of a likely match is already known.
+    /// @param id identifies the candidate.
+    /// @param value points to the string.
+    /// @param length is the number of bytes in the string.
+    bool matches(uint32 id, const uchar * value, size_t length)const
+    {
+      if(id >= entries_.size())
+      {
+        return false;
+      }
+      const Entry & entry = entries_[id];
+      return entry.length_ == length
+        && (length == 0 || std::memcmp(&storage_[entry.offset_], value, length) == 0);
+    }
+
+    /// @brief Retrieve an interned string.
+    /// @param id identifies the string.
+    /// @param[out] value points to the string.  It remains valid until the next call to intern().
+    /// @param[out] length is the number of bytes in the string.
+    /// @returns false if id is unknown.
+    bool getValue(uint32 id, const uchar *& value, size_t & length)const
+    {
+      if(id >= entries_.size())
+      {
+        return false;
+      }
+      const Entry & entry = entries_[id];
+      length = entry.length_;
+      value = length == 0 ? reinterpret_cast<const uchar *>("") : &storage_[entry.offset_];
+      return true;
+    }
+
+    /// @brief How many distinct strings have been interned.
+    size_t size()const
+    {
+      return entries_.size();
+    }
+
+    /// @brief The maximum number of distinct strings.
+    size_t limit()const
+    {
+      return limit_;
+    }
+
+    /// @brief Forget all strings.  Ids will be reassigned starting from zero.
+    void clear()
+    {
+      entries_.clear();
+      storage_.clear();
+      slots_.clear();
+      mask_ = 0;
+    }
+
+  private:
+    struct Entry
+    {
+      size_t offset_;
+      size_t length_;
+      uint32 hash_;
+    };
+
+    static uint32 hashOf(const uchar * value, size_t length)
+    {
+      // FNV-1a
+      uint32 hash = 2166136261U;
+      for(size_t pos = 0; pos < length; ++pos)
+      {
+        hash ^= value[pos];
+        hash *= 16777619U;
+      }
+      return hash;
+    }
+
+    /// @brief find the slot holding the string, or the empty slot where it belongs.
+    bool lookup(const uchar * value, size_t length, uint32 hash, size_t & slot, uint32 & id)const
+    {
+      if(slots_.empty())
+      {
+        return false;
+      }
+      slot = hash & mask_;
+      for(;;)
+      {
+        uint32 occupant = slots_[slot];
+        if(occupant == 0)
+        {
+          return false;
+        }
+        if(entries_[occupant - 1].hash_ == hash && matches(occupant - 1, value, length))
+        {
+          id = occupant - 1;
+          return true;
+        }
+        slot = (slot + 1) & mask_;
+      }
+    }
+
+    void grow()
+    {
+      size_t size = slots_.empty() ? 64 : slots_.size() * 2;
+      slots_.assign(size, 0);
+      mask_ = size - 1;
+      for(size_t nEntry = 0; nEntry < entries_.size(); ++nEntry)
+      {
+        size_t slot = entries_[nEntry].hash_ & mask_;
+        while(slots_[slot] != 0)
+        {
+          slot = (slot + 1) & mask_;
+        }
+        slots_[slot] = uint32(nEntry + 1);
+      }
+    }
+
+  private:
+    size_t limit_;
+    size_t mask_;
+    std::vector<Entry> entries_;
+    /// id + 1 of the occupant; zero means empty
+    std::vector<uint32> slots_;
+    std::vector<uchar> storage_;
+  };
+}
+#endif // INTERNTABLE_H
@@ -0,0 +1,66 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "MemoryFootprint.h"
+
+using namespace ::QuickFAST;
+
+MemoryFootprint::MemoryFootprint()
+  : total_(0)
+{
+}
+
+void
+MemoryFootprint::add(const std::string & category, size_t bytes)
+{
+  categories_[category] += bytes;
+  total_ += bytes;
+}
+
+void
+MemoryFootprint::addString(const std::string & category, const std::string & value)
+{
+  size_t held = value.capacity() + 1;
+  if(held > sizeof(std::string))
+  {
+    add(category, held);
+  }
+}
+
+void
+MemoryFootprint::add(const MemoryFootprint & rhs)
+{
+  for(const_iterator it = rhs.begin(); it != rhs.end(); ++it)
+  {
+    add(it->first, it->second);
+  }
+}
+
+size_t
+MemoryFootprint::bytes(const std::string & category) const
+{
+  const_iterator it = categories_.find(category);
+  if(it == categories_.end())
+  {
+    return 0;
+  }
+  return it->second;
+}
+
+void
+MemoryFootprint::clear()
+{
+  categories_.clear();
+  total_ = 0;
+}
+
+void
+MemoryFootprint::write(std::ostream & out, const std::string & prefix) const
+{
+  for(const_iterator it = categories_.begin(); it != categories_.end(); ++it)
+  {
+    out << prefix << it->first << ' ' << it->second << std::endl;
+  }
+  out << prefix << "total " << total_ << std::endl;
+}
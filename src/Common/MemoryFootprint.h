@@ -0,0 +1,102 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef MEMORYFOOTPRINT_H
+#define MEMORYFOOTPRINT_H
+#include "MemoryFootprint_fwd.h"
+#include <Common/QuickFAST_Export.h>
+namespace QuickFAST
+{
+  /// @brief Accumulate the number of bytes held by QuickFAST objects, by category.
+  ///
+  /// Objects that hold significant memory provide a footprint() method that adds
+  /// their bytes to a MemoryFootprint.  The categories used are:
+  ///  - registry.instructions: template and field instruction objects
+  ///  - registry.strings: names, namespaces and operator values in the templates
+  ///  - registry.identities: field identities referenced by the templates
+  ///  - dictionary.entries: dictionary pages allocated by a Context
+  ///  - dictionary.strings: string values in the dictionary that did not fit in a Value
+  ///  - workingBuffer: the buffers used to assemble field values while decoding/encoding
+  ///  - receiver.buffers: the LinkedBuffer pool owned by a Receiver
+  ///  - receiver.queued: bytes received but not yet decoded
+  ///  - allocator.reserved: memory obtained by a pooling Allocator from its backing Allocator
+  ///  - allocator.inUse: the part of allocator.reserved currently handed out
+  ///
+  /// The values are sizes the objects already track (capacities, counts times sizes)
+  /// so gathering them is cheap enough to do periodically on a live connection.  They
+  /// are a lower bound: heap bookkeeping and small internal containers are not counted.
+  ///
+  /// Gather the footprint for each connection separately, then use add(const MemoryFootprint &)
+  /// to produce the total.  A MemoryFootprint is not synchronized, and neither are the
+  /// footprint() methods of objects the decoder changes (Context, Decoder, ArenaAllocator):
+  /// call those on the thread that decodes.  To monitor a running connection from another
+  /// thread use Receiver::connectionFootprint(), DecoderConnection::footprint() or
+  /// MulticastReceiverHandle::footprint(), which report a snapshot taken by the decoding thread.
+  class QuickFAST_Export MemoryFootprint
+  {
+  public:
+    /// @brief Bytes per category, ordered by category name.
+    typedef std::map<std::string, size_t> Categories;
+    /// @brief Iterate through the categories.
+    typedef Categories::const_iterator const_iterator;
+
+    MemoryFootprint();
+
+    /// @brief Add bytes to a category.
+    /// @param category names the kind of memory.
+    /// @param bytes is the number of bytes to add.
+    void add(const std::string & category, size_t bytes);
+
+    /// @brief Add the bytes a string holds outside the std::string object.
+    ///
+    /// Short strings held in the object itself (the small string optimization) add nothing.
+    /// @param category names the kind of memory.
+    /// @param value is the string to be counted.
+    void addString(const std::string & category, const std::string & value);
+
+    /// @brief Add every category of another footprint to this one.
+    /// @param rhs is the footprint to be added.
+    void add(const MemoryFootprint & rhs);
+
+    /// @brief How many bytes have been added to a category.
+    /// @param category names the kind of memory.
+    /// @returns the number of bytes; zero for an unknown category.
+    size_t bytes(const std::string & category) const;
+
+    /// @brief How many bytes have been added in all categories.
+    size_t total() const
+    {
+      return total_;
+    }
+
+    /// @brief Discard everything so the footprint can be gathered again.
+    void clear();
+
+    /// @brief Access the first category.
+    const_iterator begin() const
+    {
+      return categories_.begin();
+    }
+
+    /// @brief Access past the last category.
+    const_iterator end() const
+    {
+      return categories_.end();
+    }
+
+    /// @brief Write one "name bytes" line per category, followed by the total.
+    ///
+    /// The format matches the other statistics written by the example programs.
+    /// @param out is the stream to write to.
+    /// @param prefix is prepended to each name, for example to identify a connection.
+    void write(std::ostream & out, const std::string & prefix = "") const;
+
+  private:
+    Categories categories_;
+    size_t total_;
+  };
+}
+#endif /* MEMORYFOOTPRINT_H */
@@ -0,0 +1,13 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef MEMORYFOOTPRINT_FWD_H
+#define MEMORYFOOTPRINT_FWD_H
+namespace QuickFAST
+{
+  class MemoryFootprint;
+}
+#endif /* MEMORYFOOTPRINT_FWD_H */
@@ -33,6 +33,7 @@
 #include <vector>
 #include <map>
 #include <stack>
+#include <queue>
 #include <stdexcept>
 #include <math.h>
 #include <iostream>
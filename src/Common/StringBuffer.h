@@ -6,6 +6,7 @@
 #define StringBuffer_H
 // All inline, do not export.
 //#include <Common/QuickFAST_Export.h>
+#include <Common/Allocator.h>
 
 namespace QuickFAST
 {
@@ -164,7 +165,7 @@ namespace QuickFAST
     /// @brief destructor
     ~StringBufferT()
     {
-      delete[] heapBuffer_;
+      Allocator::freeBlock(heapBuffer_);
     }
 
     /// @brief change the actual size of the StringBufferT, shrinking or filling it as necessary
@@ -414,7 +415,7 @@ namespace QuickFAST
     /// @brief discard contents, thereby making this an empty StringBufferT.
     void clear()
     {
-      delete [] heapBuffer_;
+      Allocator::freeBlock(heapBuffer_);
       heapBuffer_ = 0;
       capacity_ = INTERNAL_CAPACITY;
       internalBuffer_[0] = 0;
@@ -465,6 +466,13 @@ namespace QuickFAST
       return capacity_;
     }
 
+    /// @brief how many bytes are held outside this object?
+    /// @returns zero while the string fits in the internal buffer.
+    size_t heapBytes() const
+    {
+      return heapBuffer_ == 0 ? 0 : capacity_ + 1;
+    }
+
     /// @brief expose the buffer as constant a C-style string
     /// note that we keep the buffer null terminated
     const unsigned char* c_str() const
@@ -480,6 +488,21 @@ namespace QuickFAST
 
     /// @brief be sure the StringBufferT can hold at least "needed" bytes.
     void reserve(size_t needed)
+    {
+      reserveFrom(needed, 0);
+    }
+
+    /// @brief be sure the StringBufferT can hold at least "needed" bytes.
+    ///
+    /// Any new storage comes from allocator rather than the current Allocator.
+    /// Use this for buffers that outlive the message being decoded.
+    void reserve(size_t needed, Allocator & allocator)
+    {
+      reserveFrom(needed, &allocator);
+    }
+
+  private:
+    void reserveFrom(size_t needed, Allocator * allocator)
     {
       if(delegateString_)
       {
@@ -498,21 +521,21 @@ namespace QuickFAST
         {
           throw std::logic_error("StringBufferT growth calculation incorrect");
         }
-        unsigned char * newBuffer(new unsigned char[needed + 1]);
-        if(newBuffer == 0)
-        {
-          throw std::bad_alloc();
-        }
+        unsigned char * newBuffer(static_cast<unsigned char *>(allocator == 0
+          ? Allocator::allocateBlock(needed + 1)
+          : Allocator::allocateBlock(needed + 1, *allocator)));
         const unsigned char * oldBuffer = getBuffer();
         std::memcpy(newBuffer, oldBuffer, size_);
         newBuffer[size_] = 0;
         capacity_ = needed;
-        delete [] heapBuffer_;
+        Allocator::freeBlock(heapBuffer_);
         heapBuffer_ = newBuffer;
         growCount_ += 1;
       }
     }
 
+  public:
+
     /// @brief replace the current contents with data from the character buffer
     void assign(
       const unsigned char * source,
@@ -0,0 +1,189 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef UTF8_H
+#define UTF8_H
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+#include <Common/HighBitScan.h>
+
+namespace QuickFAST
+{
+  /// @brief Validate UTF-8 encoded strings.
+  ///
+  /// Follows RFC 3629: overlong encodings, surrogates (U+D800..U+DFFF) and
+  /// values above U+10FFFF are invalid.
+  ///
+  /// Most strings in market data are pure ASCII, so the validator skips ASCII
+  /// bytes with findHighBit().
+  class Utf8
+  {
+  public:
+    /// @brief Find the first invalid byte in a string.
+    /// @param value points to the string.
+    /// @param length is the number of bytes in the string.
+    /// @returns the offset of the first byte of the first invalid sequence;
+    ///          length if the string is valid.
+    static size_t validate(const uchar * value, size_t length)
+    {
+      size_t pos = 0;
+      while(pos < length)
+      {
+        pos = findHighBit(value, length, pos);
+        if(pos < length)
+        {
+          size_t sequence = sequenceLength(value + pos, length - pos);
+          if(sequence == 0)
+          {
+            return pos;
+          }
+          pos += sequence;
+        }
+      }
+      return length;
+    }
+
+    /// @brief Is the string valid UTF-8?
+    /// @param value points to the string.
+    /// @param length is the number of bytes in the string.
+    /// @returns true if valid.
+    static bool isValid(const uchar * value, size_t length)
+    {
+      return validate(value, length) == length;
+    }
+
+    /// @brief Copy a string, replacing invalid sequences with U+FFFD (the replacement character.)
+    ///
+    /// Each maximal subpart of an invalid sequence is replaced by a single replacement
+    /// character (the practice recommended by the Unicode standard.)
+    /// @param value points to the string.
+    /// @param length is the number of bytes in the string.
+    /// @param[out] result receives the corrected string.
+    static void replaceInvalid(const uchar * value, size_t length, std::string & result)
+    {
+      result.clear();
+      result.reserve(length + 2);
+      size_t pos = 0;
+      while(pos < length)
+      {
+        size_t valid = pos + validate(value + pos, length - pos);
+        result.append(reinterpret_cast<const char *>(value + pos), valid - pos);
+        pos = valid;
+        if(pos < length)
+        {
+          result.append("\xEF\xBF\xBD");
+          pos += invalidLength(value + pos, length - pos);
+        }
+      }
+    }
+
+  private:
+    static bool isContinuation(uchar byte)
+    {
+      return (byte & 0xC0) == 0x80;
+    }
+
+    /// @brief The range of valid second bytes for a lead byte.
+    static void secondByteRange(uchar lead, uchar & low, uchar & high)
+    {
+      low = 0x80;
+      high = 0xBF;
+      if(lead == 0xE0)
+      {
+        low = 0xA0;   // overlong
+      }
+      else if(lead == 0xED)
+      {
+        high = 0x9F;  // surrogates
+      }
+      else if(lead == 0xF0)
+      {
+        low = 0x90;   // overlong
+      }
+      else if(lead == 0xF4)
+      {
+        high = 0x8F;  // > U+10FFFF
+      }
+    }
+
+    /// @brief How many bytes a lead byte requires (zero if it cannot start a sequence.)
+    static size_t expectedLength(uchar lead)
+    {
+      if(lead < 0x80)
+      {
+        return 1;
+      }
+      if(lead < 0xC2)
+      {
+        return 0;
+      }
+      if(lead < 0xE0)
+      {
+        return 2;
+      }
+      if(lead < 0xF0)
+      {
+        return 3;
+      }
+      if(lead < 0xF5)
+      {
+        return 4;
+      }
+      return 0;
+    }
+
+    /// @brief The length of the valid sequence at value, or zero if it is invalid.
+    static size_t sequenceLength(const uchar * value, size_t available)
+    {
+      size_t expected = expectedLength(value[0]);
+      if(expected == 0 || expected > available)
+      {
+        return 0;
+      }
+      if(expected > 1)
+      {
+        uchar low;
+        uchar high;
+        secondByteRange(value[0], low, high);
+        if(value[1] < low || value[1] > high)
+        {
+          return 0;
+        }
+        for(size_t nByte = 2; nByte < expected; ++nByte)
+        {
+          if(!isContinuation(value[nByte]))
+          {
+            return 0;
+          }
+        }
+      }
+      return expected;
+    }
+
+    /// @brief The length of the maximal subpart of the invalid sequence at value (at least one.)
+    static size_t invalidLength(const uchar * value, size_t available)
+    {
+      size_t expected = expectedLength(value[0]);
+      size_t length = 1;
+      if(expected > 1 && available > 1)
+      {
+        uchar low;
+        uchar high;
+        secondByteRange(value[0], low, high);
+        if(value[1] >= low && value[1] <= high)
+        {
+          length = 2;
+          while(length < expected && length < available && isContinuation(value[length]))
+          {
+            ++length;
+          }
+        }
+      }
+      return length;
+    }
+  };
+}
+#endif // UTF8_H
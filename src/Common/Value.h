@@ -11,6 +11,7 @@
 #include <Common/Exceptions.h>
 #include <Common/Decimal.h>
 #include <Common/StringBuffer.h>
+#include <Common/Allocator.h>
 namespace QuickFAST{
 
   /// @brief A container for several different types of values
@@ -173,6 +174,8 @@ namespace QuickFAST{
     {
       class_ = STRING;
       cachedString_ = true;
+      // Values live in dictionaries, so don't grow into a per-message Allocator.
+      string_.reserve(length, Allocator::bufferAllocator());
       string_.assign(value, length);
     }
 
@@ -231,6 +234,13 @@ namespace QuickFAST{
       return string_;
     }
 
+    /// @brief How many bytes does this value hold outside the Value object?
+    /// @returns the size of the string buffer's heap allocation, if any.
+    size_t heapBytes() const
+    {
+      return string_.heapBytes();
+    }
+
     /// @brief Does this field have a value?
     /// @return true if the field has a value.
     bool isDefined() const
@@ -502,7 +512,9 @@ namespace QuickFAST{
       {
         buffer << "[null]";
       }
-      string_ = buffer.str();
+      const std::string text = buffer.str();
+      string_.reserve(text.size(), Allocator::bufferAllocator());
+      string_ = text;
     }
 
 
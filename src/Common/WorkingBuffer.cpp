@@ -4,6 +4,8 @@
 #include <Common/QuickFASTPch.h>
 #include "WorkingBuffer.h"
 #include <Common/Exceptions.h>
+#include <Common/Allocator.h>
+#include <Common/MemoryFootprint.h>
 
 using namespace ::QuickFAST;
 static const size_t initialCapacity = 20;
@@ -12,7 +14,7 @@ WorkingBuffer::WorkingBuffer()
 , capacity_(initialCapacity)
 , startPos_(0)
 , endPos_(0)
-, buffer_(new uchar[initialCapacity])
+, buffer_(static_cast<uchar *>(Allocator::allocateBlock(initialCapacity, Allocator::bufferAllocator())))
 {
 }
 
@@ -21,14 +23,15 @@ WorkingBuffer::WorkingBuffer(const WorkingBuffer & rhs)
 , capacity_(rhs.capacity_)
 , startPos_(rhs.startPos_)
 , endPos_(rhs.endPos_)
-, buffer_(new uchar[rhs.capacity_])
+, buffer_(static_cast<uchar *>(Allocator::allocateBlock(rhs.capacity_, Allocator::bufferAllocator())))
 {
-  memcpy(buffer_.get(), rhs.buffer_.get(), capacity_);
+  memcpy(buffer_, rhs.buffer_, capacity_);
 }
 
 
 WorkingBuffer::~WorkingBuffer()
 {
+  Allocator::freeBlock(buffer_);
 }
 
 WorkingBuffer &
@@ -57,7 +60,7 @@ WorkingBuffer::swap(WorkingBuffer & rhs)
   swap_i(rhs.capacity_, capacity_);
   swap_i(rhs.startPos_, startPos_);
   swap_i(rhs.endPos_, endPos_);
-  rhs.buffer_.swap(buffer_);
+  std::swap(rhs.buffer_, buffer_);
 }
 
 
@@ -67,8 +70,9 @@ WorkingBuffer::clear(bool reverse, size_t capacity)
   reverse_ = reverse;
   if(capacity > capacity_)
   {
-    boost::scoped_array<uchar> newBuffer(new uchar[capacity]);
-    buffer_.swap(newBuffer);
+    uchar * newBuffer = static_cast<uchar *>(Allocator::allocateBlock(capacity, Allocator::bufferAllocator()));
+    Allocator::freeBlock(buffer_);
+    buffer_ = newBuffer;
     capacity_ = capacity;
   }
   if(reverse_)
@@ -82,6 +86,13 @@ WorkingBuffer::clear(bool reverse, size_t capacity)
   endPos_ = startPos_;
 }
 
+void
+WorkingBuffer::prefault(size_t capacity)
+{
+  clear(false, capacity);
+  std::memset(buffer_, 0, capacity_);
+}
+
 void
 WorkingBuffer::pop_front()
 {
@@ -132,14 +143,15 @@ WorkingBuffer::grow(size_t newCapacity)
   {
     newCapacity = initialCapacity;
   }
-  boost::scoped_array<uchar> newBuffer(new uchar[newCapacity]);
+  uchar * newBuffer = static_cast<uchar *>(Allocator::allocateBlock(newCapacity, Allocator::bufferAllocator()));
   size_t delta = 0;
   if(reverse_)
   {
     delta = newCapacity - oldCapacity;
   }
-  std::memcpy(newBuffer.get() + delta, buffer_.get(), capacity_);
-  buffer_.swap(newBuffer);
+  std::memcpy(newBuffer + delta, buffer_, capacity_);
+  Allocator::freeBlock(buffer_);
+  buffer_ = newBuffer;
   startPos_ += delta;
   endPos_ += delta;
   capacity_ = newCapacity;
@@ -156,7 +168,7 @@ WorkingBuffer::append(const WorkingBuffer & rhs)
     {
       grow(size() + bytesToAppend);
     }
-    std::memcpy(buffer_.get() + startPos_ - bytesToAppend, rhs.buffer_.get() + rhs.startPos_, bytesToAppend);
+    std::memcpy(buffer_ + startPos_ - bytesToAppend, rhs.buffer_ + rhs.startPos_, bytesToAppend);
     startPos_ -= bytesToAppend;
   }
   else
@@ -165,7 +177,7 @@ WorkingBuffer::append(const WorkingBuffer & rhs)
     {
       grow(size() + bytesToAppend);
     }
-    std::memcpy(buffer_.get() + endPos_, rhs.buffer_.get() + rhs.startPos_, bytesToAppend);
+    std::memcpy(buffer_ + endPos_, rhs.buffer_ + rhs.startPos_, bytesToAppend);
     endPos_ += bytesToAppend;
   }
 }
@@ -175,13 +187,13 @@ WorkingBuffer::toString(std::string & result) const
 {
   result.clear();
   result.reserve(size());
-  result.append(reinterpret_cast<const char *>(buffer_.get()) + startPos_, size());
+  result.append(reinterpret_cast<const char *>(buffer_) + startPos_, size());
 }
 
 void
 WorkingBuffer::hexDisplay(std::ostream & out, size_t wrap) const
 {
-  const unsigned char * ptr = buffer_.get() + startPos_;
+  const unsigned char * ptr = buffer_ + startPos_;
   size_t size = endPos_ - startPos_;
   out << std::hex << std::setfill('0');
   size_t pos = 0;
@@ -211,5 +223,11 @@ WorkingBuffer::operator ==(const WorkingBuffer & rhs) const
   {
     return false;
   }
-  return 0 == memcmp(buffer_.get(), rhs.buffer_.get(), size());
+  return 0 == memcmp(buffer_, rhs.buffer_, size());
+}
+
+void
+WorkingBuffer::footprint(MemoryFootprint & footprint) const
+{
+  footprint.add("workingBuffer", capacity_);
 }
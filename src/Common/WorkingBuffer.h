@@ -8,6 +8,7 @@
 #define BUFFER_H
 #include <Common/QuickFAST_Export.h>
 #include <Common/Types.h>
+#include <Common/MemoryFootprint_fwd.h>
 
 namespace QuickFAST{
   /// @brief A helper buffer for QuickFAST encoding and decoding.
@@ -48,6 +49,12 @@ namespace QuickFAST{
     /// @param capacity is the minimum size expected to be used.
     void clear(bool reverse, size_t capacity = 0);
 
+    /// @brief Allocate space in advance and touch it so it will not fault when first used.
+    ///
+    /// Discards the contents of the buffer.
+    /// @param capacity is the minimum size expected to be used.
+    void prefault(size_t capacity);
+
     /// @brief add a byte to the buffer
     ///
     /// the reverse parameter is honored so this is either push_back or push_front
@@ -58,14 +65,14 @@ namespace QuickFAST{
     /// @returns a uchar* to be used as an iterator
     const uchar * begin()const
     {
-      return buffer_.get() + startPos_;
+      return buffer_ + startPos_;
     }
 
     /// @brief Support forward iteration to the end of the buffer.
     /// @returns a uchar* to be used as an iterator
     const uchar * end()const
     {
-      return buffer_.get() + endPos_;
+      return buffer_ + endPos_;
     }
 
     /// @brief Discard a byte from the front of the buffer (ignores "reverse")
@@ -92,6 +99,13 @@ namespace QuickFAST{
       return capacity_;
     }
 
+    /// @brief Add the bytes held by this buffer to a footprint.
+    ///
+    /// The buffer never shrinks, so one oversized field value shows up here
+    /// for the life of the buffer.
+    /// @param footprint accumulates the result in the "workingBuffer" category.
+    void footprint(MemoryFootprint & footprint)const;
+
     ///@brief Apeend one working buffer to another
     ///
     /// if reverse append to the front of this buffer else append to the back
@@ -121,7 +135,8 @@ namespace QuickFAST{
     size_t capacity_;
     size_t startPos_;
     size_t endPos_;
-    boost::scoped_array<uchar> buffer_;
+    /// obtained from the Allocator::bufferAllocator() because it outlives any one message.
+    uchar * buffer_;
   };
 }
 
@@ -13,6 +13,7 @@
 #include <Codecs/Decoder.h>
 #include <Communication/LinkedBuffer.h>
 #include <Common/Logger.h>
+#include <Common/Allocator_fwd.h>
 
 namespace QuickFAST{
   namespace Communication
@@ -36,6 +37,7 @@ namespace QuickFAST{
         , logger_(logger)
         , strict_(true)
         , reset_(false)
+        , allocator_(0)
       {
       }
 
@@ -93,6 +95,25 @@ namespace QuickFAST{
         strict_ = strict;
       }
 
+      /// @brief Set the Allocator to be used while incoming buffers are processed.
+      ///
+      /// The Receiver installs it (see AllocatorScope) around calls to serviceQueue()
+      /// so the messages and fields decoded by this Assembler use it.  Receiver buffers,
+      /// the decoder's working buffer and dictionary values come from the default
+      /// Allocator, so an ArenaAllocator may be rewound between messages.
+      /// @param allocator must outlive the decoded messages.  Zero means use the thread's Allocator.
+      void setAllocator(Allocator * allocator)
+      {
+        allocator_ = allocator;
+      }
+
+      /// @brief Access the Allocator set by setAllocator()
+      /// @returns the Allocator or zero if none was set.
+      Allocator * getAllocator()const
+      {
+        return allocator_;
+      }
+
       /// @brief Provide direct access to the decoder.
       Codecs::Decoder & decoder()
       {
@@ -109,6 +130,8 @@ namespace QuickFAST{
       bool strict_;
       /// Reset the decoder for every message
       bool reset_;
+      /// Allocator for decoded messages (zero means the thread's Allocator)
+      Allocator * allocator_;
 
 
     };
@@ -155,21 +155,26 @@ namespace QuickFAST
             {
               // empty buffer? just use it again
               ++emptyPackets_;
-              idleBufferPool_.push(buffer);
+              recoverBuffer(buffer);
             }
             else if(paused_)
             {
               // We're paused.  Ignore incoming packets
               ++pausedPackets_;
-              idleBufferPool_.push(buffer);
+              recoverBuffer(buffer);
             }
             else
             {
-              ++packetsQueued_;
+              if(buffer != discardBuffer_.get())
+              {
+                // a packet read into the discard buffer is counted by queueBuffer() as dropped.
+                journalPacket(buffer->get(), bytesReceived);
+                ++packetsQueued_;
+              }
               bytesReceived_ += bytesReceived;
               largestPacket_ = std::max(largestPacket_, bytesReceived);
               buffer->setUsed(bytesReceived);
-              if(queue_.push(buffer, lock))
+              if(queueBuffer(buffer, lock))
               {
                 // A true return from push means that no one is servicing the queue
                 // Volunteer to service it. If it returns true, then the offer was
@@ -181,7 +186,7 @@ namespace QuickFAST
           else
           {
             // after an error, recover the buffer
-            idleBufferPool_.push(buffer);
+            recoverBuffer(buffer);
             // ignore errors during state transitions
             if(!paused_ && !stopping_)
             {
@@ -7,6 +7,7 @@
 // All inline, do not export.
 //#include <Common/QuickFAST_Export.h>
 #include "LinkedBuffer_fwd.h"
+#include <Common/Allocator.h>
 
 namespace QuickFAST
 {
@@ -20,7 +21,7 @@ namespace QuickFAST
       /// @param capacity is how many bytes to allocate
       LinkedBuffer(size_t capacity)
         : link_(0)
-        , buffer_(new unsigned char [capacity])
+        , buffer_(static_cast<unsigned char *>(Allocator::allocateBlock(capacity, Allocator::bufferAllocator())))
         , capacity_(capacity)
         , used_(0)
       {
@@ -42,7 +43,7 @@ namespace QuickFAST
       {
         if(capacity_ != 0)
         {
-          delete[] buffer_;
+          Allocator::freeBlock(buffer_);
         }
       }
 
@@ -93,7 +94,7 @@ namespace QuickFAST
       {
         if(capacity_ != 0)
         {
-          delete[] buffer_;
+          Allocator::freeBlock(buffer_);
           capacity_ = 0;
         }
         buffer_ = const_cast<unsigned char *>(externalBuffer);
@@ -386,6 +387,15 @@ namespace QuickFAST
         return !wasEmpty;
       }
 
+      /// @brief Remove the oldest buffer that has not yet been delivered for service.
+      ///
+      /// Used to discard data when buffers run out.
+      /// @returns the buffer, or zero if no undelivered buffers are queued.
+      LinkedBuffer * popIncoming(boost::mutex::scoped_lock &)
+      {
+        return incoming_.pop();
+      }
+
       /// @brief A nondestructive peek at the outgoing queue.
       const LinkedBuffer * peekOutgoing()const
       {
@@ -8,6 +8,14 @@
 //#include <Common/QuickFAST_Export.h>
 #include "MulticastReceiver_fwd.h"
 #include <Communication/AsynchReceiver.h>
+#include <Common/AtomicOps.h>
+#include <limits>
+#include <cstring>
+#if defined(__linux__)
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <errno.h>
+#endif // __linux__
 
 namespace QuickFAST
 {
@@ -35,6 +43,8 @@ namespace QuickFAST
         , endpoint_(listenInterface_, portNumber)
         , socket_(ioService_)
         , joined_(false)
+        , rxqOverflow_(false)
+        , overflowDrops_(0)
       {
       }
 
@@ -55,6 +65,8 @@ namespace QuickFAST
         , endpoint_(listenInterface_, portNumber)
         , socket_(ioService_.ioService())
         , joined_(false)
+        , rxqOverflow_(false)
+        , overflowDrops_(0)
       {
       }
 
@@ -68,6 +80,12 @@ namespace QuickFAST
         socket_.open(endpoint_.protocol());
         socket_.set_option(boost::asio::ip::udp::socket::reuse_address(true));
         socket_.bind(endpoint_);
+#if defined(SO_RXQ_OVFL)
+        // Ask the kernel to attach its drop counter to every packet we receive.
+        int enable = 1;
+        rxqOverflow_ = setsockopt(
+          socket_.native_handle(), SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)) == 0;
+#endif // SO_RXQ_OVFL
 
         if(assembler_->wantLog(Common::Logger::QF_LOG_INFO))
         {
@@ -146,11 +164,116 @@ namespace QuickFAST
         return socket_;
       }
 
+      /// @brief Statistic: How many packets were dropped because the socket's receive buffer was full.
+      ///
+      /// Where the socket accepts SO_RXQ_OVFL this is the kernel's drop counter as
+      /// delivered with the most recently received packet, so drops after that packet
+      /// are not seen until the next one arrives.
+      /// Otherwise, on Linux, the counter is read from /proc/net/udp.  This fallback
+      /// is relatively expensive, so call it to report statistics, not per-packet.
+      /// Elsewhere it is not available.
+      /// @returns the number of packets dropped, or zero if not available.
+      virtual size_t kernelDrops() const
+      {
+        if(rxqOverflow_)
+        {
+          return size_t(atomic_read_long(&overflowDrops_));
+        }
+        size_t drops = 0;
+#if defined(__linux__)
+        MulticastReceiver * self = const_cast<MulticastReceiver *>(this);
+        if(!self->socket_.is_open())
+        {
+          return 0;
+        }
+        struct stat status;
+        if(fstat(self->socket_.native_handle(), &status) != 0)
+        {
+          return 0;
+        }
+        const char * table = endpoint_.address().is_v6() ? "/proc/net/udp6" : "/proc/net/udp";
+        std::ifstream udp(table);
+        findSocketDrops(udp, static_cast<unsigned long>(status.st_ino), drops);
+#endif // __linux__
+        return drops;
+      }
+
+      /// @brief Find a socket's drop counter in the format of /proc/net/udp.
+      ///
+      /// Lines that do not have the expected columns, or whose inode or drops column is
+      /// not a decimal number, are skipped.
+      /// @param table is the contents of /proc/net/udp or /proc/net/udp6.
+      /// @param inode identifies the socket.
+      /// @param[out] drops is the socket's drop counter, if found.
+      /// @returns true if the socket was found.
+      static bool findSocketDrops(std::istream & table, unsigned long inode, size_t & drops)
+      {
+        std::string line;
+        // skip the column headings
+        std::getline(table, line);
+        while(std::getline(table, line))
+        {
+          // sl local rem st queues tr retrnsmt uid timeout inode ref pointer drops
+          std::istringstream input(line);
+          std::vector<std::string> columns;
+          std::string column;
+          while(input >> column)
+          {
+            columns.push_back(column);
+          }
+          unsigned long lineInode = 0;
+          unsigned long lineDrops = 0;
+          if(columns.size() > 12
+            && parseDecimal(columns[9], lineInode)
+            && lineInode == inode
+            && parseDecimal(columns[12], lineDrops))
+          {
+            drops = size_t(lineDrops);
+            return true;
+          }
+        }
+        return false;
+      }
+
 
     private:
+      static bool parseDecimal(const std::string & text, unsigned long & value)
+      {
+        if(text.empty())
+        {
+          return false;
+        }
+        value = 0;
+        for(size_t pos = 0; pos < text.size(); ++pos)
+        {
+          if(text[pos] < '0' || text[pos] > '9')
+          {
+            return false;
+          }
+          unsigned long digit = static_cast<unsigned long>(text[pos] - '0');
+          if(value > (std::numeric_limits<unsigned long>::max() - digit) / 10)
+          {
+            return false;
+          }
+          value = value * 10 + digit;
+        }
+        return true;
+      }
 
       bool fillBuffer(LinkedBuffer * buffer, boost::mutex::scoped_lock& lock)
       {
+        if(rxqOverflow_)
+        {
+          // asio cannot return ancillary data, so wait for the packet and read it with recvmsg.
+          socket_.async_receive(
+            boost::asio::null_buffers(),
+            boost::bind(&MulticastReceiver::handleReadable,
+            this,
+            boost::asio::placeholders::error,
+            buffer)
+            );
+          return true;
+        }
         socket_.async_receive_from(
           boost::asio::buffer(buffer->get(), buffer->capacity()),
           senderEndpoint_,
@@ -163,6 +286,58 @@ namespace QuickFAST
         return true;
       }
 
+      /// @brief Read a waiting packet and the drop counter that accompanies it.
+      void handleReadable(const boost::system::error_code& error, LinkedBuffer * buffer)
+      {
+        if(error)
+        {
+          handleReceive(error, buffer, 0);
+          return;
+        }
+#if defined(SO_RXQ_OVFL)
+        struct iovec data;
+        data.iov_base = buffer->get();
+        data.iov_len = buffer->capacity();
+        char control[CMSG_SPACE(sizeof(uint32_t))];
+        struct msghdr header;
+        std::memset(&header, 0, sizeof(header));
+        header.msg_name = senderEndpoint_.data();
+        header.msg_namelen = senderEndpoint_.capacity();
+        header.msg_iov = &data;
+        header.msg_iovlen = 1;
+        header.msg_control = control;
+        header.msg_controllen = sizeof(control);
+        ssize_t received = ::recvmsg(socket_.native_handle(), &header, MSG_DONTWAIT);
+        if(received < 0)
+        {
+          if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+          {
+            // someone else got it first, wait for the next one.
+            boost::mutex::scoped_lock lock(bufferMutex_);
+            fillBuffer(buffer, lock);
+            return;
+          }
+          handleReceive(
+            boost::system::error_code(errno, boost::asio::error::get_system_category()),
+            buffer,
+            0);
+          return;
+        }
+        for(struct cmsghdr * message = CMSG_FIRSTHDR(&header);
+          message != 0;
+          message = CMSG_NXTHDR(&header, message))
+        {
+          if(message->cmsg_level == SOL_SOCKET && message->cmsg_type == SO_RXQ_OVFL)
+          {
+            uint32_t drops = 0;
+            std::memcpy(&drops, CMSG_DATA(message), sizeof(drops));
+            atomic_write_long(&overflowDrops_, long(drops));
+          }
+        }
+        handleReceive(error, buffer, size_t(received));
+#endif // SO_RXQ_OVFL
+      }
+
     private:
       boost::asio::ip::address listenInterface_;
       boost::asio::ip::address multicastGroup_;
@@ -170,6 +345,10 @@ namespace QuickFAST
       boost::asio::ip::udp::endpoint senderEndpoint_;
       boost::asio::ip::udp::socket socket_;
       bool joined_;
+      /// true if the kernel delivers its drop counter with each packet.
+      bool rxqOverflow_;
+      /// The kernel drop counter from the most recent packet.
+      volatile long overflowDrops_;
     };
   }
 }
@@ -113,6 +113,12 @@ MulticastReceiverHandle::largestPacket() const
   return pImpl_->ptr_->largestPacket();
 }
 
+void
+MulticastReceiverHandle::footprint(MemoryFootprint & footprint) const
+{
+  pImpl_->ptr_->connectionFootprint(footprint);
+}
+
 
 void
 MulticastReceiverHandle::start(
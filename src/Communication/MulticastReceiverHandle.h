@@ -6,6 +6,7 @@
 #define MULTICASTRECEIVERHANDLE_H
 #include <Common/QuickFAST_Export.h>
 #include <Communication/Assembler_fwd.h>
+#include <Common/MemoryFootprint_fwd.h>
 
 namespace QuickFAST{
   namespace Communication {
@@ -73,6 +74,13 @@ namespace QuickFAST{
       /// @returns the number of bytes in the largest packet
       size_t largestPacket() const;
 
+      /// @brief Add the memory held by the receiver and its decoder to a footprint.
+      ///
+      /// The decoder's part is a snapshot taken by the decoding thread.
+      /// @see Receiver::connectionFootprint()
+      /// @param footprint accumulates the result.
+      void footprint(MemoryFootprint & footprint) const;
+
       /// @brief Start accepting packets.  Returns immediately
       /// @param assembler accepts and processes the filled buffers
       /// @param bufferSize determines the maximum size of an incoming packet
@@ -0,0 +1,181 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef PCAPMERGEREADER_H
+#define PCAPMERGEREADER_H
+// All inline, do not export.
+//#include <Common/QuickFAST_Export.h>
+#include "PCapMergeReader_fwd.h"
+#include <Communication/PCapReader.h>
+#include <Common/Exceptions.h>
+
+namespace QuickFAST
+{
+  namespace Communication
+  {
+    /// @brief Read several PCap files as a single stream of packets in time stamp order.
+    ///
+    /// Each file is a "channel."  Packets are returned in order by capture time stamp
+    /// regardless of which file they come from.  Packets with identical time stamps are
+    /// returned in channel order.  Packets within a channel are always returned in the
+    /// order in which they appear in the file.
+    ///
+    /// The merge holds at most one pending packet per channel (a k-way heap merge)
+    /// so no sorting of the captured data is needed.  Each PCapReader streams its file
+    /// through a bounded read-ahead window so the files are never loaded whole.
+    class PCapMergeReader
+    {
+    public:
+      PCapMergeReader()
+        : primed_(false)
+        , refill_(false)
+        , lastChannel_(0)
+        , timestamp_(0)
+      {
+      }
+
+      ~PCapMergeReader()
+      {
+      }
+
+      /// @brief Open a PCap file and add it to the merge as the next channel.
+      ///
+      /// All files must be opened before the first call to read().
+      /// @param filename names the file
+      /// @param wordSize is the word size of the platform where the file was captured (0 means native)
+      /// @returns true if the file was opened successfully.
+      bool open(const std::string & filename, size_t wordSize = 0)
+      {
+        if(primed_)
+        {
+          throw UsageError("Coding Error", "PCapMergeReader: Files must be opened before reading begins.");
+        }
+        PCapReaderPtr reader(new PCapReader);
+        if(wordSize == 32)
+        {
+          reader->set32bit(true);
+        }
+        else if (wordSize == 64)
+        {
+          reader->set64bit(true);
+        }
+        if(!reader->open(filename.c_str()))
+        {
+          return false;
+        }
+        readers_.push_back(reader);
+        return true;
+      }
+
+      /// @brief How many channels are being merged.
+      size_t channelCount()const
+      {
+        return readers_.size();
+      }
+
+      /// @brief enable noisy operation for debugging purposes
+      ///
+      /// @param verbose true turns on the noise.
+      void setVerbose(bool verbose)
+      {
+        for(Readers::iterator it = readers_.begin(); it != readers_.end(); ++it)
+        {
+          (*it)->setVerbose(verbose);
+        }
+      }
+
+      /// @brief Read the next packet in time stamp order.
+      ///
+      /// @param[out] channel is the index (in order of open()) of the file containing the packet
+      /// @param[out] buffer points to the user data in the packet.  It remains valid until
+      ///             the next call to read().
+      /// @param[out] size contains the number of bytes of user data in the packet
+      /// @returns true if a packet was read.  False means all files are exhausted.
+      bool read(size_t & channel, const unsigned char *& buffer, size_t & size)
+      {
+        if(!primed_)
+        {
+          primed_ = true;
+          for(size_t nChannel = 0; nChannel < readers_.size(); ++nChannel)
+          {
+            readNext(nChannel);
+          }
+        }
+        else if(refill_)
+        {
+          // Not until now: reading the next packet may reuse the previous packet's buffer.
+          refill_ = false;
+          readNext(lastChannel_);
+        }
+        if(pending_.empty())
+        {
+          return false;
+        }
+        Packet packet = pending_.top();
+        pending_.pop();
+        channel = packet.channel_;
+        buffer = packet.buffer_;
+        size = packet.size_;
+        timestamp_ = packet.timestamp_;
+        lastChannel_ = channel;
+        refill_ = true;
+        return true;
+      }
+
+      /// @brief The capture time of the packet returned by the most recent read().
+      ///
+      /// @returns the time stamp in microseconds since the epoch.
+      uint64 timestamp()const
+      {
+        return timestamp_;
+      }
+
+    private:
+      typedef boost::shared_ptr<PCapReader> PCapReaderPtr;
+      typedef std::vector<PCapReaderPtr> Readers;
+
+      struct Packet
+      {
+        uint64 timestamp_;
+        size_t channel_;
+        const unsigned char * buffer_;
+        size_t size_;
+      };
+
+      /// @brief Ordering for the heap: earliest time stamp (then lowest channel) on top.
+      struct Later
+      {
+        bool operator()(const Packet & lhs, const Packet & rhs) const
+        {
+          if(lhs.timestamp_ != rhs.timestamp_)
+          {
+            return lhs.timestamp_ > rhs.timestamp_;
+          }
+          return lhs.channel_ > rhs.channel_;
+        }
+      };
+
+      void readNext(size_t channel)
+      {
+        Packet packet;
+        if(readers_[channel]->read(packet.buffer_, packet.size_))
+        {
+          packet.timestamp_ = readers_[channel]->timestamp();
+          packet.channel_ = channel;
+          pending_.push(packet);
+        }
+      }
+
+    private:
+      Readers readers_;
+      std::priority_queue<Packet, std::vector<Packet>, Later> pending_;
+      bool primed_;
+      /// True if the channel that supplied the last packet needs another pending packet.
+      bool refill_;
+      size_t lastChannel_;
+      uint64 timestamp_;
+    };
+  }
+}
+#endif // PCAPMERGEREADER_H
@@ -0,0 +1,15 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef PCAPMERGEREADER_FWD_H
+#define PCAPMERGEREADER_FWD_H
+
+namespace QuickFAST{
+  namespace Communication{
+    class PCapMergeReader;
+    /// @brief smart pointer to a PCapMergeReader
+    typedef boost::shared_ptr<PCapMergeReader> PCapMergeReaderPtr;
+  }
+}
+#endif // PCAPMERGEREADER_FWD_H
@@ -209,43 +209,125 @@ namespace
   typedef uint32 checksum_t;
 #pragma pack(pop)
 
+  // Capture files can be larger than a long can address.
+  int seekFile(FILE * file, uint64 offset, int origin)
+  {
+#if defined(_MSC_VER)
+    return _fseeki64(file, int64(offset), origin);
+#else
+    return fseeko(file, off_t(offset), origin);
+#endif
+  }
+
+  uint64 tellFile(FILE * file)
+  {
+#if defined(_MSC_VER)
+    int64 offset = _ftelli64(file);
+#else
+    int64 offset = int64(ftello(file));
+#endif
+    return offset < 0 ? 0 : uint64(offset);
+  }
 }
 
-PCapReader::PCapReader()
-: fileSize_(0)
+PCapReader::PCapReader(size_t readAhead)
+: file_(0)
+, readAhead_(readAhead)
+, windowCapacity_(0)
+, windowPos_(0)
+, windowUsed_(0)
+, fileSize_(0)
 , pos_(0)
 , ok_(false)
 , usetv32_(false)
 , usetv64_(false)
 , linktype_(DLT_NULL)
+, timestamp_(0)
 , swap(false)
 , verbose_(false)
 {
 }
 
+PCapReader::~PCapReader()
+{
+  if(file_ != 0)
+  {
+    fclose(file_);
+  }
+}
+
 bool
 PCapReader::open(const char * filename)
 {
-  ok_ = true;
-  FILE * file = fopen(filename, "rb");
-  ok_ = file != 0;
-  if(ok_)
+  if(file_ != 0)
   {
-    fseek(file, 0, SEEK_END);
-    fileSize_ = ftell(file);
-    buffer_.reset(new unsigned char[fileSize_]);
-    fseek(file, 0, SEEK_SET);
-    size_t byteCount = fread(buffer_.get(), 1, fileSize_, file);
-    ok_ = byteCount == fileSize_;
-    fclose(file);
+    fclose(file_);
   }
+  fileSize_ = 0;
+  windowPos_ = 0;
+  windowUsed_ = 0;
+  file_ = fopen(filename, "rb");
+  ok_ = file_ != 0;
   if(ok_)
   {
+    // the window does the buffering.
+    setvbuf(file_, 0, _IONBF, 0);
+    seekFile(file_, 0, SEEK_END);
+    uint64 fileSize = tellFile(file_);
+    // positions are size_t; a file too big to address is read as far as possible.
+    fileSize_ = fileSize > uint64(size_t(-1)) ? size_t(-1) : size_t(fileSize);
+    seekFile(file_, 0, SEEK_SET);
     ok_ = rewind();
   }
   return ok_;
 }
 
+const unsigned char *
+PCapReader::fetch(size_t pos, size_t size)
+{
+  if(pos >= windowPos_ && pos + size <= windowPos_ + windowUsed_)
+  {
+    return window_.get() + (pos - windowPos_);
+  }
+  if(file_ == 0 || pos > fileSize_ || size > fileSize_ - pos)
+  {
+    return 0;
+  }
+  // Keep any part of the request that is already in the window.
+  size_t kept = 0;
+  if(pos >= windowPos_ && pos < windowPos_ + windowUsed_)
+  {
+    kept = windowPos_ + windowUsed_ - pos;
+  }
+  size_t capacity = std::max(readAhead_, size);
+  if(capacity > windowCapacity_)
+  {
+    boost::scoped_array<unsigned char> window(new unsigned char[capacity]);
+    if(kept != 0)
+    {
+      std::memcpy(window.get(), window_.get() + (pos - windowPos_), kept);
+    }
+    window_.swap(window);
+    windowCapacity_ = capacity;
+  }
+  else if(kept != 0)
+  {
+    std::memmove(window_.get(), window_.get() + (pos - windowPos_), kept);
+  }
+  windowPos_ = pos;
+  windowUsed_ = kept;
+  size_t wanted = std::min(windowCapacity_, fileSize_ - pos) - kept;
+  if(seekFile(file_, uint64(pos) + kept, SEEK_SET) == 0)
+  {
+    windowUsed_ += fread(window_.get() + kept, 1, wanted, file_);
+  }
+  if(windowUsed_ < size)
+  {
+    return 0;
+  }
+  return window_.get();
+}
+
 bool
 PCapReader::rewind()
 {
@@ -254,14 +336,15 @@ PCapReader::rewind()
 
   //////////////////////////
   // Process the file header
-  if(fileSize_ - pos_ < sizeof(pcap_file_header))
+  const pcap_file_header * fileHeader =
+    reinterpret_cast<const pcap_file_header *>(fetch(pos_, sizeof(pcap_file_header)));
+  if(fileHeader == 0)
   {
     std::cerr << "Invalid pcap file: no header." << std::endl;
     ok_ = false;
   }
   if(ok_)
   {
-    pcap_file_header * fileHeader = reinterpret_cast<pcap_file_header *>(buffer_.get() + pos_);
     pos_ += sizeof(pcap_file_header);
 
     if(fileHeader->magic != nativeMagic && fileHeader->magic != swappedMagic)
@@ -292,15 +375,16 @@ PCapReader::read(const unsigned char *& buffer, size_t & size)
   {
     ok_ = false;
     size_t skipped = 0;
-    size_t minBytes = sizeof(pcap_pkthdr) + sizeof(ip_header) + sizeof(udp_header);
+    size_t packetHeaderSize = sizeof(pcap_pkthdr);
     if(usetv32_)
     {
-      minBytes = sizeof(pcap_pkthdr32) + sizeof(ip_header) + sizeof(udp_header);
+      packetHeaderSize = sizeof(pcap_pkthdr32);
     }
     if(usetv64_)
     {
-      minBytes = sizeof(pcap_pkthdr64) + sizeof(ip_header) + sizeof(udp_header);
+      packetHeaderSize = sizeof(pcap_pkthdr64);
     }
+    size_t minBytes = packetHeaderSize + sizeof(ip_header) + sizeof(udp_header);
 
     while(!ok_ && (pos_ + minBytes < fileSize_))
     {
@@ -309,32 +393,51 @@ PCapReader::read(const unsigned char *& buffer, size_t & size)
       size_t headerPos = pos_;
       size_t datalen = 0;
       bool truncate = false;
-      unsigned int dataLinkType = 0;
+      const unsigned char * header = fetch(pos_, packetHeaderSize);
+      if(header == 0)
+      {
+        break;
+      }
+      pos_ += packetHeaderSize;
 
       if(usetv32_)
       {
-        pcap_pkthdr32 * packetHeader = reinterpret_cast<pcap_pkthdr32 *>(buffer_.get() + pos_);
-        pos_ += sizeof(pcap_pkthdr32);
+        const pcap_pkthdr32 * packetHeader = reinterpret_cast<const pcap_pkthdr32 *>(header);
         datalen = swap(packetHeader->caplen);
+        timestamp_ = uint64(swap(packetHeader->tv_sec)) * 1000000 + swap(packetHeader->tv_usec);
         truncate = (packetHeader->caplen != packetHeader->len);
       }
       else if(usetv64_)
       {
-        pcap_pkthdr64 * packetHeader = reinterpret_cast<pcap_pkthdr64 *>(buffer_.get() + pos_);
-        pos_ += sizeof(pcap_pkthdr64);
+        const pcap_pkthdr64 * packetHeader = reinterpret_cast<const pcap_pkthdr64 *>(header);
         datalen = swap(packetHeader->caplen);
+        timestamp_ = swap(packetHeader->tv_sec) * 1000000 + swap(packetHeader->tv_usec);
         truncate = (packetHeader->caplen != packetHeader->len);
       }
       else
       {
-        pcap_pkthdr * packetHeader = reinterpret_cast<pcap_pkthdr *>(buffer_.get() + pos_);
-        pos_ += sizeof(pcap_pkthdr);
+        const pcap_pkthdr * packetHeader = reinterpret_cast<const pcap_pkthdr *>(header);
         datalen = swap(packetHeader->caplen);
+        if(sizeof(packetHeader->ts.tv_sec) == sizeof(uint64))
+        {
+          timestamp_ = swap(uint64(packetHeader->ts.tv_sec)) * 1000000 + swap(uint64(packetHeader->ts.tv_usec));
+        }
+        else
+        {
+          timestamp_ = uint64(swap(uint32(packetHeader->ts.tv_sec))) * 1000000 + swap(uint32(packetHeader->ts.tv_usec));
+        }
         truncate = (packetHeader->caplen != packetHeader->len);
       }
-      if(truncate)
+      size_t packetEnd = pos_ + datalen;
+      const unsigned char * packet = 0;
+      if(!truncate)
+      {
+        packet = fetch(pos_, datalen);
+      }
+      if(packet == 0)
       {
-        pos_ += datalen;
+        // truncated by the capture or by the end of the file.
+        pos_ = packetEnd;
         skipped+= 1;
       }
       else
@@ -344,14 +447,14 @@ PCapReader::read(const unsigned char *& buffer, size_t & size)
         {
         case DLT_EN10MB:
           {
-            pos_ += sizeof(ethernetIIHeader);
+            packet += sizeof(ethernetIIHeader);
             datalen -= sizeof(ethernetIIHeader);
             found = true;
             break;
           }
         case DLT_LINUX_SLL:
           {
-            pos_ += sizeof(linuxCookedCaptureHeader);
+            packet += sizeof(linuxCookedCaptureHeader);
             datalen -= sizeof(linuxCookedCaptureHeader);
             found = true;
             break;
@@ -362,16 +465,16 @@ PCapReader::read(const unsigned char *& buffer, size_t & size)
             static unsigned short IPProtocol = 0x0008;
             while(!found && datalen - sizeof(checksum_t) > 2)
             {
-              unsigned short protocol = *(unsigned short *)(buffer_.get() + pos_);
+              unsigned short protocol = *(const unsigned short *)(packet);
               if(swap(protocol) == IPProtocol)
               {
                 found = true;
-                pos_ += 2;
+                packet += 2;
                 datalen -= 2;
               }
               else
               {
-                pos_ += 1;
+                packet += 1;
                 datalen -= 1;
               }
             }
@@ -380,33 +483,28 @@ PCapReader::read(const unsigned char *& buffer, size_t & size)
         }
         if(found)
         {
-          ip_header * ipHeader = reinterpret_cast<ip_header *>(buffer_.get() + pos_);
-          // IP header contains its own length expressed in 4 byte units.
-          size_t ipLen = (ipHeader->ver_ihl & 0xF) * 4;
-          pos_ += ipLen;
-          datalen -= ipLen;
-          pos_ += sizeof(udp_header);
-          datalen -= sizeof(udp_header);
+          size_t headerLength = udpHeaderLength(packet);
+          packet += headerLength;
+          datalen -= headerLength;
           // a 4 byte checksum appears at the end of the packet.  It is not part of the payload.
           if(datalen > sizeof(checksum_t))
           {
-            buffer = buffer_.get() + pos_;
+            buffer = packet;
             size = datalen - sizeof(checksum_t);
             if(verbose_)
             {
-              std::cout << "PCapReader: " << headerPos << ": " << pos_ << ' ' << datalen
-                << "=== 0x" << std::hex  << headerPos << ": 0x" << pos_ << " 0x" << datalen << std::dec << std::endl;
+              size_t payloadPos = packetEnd - datalen;
+              std::cout << "PCapReader: " << headerPos << ": " << payloadPos << ' ' << datalen
+                << "=== 0x" << std::hex  << headerPos << ": 0x" << payloadPos << " 0x" << datalen << std::dec << std::endl;
             }
             ok_ = true;
           }
-          pos_ += datalen;
         }
         else
         {
-          pos_ += datalen;
           skipped += 1;
         }
-
+        pos_ = packetEnd;
       }
     }
     if(skipped != 0)
@@ -417,6 +515,57 @@ PCapReader::read(const unsigned char *& buffer, size_t & size)
   return ok_;
 }
 
+size_t
+PCapReader::udpHeaderLength(const unsigned char * packet)
+{
+  const ip_header * ipHeader = reinterpret_cast<const ip_header *>(packet);
+  // IP header contains its own length expressed in 4 byte units.
+  size_t ipLen = (ipHeader->ver_ihl & 0xF) * 4;
+  return ipLen + sizeof(udp_header);
+}
+
+bool
+PCapReader::findUdpPayload(
+  const unsigned char * packet,
+  size_t length,
+  const unsigned char *& payload,
+  size_t & size)
+{
+  static const uchar udpProtocol = 17;
+  // offsets of fields in the ip and udp headers (all big endian)
+  static const size_t ipFlagsOffset = 6;
+  static const size_t udpLengthOffset = 4;
+  if(length < sizeof(ip_header) - sizeof(uint32) + sizeof(udp_header))
+  {
+    return false;
+  }
+  const ip_header * ipHeader = reinterpret_cast<const ip_header *>(packet);
+  if((ipHeader->ver_ihl >> 4) != 4 || ipHeader->proto != udpProtocol)
+  {
+    return false;
+  }
+  // fragments other than the first have no UDP header, and the first is incomplete.
+  uint16 flags = uint16((packet[ipFlagsOffset] << 8) | packet[ipFlagsOffset + 1]);
+  if((flags & 0x3FFF) != 0)
+  {
+    return false;
+  }
+  size_t headerLength = udpHeaderLength(packet);
+  if(headerLength > length)
+  {
+    return false;
+  }
+  const unsigned char * udp = packet + headerLength - sizeof(udp_header);
+  size_t udpLength = (size_t(udp[udpLengthOffset]) << 8) | udp[udpLengthOffset + 1];
+  if(udpLength < sizeof(udp_header) || headerLength + udpLength - sizeof(udp_header) > length)
+  {
+    return false;
+  }
+  payload = packet + headerLength;
+  size = udpLength - sizeof(udp_header);
+  return true;
+}
+
 void
 PCapReader::setVerbose(bool verbose)
 {
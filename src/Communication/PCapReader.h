@@ -22,10 +22,18 @@ namespace QuickFAST
     ///
     /// PCap is the format used by many communication utility data capture packages
     /// including Wireshark (aka Ethereal) and tcpdump.
+    ///
+    /// The file is read through a bounded read-ahead window rather than being loaded
+    /// whole, so memory use does not depend on the size of the capture.
     class QuickFAST_Export PCapReader
     {
     public:
-      PCapReader();
+      /// @brief Construct
+      /// @param readAhead is the number of bytes to read from the file at a time.
+      ///        The window grows if a single packet is larger than this.
+      explicit PCapReader(size_t readAhead = 64 * 1024);
+      ~PCapReader();
+
       /// @brief open a PCap formatted file
       ///
       /// @param filename names the file
@@ -50,10 +58,40 @@ namespace QuickFAST
       /// @brief Read the next record in the file.
       ///
       /// @param[out] buffer end up pointing to the user data in the packet (headers are bypassed)
+      ///             It remains valid until the next call to read(), rewind(), seek() or open()
       /// @param[out] size contains the number of bytes of user data in the packet (zero is possible and legal!)
       /// @returns true if the read was successful.  False usually means end of data
       bool read(const unsigned char *& buffer, size_t & size);
 
+      /// @brief The capture time of the packet returned by the most recent read().
+      ///
+      /// @returns the time stamp in microseconds since the epoch.
+      uint64 timestamp()const
+      {
+        return timestamp_;
+      }
+
+      /// @brief Find the length of the IP and UDP headers at the start of a packet.
+      ///
+      /// @param packet points to the IPv4 header
+      /// @returns the number of bytes before the UDP payload.
+      static size_t udpHeaderLength(const unsigned char * packet);
+
+      /// @brief Find the UDP payload of an IPv4 packet.
+      ///
+      /// Used by receivers that capture packets from the network
+      /// (see PacketRingReceiver.)
+      /// @param packet points to the IPv4 header
+      /// @param length is the number of bytes available at packet
+      /// @param[out] payload points to the UDP payload
+      /// @param[out] size is the length of the payload according to the UDP header.
+      /// @returns false if the packet is not a complete, unfragmented UDP datagram.
+      static bool findUdpPayload(
+        const unsigned char * packet,
+        size_t length,
+        const unsigned char *& payload,
+        size_t & size);
+
       /// @brief DEBUG ONLY.  Seek to a particular address.
       ///
       /// since there is no tell() method the address probably came from a verbose display.
@@ -80,7 +118,21 @@ namespace QuickFAST
       }
 
     private:
-      boost::scoped_array<unsigned char> buffer_;
+      PCapReader(const PCapReader &);
+      PCapReader & operator=(const PCapReader &);
+
+      /// @brief Make bytes [pos, pos + size) of the file available.
+      /// @returns a pointer to the bytes, or zero if they are beyond the end of file.
+      const unsigned char * fetch(size_t pos, size_t size);
+
+    private:
+      FILE * file_;
+      size_t readAhead_;
+      /// The read-ahead window holds bytes [windowPos_, windowPos_ + windowUsed_) of the file.
+      boost::scoped_array<unsigned char> window_;
+      size_t windowCapacity_;
+      size_t windowPos_;
+      size_t windowUsed_;
       size_t fileSize_;
       size_t pos_;
       bool ok_;
@@ -89,6 +141,7 @@ namespace QuickFAST
                       // neither usetv32_ nor usetv64_ means use native
                       // both is an (undetected) error.
       uint32 linktype_;
+      uint64 timestamp_;
       ByteSwapper swap;
       bool verbose_;
     };
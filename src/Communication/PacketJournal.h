@@ -0,0 +1,509 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef PACKETJOURNAL_H
+#define PACKETJOURNAL_H
+// All inline, do not export.
+//#include <Common/QuickFAST_Export.h>
+#include "PacketJournal_fwd.h"
+#include <Common/Types.h>
+#include <Common/AtomicOps.h>
+#include <Common/AtomicCounter.h>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace QuickFAST
+{
+  namespace Communication
+  {
+    /// @brief Record raw incoming packets in PCap format files.
+    ///
+    /// Attach a PacketJournal to a Receiver (see Receiver::setJournal()) to keep a copy of
+    /// every packet received along with its arrival time.
+    ///
+    /// The receive path copies each packet into a preallocated ring and returns
+    /// immediately.  It never waits: if the ring is full the packet is counted as dropped.
+    /// A background thread drains the ring into large sequential writes.  When a file
+    /// reaches the size limit a new file is started.  Files are named:
+    ///   baseName.000000.pcap, baseName.000001.pcap, ...
+    /// Each file is preallocated to the size limit when it is created and trimmed
+    /// to the bytes written when it is closed.  See setFileLimit() to keep only the
+    /// most recent files.
+    ///
+    /// If a file cannot be created the writer keeps the packets in the ring and tries
+    /// again, waiting longer after each failure (up to one second).  writeFailing() is
+    /// true meanwhile and openFailures() counts the attempts.
+    ///
+    /// Each packet is written with synthetic Ethernet/IP/UDP headers and the standard
+    /// (32 bit) PCap packet header so the files can be replayed using a PCapReader
+    /// or PCapFileReceiver with a word size of 32.
+    ///
+    /// record() must be called by only one thread at a time.  The Receiver guarantees this
+    /// by recording packets with its buffer lock held.  The statistics may be read from
+    /// any thread.
+    class PacketJournal
+    {
+    public:
+      /// @brief Construct and allocate the ring.
+      /// @param baseName is the path and prefix for the journal files
+      /// @param slotCount is the number of packets the ring can hold
+      /// @param slotSize is the largest packet that can be journaled.
+      /// @param fileSizeLimit is the size at which a new file will be started.
+      /// @param writeBufferSize is the size of the file write buffer.
+      PacketJournal(
+        const std::string & baseName,
+        size_t slotCount = 4096,
+        size_t slotSize = 1500,
+        size_t fileSizeLimit = 1024 * 1024 * 1024,
+        size_t writeBufferSize = 1024 * 1024)
+        : baseName_(baseName)
+        , slotCount_(slotCount)
+        , slotSize_(slotSize)
+        , fileSizeLimit_(fileSizeLimit)
+        , writeBufferSize_(writeBufferSize)
+        , slots_(new Slot[slotCount])
+        , data_(new unsigned char[slotCount * slotSize])
+        , writeBuffer_(new char[writeBufferSize])
+        , head_(0)
+        , tail_(0)
+        , stopping_(0)
+        , file_(0)
+        , fileNumber_(0)
+        , fileLimit_(0)
+        , bytesInFile_(0)
+        , recorded_(0)
+        , dropped_(0)
+        , oversized_(0)
+        , packetsWritten_(0)
+        , bytesWritten_(0)
+        , filesWritten_(0)
+        , writeErrors_(0)
+        , openFailures_(0)
+        , failing_(0)
+      {
+        // touch the memory now so the receive path doesn't take page faults.
+        std::memset(data_.get(), 0, slotCount * slotSize);
+      }
+
+      ~PacketJournal()
+      {
+        stop();
+      }
+
+      /// @brief Keep only the most recent files.
+      ///
+      /// When a new file is started the oldest one is removed.  Call before start().
+      /// @param fileLimit is the number of files to keep.  Zero (the default) keeps all files.
+      void setFileLimit(size_t fileLimit)
+      {
+        fileLimit_ = fileLimit;
+      }
+
+      /// @brief Start the background writer thread.
+      /// @returns true if the first journal file was created.  If not, the writer
+      /// thread is started anyway and keeps trying.
+      bool start()
+      {
+        if(bool(thread_))
+        {
+          return true;
+        }
+        atomic_write_long(&stopping_, 0);
+        bool opened = openFile();
+        thread_.reset(new boost::thread(boost::bind(&PacketJournal::writeLoop, this)));
+        return opened;
+      }
+
+      /// @brief Write any packets still in the ring, stop the writer thread, and close the file.
+      ///
+      /// If no file can be opened, one last attempt is made and the packets still in the
+      /// ring are counted as dropped.
+      void stop()
+      {
+        atomic_write_long(&stopping_, 1);
+        if(bool(thread_))
+        {
+          thread_->join();
+          thread_.reset();
+        }
+      }
+
+      /// @brief Copy a packet into the journal.
+      ///
+      /// Never blocks.
+      /// @param data points to the packet
+      /// @param size is the number of bytes in the packet
+      /// @returns true if the packet was journaled; false if it was dropped.
+      bool record(const unsigned char * data, size_t size)
+      {
+        if(size > slotSize_)
+        {
+          ++oversized_;
+          ++dropped_;
+          return false;
+        }
+        long head = head_;
+        if(depth(head, atomic_read_long(&tail_)) >= slotCount_)
+        {
+          ++dropped_;
+          return false;
+        }
+        size_t index = size_t(head) % slotCount_;
+        Slot & slot = slots_[index];
+        slot.timestamp_ = now();
+        slot.size_ = size;
+        std::memcpy(data_.get() + index * slotSize_, data, size);
+        atomic_write_long(&head_, advance(head));
+        ++recorded_;
+        return true;
+      }
+
+      /// @brief How many packets have been accepted into the ring.
+      size_t recorded()const
+      {
+        return size_t(static_cast<unsigned long>(recorded_));
+      }
+
+      /// @brief How many packets were dropped (ring full, packet too large, or unwritable at stop()).
+      size_t dropped()const
+      {
+        return size_t(static_cast<unsigned long>(dropped_));
+      }
+
+      /// @brief How many of the dropped packets were larger than the slot size.
+      size_t oversized()const
+      {
+        return size_t(static_cast<unsigned long>(oversized_));
+      }
+
+      /// @brief How many packets have been written to journal files.
+      size_t packetsWritten()const
+      {
+        return size_t(static_cast<unsigned long>(packetsWritten_));
+      }
+
+      /// @brief How many bytes have been written to journal files (including headers).
+      size_t bytesWritten()const
+      {
+        return size_t(static_cast<unsigned long>(bytesWritten_));
+      }
+
+      /// @brief How many journal files have been started.
+      size_t filesWritten()const
+      {
+        return size_t(static_cast<unsigned long>(filesWritten_));
+      }
+
+      /// @brief How many file write errors occurred.
+      size_t writeErrors()const
+      {
+        return size_t(static_cast<unsigned long>(writeErrors_));
+      }
+
+      /// @brief How many attempts to create a journal file failed.
+      size_t openFailures()const
+      {
+        return size_t(static_cast<unsigned long>(openFailures_));
+      }
+
+      /// @brief Is the writer unable to create a journal file?
+      ///
+      /// While this is true packets accumulate in the ring.  When the ring is full
+      /// they are dropped.
+      bool writeFailing()const
+      {
+        return atomic_read_long(&failing_) != 0;
+      }
+
+      /// @brief Construct the name of a journal file.
+      /// @param fileNumber is the sequence number of the file (starting at zero)
+      /// @returns the name of the file
+      std::string fileName(size_t fileNumber)const
+      {
+        std::stringstream name;
+        name << baseName_ << '.' << std::setw(6) << std::setfill('0') << fileNumber << ".pcap";
+        return name.str();
+      }
+
+    private:
+      struct Slot
+      {
+        uint64 timestamp_;
+        size_t size_;
+      };
+
+      // Sizes of the headers written for each packet.
+      static const size_t fileHeaderSize = 24;
+      static const size_t packetHeaderSize = 16;
+      static const size_t ethernetHeaderSize = 14;
+      static const size_t ipHeaderSize = 20;
+      static const size_t udpHeaderSize = 8;
+      static const size_t checksumSize = 4;
+
+      // Delays between attempts to create a journal file (milliseconds).
+      static const long firstRetryDelay = 1;
+      static const long maxRetryDelay = 1000;
+
+      // head_ and tail_ count from 0 to 2 * slotCount_ - 1 and wrap, so a full ring
+      // can be told from an empty one without the counts overflowing.
+      long advance(long position)const
+      {
+        ++position;
+        return position == long(2 * slotCount_) ? 0 : position;
+      }
+
+      size_t depth(long head, long tail)const
+      {
+        return size_t(head - tail + long(2 * slotCount_)) % (2 * slotCount_);
+      }
+
+      static uint64 now()
+      {
+        static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+        return (boost::posix_time::microsec_clock::universal_time() - epoch).total_microseconds();
+      }
+
+      void put(const void * data, size_t size)
+      {
+        size_t written = std::fwrite(data, 1, size, file_);
+        if(written != size)
+        {
+          ++writeErrors_;
+        }
+        bytesInFile_ += written;
+        bytesWritten_ += long(written);
+      }
+
+      // Reserve the disk space for a whole file so writes don't allocate blocks.
+      // A failure is not counted here: the writes report it if the disk is full.
+      bool preallocate()
+      {
+#if defined(_WIN32)
+        return _chsize_s(_fileno(file_), __int64(fileSizeLimit_)) == 0;
+#elif defined(__linux__)
+        return posix_fallocate(fileno(file_), 0, off_t(fileSizeLimit_)) == 0;
+#else
+        return ftruncate(fileno(file_), off_t(fileSizeLimit_)) == 0;
+#endif
+      }
+
+      // Remove the unused part of the preallocated space.
+      bool trim()
+      {
+        std::fflush(file_);
+#if defined(_WIN32)
+        return _chsize_s(_fileno(file_), __int64(bytesInFile_)) == 0;
+#else
+        return ftruncate(fileno(file_), off_t(bytesInFile_)) == 0;
+#endif
+      }
+
+      void put32(uint32 value)
+      {
+        put(&value, sizeof(value));
+      }
+
+      void put16(uint16 value)
+      {
+        put(&value, sizeof(value));
+      }
+
+      bool openFile()
+      {
+        file_ = std::fopen(fileName(fileNumber_).c_str(), "wb");
+        if(file_ == 0)
+        {
+          ++openFailures_;
+          atomic_write_long(&failing_, 1);
+          return false;
+        }
+        atomic_write_long(&failing_, 0);
+        if(fileLimit_ != 0 && fileNumber_ >= fileLimit_)
+        {
+          std::remove(fileName(fileNumber_ - fileLimit_).c_str());
+        }
+        ++fileNumber_;
+        ++filesWritten_;
+        std::setvbuf(file_, writeBuffer_.get(), _IOFBF, writeBufferSize_);
+        preallocate();
+        bytesInFile_ = 0;
+        // written in native byte order.  Readers check the magic number.
+        put32(0xa1b2c3d4);  // magic
+        put16(2);           // version_major
+        put16(4);           // version_minor
+        put32(0);           // thiszone
+        put32(0);           // sigfigs
+        put32(uint32(slotSize_ + ethernetHeaderSize + ipHeaderSize + udpHeaderSize + checksumSize)); // snaplen
+        put32(1);           // linktype: DLT_EN10MB
+        return true;
+      }
+
+      void closeFile()
+      {
+        if(file_ != 0)
+        {
+          if(!trim())
+          {
+            ++writeErrors_;
+          }
+          std::fclose(file_);
+          file_ = 0;
+        }
+      }
+
+      // Returns false if a new file was needed but could not be created.
+      bool writePacket(const Slot & slot, const unsigned char * data)
+      {
+        size_t udpLength = udpHeaderSize + slot.size_;
+        size_t ipLength = ipHeaderSize + udpLength;
+        size_t captureLength = ethernetHeaderSize + ipLength + checksumSize;
+        if(bytesInFile_ > fileHeaderSize
+          && bytesInFile_ + packetHeaderSize + captureLength > fileSizeLimit_)
+        {
+          closeFile();
+          if(!openFile())
+          {
+            return false;
+          }
+        }
+
+        put32(uint32(slot.timestamp_ / 1000000));
+        put32(uint32(slot.timestamp_ % 1000000));
+        put32(uint32(captureLength));
+        put32(uint32(captureLength));
+
+        unsigned char headers[ethernetHeaderSize + ipHeaderSize + udpHeaderSize];
+        std::memset(headers, 0, sizeof(headers));
+        unsigned char * ethernet = headers;
+        ethernet[12] = 0x08;   // ether_type = IP
+        unsigned char * ip = headers + ethernetHeaderSize;
+        ip[0] = 0x45;          // IPv4, 5 words of header
+        ip[2] = uchar(ipLength >> 8);
+        ip[3] = uchar(ipLength);
+        ip[8] = 1;             // ttl
+        ip[9] = 17;            // UDP
+        unsigned char * udp = ip + ipHeaderSize;
+        udp[4] = uchar(udpLength >> 8);
+        udp[5] = uchar(udpLength);
+        put(headers, sizeof(headers));
+        put(data, slot.size_);
+        put32(0);              // checksum
+        ++packetsWritten_;
+        return true;
+      }
+
+      // No file can be opened and the journal is stopping.
+      void discardUnwritten()
+      {
+        long tail = tail_;
+        long head = atomic_read_long(&head_);
+        dropped_ += long(depth(head, tail));
+        atomic_write_long(&tail_, head);
+      }
+
+      void writeLoop()
+      {
+        bool idle = false;
+        long retryDelay = firstRetryDelay;
+        for(;;)
+        {
+          bool stopping = atomic_read_long(&stopping_) != 0;
+          if(file_ == 0)
+          {
+            // The packets stay in the ring until a file can be created.
+            if(!openFile())
+            {
+              if(stopping)
+              {
+                discardUnwritten();
+                break;
+              }
+              boost::this_thread::sleep(boost::posix_time::milliseconds(retryDelay));
+              retryDelay *= 2;
+              if(retryDelay > maxRetryDelay)
+              {
+                retryDelay = maxRetryDelay;
+              }
+              continue;
+            }
+            retryDelay = firstRetryDelay;
+          }
+          long tail = tail_;
+          long head = atomic_read_long(&head_);
+          if(tail == head)
+          {
+            if(stopping)
+            {
+              break;
+            }
+            if(!idle)
+            {
+              std::fflush(file_);
+              idle = true;
+            }
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+          }
+          else
+          {
+            idle = false;
+            while(tail != head)
+            {
+              size_t index = size_t(tail) % slotCount_;
+              if(!writePacket(slots_[index], data_.get() + index * slotSize_))
+              {
+                break;
+              }
+              tail = advance(tail);
+              atomic_write_long(&tail_, tail);
+            }
+          }
+        }
+        closeFile();
+      }
+
+    private:
+      PacketJournal(const PacketJournal &);
+      PacketJournal & operator=(const PacketJournal &);
+
+    private:
+      std::string baseName_;
+      size_t slotCount_;
+      size_t slotSize_;
+      size_t fileSizeLimit_;
+      size_t writeBufferSize_;
+      boost::scoped_array<Slot> slots_;
+      boost::scoped_array<unsigned char> data_;
+      boost::scoped_array<char> writeBuffer_;
+
+      // head_ is stored only by record() and tail_ only by the writer thread.
+      volatile long head_;
+      volatile long tail_;
+      volatile long stopping_;
+      boost::scoped_ptr<boost::thread> thread_;
+
+      FILE * file_;
+      size_t fileNumber_;
+      size_t fileLimit_;
+      size_t bytesInFile_;
+
+      // Statistics: updated by the receive path or the writer thread, read by anyone.
+      // Where long is 32 bits they wrap at 4G.
+      AtomicCounter recorded_;
+      AtomicCounter dropped_;
+      AtomicCounter oversized_;
+      AtomicCounter packetsWritten_;
+      AtomicCounter bytesWritten_;
+      AtomicCounter filesWritten_;
+      AtomicCounter writeErrors_;
+      AtomicCounter openFailures_;
+      volatile long failing_;
+    };
+  }
+}
+#endif // PACKETJOURNAL_H
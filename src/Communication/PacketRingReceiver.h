@@ -0,0 +1,446 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef PACKETRINGRECEIVER_H
+#define PACKETRINGRECEIVER_H
+// All inline, do not export.
+//#include <Common/QuickFAST_Export.h>
+#include "PacketRingReceiver_fwd.h"
+#include <Communication/SynchReceiver.h>
+#include <Communication/PCapReader.h>
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+#include <linux/filter.h>
+
+namespace QuickFAST
+{
+  namespace Communication
+  {
+    /// @brief Receive UDP packets from a Linux TPACKET_V3 memory mapped ring.
+    ///
+    /// An AF_PACKET socket is bound to one network interface.  A BPF program
+    /// attached to the socket passes only UDP packets addressed to the multicast group
+    /// and port, so other traffic on the interface never reaches the ring.  The kernel
+    /// fills the ring a block at a time; a block is handed over when it is full or
+    /// when the block timeout expires.
+    ///
+    /// The Assembler receives the UDP payloads in place, so there is no system call
+    /// and no copy per packet.  A block is returned to the kernel when every buffer that
+    /// refers to it has been released.  Each LinkedBuffer can hold on to at most one
+    /// block, so blockCount must be larger than the number of buffers given to
+    /// Receiver::start() (plus any added by setAdaptiveBuffers().)
+    ///
+    /// Like the other synchronous receivers, Receiver::start() reads the first
+    /// packet before it returns, so it waits until traffic arrives (or stop() is called.)
+    ///
+    /// Opening the socket requires the CAP_NET_RAW capability (or root).
+    /// Only available on Linux.
+    class PacketRingReceiver
+      : public SynchReceiver
+    {
+    public:
+      /// @brief Construct given multicast information.
+      /// @param interfaceName names the network interface to capture from (e.g. "eth0")
+      /// @param multicastGroupIP multicast address as a text string
+      /// @param listenInterfaceIP address of the interface used to join the group.
+      ///        0.0.0.0 means "let the system choose"
+      /// @param portNumber port number
+      /// @param blockSize is the size of each block in the ring.  It must be a multiple
+      ///        of the page size.
+      /// @param blockCount is the number of blocks in the ring.
+      /// @param blockTimeout is how many milliseconds the kernel waits before
+      ///        handing over a block that is not full.
+      PacketRingReceiver(
+        const std::string & interfaceName,
+        const std::string & multicastGroupIP,
+        const std::string & listenInterfaceIP,
+        unsigned short portNumber,
+        size_t blockSize = 1024 * 1024,
+        size_t blockCount = 64,
+        unsigned int blockTimeout = 10
+        )
+        : SynchReceiver()
+        , interfaceName_(interfaceName)
+        , multicastGroupIP_(multicastGroupIP)
+        , listenInterfaceIP_(listenInterfaceIP)
+        , portNumber_(portNumber)
+        , blockSize_(blockSize)
+        , blockCount_(blockCount)
+        , blockTimeout_(blockTimeout)
+        , socket_(-1)
+        , memberSocket_(-1)
+        , ring_(0)
+        , ringSize_(0)
+        , blockIndex_(0)
+        , inBlock_(false)
+        , packet_(0)
+        , packetsLeft_(0)
+        , blocksReceived_(0)
+        , timestamp_(0)
+        , kernelDrops_(0)
+      {
+        if(blockCount_ < 2 || blockSize_ < frameSize)
+        {
+          throw UsageError("Coding Error", "PacketRingReceiver needs at least two blocks of at least 2048 bytes.");
+        }
+      }
+
+      ~PacketRingReceiver()
+      {
+        stop();
+        joinThreads();
+        close();
+      }
+
+      /// @brief Statistic: How many blocks has the kernel handed over.
+      size_t blocksReceived() const
+      {
+        return blocksReceived_;
+      }
+
+      /// @brief The time the kernel received the most recently delivered packet.
+      /// @returns the time in nanoseconds since the epoch.
+      uint64 timestamp() const
+      {
+        return timestamp_;
+      }
+
+      /// @brief Statistic: How many packets the kernel dropped because the ring was full.
+      ///
+      /// May be called from any thread.
+      virtual size_t kernelDrops() const
+      {
+        // Not bufferMutex_: the receive thread holds it while waiting for a block.
+        boost::mutex::scoped_lock lock(statisticsMutex_);
+        if(socket_ >= 0)
+        {
+          // reading the statistics resets them
+          tpacket_stats_v3 stats;
+          socklen_t length = sizeof(stats);
+          if(getsockopt(socket_, SOL_PACKET, PACKET_STATISTICS, &stats, &length) == 0)
+          {
+            kernelDrops_ += stats.tp_drops;
+          }
+        }
+        return kernelDrops_;
+      }
+
+    private:
+      static const size_t frameSize = 2048;
+
+      // Implement Receiver method
+      virtual bool initializeReceiver()
+      {
+        in_addr group;
+        in_addr listen;
+        if(inet_aton(multicastGroupIP_.c_str(), &group) == 0
+          || inet_aton(listenInterfaceIP_.c_str(), &listen) == 0)
+        {
+          throw UsageError("Coding Error", "PacketRingReceiver: invalid IP address.");
+        }
+        unsigned int interfaceIndex = if_nametoindex(interfaceName_.c_str());
+        if(interfaceIndex == 0)
+        {
+          fail("unknown interface " + interfaceName_);
+        }
+
+        // Protocol zero: no packets are delivered until bind().
+        socket_ = ::socket(AF_PACKET, SOCK_DGRAM, 0);
+        if(socket_ < 0)
+        {
+          fail("cannot open packet socket");
+        }
+
+        // The socket is SOCK_DGRAM so offsets are relative to the IP header.
+        sock_filter code[] = {
+          { BPF_LD  | BPF_B   | BPF_ABS, 0, 0, 9 },                     // IP protocol
+          { BPF_JMP | BPF_JEQ | BPF_K,   0, 8, IPPROTO_UDP },
+          { BPF_LD  | BPF_W   | BPF_ABS, 0, 0, 16 },                    // destination address
+          { BPF_JMP | BPF_JEQ | BPF_K,   0, 6, ntohl(group.s_addr) },
+          { BPF_LD  | BPF_H   | BPF_ABS, 0, 0, 6 },                     // fragment offset
+          { BPF_JMP | BPF_JSET| BPF_K,   4, 0, 0x1FFF },
+          { BPF_LDX | BPF_B   | BPF_MSH, 0, 0, 0 },                     // IP header length
+          { BPF_LD  | BPF_H   | BPF_IND, 0, 0, 2 },                     // destination port
+          { BPF_JMP | BPF_JEQ | BPF_K,   0, 1, portNumber_ },
+          { BPF_RET | BPF_K,             0, 0, 0xFFFFFFFF },            // accept
+          { BPF_RET | BPF_K,             0, 0, 0 }                      // drop
+        };
+        sock_fprog filter = {sizeof(code) / sizeof(code[0]), code};
+        if(setsockopt(socket_, SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) != 0)
+        {
+          fail("cannot attach filter");
+        }
+
+        int version = TPACKET_V3;
+        if(setsockopt(socket_, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0)
+        {
+          fail("TPACKET_V3 is not supported");
+        }
+        tpacket_req3 request;
+        memset(&request, 0, sizeof(request));
+        request.tp_block_size = static_cast<unsigned int>(blockSize_);
+        request.tp_block_nr = static_cast<unsigned int>(blockCount_);
+        request.tp_frame_size = static_cast<unsigned int>(frameSize);
+        request.tp_frame_nr = static_cast<unsigned int>(blockSize_ / frameSize * blockCount_);
+        request.tp_retire_blk_tov = blockTimeout_;
+        if(setsockopt(socket_, SOL_PACKET, PACKET_RX_RING, &request, sizeof(request)) != 0)
+        {
+          fail("cannot create receive ring");
+        }
+        ringSize_ = blockSize_ * blockCount_;
+        void * ring = mmap(0, ringSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, socket_, 0);
+        if(ring == MAP_FAILED)
+        {
+          // locking the ring is an optimization.  Try without it.
+          ring = mmap(0, ringSize_, PROT_READ | PROT_WRITE, MAP_SHARED, socket_, 0);
+        }
+        if(ring == MAP_FAILED)
+        {
+          fail("cannot map receive ring");
+        }
+        ring_ = static_cast<unsigned char *>(ring);
+        pins_.assign(blockCount_, 0);
+        walked_.assign(blockCount_, false);
+
+        sockaddr_ll address;
+        memset(&address, 0, sizeof(address));
+        address.sll_family = AF_PACKET;
+        address.sll_protocol = htons(ETH_P_IP);
+        address.sll_ifindex = interfaceIndex;
+        if(::bind(socket_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+        {
+          fail("cannot bind to " + interfaceName_);
+        }
+
+        if(IN_MULTICAST(ntohl(group.s_addr)))
+        {
+          // A UDP socket joins the group so the interface accepts the traffic.
+          // It is not bound, so it receives nothing itself.
+          memberSocket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+          ip_mreq join;
+          join.imr_multiaddr = group;
+          join.imr_interface = listen;
+          if(memberSocket_ < 0
+            || setsockopt(memberSocket_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &join, sizeof(join)) != 0)
+          {
+            fail("cannot join multicast group " + multicastGroupIP_);
+          }
+        }
+
+        if(assembler_->wantLog(Common::Logger::QF_LOG_INFO))
+        {
+          std::stringstream msg;
+          msg << "Capturing " << multicastGroupIP_ << ':' << portNumber_
+            << " from " << interfaceName_
+            << " into " << blockCount_ << " blocks of " << blockSize_ << " bytes.";
+          assembler_->logMessage(Common::Logger::QF_LOG_INFO, msg.str());
+        }
+        return true;
+      }
+
+      // Implement Receiver method
+      bool fillBuffer(LinkedBuffer * buffer, boost::mutex::scoped_lock& lock)
+      {
+        release(buffer);
+        while(!stopping_)
+        {
+          if(packetsLeft_ == 0)
+          {
+            if(!nextBlock())
+            {
+              return false;
+            }
+            continue;
+          }
+          tpacket3_hdr * packet = packet_;
+          if(--packetsLeft_ != 0)
+          {
+            packet_ = reinterpret_cast<tpacket3_hdr *>(
+              reinterpret_cast<unsigned char *>(packet_) + packet_->tp_next_offset);
+          }
+          const unsigned char * payload = 0;
+          size_t size = 0;
+          if(PCapReader::findUdpPayload(
+            reinterpret_cast<unsigned char *>(packet) + packet->tp_net,
+            packet->tp_snaplen,
+            payload,
+            size))
+          {
+            timestamp_ = uint64(packet->tp_sec) * 1000000000 + packet->tp_nsec;
+            bytesReceived_ += size;
+            ++pins_[blockIndex_];
+            buffer->setExternal(payload, size);
+            acceptFullBuffer(buffer, size, lock);
+            if(buffer == discardBuffer_.get())
+            {
+              release(buffer);
+            }
+            return true;
+          }
+          ++errorPackets_;
+        }
+        return false;
+      }
+
+      // Implement Receiver method
+      virtual void retireBuffer(LinkedBuffer * buffer)
+      {
+        release(buffer);
+      }
+
+      // Implement Receiver method
+      virtual void resetService()
+      {
+        return;
+      }
+
+      // Finish with the current block and wait for the kernel to hand over the next one.
+      // Called with bufferMutex_ locked.
+      bool nextBlock()
+      {
+        if(inBlock_)
+        {
+          inBlock_ = false;
+          walked_[blockIndex_] = true;
+          if(pins_[blockIndex_] == 0)
+          {
+            returnBlock(blockIndex_);
+          }
+          blockIndex_ = (blockIndex_ + 1) % blockCount_;
+          // idle buffers no longer need the data they refer to.
+          for(LinkedBuffer * buffer = idleBufferPool_.begin(); buffer != idleBufferPool_.end(); buffer = buffer->link())
+          {
+            release(buffer);
+          }
+        }
+        if(walked_[blockIndex_])
+        {
+          // Every block is in use.  Waiting would deadlock because the
+          // Assembler cannot release buffers until this call returns.
+          ++errorPackets_;
+          assembler_->reportCommunicationError(
+            "PacketRingReceiver: all ring blocks are held by buffers.  Use more blocks or fewer buffers.");
+          return false;
+        }
+        tpacket_block_desc * block = blockAt(blockIndex_);
+        while((block->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+        {
+          if(stopping_)
+          {
+            return false;
+          }
+          pollfd descriptor;
+          descriptor.fd = socket_;
+          descriptor.events = POLLIN | POLLERR;
+          descriptor.revents = 0;
+          // wake up now and then to check for stop()
+          if(::poll(&descriptor, 1, 100) < 0 && errno != EINTR)
+          {
+            fail("poll failed");
+          }
+        }
+        __sync_synchronize();
+        ++blocksReceived_;
+        inBlock_ = true;
+        packetsLeft_ = block->hdr.bh1.num_pkts;
+        packet_ = reinterpret_cast<tpacket3_hdr *>(
+          reinterpret_cast<unsigned char *>(block) + block->hdr.bh1.offset_to_first_pkt);
+        return true;
+      }
+
+      // The buffer no longer refers to the ring.
+      // Called with bufferMutex_ locked.
+      void release(LinkedBuffer * buffer)
+      {
+        const unsigned char * data = buffer->get();
+        if(buffer->capacity() == 0 && data >= ring_ && data < ring_ + ringSize_)
+        {
+          size_t index = (data - ring_) / blockSize_;
+          buffer->setExternal(0, 0);
+          if(--pins_[index] == 0 && walked_[index])
+          {
+            returnBlock(index);
+          }
+        }
+      }
+
+      void returnBlock(size_t index)
+      {
+        walked_[index] = false;
+        __sync_synchronize();
+        blockAt(index)->hdr.bh1.block_status = TP_STATUS_KERNEL;
+      }
+
+      tpacket_block_desc * blockAt(size_t index)
+      {
+        return reinterpret_cast<tpacket_block_desc *>(ring_ + index * blockSize_);
+      }
+
+      void fail(const std::string & what)
+      {
+        std::string reason = "PacketRingReceiver: " + what + ": " + strerror(errno);
+        close();
+        throw CommunicationError(reason);
+      }
+
+      void close()
+      {
+        if(ring_ != 0)
+        {
+          munmap(ring_, ringSize_);
+          ring_ = 0;
+        }
+        if(socket_ >= 0)
+        {
+          ::close(socket_);
+          socket_ = -1;
+        }
+        if(memberSocket_ >= 0)
+        {
+          ::close(memberSocket_);
+          memberSocket_ = -1;
+        }
+      }
+
+    private:
+      std::string interfaceName_;
+      std::string multicastGroupIP_;
+      std::string listenInterfaceIP_;
+      unsigned short portNumber_;
+      size_t blockSize_;
+      size_t blockCount_;
+      unsigned int blockTimeout_;
+      int socket_;
+      int memberSocket_;
+      unsigned char * ring_;
+      size_t ringSize_;
+      // the block being walked (or the next one expected from the kernel)
+      size_t blockIndex_;
+      bool inBlock_;
+      tpacket3_hdr * packet_;
+      size_t packetsLeft_;
+      // how many buffers refer to each block
+      std::vector<size_t> pins_;
+      // blocks that have been walked but are still referenced by buffers
+      std::vector<bool> walked_;
+      size_t blocksReceived_;
+      uint64 timestamp_;
+      // protects kernelDrops_ and the reset-on-read kernel statistics
+      mutable boost::mutex statisticsMutex_;
+      mutable size_t kernelDrops_;
+    };
+  }
+}
+#endif // __linux__
+#endif // PACKETRINGRECEIVER_H
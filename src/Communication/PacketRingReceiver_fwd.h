@@ -0,0 +1,15 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef PACKETRINGRECEIVER_FWD_H
+#define PACKETRINGRECEIVER_FWD_H
+
+namespace QuickFAST{
+  namespace Communication{
+    class PacketRingReceiver;
+    /// @brief smart pointer to a PacketRingReceiver
+    typedef boost::shared_ptr<PacketRingReceiver> PacketRingReceiverPtr;
+  }
+}
+#endif // PACKETRINGRECEIVER_FWD_H
@@ -9,16 +9,40 @@
 #include "Receiver_fwd.h"
 #include <Communication/Assembler.h>
 #include <Communication/LinkedBuffer.h>
+#include <Communication/PacketJournal.h>
 #include <Common/Exceptions.h>
+#include <Common/AtomicCounter.h>
+#include <Common/Allocator.h>
+#include <Common/MemoryFootprint.h>
 
 namespace QuickFAST
 {
   namespace Communication
   {
     /// @brief Receiver base class for receiving incoming data
+    ///
+    /// The Receiver reads into a pool of buffers.  If all buffers are busy (because the
+    /// Assembler has fallen behind) the pool may grow in slabs up to a memory limit
+    /// (see setAdaptiveBuffers().)  Buffers added this way are released again after
+    /// the burst ends.  When no more buffers can be added, the OverloadPolicy determines
+    /// what happens to incoming data.
     class Receiver
     {
     public:
+      /// @brief What to do when no buffer is available to receive incoming data.
+      enum OverloadPolicy
+      {
+        /// Stop reading until a buffer is released.  Data accumulates in the
+        /// kernel's socket buffer and may be lost there (see kernelDrops().)
+        /// This is the default.
+        BLOCK,
+        /// Keep reading, but discard incoming packets.
+        DROP_NEWEST,
+        /// Keep reading, reusing the buffer holding the oldest packet that is queued
+        /// but not yet being decoded.  If there is no such packet, drop the newest.
+        DROP_OLDEST
+      };
+
       Receiver()
         : bufferSize_(1400)
         , paused_(false)
@@ -35,6 +59,21 @@ namespace QuickFAST
         , packetsProcessed_(0)
         , bytesProcessed_(0)
         , largestPacket_(0)
+        , journal_(0)
+        , overloadPolicy_(BLOCK)
+        , slabBuffers_(0)
+        , memoryLimit_(0)
+        , shrinkDelay_(0)
+        , quietBatches_(0)
+        , baseBuffers_(0)
+        , totalBuffers_(0)
+        , slabsAdded_(0)
+        , slabsReleased_(0)
+        , blockedReads_(0)
+        , droppedNewest_(0)
+        , droppedOldest_(0)
+        , bytesDropped_(0)
+        , footprintRequested_(0)
       {
       }
 
@@ -58,17 +97,12 @@ namespace QuickFAST
         if(initializeReceiver())
         {
           assembler_->receiverStarted(*this);
+          publishFootprint();
 
           // Allocate initial set of buffers
           boost::mutex::scoped_lock lock(bufferMutex_);
-
-          for(size_t nBuffer = 0; nBuffer < bufferCount; ++nBuffer)
-          {
-            BufferLifetime buffer(new LinkedBuffer(bufferSize));
-            /// bufferLifetimes_ is used only to clean up on object destruction
-            bufferLifetimes_.push_back(buffer);
-            idleBufferPool_.push(buffer.get());
-          }
+          allocateBuffers(bufferCount, lock);
+          baseBuffers_ += bufferCount;
           startReceive(lock);
           result = true;
         }
@@ -82,16 +116,64 @@ namespace QuickFAST
         size_t bufferCount = 1)
       {
         boost::mutex::scoped_lock lock(bufferMutex_);
+        allocateBuffers(bufferCount, lock);
+        baseBuffers_ += bufferCount;
+      }
 
-        for(size_t nBuffer = 0; nBuffer < bufferCount; ++nBuffer)
+      /// @brief Let the buffer pool grow when all buffers are busy.
+      ///
+      /// Buffers allocated by start() and addBuffers() are never released.  Buffers
+      /// added automatically are released (one slab at a time) once the Assembler
+      /// has kept up for shrinkDelay batches in a row.
+      /// @param slabBuffers is how many buffers to add at a time.  Zero disables growth.
+      /// @param memoryLimit is the largest number of bytes to be used by all buffers.
+      /// @param shrinkDelay is how many batches must be processed without a buffer
+      ///        shortage before a slab is released.
+      void setAdaptiveBuffers(size_t slabBuffers, size_t memoryLimit, size_t shrinkDelay = 100)
+      {
+        boost::mutex::scoped_lock lock(bufferMutex_);
+        slabBuffers_ = slabBuffers;
+        memoryLimit_ = memoryLimit;
+        shrinkDelay_ = shrinkDelay;
+      }
+
+      /// @brief Choose what happens to incoming data when no buffer is available.
+      /// @param policy is the OverloadPolicy to apply.
+      void setOverloadPolicy(OverloadPolicy policy)
+      {
+        boost::mutex::scoped_lock lock(bufferMutex_);
+        overloadPolicy_ = policy;
+      }
+
+      /// @brief Touch every idle buffer so the first packets received do not cause page faults.
+      void prefaultBuffers()
+      {
+        boost::mutex::scoped_lock lock(bufferMutex_);
+        for(LinkedBuffer * buffer = idleBufferPool_.begin(); buffer != idleBufferPool_.end(); buffer = buffer->link())
         {
-          BufferLifetime buffer(new LinkedBuffer(bufferSize_));
-          /// bufferLifetimes_ is used only to clean up on object destruction
-          bufferLifetimes_.push_back(buffer);
-          idleBufferPool_.push(buffer.get());
+          std::memset(buffer->get(), 0, buffer->capacity());
         }
       }
 
+      /// @brief The size of each buffer (the largest packet that can be received).
+      size_t bufferSize() const
+      {
+        return bufferSize_;
+      }
+
+      /// @brief Keep a copy of every packet received.
+      ///
+      /// The journal is filled from the receive path without blocking, so the receiver
+      /// does not guard against the journal being changed during a copy.  Attach the
+      /// journal before start(), and remove or replace it only after stop() and
+      /// joinThreads() have returned.
+      /// @param journal receives a copy of each packet.  It must outlive the receiver
+      ///        (or be removed by calling setJournal(0) while the receiver is stopped).
+      void setJournal(PacketJournal * journal)
+      {
+        journal_ = journal;
+      }
+
       ////////////////////////////////////////////////////////////////////
       // public methods to be implemented by specific types of receiver
 
@@ -266,20 +348,145 @@ namespace QuickFAST
         if( !readInProgress_ && !stopping_)
         {
           LinkedBuffer *buffer = idleBufferPool_.pop();
+          if(buffer == 0)
+          {
+            buffer = overloadBuffer(lock);
+          }
           if(buffer != 0)
           {
             readInProgress_ = true;
             if(!fillBuffer(buffer, lock))
             {
-              idleBufferPool_.push(buffer);
+              recoverBuffer(buffer);
               readInProgress_ = false;
               stop();
             }
           }
-          else
+        }
+      }
+
+      /// @brief Copy a packet to the journal, if any.
+      ///
+      /// Call with bufferMutex_ locked, once the packet has been accepted for delivery
+      /// and before the buffer is queued, so only one thread records at a time.
+      /// PacketJournal::record() only copies the packet into its ring.
+      /// @param data points to the packet.
+      /// @param size is the number of bytes in the packet.
+      void journalPacket(const unsigned char * data, size_t size)
+      {
+        if(journal_ != 0)
+        {
+          journal_->record(data, size);
+        }
+      }
+
+      /// @brief Queue a buffer full of data to be processed.
+      ///
+      /// If the buffer was filled under the DROP_NEWEST policy the data is discarded.
+      /// @param buffer contains the data.
+      /// @param lock to be sure we have it.
+      /// @returns true if the queue needs service.
+      bool queueBuffer(LinkedBuffer * buffer, boost::mutex::scoped_lock & lock)
+      {
+        if(buffer == discardBuffer_.get())
+        {
+          ++droppedNewest_;
+          bytesDropped_ += buffer->used();
+          return false;
+        }
+        return queue_.push(buffer, lock);
+      }
+
+      /// @brief Return a buffer that will not be queued to the idle pool.
+      ///
+      /// Call with bufferMutex_ locked.
+      /// @param buffer is the buffer to be recovered.
+      void recoverBuffer(LinkedBuffer * buffer)
+      {
+        if(buffer != discardBuffer_.get())
+        {
+          idleBufferPool_.push(buffer);
+        }
+      }
+
+    private:
+      void allocateBuffers(size_t bufferCount, boost::mutex::scoped_lock &)
+      {
+        for(size_t nBuffer = 0; nBuffer < bufferCount; ++nBuffer)
+        {
+          BufferLifetime buffer(new LinkedBuffer(bufferSize_));
+          /// bufferLifetimes_ is used to clean up on object destruction or when the pool shrinks.
+          bufferLifetimes_.push_back(buffer);
+          idleBufferPool_.push(buffer.get());
+        }
+        totalBuffers_ += bufferCount;
+      }
+
+      /// @brief No idle buffer is available.  Grow the pool or apply the overload policy.
+      LinkedBuffer * overloadBuffer(boost::mutex::scoped_lock & lock)
+      {
+        ++noBufferAvailable_;
+        quietBatches_ = 0;
+        if(slabBuffers_ != 0
+          && (totalBuffers_ + slabBuffers_) * bufferSize_ <= memoryLimit_)
+        {
+          allocateBuffers(slabBuffers_, lock);
+          ++slabsAdded_;
+          return idleBufferPool_.pop();
+        }
+        if(overloadPolicy_ == DROP_OLDEST)
+        {
+          LinkedBuffer * buffer = queue_.popIncoming(lock);
+          if(buffer != 0)
+          {
+            ++droppedOldest_;
+            bytesDropped_ += buffer->used();
+            return buffer;
+          }
+        }
+        if(overloadPolicy_ == BLOCK)
+        {
+          ++blockedReads_;
+          return 0;
+        }
+        if(!discardBuffer_)
+        {
+          discardBuffer_.reset(new LinkedBuffer(bufferSize_));
+        }
+        return discardBuffer_.get();
+      }
+
+      /// @brief Release a slab of idle buffers if the burst is over.
+      void shrinkBuffers(boost::mutex::scoped_lock &)
+      {
+        if(totalBuffers_ <= baseBuffers_ || ++quietBatches_ < shrinkDelay_)
+        {
+          return;
+        }
+        quietBatches_ = 0;
+        size_t releaseCount = std::min(slabBuffers_, totalBuffers_ - baseBuffers_);
+        size_t released = 0;
+        LinkedBuffer * buffer = 0;
+        while(released < releaseCount && (buffer = idleBufferPool_.pop()) != 0)
+        {
+          retireBuffer(buffer);
+          for(BufferLifetimeManager::iterator it = bufferLifetimes_.begin();
+            it != bufferLifetimes_.end();
+            ++it)
           {
-            ++noBufferAvailable_;
+            if(it->get() == buffer)
+            {
+              *it = bufferLifetimes_.back();
+              bufferLifetimes_.pop_back();
+              break;
+            }
           }
+          ++released;
+        }
+        if(released != 0)
+        {
+          totalBuffers_ -= released;
+          ++slabsReleased_;
         }
       }
 
@@ -311,6 +518,15 @@ namespace QuickFAST
         LinkedBuffer * buffer,
         boost::mutex::scoped_lock& lock) = 0;
 
+      /// @brief An idle buffer is about to be destroyed because the pool is shrinking.
+      ///
+      /// Receivers that lend their own storage to buffers (see LinkedBuffer::setExternal())
+      /// reclaim it here.  Called with bufferMutex_ locked.
+      /// @param buffer will be destroyed when this method returns.
+      virtual void retireBuffer(LinkedBuffer * /*buffer*/)
+      {
+      }
+
 
       /////////////
       // Statistics
@@ -393,11 +609,106 @@ namespace QuickFAST
         return largestPacket_;
       }
 
+      /// @brief Statistic: How many buffers are currently allocated
+      size_t buffersAllocated() const
+      {
+        return totalBuffers_;
+      }
+
+      /// @brief Statistic: How many times has the buffer pool grown by a slab
+      size_t slabsAdded() const
+      {
+        return slabsAdded_;
+      }
+
+      /// @brief Statistic: How many times has the buffer pool shrunk by a slab
+      size_t slabsReleased() const
+      {
+        return slabsReleased_;
+      }
+
+      /// @brief Statistic: How many times did the BLOCK policy stop reading
+      size_t blockedReads() const
+      {
+        return blockedReads_;
+      }
+
+      /// @brief Statistic: How many incoming packets were discarded by the DROP_NEWEST policy
+      ///
+      /// Includes packets discarded by DROP_OLDEST when no queued packet could be dropped.
+      size_t droppedNewest() const
+      {
+        return droppedNewest_;
+      }
+
+      /// @brief Statistic: How many queued packets were discarded by the DROP_OLDEST policy
+      size_t droppedOldest() const
+      {
+        return droppedOldest_;
+      }
+
+      /// @brief Statistic: How many bytes were in the packets discarded by the overload policy
+      size_t bytesDropped() const
+      {
+        return bytesDropped_;
+      }
+
+      /// @brief Statistic: How many packets were dropped by the operating system
+      ///
+      /// Counts packets lost because the socket's receive buffer was full.
+      /// Not all receivers or platforms support this.
+      /// @returns the number of packets dropped, or zero if not available.
+      virtual size_t kernelDrops() const
+      {
+        return 0;
+      }
+
       /// @brief Approximately how many bytes are waiting to be decoded
       size_t bytesReadable() const
       {
         // todo: we *could* ask the socket how much data is waiting
-        return bytesReceived_ - bytesProcessed_;
+        return bytesReceived_ - bytesProcessed_ - bytesDropped_;
+      }
+
+      /// @brief Add the memory held by this receiver to a footprint.
+      ///
+      /// Reports the buffer pool, including slabs added by adaptive growth, as
+      /// "receiver.buffers" and the data waiting to be decoded as "receiver.queued".
+      /// May be called from any thread.
+      /// @param footprint accumulates the result.
+      void footprint(MemoryFootprint & footprint) const
+      {
+        size_t buffers = 0;
+        {
+          boost::mutex::scoped_lock lock(bufferMutex_);
+          buffers = totalBuffers_;
+          if(discardBuffer_)
+          {
+            ++buffers;
+          }
+        }
+        footprint.add("receiver.buffers", buffers * (sizeof(LinkedBuffer) + bufferSize_));
+        footprint.add("receiver.queued", bytesReadable());
+      }
+
+      /// @brief Add the memory held by this receiver and its decoder to a footprint.
+      ///
+      /// The decoder's dictionary and working buffer, and the memory held by the
+      /// Allocator set on the Assembler, change while messages are decoded so they
+      /// are gathered by the thread that decodes: once by start() and again after the
+      /// next batch of packets following each call to this method.  The result is the
+      /// receiver's footprint() plus the most recent of those snapshots.  The template
+      /// registry is not included (see TemplateRegistry::footprint().)
+      /// May be called from any thread.
+      /// @param footprint accumulates the result.
+      void connectionFootprint(MemoryFootprint & footprint) const
+      {
+        this->footprint(footprint);
+        {
+          boost::mutex::scoped_lock lock(footprintMutex_);
+          footprint.add(decodingFootprint_);
+        }
+        footprintRequested_.CAS(0, 1);
       }
       // Statistics
       /////////////
@@ -413,18 +724,41 @@ namespace QuickFAST
       bool serviceQueue()
       {
           ++batchesProcessed_;
+          AllocatorScope allocatorScope(assembler_->getAllocator());
           if(!assembler_->serviceQueue(*this))
           {
             stop();
           }
+          if(footprintRequested_ != 0)
+          {
+            publishFootprint();
+          }
           boost::mutex::scoped_lock lock(bufferMutex_);
           // add idle buffers to pool before trying to start a read.
           idleBufferPool_.push(idleBuffers_);
+          shrinkBuffers(lock);
           startReceive(lock);
           // see if this thread is still needed to service the queue
           return queue_.endService(!stopping_, lock);
       }
 
+      /// @brief Gather the footprint of the decoder and the Allocator for connectionFootprint()
+      ///
+      /// Call on the thread that decodes, or before decoding starts.
+      void publishFootprint()
+      {
+        footprintRequested_.CAS(1, 0);
+        MemoryFootprint snapshot;
+        assembler_->decoder().footprint(snapshot);
+        Allocator * allocator = assembler_->getAllocator();
+        if(allocator != 0)
+        {
+          allocator->footprint(snapshot);
+        }
+        boost::mutex::scoped_lock lock(footprintMutex_);
+        decodingFootprint_ = snapshot;
+      }
+
     protected:
       /// The assembler to receive full buffers
       Assembler * assembler_;
@@ -432,7 +766,7 @@ namespace QuickFAST
       BufferLifetimeManager bufferLifetimes_;
 
       /// Protect access to the SingleServerBufferQueue
-      boost::mutex bufferMutex_;
+      mutable boost::mutex bufferMutex_;
 
       /// @brief Accept buffers from multiple threads and deliver them to a single thread.
       ///
@@ -485,6 +819,45 @@ namespace QuickFAST
       size_t bytesProcessed_;
       /// Largest single packet received
       size_t largestPacket_;
+
+      /// Optional copy of all packets received.  See setJournal() and journalPacket()
+      PacketJournal * journal_;
+
+      /// What to do when no buffers are available.
+      OverloadPolicy overloadPolicy_;
+      /// Read into this buffer (then ignore the data) to drop incoming packets.
+      BufferLifetime discardBuffer_;
+      /// Buffers added at a time when the pool grows (zero means don't grow)
+      size_t slabBuffers_;
+      /// Upper limit on the bytes used by all buffers
+      size_t memoryLimit_;
+      /// Batches without a shortage before the pool shrinks
+      size_t shrinkDelay_;
+      /// Batches processed since the last shortage
+      size_t quietBatches_;
+      /// Buffers allocated explicitly (never released)
+      size_t baseBuffers_;
+      /// All buffers currently allocated (not counting discardBuffer_)
+      size_t totalBuffers_;
+      /// Number of times the pool grew
+      size_t slabsAdded_;
+      /// Number of times the pool shrank
+      size_t slabsReleased_;
+      /// Reads not started due to the BLOCK policy
+      size_t blockedReads_;
+      /// Packets discarded on arrival
+      size_t droppedNewest_;
+      /// Queued packets discarded to make room
+      size_t droppedOldest_;
+      /// Bytes in all discarded packets
+      size_t bytesDropped_;
+
+      /// Protect decodingFootprint_
+      mutable boost::mutex footprintMutex_;
+      /// The decoder and Allocator footprint gathered by publishFootprint()
+      MemoryFootprint decodingFootprint_;
+      /// Set by connectionFootprint() to ask the decoding thread for a new snapshot.
+      mutable AtomicCounter footprintRequested_;
     };
   }
 }
@@ -53,16 +53,21 @@ namespace QuickFAST
         ++packetsReceived_;
         if(bytesReceived > 0)
         {
-          ++packetsQueued_;
+          if(buffer != discardBuffer_.get())
+          {
+            // a packet read into the discard buffer is counted by queueBuffer() as dropped.
+            journalPacket(buffer->get(), bytesReceived);
+            ++packetsQueued_;
+          }
           largestPacket_ = std::max(largestPacket_, bytesReceived);
           buffer->setUsed(bytesReceived);
-          needService = queue_.push(buffer, lock);
+          needService = queueBuffer(buffer, lock);
         }
         else
         {
           // empty buffer? just use it again
           ++emptyPackets_;
-          idleBufferPool_.push(buffer);
+          recoverBuffer(buffer);
         }
         return needService;
       }
@@ -9,6 +9,7 @@
 #include <Codecs/GenericMessageBuilder.h>
 #include <Codecs/MessagePerPacketAssembler.h>
 #include <Codecs/StreamingAssembler.h>
+#include <Codecs/DigestBuilder.h>
 
 #include <Codecs/NoHeaderAnalyzer.h>
 #include <Codecs/FixedSizeHeaderAnalyzer.h>
@@ -34,6 +35,8 @@ InterpretApplication::InterpretApplication()
 , fixOutput_(false)
 , threads_(1)
 , silent_(false)
+, checkpointInterval_(Codecs::DecodeDigest::defaultCheckpointInterval)
+, digestMessages_(false)
 {
 }
 
@@ -352,6 +355,26 @@ InterpretApplication::parseSingleArg(int argc, char * argv[])
       silent_ = true;
       consumed = 1;
     }
+    else if(opt == "-digest" && argc > 1)
+    {
+      digestFilename_ = argv[1];
+      consumed = 2;
+    }
+    else if(opt == "-compare" && argc > 1)
+    {
+      compareFilename_ = argv[1];
+      consumed = 2;
+    }
+    else if(opt == "-checkpoint" && argc > 1)
+    {
+      checkpointInterval_ = boost::lexical_cast<size_t>(argv[1]);
+      consumed = 2;
+    }
+    else if(opt == "-digestmessages")
+    {
+      digestMessages_ = true;
+      consumed = 1;
+    }
   }
   catch (std::exception & ex)
   {
@@ -392,6 +415,16 @@ InterpretApplication::usage(std::ostream & out) const
   out << std::endl;
   out << "  -ofix                : Write the output as newline separated FIX records." << std::endl;
   out << std::endl;
+  out << "  -digest file         : Hash the decoded messages instead of writing them." << std::endl;
+  out << "                         Write the digest to file." << std::endl;
+  out << "  -compare file        : Hash the decoded messages and compare the result to" << std::endl;
+  out << "                         a digest written by -digest.  Reports the first" << std::endl;
+  out << "                         message that differs." << std::endl;
+  out << "  -checkpoint n        : Messages between digest checkpoints (default " << checkpointInterval_ << ")." << std::endl;
+  out << "                         Ignored with -compare; the saved digest's value is used." << std::endl;
+  out << "  -digestmessages      : Keep a digest for every message (8 bytes per message)" << std::endl;
+  out << "                         so -compare can find the exact message that differs." << std::endl;
+  out << std::endl;
   out << "  -file file           : Input from raw FAST message file." << std::endl;
   out << "  -buffer file         : Input from raw FAST message file into a buffer; decode from buffer." << std::endl;
   out << "  -pcap file           : Input from PCap FAST message file." << std::endl;
@@ -478,6 +511,11 @@ InterpretApplication::applyArgs()
       ok = false;
       std::cerr << "ERROR: -t [templatefile] option is required." << std::endl;
     }
+    if((!digestFilename_.empty() || !compareFilename_.empty()) && !configurations_.empty())
+    {
+      ok = false;
+      std::cerr << "ERROR: -digest and -compare support a single connection." << std::endl;
+    }
   }
   catch (std::exception& e)
   {
@@ -501,13 +539,34 @@ InterpretApplication::run()
   try
   {
     MessageInterpreter handler(std::cout, silent_);
+    if(!compareFilename_.empty())
+    {
+      expected_.reset(new Codecs::DecodeDigest);
+      std::ifstream expectedFile(compareFilename_.c_str());
+      if(!expected_->read(expectedFile))
+      {
+        std::cerr << "Can't read digest from " << compareFilename_ << std::endl;
+        return -1;
+      }
+      checkpointInterval_ = expected_->checkpointInterval();
+      digestMessages_ = digestMessages_ || expected_->hasMessages();
+    }
+    if(expected_ || !digestFilename_.empty())
+    {
+      digest_.reset(new Codecs::DecodeDigest(checkpointInterval_));
+      digest_->setKeepMessages(digestMessages_);
+    }
     for(Configurations::const_iterator pConfig = configurations_.begin();
       pConfig != configurations_.end();
       ++pConfig)
     {
       Messages::ValueMessageBuilderPtr builder;
 
-      if(fixOutput_)
+      if(digest_)
+      {
+        builder.reset(new Codecs::DigestBuilder(*digest_));
+      }
+      else if(fixOutput_)
       {
         builder.reset(new ValueToFix(std::cout));
       }
@@ -628,6 +687,10 @@ InterpretApplication::run()
         (*pConnection)->receiver().joinThreads();
       }
     }
+    if(digest_)
+    {
+      result = reportDigest();
+    }
   }
 
   catch (std::exception & e)
@@ -638,6 +701,51 @@ InterpretApplication::run()
   return result;
 }
 
+int
+InterpretApplication::reportDigest()
+{
+  size_t errorCount = 0;
+  for(Builders::const_iterator pBuilder = builders_.begin();
+    pBuilder != builders_.end();
+    ++pBuilder)
+  {
+    const Codecs::DigestBuilder * digestBuilder = dynamic_cast<const Codecs::DigestBuilder *>(pBuilder->get());
+    if(digestBuilder != 0)
+    {
+      errorCount += digestBuilder->errorCount();
+    }
+  }
+  std::cout << "Messages: " << digest_->messageCount()
+    << " Digest: " << std::hex << digest_->finalDigest() << std::dec
+    << " Decoding errors: " << errorCount << std::endl;
+  if(!digestFilename_.empty())
+  {
+    std::ofstream digestFile(digestFilename_.c_str());
+    digest_->write(digestFile);
+  }
+  if(expected_)
+  {
+    size_t first = 0;
+    size_t last = 0;
+    if(digest_->findDifference(*expected_, first, last))
+    {
+      if(last == first + 1)
+      {
+        std::cout << "Message " << first;
+      }
+      else
+      {
+        std::cout << "Messages " << first << " through " << last - 1;
+      }
+      std::cout << ": first difference from " << compareFilename_
+        << " (" << expected_->messageCount() << " messages)." << std::endl;
+      return 1;
+    }
+    std::cout << "Same as " << compareFilename_ << std::endl;
+  }
+  return 0;
+}
+
 void
 InterpretApplication::fini()
 {
@@ -10,6 +10,7 @@
 #include <Communication/Receiver_fwd.h>
 #include <Application/DecoderConfiguration.h>
 #include <Application/DecoderConnection.h>
+#include <Codecs/DecodeDigest_fwd.h>
 
 namespace QuickFAST{
   namespace Examples{
@@ -39,6 +40,7 @@ namespace QuickFAST{
       virtual int parseSingleArg(int argc, char * argv[]);
       virtual void usage(std::ostream & out) const;
       virtual bool applyArgs();
+      int reportDigest();
 
     private:
       CommandArgParser commandArgParser_;
@@ -68,6 +70,14 @@ namespace QuickFAST{
       bool fixOutput_;
       size_t threads_;
       bool silent_;
+
+      // digest the decoded messages instead of interpreting them
+      std::string digestFilename_;
+      std::string compareFilename_;
+      size_t checkpointInterval_;
+      bool digestMessages_;
+      boost::scoped_ptr<Codecs::DecodeDigest> digest_;
+      boost::scoped_ptr<Codecs::DecodeDigest> expected_;
     };
   }
 }
@@ -24,6 +24,8 @@ PerformanceTest::PerformanceTest()
   : resetOnMessage_(false)
   , strict_(true)
   , useNullMessage_(false)
+  , useStaticBuilder_(false)
+  , readAheadBuffers_(0)
   , performanceFile_(0)
   , profileFile_(0)
   , head_(0)
@@ -92,6 +94,16 @@ PerformanceTest::parseSingleArg(int argc, char * argv[])
       useNullMessage_ = true;
       consumed = 1;
     }
+    else if(opt == "-static")
+    {
+      useStaticBuilder_ = true;
+      consumed = 1;
+    }
+    else if(opt == "-readahead" && argc > 1)
+    {
+      readAheadBuffers_ = boost::lexical_cast<size_t>(argv[1]);
+      consumed = 2;
+    }
     else if(opt == "-head" && argc > 1)
     {
       head_ = boost::lexical_cast<size_t>(argv[1]);
@@ -133,6 +145,8 @@ PerformanceTest::usage(std::ostream & out) const
   out << "  -i count    : retrieve (interprete) field values count times." << std::endl;
   out << "  -r          : Toggle 'reset decoder on every message' (default false)." << std::endl;
   out << "  -null       : Use null message to receive fields." << std::endl;
+  out << "  -static     : Call the builder directly rather than via virtual methods." << std::endl;
+  out << "  -readahead n : Read the FAST file on a helper thread into n large buffers." << std::endl;
   out << "  -s          : Toggle 'strict decoding rules' (default true)." << std::endl;
   out << "  -hfix n     : Skip n byte header before each message" << std::endl;
   out << std::endl;
@@ -257,7 +271,16 @@ PerformanceTest::run()
         std::cout << "Decoding input; pass " << nPass + 1 << " of " << count_ << std::endl;
       }
       fastFile_.seekg(0, std::ios::beg);
-      Codecs::DataSourceBufferedStream source(fastFile_);
+      boost::scoped_ptr<Codecs::DataSource> sourcePtr;
+      if(readAheadBuffers_ > 0)
+      {
+        sourcePtr.reset(new Codecs::DataSourceStream(fastFile_, 256 * 1024, readAheadBuffers_));
+      }
+      else
+      {
+        sourcePtr.reset(new Codecs::DataSourceBufferedStream(fastFile_));
+      }
+      Codecs::DataSource & source = *sourcePtr;
       if(echo_)
       {
         source.setEcho(std::cout, Codecs::DataSource::HEX, true, true);
@@ -272,7 +295,14 @@ PerformanceTest::run()
       StopWatch decodeTimer;
       {
         PROFILE_POINT("Main");
-        decoder.decode(source, builder);
+        if(useStaticBuilder_)
+        {
+          decoder.decodeStatic(source, builder);
+        }
+        else
+        {
+          decoder.decode(source, builder);
+        }
       }//PROFILE_POINT
       unsigned long decodeLapse = decodeTimer.freeze();
       size_t messageCount = builder.msgCount();//handler.getMessageCount();
@@ -41,6 +41,8 @@ namespace QuickFAST{
       bool resetOnMessage_;
       bool strict_;
       bool useNullMessage_;
+      bool useStaticBuilder_;
+      size_t readAheadBuffers_;
       std::string templateFileName_;
       std::ifstream templateFile_;
       std::string fastFileName_;
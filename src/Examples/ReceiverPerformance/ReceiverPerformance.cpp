@@ -0,0 +1,575 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+
+#include <Examples/ExamplesPch.h>
+#include "ReceiverPerformance.h"
+#include <Codecs/XMLTemplateParser.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/NoHeaderAnalyzer.h>
+#include <Codecs/MessagePerPacketAssembler.h>
+#include <Codecs/StreamingAssembler.h>
+#include <Communication/BufferReceiver.h>
+#include <Communication/RawFileReceiver.h>
+#include <Communication/PCapFileReceiver.h>
+#include <Communication/MulticastReceiver.h>
+#include <Communication/TCPReceiver.h>
+#include <Messages/NullMessageBuilder.h>
+#include <Common/MemoryFootprint.h>
+
+using namespace QuickFAST;
+using namespace Examples;
+
+namespace
+{
+  /// Discard messages; count decoding errors.
+  class CountingBuilder : public Messages::NullMessageBuilder
+  {
+  public:
+    CountingBuilder()
+      : errors_(0)
+    {
+    }
+
+    virtual bool reportDecodingError(const std::string & /*errorMessage*/)
+    {
+      ++errors_;
+      return true;
+    }
+
+    size_t errors_;
+  };
+
+  /// An Assembler that releases each buffer without looking at it.
+  ///
+  /// This stands in for the Assembler so only the Receiver's work is measured.
+  class CountingAssembler : public Communication::Assembler
+  {
+  public:
+    CountingAssembler(
+        Codecs::TemplateRegistryPtr registry,
+        Common::Logger & logger)
+      : Communication::Assembler(registry, logger)
+    {
+    }
+
+    virtual void receiverStarted(Communication::Receiver & /*receiver*/)
+    {
+    }
+
+    virtual void receiverStopped(Communication::Receiver & /*receiver*/)
+    {
+    }
+
+    virtual bool serviceQueue(Communication::Receiver & receiver)
+    {
+      Communication::LinkedBuffer * buffer = receiver.getBuffer(false);
+      while(buffer != 0)
+      {
+        receiver.releaseBuffer(buffer);
+        buffer = receiver.getBuffer(false);
+      }
+      return true;
+    }
+  };
+
+  /// A message header analyzer that consumes every byte it is offered.
+  ///
+  /// This stands in for the decoder.  The real Assembler gets, reads and releases
+  /// each buffer, but no message is decoded.
+  class SwallowingHeaderAnalyzer : public Codecs::HeaderAnalyzer
+  {
+  public:
+    /// @param packets is true for a MessagePerPacketAssembler: the rest of the packet is
+    ///        skipped.  Otherwise the analyzer asks for more data so the StreamingAssembler
+    ///        never calls the decoder.
+    explicit SwallowingHeaderAnalyzer(bool packets)
+      : packets_(packets)
+      , bytes_(0)
+    {
+    }
+
+    virtual bool analyzeHeader(Codecs::DataSource & source, size_t & /*blockSize*/, bool & skip)
+    {
+      const uchar * chunk = 0;
+      size_t size = source.getContiguous(size_t(-1), chunk);
+      while(size != 0)
+      {
+        bytes_ += size;
+        size = source.getContiguous(size_t(-1), chunk);
+      }
+      skip = true;
+      return packets_;
+    }
+
+    /// @returns the number of bytes consumed.
+    size_t bytes()const
+    {
+      return bytes_;
+    }
+
+  private:
+    bool packets_;
+    size_t bytes_;
+  };
+
+  /// Measure the time between the first and the last service request.
+  ///
+  /// Time spent waiting for a network sender to start is not included.
+  /// Also stops the Receiver once limit packets have been processed.
+  class TimingAssembler : public Communication::Assembler
+  {
+  public:
+    TimingAssembler(
+        Codecs::TemplateRegistryPtr registry,
+        Common::Logger & logger,
+        Communication::Assembler & assembler,
+        size_t limit)
+      : Communication::Assembler(registry, logger)
+      , assembler_(assembler)
+      , limit_(limit)
+      , started_(false)
+    {
+    }
+
+    virtual void receiverStarted(Communication::Receiver & receiver)
+    {
+      assembler_.receiverStarted(receiver);
+    }
+
+    virtual void receiverStopped(Communication::Receiver & receiver)
+    {
+      assembler_.receiverStopped(receiver);
+    }
+
+    virtual bool serviceQueue(Communication::Receiver & receiver)
+    {
+      if(!started_)
+      {
+        started_ = true;
+        first_ = boost::posix_time::microsec_clock::universal_time();
+      }
+      bool result = assembler_.serviceQueue(receiver);
+      last_ = boost::posix_time::microsec_clock::universal_time();
+      if(limit_ != 0 && receiver.packetsProcessed() >= limit_)
+      {
+        result = false;
+      }
+      return result;
+    }
+
+    /// @returns microseconds between the first and the last service request.
+    double lapse()const
+    {
+      if(!started_)
+      {
+        return 0.0;
+      }
+      return double((last_ - first_).total_microseconds());
+    }
+
+  private:
+    Communication::Assembler & assembler_;
+    size_t limit_;
+    bool started_;
+    boost::posix_time::ptime first_;
+    boost::posix_time::ptime last_;
+  };
+}
+
+ReceiverPerformance::ReceiverPerformance()
+  : receiverType_(RAWFILE_RECEIVER)
+  , assemblerType_(COUNT_ASSEMBLER)
+  , bufferSize_(1400)
+  , bufferCount_(2)
+  , threadCount_(1)
+  , count_(1)
+  , limit_(0)
+  , pcapWordSize_(0)
+  , multicastGroupIP_("224.1.2.133")
+  , listenInterfaceIP_("0.0.0.0")
+  , portNumber_(13014)
+  , hostName_("127.0.0.1")
+  , portName_("13014")
+{
+}
+
+ReceiverPerformance::~ReceiverPerformance()
+{
+}
+
+bool
+ReceiverPerformance::init(int argc, char* argv[])
+{
+  commandArgParser_.addHandler(this);
+  return commandArgParser_.parse(argc, argv);
+}
+
+int
+ReceiverPerformance::parseSingleArg(int argc, char * argv[])
+{
+  int consumed = 0;
+  std::string opt(argv[0]);
+  try
+  {
+    if(opt == "-receiver" && argc > 1)
+    {
+      std::string type = argv[1];
+      consumed = 2;
+      if(type == "buffer")
+      {
+        receiverType_ = BUFFER_RECEIVER;
+      }
+      else if(type == "raw")
+      {
+        receiverType_ = RAWFILE_RECEIVER;
+      }
+      else if(type == "pcap")
+      {
+        receiverType_ = PCAPFILE_RECEIVER;
+      }
+      else if(type == "multicast")
+      {
+        receiverType_ = MULTICAST_RECEIVER;
+      }
+      else if(type == "tcp")
+      {
+        receiverType_ = TCP_RECEIVER;
+      }
+      else
+      {
+        consumed = 0;
+      }
+    }
+    else if(opt == "-assembler" && argc > 1)
+    {
+      std::string type = argv[1];
+      consumed = 2;
+      if(type == "count")
+      {
+        assemblerType_ = COUNT_ASSEMBLER;
+      }
+      else if(type == "packet")
+      {
+        assemblerType_ = PACKET_ASSEMBLER;
+      }
+      else if(type == "stream")
+      {
+        assemblerType_ = STREAM_ASSEMBLER;
+      }
+      else
+      {
+        consumed = 0;
+      }
+    }
+    else if(opt == "-t" && argc > 1)
+    {
+      templateFileName_ = argv[1];
+      consumed = 2;
+    }
+    else if(opt == "-f" && argc > 1)
+    {
+      fileName_ = argv[1];
+      consumed = 2;
+    }
+    else if(opt == "-b" && argc > 1)
+    {
+      bufferSize_ = boost::lexical_cast<size_t>(argv[1]);
+      consumed = 2;
+    }
+    else if(opt == "-bc" && argc > 1)
+    {
+      bufferCount_ = boost::lexical_cast<size_t>(argv[1]);
+      consumed = 2;
+    }
+    else if(opt == "-threads" && argc > 1)
+    {
+      threadCount_ = boost::lexical_cast<size_t>(argv[1]);
+      consumed = 2;
+    }
+    else if(opt == "-c" && argc > 1)
+    {
+      count_ = boost::lexical_cast<size_t>(argv[1]);
+      consumed = 2;
+    }
+    else if(opt == "-n" && argc > 1)
+    {
+      limit_ = boost::lexical_cast<size_t>(argv[1]);
+      consumed = 2;
+    }
+    else if(opt == "-pcapword" && argc > 1)
+    {
+      pcapWordSize_ = boost::lexical_cast<size_t>(argv[1]);
+      consumed = 2;
+    }
+    else if(opt == "-mip" && argc > 1)
+    {
+      multicastGroupIP_ = argv[1];
+      consumed = 2;
+    }
+    else if(opt == "-mif" && argc > 1)
+    {
+      listenInterfaceIP_ = argv[1];
+      consumed = 2;
+    }
+    else if(opt == "-mport" && argc > 1)
+    {
+      portNumber_ = boost::lexical_cast<unsigned short>(argv[1]);
+      consumed = 2;
+    }
+    else if(opt == "-host" && argc > 1)
+    {
+      hostName_ = argv[1];
+      consumed = 2;
+    }
+    else if(opt == "-port" && argc > 1)
+    {
+      portName_ = argv[1];
+      consumed = 2;
+    }
+  }
+  catch (std::exception & ex)
+  {
+    std::cerr << ex.what() << " while interpreting " << opt << std::endl;
+    consumed = 0;
+  }
+  return consumed;
+}
+
+void
+ReceiverPerformance::usage(std::ostream & out) const
+{
+  out << "  -receiver type : buffer, raw, pcap, multicast, or tcp (default raw)" << std::endl;
+  out << "                   buffer: the file is read into memory then passed in -b sized pieces." << std::endl;
+  out << "                   multicast and tcp: run FileToMulticast/PCapToMulticast or FileToTCP" << std::endl;
+  out << "                   to send the data over the loopback interface." << std::endl;
+  out << "  -assembler type: count, packet, or stream (default count)" << std::endl;
+  out << "                   count: release buffers without looking at them." << std::endl;
+  out << "                   packet: MessagePerPacketAssembler; stream: StreamingAssembler." << std::endl;
+  out << "                   The assemblers read every byte but do not decode." << std::endl;
+  out << "  -t file     : Template file (optional: included in the memory footprint)" << std::endl;
+  out << "  -f file     : Data file (required for buffer, raw and pcap)" << std::endl;
+  out << "  -b size     : Size of a receive buffer (default 1400)" << std::endl;
+  out << "  -bc count   : Number of receive buffers (default 2)" << std::endl;
+  out << "  -threads n  : Number of threads servicing the receiver (default 1)" << std::endl;
+  out << "  -c count    : Repeat the test 'count' times" << std::endl;
+  out << "  -n count    : Stop after 'count' packets." << std::endl;
+  out << "                Required for multicast and tcp." << std::endl;
+  out << "  -pcapword n : Word size of the system that captured the pcap file (default: guess)" << std::endl;
+  out << "  -mip addr   : Multicast group (default 224.1.2.133)" << std::endl;
+  out << "  -mif addr   : Listen interface (default 0.0.0.0)" << std::endl;
+  out << "  -mport port : Multicast port (default 13014)" << std::endl;
+  out << "  -host name  : TCP host (default 127.0.0.1)" << std::endl;
+  out << "  -port port  : TCP port (default 13014)" << std::endl;
+}
+
+bool
+ReceiverPerformance::applyArgs()
+{
+  bool ok = true;
+  bool network = receiverType_ == MULTICAST_RECEIVER || receiverType_ == TCP_RECEIVER;
+  if(!network && fileName_.empty())
+  {
+    ok = false;
+    std::cerr << "ERROR: -f [file] option is required." << std::endl;
+  }
+  if(network && limit_ == 0)
+  {
+    ok = false;
+    std::cerr << "ERROR: -n [count] option is required for network receivers." << std::endl;
+  }
+  if(bufferSize_ == 0 || bufferCount_ == 0 || threadCount_ == 0)
+  {
+    ok = false;
+    std::cerr << "ERROR: buffer size, buffer count and thread count must be nonzero." << std::endl;
+  }
+  if(!ok)
+  {
+    commandArgParser_.usage(std::cerr);
+  }
+  return ok;
+}
+
+int
+ReceiverPerformance::run()
+{
+  int result = 0;
+  try
+  {
+    Codecs::TemplateRegistryPtr registry;
+    if(templateFileName_.empty())
+    {
+      registry.reset(new Codecs::TemplateRegistry);
+      registry->finalize();
+    }
+    else
+    {
+      std::ifstream templateFile(templateFileName_.c_str(), std::ios::in | std::ios::binary);
+      Codecs::XMLTemplateParser parser;
+      registry = parser.parse(templateFile);
+    }
+
+    // The buffer receiver takes its data from memory; read it before the clock starts.
+    std::vector<unsigned char> data;
+    if(receiverType_ == BUFFER_RECEIVER)
+    {
+      std::ifstream file(fileName_.c_str(), std::ios::in | std::ios::binary);
+      data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    for(size_t nPass = 0; nPass < count_; ++nPass)
+    {
+      if(count_ > 1)
+      {
+        std::cout << "Pass " << nPass + 1 << " of " << count_ << std::endl;
+      }
+      runPass(registry, data);
+    }
+  }
+  catch (std::exception & e)
+  {
+    std::cerr << e.what() << std::endl;
+    result = -1;
+  }
+  return result;
+}
+
+Communication::Receiver *
+ReceiverPerformance::createReceiver()
+{
+  switch(receiverType_)
+  {
+  case BUFFER_RECEIVER:
+    return new Communication::BufferReceiver;
+  case PCAPFILE_RECEIVER:
+    return new Communication::PCapFileReceiver(fileName_, pcapWordSize_);
+  case MULTICAST_RECEIVER:
+    return new Communication::MulticastReceiver(multicastGroupIP_, listenInterfaceIP_, portNumber_);
+  case TCP_RECEIVER:
+    return new Communication::TCPReceiver(hostName_, portName_);
+  case RAWFILE_RECEIVER:
+  default:
+    return 0;
+  }
+}
+
+void
+ReceiverPerformance::runPass(
+  Codecs::TemplateRegistryPtr & registry,
+  const std::vector<unsigned char> & data)
+{
+  CountingBuilder builder;
+  Codecs::NoHeaderAnalyzer packetHeaderAnalyzer;
+  SwallowingHeaderAnalyzer messageHeaderAnalyzer(assemblerType_ == PACKET_ASSEMBLER);
+
+  boost::scoped_ptr<Communication::Assembler> assembler;
+  switch(assemblerType_)
+  {
+  case PACKET_ASSEMBLER:
+    {
+      assembler.reset(new Codecs::MessagePerPacketAssembler(
+        registry, packetHeaderAnalyzer, messageHeaderAnalyzer, builder));
+      break;
+    }
+  case STREAM_ASSEMBLER:
+    {
+      assembler.reset(new Codecs::StreamingAssembler(
+        registry, messageHeaderAnalyzer, builder));
+      break;
+    }
+  case COUNT_ASSEMBLER:
+  default:
+    {
+      assembler.reset(new CountingAssembler(registry, builder));
+      break;
+    }
+  }
+  TimingAssembler timer(registry, builder, *assembler, limit_);
+
+  std::ifstream rawFile;
+  boost::scoped_ptr<Communication::Receiver> receiver;
+  if(receiverType_ == RAWFILE_RECEIVER)
+  {
+    rawFile.open(fileName_.c_str(), std::ios::in | std::ios::binary);
+    receiver.reset(new Communication::RawFileReceiver(rawFile));
+  }
+  else
+  {
+    receiver.reset(createReceiver());
+  }
+
+  if(!receiver->start(timer, bufferSize_, bufferCount_))
+  {
+    throw std::runtime_error("Receiver did not start.");
+  }
+  if(receiverType_ == BUFFER_RECEIVER)
+  {
+    Communication::BufferReceiver & bufferReceiver = static_cast<Communication::BufferReceiver &>(*receiver);
+    for(size_t offset = 0; offset < data.size(); offset += bufferSize_)
+    {
+      size_t size = std::min(bufferSize_, data.size() - offset);
+      bufferReceiver.receiveBuffer(&data[offset], size);
+      if(limit_ != 0 && receiver->packetsProcessed() >= limit_)
+      {
+        break;
+      }
+    }
+  }
+  else
+  {
+    if(receiverType_ == MULTICAST_RECEIVER || receiverType_ == TCP_RECEIVER)
+    {
+      std::cout << "Waiting for data." << std::endl;
+    }
+    receiver->runThreads(threadCount_ - 1, true);
+    receiver->joinThreads();
+  }
+  receiver->stop();
+
+  double lapse = timer.lapse();
+  size_t packets = receiver->packetsProcessed();
+  size_t bytes = receiver->bytesProcessed();
+  size_t batches = receiver->batchesProcessed();
+  std::cout << "Processed " << packets << " packets, " << bytes << " bytes in "
+    << std::fixed << std::setprecision(3) << lapse / 1000. << " milliseconds." << std::endl;
+  if(lapse > 0.0 && packets > 0)
+  {
+    std::cout << std::fixed << std::setprecision(0)
+      << "  " << 1000000. * double(packets) / lapse << " packets/second; "
+      << std::setprecision(3)
+      << double(bytes) / lapse << " MB/second; "
+      << lapse / double(packets) << " usec/packet." << std::endl;
+  }
+  if(batches > 0)
+  {
+    // Each batch is one hand-off between the receiving and the servicing code,
+    // including the mutex and queue operations.
+    std::cout << std::fixed << std::setprecision(3)
+      << "  " << batches << " batches; " << double(packets) / double(batches) << " packets/batch; "
+      << lapse / double(batches) << " usec/batch." << std::endl;
+  }
+  std::cout << "  buffers: " << receiver->buffersAllocated()
+    << " allocated; no buffer available " << receiver->noBufferAvailable()
+    << " times; " << receiver->blockedReads() << " blocked reads; "
+    << receiver->emptyPackets() << " empty packets." << std::endl;
+  if(assemblerType_ != COUNT_ASSEMBLER)
+  {
+    std::cout << "  assembler consumed " << messageHeaderAnalyzer.bytes() << " bytes." << std::endl;
+  }
+  MemoryFootprint footprint;
+  registry->footprint(footprint);
+  assembler->decoder().footprint(footprint);
+  receiver->footprint(footprint);
+  std::cout << "  memory footprint (bytes):" << std::endl;
+  footprint.write(std::cout, "    ");
+  if(builder.errors_ != 0)
+  {
+    std::cout << "  " << builder.errors_ << " decoding errors." << std::endl;
+  }
+}
+
+void
+ReceiverPerformance::fini()
+{
+}
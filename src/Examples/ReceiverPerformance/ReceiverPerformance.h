@@ -0,0 +1,92 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef RECEIVERPERFORMANCE_H
+#define RECEIVERPERFORMANCE_H
+
+#include <Codecs/TemplateRegistry_fwd.h>
+#include <Communication/Receiver_fwd.h>
+#include <Communication/Assembler_fwd.h>
+#include <Examples/CommandArgParser.h>
+
+namespace QuickFAST{
+  namespace Examples{
+    /// @brief Measure the overhead of the Communication layer.
+    ///
+    /// Data from a file, a memory buffer, or the network is passed through one of the
+    /// Receivers to an Assembler.  With the "count" assembler the buffers are counted and
+    /// released so the numbers show the cost of receiving and handing off buffers.
+    /// The "packet" and "stream" modes drive the real MessagePerPacketAssembler and
+    /// StreamingAssembler with a null packet header analyzer and a message header
+    /// analyzer that consumes every byte, so no message is decoded; the difference
+    /// between these and the "count" numbers is the cost of the Assembler itself.
+    ///
+    /// Vary the buffer size, buffer count and thread count to see their effect.
+    ///
+    /// Run the program with a -? command line option for detailed usage information.
+    class ReceiverPerformance : public CommandArgHandler
+    {
+    public:
+      ReceiverPerformance();
+      ~ReceiverPerformance();
+
+      /// @brief parse command line arguments, and initialize.
+      /// @param argc from main
+      /// @param argv from main
+      /// @returns true if everything is ok.
+      bool init(int argc, char * argv[]);
+      /// @brief run the program
+      /// @returns a value to be used as an exit code of the program (0 means all is well)
+      int run();
+      /// @brief do final cleanup after a run.
+      void fini();
+
+    private:
+      virtual int parseSingleArg(int argc, char * argv[]);
+      virtual void usage(std::ostream & out) const;
+      virtual bool applyArgs();
+
+    private:
+      enum ReceiverType
+      {
+        BUFFER_RECEIVER,
+        RAWFILE_RECEIVER,
+        PCAPFILE_RECEIVER,
+        MULTICAST_RECEIVER,
+        TCP_RECEIVER
+      };
+      enum AssemblerType
+      {
+        COUNT_ASSEMBLER,
+        PACKET_ASSEMBLER,
+        STREAM_ASSEMBLER
+      };
+
+      Communication::Receiver * createReceiver();
+      void runPass(
+        Codecs::TemplateRegistryPtr & registry,
+        const std::vector<unsigned char> & data);
+
+    private:
+      ReceiverType receiverType_;
+      AssemblerType assemblerType_;
+      std::string templateFileName_;
+      std::string fileName_;
+      size_t bufferSize_;
+      size_t bufferCount_;
+      size_t threadCount_;
+      size_t count_;
+      size_t limit_;
+      size_t pcapWordSize_;
+      std::string multicastGroupIP_;
+      std::string listenInterfaceIP_;
+      unsigned short portNumber_;
+      std::string hostName_;
+      std::string portName_;
+
+      CommandArgParser commandArgParser_;
+    };
+  }
+}
+#endif // RECEIVERPERFORMANCE_H
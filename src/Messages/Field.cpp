@@ -4,6 +4,7 @@
 #include <Common/QuickFASTPch.h>
 #include "Field.h"
 #include <Common/Exceptions.h>
+#include <Common/Allocator.h>
 
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Messages;
@@ -19,6 +20,18 @@ Field::~Field()
 {
 }
 
+void *
+Field::operator new(size_t size)
+{
+  return Allocator::allocateBlock(size);
+}
+
+void
+Field::operator delete(void * block)
+{
+  Allocator::freeBlock(block);
+}
+
 bool
 Field::isDefined() const
 {
@@ -27,6 +27,11 @@ namespace QuickFAST{
       /// @brief a typical virtual destructor.
       virtual ~Field() = 0;
 
+      /// @brief Allocate fields from the current Allocator.
+      static void * operator new(size_t size);
+      /// @brief Return fields to their Allocator.
+      static void operator delete(void * block);
+
       /// @brief compare to field for type and value
       ///
       /// The default implementation handles all string, integer, and decimal types.
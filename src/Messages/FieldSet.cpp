@@ -7,12 +7,13 @@
 #include <Messages/Group.h>
 #include <Common/Exceptions.h>
 #include <Common/Profiler.h>
+#include <Common/Allocator.h>
 
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Messages;
 
 FieldSet::FieldSet(size_t res)
-: fields_(reinterpret_cast<MessageField *>(new unsigned char[sizeof(MessageField) * res]))
+: fields_(static_cast<MessageField *>(Allocator::allocateBlock(sizeof(MessageField) * res)))
 , capacity_(res)
 , used_(0)
 {
@@ -22,7 +23,19 @@ FieldSet::FieldSet(size_t res)
 FieldSet::~FieldSet()
 {
   clear();
-  delete [] reinterpret_cast<unsigned char *>(fields_);
+  Allocator::freeBlock(fields_);
+}
+
+void *
+FieldSet::operator new(size_t size)
+{
+  return Allocator::allocateBlock(size);
+}
+
+void
+FieldSet::operator delete(void * block)
+{
+  Allocator::freeBlock(block);
 }
 
 void
@@ -30,7 +43,7 @@ FieldSet::reserve(size_t capacity)
 {
   if(capacity > capacity_)
   {
-    MessageField * buffer = reinterpret_cast<MessageField *>(new unsigned char[sizeof(MessageField) * capacity]);
+    MessageField * buffer = static_cast<MessageField *>(Allocator::allocateBlock(sizeof(MessageField) * capacity));
     memset(buffer, 0, sizeof(MessageField) * capacity_);
     for(size_t nField = 0; nField < used_; ++nField)
     {
@@ -47,7 +60,7 @@ FieldSet::reserve(size_t capacity)
       --oldUsed;
       oldBuffer[oldUsed].~MessageField();
     }
-    delete[] reinterpret_cast<unsigned char *>(oldBuffer);
+    Allocator::freeBlock(oldBuffer);
   }
 }
 
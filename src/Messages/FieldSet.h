@@ -30,6 +30,11 @@ namespace QuickFAST{
       /// @brief Virtual destructor
       virtual ~FieldSet();
 
+      /// @brief Allocate field sets (and messages) from the current Allocator.
+      static void * operator new(size_t size);
+      /// @brief Return field sets to their Allocator.
+      static void operator delete(void * block);
+
       /// @brief clear current contents of the field set
       ///
       /// Optionally adjust the capacity.
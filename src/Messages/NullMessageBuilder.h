@@ -0,0 +1,167 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef NULLMESSAGEBUILDER_H
+#define NULLMESSAGEBUILDER_H
+#include <Messages/ValueMessageBuilder.h>
+
+namespace QuickFAST
+{
+  namespace Messages
+  {
+    ///@brief a ValueMessageBuilder that discards everything it is given.
+    ///
+    /// Useful when a message must be decoded to keep the dictionaries up to date,
+    /// but the application is not interested in the contents of the message.
+    /// All nested builders (groups, sequences, etc.) are *this.
+    class NullMessageBuilder : public ValueMessageBuilder
+    {
+    public:
+      NullMessageBuilder()
+      {
+      }
+
+      virtual ~NullMessageBuilder()
+      {
+      }
+
+      ///////////////////////////
+      // Implement ValueMessageBuilder
+      virtual const std::string & getApplicationType()const
+      {
+        static const std::string name("null");
+        return name;
+      }
+
+      virtual const std::string & getApplicationTypeNs()const
+      {
+        static const std::string result("");
+        return result;
+      }
+
+      virtual void addValue(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const int64 /*value*/)
+      {
+      }
+      virtual void addValue(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const uint64 /*value*/)
+      {
+      }
+      virtual void addValue(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const int32 /*value*/)
+      {
+      }
+      virtual void addValue(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const uint32 /*value*/)
+      {
+      }
+      virtual void addValue(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const int16 /*value*/)
+      {
+      }
+      virtual void addValue(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const uint16 /*value*/)
+      {
+      }
+      virtual void addValue(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const int8 /*value*/)
+      {
+      }
+      virtual void addValue(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const uchar /*value*/)
+      {
+      }
+      virtual void addValue(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const Decimal& /*value*/)
+      {
+      }
+      virtual void addValue(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, const unsigned char * /*value*/, size_t /*length*/)
+      {
+      }
+      // Accept large byte vectors in pieces to avoid copying them into the working buffer.
+      virtual bool startByteVector(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, size_t /*length*/)
+      {
+        return true;
+      }
+
+      virtual ValueMessageBuilder & startMessage(
+        const std::string & /*applicationType*/,
+        const std::string & /*applicationTypeNamespace*/,
+        size_t /*size*/)
+      {
+        return *this;
+      }
+
+      virtual bool endMessage(ValueMessageBuilder & /*messageBuilder*/)
+      {
+        return true;
+      }
+
+      virtual bool ignoreMessage(ValueMessageBuilder & /*messageBuilder*/)
+      {
+        return true;
+      }
+
+      virtual ValueMessageBuilder & startSequence(
+        FieldIdentityCPtr & /*identity*/,
+        const std::string & /*applicationType*/,
+        const std::string & /*applicationTypeNamespace*/,
+        size_t /*fieldCount*/,
+        FieldIdentityCPtr & /*lengthIdentity*/,
+        size_t /*length*/)
+      {
+        return *this;
+      }
+
+      virtual void endSequence(
+        FieldIdentityCPtr & /*identity*/,
+        ValueMessageBuilder & /*sequenceBuilder*/)
+      {
+      }
+
+      virtual ValueMessageBuilder & startSequenceEntry(
+        const std::string & /*applicationType*/,
+        const std::string & /*applicationTypeNamespace*/,
+        size_t /*size*/)
+      {
+        return *this;
+      }
+
+      virtual void endSequenceEntry(ValueMessageBuilder & /*entry*/)
+      {
+      }
+
+      virtual ValueMessageBuilder & startGroup(
+        FieldIdentityCPtr & /*identity*/,
+        const std::string & /*applicationType*/,
+        const std::string & /*applicationTypeNamespace*/,
+        size_t /*size*/)
+      {
+        return *this;
+      }
+
+      virtual void endGroup(
+        FieldIdentityCPtr & /*identity*/,
+        ValueMessageBuilder & /*groupBuilder*/)
+      {
+      }
+
+      ///////////////////
+      // Implement Logger
+      virtual bool wantLog(unsigned short /*level*/)
+      {
+        return false;
+      }
+
+      virtual bool logMessage(unsigned short /*level*/, const std::string & /*logMessage*/)
+      {
+        return true;
+      }
+
+      virtual bool reportDecodingError(const std::string & /*errorMessage*/)
+      {
+        return true;
+      }
+
+      virtual bool reportCommunicationError(const std::string & /*errorMessage*/)
+      {
+        return true;
+      }
+    };
+  }
+}
+#endif // NULLMESSAGEBUILDER_H
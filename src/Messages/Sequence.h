@@ -9,6 +9,7 @@
 #include "Sequence_fwd.h"
 #include <Common/QuickFAST_Export.h>
 #include <Messages/FieldSet.h>
+#include <Common/Allocator.h>
 
 namespace QuickFAST{
   namespace Messages{
@@ -18,8 +19,8 @@ namespace QuickFAST{
     public:
       /// @brief Each entry is a field set
       typedef FieldSetCPtr Entry;
-      /// @brief We store them in a vector
-      typedef std::vector<Entry> Entries;
+      /// @brief We store them in a vector using the current Allocator
+      typedef std::vector<Entry, StlAllocator<Entry> > Entries;
       /// @brief We support iteration through the sequence
       typedef Entries::const_iterator const_iterator;
 
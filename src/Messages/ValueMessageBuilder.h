@@ -13,6 +13,8 @@
 #include <Common/Logger.h>
 namespace QuickFAST{
   namespace Messages{
+    class MessageAccessor;
+
     /// @brief Interface to support building a message during decoding.
     class ValueMessageBuilder : public Common::Logger
     {
@@ -90,6 +92,87 @@ namespace QuickFAST{
       /// @param length is the length of the string pointed to by value
       virtual void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length) = 0;
 
+      /// @brief Add an ASCII field whose value has been interned.
+      ///
+      /// Called instead of addValue() for fields the Decoder has been asked to intern
+      /// (see Decoder::internField().)  The default implementation ignores the id.
+      /// @param identity identifies this field
+      /// @param type is the type of data to be added
+      /// @param value is the value to be assigned.
+      /// @param length is the length of the string pointed to by value
+      /// @param id is the value's id in the Decoder's InternTable.
+      virtual void addInternedValue(FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length, uint32 /*id*/)
+      {
+        addValue(identity, type, value, length);
+      }
+
+      /// @brief Notification that the unicode string just added is not valid UTF-8.
+      ///
+      /// Called immediately after addValue() if the Decoder's Utf8Policy is UTF8_FLAG.
+      /// The default implementation ignores the notification.
+      /// @param identity identifies the field.
+      /// @param errorOffset is the offset of the first invalid byte in the value.
+      virtual void invalidUtf8(FieldIdentityCPtr & /*identity*/, size_t /*errorOffset*/)
+      {
+      }
+
+      /// @brief Offer to deliver a large byte vector in pieces.
+      ///
+      /// Called by the Decoder when a byte vector is at least as large as the
+      /// Decoder's byte vector chunk threshold.  If the builder accepts, the value
+      /// arrives as one or more appendByteVector() calls followed by endByteVector().
+      /// The default implementation declines so the value arrives via addValue().
+      /// @param identity identifies the field.
+      /// @param type is the type of the field (always BYTEVECTOR)
+      /// @param length is the total number of bytes that will be delivered.
+      /// @returns true to accept delivery in pieces.
+      virtual bool startByteVector(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, size_t /*length*/)
+      {
+        return false;
+      }
+
+      /// @brief Accept the next piece of a byte vector.
+      ///
+      /// The data points into the DataSource's buffer and is valid only during this call.
+      /// @param identity identifies the field.
+      /// @param chunk points to the data.
+      /// @param size is the number of bytes at chunk.
+      virtual void appendByteVector(FieldIdentityCPtr & /*identity*/, const unsigned char * /*chunk*/, size_t /*size*/)
+      {
+      }
+
+      /// @brief All pieces of the byte vector have been delivered.
+      /// @param identity identifies the field.
+      /// @param type is the type of the field (always BYTEVECTOR)
+      virtual void endByteVector(FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/)
+      {
+      }
+
+      /// @brief Does this builder want messages via lazyMessage()?
+      ///
+      /// A Decoder with lazy messages enabled asks for each message that could be
+      /// delivered lazily.  The default implementation returns false: messages are
+      /// decoded and delivered the usual way without the cost of a LazyMessageView.
+      virtual bool acceptsLazyMessages()const
+      {
+        return false;
+      }
+
+      /// @brief Accept a message whose fields have not been decoded.
+      ///
+      /// Called by a Decoder with lazy messages enabled (see Decoder::setLazyMessages())
+      /// instead of startMessage() when acceptsLazyMessages() is true and the template
+      /// allows it.  The message is a Codecs::LazyMessageView that decodes each field
+      /// on request.  It is valid only during this call.
+      /// If the builder declines, the message is decoded from the view and delivered
+      /// the usual way.
+      /// @param message provides access to the fields.
+      /// @returns true if the message was accepted.
+      virtual bool lazyMessage(const MessageAccessor & /*message*/)
+      {
+        return false;
+      }
+
       /// @brief prepare to accept an entire message
       ///
       /// @param applicationType is the data type for the message
@@ -0,0 +1,244 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef TEMPLATEBUILDER_H
+#define TEMPLATEBUILDER_H
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/Template.h>
+#include <Codecs/FieldInstructionGroup.h>
+#include <Codecs/FieldInstructionUInt32.h>
+#include <Codecs/FieldInstructionAscii.h>
+#include <Codecs/FieldOpCopy.h>
+#include <Codecs/FieldOpIncrement.h>
+#include <Codecs/Encoder.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/DataDestination.h>
+#include <Codecs/DataSourceString.h>
+#include <Codecs/GenericMessageBuilder.h>
+#include <Codecs/MessageConsumer.h>
+#include <Messages/Message.h>
+#include <Messages/FieldIdentity.h>
+#include <Messages/FieldUInt32.h>
+#include <Messages/FieldAscii.h>
+
+namespace QuickFAST{
+  namespace Tests{
+    /// @brief Add a field to a template or group.
+    ///
+    /// The tests build their templates in code rather than parsing XML.
+    /// @param target is the template or group body that receives the field.
+    /// @param instruction defines the field.  The target takes ownership.
+    /// @param op is the field operator.  The instruction takes ownership.
+    /// @param mandatory is the field's presence.
+    inline void addField(
+      const Codecs::SegmentBodyPtr & target,
+      Codecs::FieldInstruction * instruction,
+      Codecs::FieldOp * op,
+      bool mandatory = true)
+    {
+      Codecs::FieldInstructionPtr field(instruction);
+      field->setFieldOp(Codecs::FieldOpPtr(op));
+      field->setPresence(mandatory);
+      target->addInstruction(field);
+    }
+
+    /// @brief Give a field operator an initial value.
+    /// @returns op to be passed to addField()
+    inline Codecs::FieldOp * withValue(Codecs::FieldOp * op, const std::string & value)
+    {
+      op->setValue(value);
+      return op;
+    }
+
+    /// @brief Add a group to a template or group.
+    /// @param target receives the group.
+    /// @param name names the group.  It is also the application type of its body.
+    /// @param mandatory is the group's presence.
+    /// @returns the body of the group, ready for addField().
+    inline Codecs::SegmentBodyPtr addGroup(
+      const Codecs::SegmentBodyPtr & target,
+      const std::string & name,
+      bool mandatory)
+    {
+      Codecs::FieldInstructionPtr group(new Codecs::FieldInstructionGroup(name, ""));
+      group->setPresence(mandatory);
+      Codecs::SegmentBodyPtr body(new Codecs::SegmentBody);
+      body->setApplicationType(name, "");
+      group->setSegmentBody(body);
+      target->addInstruction(group);
+      return body;
+    }
+
+    /// @brief Create an empty template.
+    inline Codecs::TemplatePtr createTemplate(template_id_t id, const std::string & name)
+    {
+      Codecs::TemplatePtr result(new Codecs::Template);
+      result->setId(id);
+      result->setTemplateName(name);
+      return result;
+    }
+
+    /// @brief Add the template used by tests that need a simple quote stream.
+    ///
+    /// <template name="name" id="id">
+    ///   <uInt32 name="Seq"><increment/></uInt32>
+    ///   <string name="Symbol"><copy/></string>
+    /// </template>
+    /// @returns the template so the caller may adjust it before the registry is finalized.
+    inline Codecs::TemplatePtr addQuoteTemplate(
+      Codecs::TemplateRegistry & registry,
+      template_id_t id,
+      const std::string & name)
+    {
+      Codecs::TemplatePtr quote = createTemplate(id, name);
+      addField(quote, new Codecs::FieldInstructionUInt32("Seq", ""), new Codecs::FieldOpIncrement);
+      addField(quote, new Codecs::FieldInstructionAscii("Symbol", ""), new Codecs::FieldOpCopy);
+      registry.addTemplate(quote);
+      return quote;
+    }
+
+    /// @brief Encode a message for a template added by addQuoteTemplate().
+    inline void encodeQuote(
+      Codecs::Encoder & encoder,
+      Codecs::DataDestination & destination,
+      template_id_t templateId,
+      uint32 seq,
+      const std::string & symbol = "IBM")
+    {
+      Messages::Message message(2);
+      message.addField(new Messages::FieldIdentity("Seq"), Messages::FieldUInt32::create(seq));
+      message.addField(new Messages::FieldIdentity("Symbol"), Messages::FieldAscii::create(symbol));
+      encoder.encodeMessage(destination, templateId, message);
+    }
+
+    /// @brief Add a field to a message by name.
+    /// @param message receives the field.
+    /// @param name identifies the field.
+    /// @param field is the value.
+    inline void addNamedField(
+      Messages::Message & message,
+      const std::string & name,
+      const Messages::FieldCPtr & field)
+    {
+      message.addField(new Messages::FieldIdentity(name), field);
+    }
+
+    /// @brief Encode messages into a string of FAST data.
+    ///
+    /// One Encoder encodes every message, so dictionary values carry from one
+    /// message to the next as they would on a connection.
+    class EncodedMessages
+    {
+    public:
+      /// @brief Construct
+      /// @param registry defines the templates.
+      explicit EncodedMessages(Codecs::TemplateRegistryPtr registry)
+        : encoder_(registry)
+      {
+      }
+
+      /// @brief Encode a message and append it to the data.
+      /// @param templateId identifies the template to use.
+      /// @param message contains the fields.
+      void add(template_id_t templateId, const Messages::Message & message)
+      {
+        encoder_.encodeMessage(destination_, templateId, message);
+      }
+
+      /// @brief The messages encoded so far.
+      std::string str()const
+      {
+        std::string fast;
+        destination_.toString(fast);
+        return fast;
+      }
+
+    private:
+      Codecs::Encoder encoder_;
+      Codecs::DataDestination destination_;
+    };
+
+    /// @brief Collect the Seq field of each message; count errors and warnings.
+    class SequenceConsumer : public Codecs::MessageConsumer
+    {
+    public:
+      SequenceConsumer()
+        : errors_(0)
+        , warnings_(0)
+      {
+      }
+
+      virtual bool consumeMessage(Messages::Message & message)
+      {
+        Messages::FieldCPtr field;
+        if(message.getField("Seq", field))
+        {
+          sequence_.push_back(field->toUInt32());
+        }
+        return true;
+      }
+
+      virtual bool wantLog(unsigned short level)
+      {
+        return level <= QF_LOG_WARNING;
+      }
+
+      virtual bool logMessage(unsigned short level, const std::string & /*logMessage*/)
+      {
+        if(level == QF_LOG_WARNING)
+        {
+          ++warnings_;
+        }
+        return true;
+      }
+
+      virtual bool reportDecodingError(const std::string & /*errorMessage*/)
+      {
+        ++errors_;
+        return true;
+      }
+
+      virtual bool reportCommunicationError(const std::string & /*errorMessage*/)
+      {
+        return false;
+      }
+
+      virtual void decodingStarted()
+      {
+      }
+
+      virtual void decodingStopped()
+      {
+      }
+
+      /// The Seq values in the order the messages arrived
+      std::vector<uint32> sequence_;
+      /// Decoding errors reported
+      size_t errors_;
+      /// Warnings logged
+      size_t warnings_;
+    };
+
+    /// @brief Decode every message in a string of FAST data.
+    /// @param registry defines the templates.
+    /// @param fast contains the encoded messages.
+    /// @param consumer receives each message via a GenericMessageBuilder.
+    inline void decodeAll(
+      Codecs::TemplateRegistryPtr registry,
+      const std::string & fast,
+      Codecs::MessageConsumer & consumer)
+    {
+      Codecs::Decoder decoder(registry);
+      Codecs::DataSourceString source(fast);
+      Codecs::GenericMessageBuilder builder(consumer);
+      while(source.messageAvailable() > 0)
+      {
+        decoder.decodeMessage(source, builder);
+      }
+    }
+  }
+}
+#endif // TEMPLATEBUILDER_H
@@ -0,0 +1,233 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Common/Allocator.h>
+#include <Common/StringBuffer.h>
+#include <Common/WorkingBuffer.h>
+#include <Common/Value.h>
+#include <Communication/LinkedBuffer.h>
+#include <Messages/Message.h>
+#include <Messages/Sequence.h>
+#include <Messages/FieldUInt32.h>
+#include <Messages/FieldAscii.h>
+#include <Messages/FieldSequence.h>
+
+using namespace QuickFAST;
+
+namespace
+{
+  /// Keep track of blocks that have not been freed.
+  class CountingAllocator : public HeapAllocator
+  {
+  public:
+    CountingAllocator()
+      : allocations_(0)
+      , outstanding_(0)
+    {
+    }
+
+    virtual void * allocate(size_t size)
+    {
+      ++allocations_;
+      ++outstanding_;
+      return HeapAllocator::allocate(size);
+    }
+
+    virtual void deallocate(void * block, size_t size)
+    {
+      --outstanding_;
+      HeapAllocator::deallocate(block, size);
+    }
+
+    size_t allocations_;
+    size_t outstanding_;
+  };
+}
+
+BOOST_AUTO_TEST_CASE(testAllocatorScope)
+{
+  CountingAllocator counting;
+  BOOST_CHECK(&Allocator::current() == &Allocator::defaultAllocator());
+  {
+    AllocatorScope scope(&counting);
+    BOOST_CHECK(&Allocator::current() == &counting);
+    {
+      AllocatorScope unchanged(0);
+      BOOST_CHECK(&Allocator::current() == &counting);
+    }
+    Messages::FieldIdentityCPtr seqIdentity = new Messages::FieldIdentity("Seq");
+    Messages::FieldIdentityCPtr symbolIdentity = new Messages::FieldIdentity("Symbol");
+    Messages::FieldIdentityCPtr entriesIdentity = new Messages::FieldIdentity("Entries");
+    Messages::FieldIdentityCPtr lengthIdentity = new Messages::FieldIdentity("NoEntries");
+
+    Messages::Message message(2);
+    message.addField(seqIdentity, Messages::FieldUInt32::create(1));
+    message.addField(symbolIdentity, Messages::FieldAscii::create(std::string(200, 'x')));
+    Messages::SequencePtr sequence(new Messages::Sequence(lengthIdentity, 2));
+    for(size_t nEntry = 0; nEntry < 2; ++nEntry)
+    {
+      Messages::FieldSetPtr entry(new Messages::FieldSet(1));
+      entry->addField(seqIdentity, Messages::FieldUInt32::create(uint32(nEntry)));
+      sequence->addEntry(entry);
+    }
+    message.addField(entriesIdentity, Messages::FieldSequence::create(sequence));
+    BOOST_CHECK(counting.allocations_ > 0);
+    BOOST_CHECK(counting.outstanding_ > 0);
+
+    StringBuffer big;
+    big.assign(reinterpret_cast<const uchar *>(std::string(500, 'y').c_str()), 500);
+    WorkingBuffer working;
+    working.clear(false, 1000);
+  }
+  BOOST_CHECK(&Allocator::current() == &Allocator::defaultAllocator());
+  // Everything was freed to the allocator it came from.
+  BOOST_CHECK_EQUAL(counting.outstanding_, 0);
+}
+
+BOOST_AUTO_TEST_CASE(testFreedOutsideScope)
+{
+  CountingAllocator counting;
+  Messages::FieldCPtr field;
+  {
+    AllocatorScope scope(&counting);
+    field = Messages::FieldUInt32::create(7);
+  }
+  BOOST_CHECK_EQUAL(counting.outstanding_, 1);
+  field.reset();
+  BOOST_CHECK_EQUAL(counting.outstanding_, 0);
+}
+
+BOOST_AUTO_TEST_CASE(testPoolAllocator)
+{
+  CountingAllocator backing;
+  {
+    PoolAllocator pool(64, 4096, &backing);
+    void * first = pool.allocate(40);
+    void * second = pool.allocate(40);
+    BOOST_CHECK(first != second);
+    BOOST_CHECK_EQUAL(reinterpret_cast<size_t>(first) % PoolAllocator::granularity, 0);
+    BOOST_CHECK_EQUAL(backing.allocations_, 1);
+    BOOST_CHECK_EQUAL(pool.slabBytes(), 4096);
+    pool.deallocate(first, 40);
+    BOOST_CHECK(pool.allocate(33) == first);
+
+    // too big to pool
+    void * large = pool.allocate(1000);
+    BOOST_CHECK_EQUAL(backing.allocations_, 2);
+    pool.deallocate(large, 1000);
+    BOOST_CHECK_EQUAL(backing.outstanding_, 1);
+
+    AllocatorScope scope(&pool);
+    Messages::FieldCPtr field = Messages::FieldUInt32::create(1);
+    BOOST_CHECK_EQUAL(field->toUInt32(), 1);
+  }
+  BOOST_CHECK_EQUAL(backing.outstanding_, 0);
+}
+
+namespace
+{
+  void releaseFields(std::vector<Messages::FieldCPtr> * fields)
+  {
+    fields->clear();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testLockedPoolAllocator)
+{
+  LockedPoolAllocator pool(512, 4096);
+  std::vector<Messages::FieldCPtr> fields;
+  {
+    AllocatorScope scope(&pool);
+    for(uint32 nField = 0; nField < 100; ++nField)
+    {
+      fields.push_back(Messages::FieldUInt32::create(nField));
+    }
+  }
+  BOOST_CHECK(pool.bytesInUse() > 0);
+  BOOST_CHECK(pool.slabBytes() > 0);
+
+  // The fields are released on another thread while this one allocates.
+  boost::thread releaser(boost::bind(releaseFields, &fields));
+  for(size_t nBlock = 0; nBlock < 1000; ++nBlock)
+  {
+    pool.deallocate(pool.allocate(48), 48);
+  }
+  releaser.join();
+  BOOST_CHECK_EQUAL(pool.bytesInUse(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testArenaAllocator)
+{
+  CountingAllocator backing;
+  {
+    ArenaAllocator arena(1024, &backing);
+    void * first = arena.allocate(10);
+    void * second = arena.allocate(10);
+    BOOST_CHECK_EQUAL(static_cast<uchar *>(second) - static_cast<uchar *>(first), 16);
+    BOOST_CHECK_EQUAL(arena.bytesInUse(), 32);
+    arena.deallocate(first, 10);
+    BOOST_CHECK_EQUAL(arena.bytesInUse(), 32);
+
+    (void)arena.allocate(2000);
+    (void)arena.allocate(1000);
+    BOOST_CHECK_EQUAL(backing.allocations_, 3);
+    arena.rewind();
+    BOOST_CHECK_EQUAL(arena.bytesInUse(), 0);
+    BOOST_CHECK_EQUAL(backing.outstanding_, 1);
+    BOOST_CHECK(arena.allocate(10) == first);
+  }
+  BOOST_CHECK_EQUAL(backing.outstanding_, 0);
+}
+
+BOOST_AUTO_TEST_CASE(testLongLivedStorageUsesDefault)
+{
+  CountingAllocator counting;
+  {
+    AllocatorScope scope(&counting);
+    // dictionary values, working buffers and receiver buffers outlive a message.
+    Value value;
+    value.setValue(std::string(200, 'v'));
+    WorkingBuffer working;
+    working.clear(false, 1000);
+    Communication::LinkedBuffer buffer(1000);
+    BOOST_CHECK_EQUAL(counting.allocations_, 0);
+
+    Messages::FieldCPtr field = Messages::FieldAscii::create(std::string(200, 'x'));
+    BOOST_CHECK(counting.allocations_ > 0);
+  }
+  BOOST_CHECK_EQUAL(counting.outstanding_, 0);
+}
+
+BOOST_AUTO_TEST_CASE(testBufferAllocator)
+{
+  CountingAllocator counting;
+  BOOST_CHECK(&Allocator::bufferAllocator() == &Allocator::defaultAllocator());
+  BOOST_CHECK(Allocator::setBufferAllocator(&counting) == 0);
+  BOOST_CHECK(&Allocator::bufferAllocator() == &counting);
+  {
+    Value value;
+    value.setValue(std::string(200, 'v'));
+    size_t valueAllocations = counting.allocations_;
+    BOOST_CHECK(valueAllocations > 0);
+    WorkingBuffer working;
+    working.clear(false, 1000);
+    BOOST_CHECK(counting.allocations_ > valueAllocations);
+    size_t workingAllocations = counting.allocations_;
+    Communication::LinkedBuffer buffer(1000);
+    BOOST_CHECK(counting.allocations_ > workingAllocations);
+
+    // messages still come from the current Allocator.
+    size_t bufferAllocations = counting.allocations_;
+    Messages::FieldCPtr field = Messages::FieldAscii::create(std::string(200, 'x'));
+    BOOST_CHECK_EQUAL(counting.allocations_, bufferAllocations);
+    BOOST_CHECK(Allocator::setBufferAllocator(0) == &counting);
+  }
+  BOOST_CHECK(&Allocator::bufferAllocator() == &Allocator::defaultAllocator());
+  // buffers allocated before the change were returned to the allocator that supplied them.
+  BOOST_CHECK_EQUAL(counting.outstanding_, 0);
+}
@@ -0,0 +1,187 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/FieldInstructionByteVector.h>
+#include <Codecs/FieldOpNop.h>
+#include <Codecs/DataSource.h>
+#include <Codecs/SingleMessageConsumer.h>
+
+#include <Messages/FieldByteVector.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  /// A DataSource that delivers its data a few bytes at a time
+  /// to simulate a message that spans several packets.
+  class SmallBufferSource : public Codecs::DataSource
+  {
+  public:
+    SmallBufferSource(const std::string & data, size_t bufferSize)
+      : data_(data)
+      , bufferSize_(bufferSize)
+      , position_(0)
+    {
+    }
+
+    virtual bool getBuffer(const uchar *& buffer, size_t & size)
+    {
+      if(position_ >= data_.size())
+      {
+        return false;
+      }
+      buffer = reinterpret_cast<const uchar *>(data_.data()) + position_;
+      size = std::min(bufferSize_, data_.size() - position_);
+      position_ += size;
+      return true;
+    }
+
+  private:
+    std::string data_;
+    size_t bufferSize_;
+    size_t position_;
+  };
+
+  /// Accept byte vectors in pieces and remember what arrived.
+  class ChunkRecorder : public Codecs::GenericMessageBuilder
+  {
+  public:
+    ChunkRecorder(Codecs::MessageConsumer & consumer)
+      : Codecs::GenericMessageBuilder(consumer)
+      , started_(0)
+      , chunks_(0)
+      , ended_(0)
+      , announced_(0)
+    {
+    }
+
+    virtual bool startByteVector(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/, size_t length)
+    {
+      ++started_;
+      announced_ = length;
+      value_.clear();
+      return true;
+    }
+
+    virtual void appendByteVector(Messages::FieldIdentityCPtr & /*identity*/, const unsigned char * chunk, size_t size)
+    {
+      ++chunks_;
+      value_.append(reinterpret_cast<const char *>(chunk), size);
+    }
+
+    virtual void endByteVector(Messages::FieldIdentityCPtr & /*identity*/, ValueType::Type /*type*/)
+    {
+      ++ended_;
+    }
+
+    size_t started_;
+    size_t chunks_;
+    size_t ended_;
+    size_t announced_;
+    std::string value_;
+  };
+
+  // <template name="Blob" id="1">
+  //   <byteVector name="Data"/>
+  //   <uInt32 name="Seq"><copy/></uInt32>
+  // </template>
+  Codecs::TemplateRegistryPtr createRegistry()
+  {
+    Codecs::TemplatePtr blob = createTemplate(1, "Blob");
+    addField(blob, new Codecs::FieldInstructionByteVector("Data", ""), new Codecs::FieldOpNop);
+    addField(blob, new Codecs::FieldInstructionUInt32("Seq", ""), new Codecs::FieldOpCopy);
+
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(blob);
+    registry->finalize();
+    return registry;
+  }
+
+  // Seq numbers the values from one.
+  std::string encodeBlobs(Codecs::TemplateRegistryPtr registry, const std::string & first, const std::string & second)
+  {
+    const std::string * values[] = {&first, &second};
+    EncodedMessages fast(registry);
+    for(size_t nMsg = 0; nMsg < 2; ++nMsg)
+    {
+      Messages::Message message(registry->maxFieldCount());
+      addNamedField(message, "Data", Messages::FieldByteVector::create(*values[nMsg]));
+      addNamedField(message, "Seq", Messages::FieldUInt32::create(uint32(nMsg + 1)));
+      fast.add(1, message);
+    }
+    return fast.str();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testByteVectorChunks)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string large;
+  for(size_t nByte = 0; nByte < 1000; ++nByte)
+  {
+    large += char(nByte * 7);
+  }
+  std::string small("tiny");
+  std::string fast = encodeBlobs(registry, large, small);
+
+  // Streaming disabled (the default): the builder sees ordinary fields.
+  {
+    Codecs::Decoder decoder(registry);
+    BOOST_CHECK_EQUAL(decoder.getByteVectorChunkThreshold(), 0);
+    SmallBufferSource source(fast, 13);
+    Codecs::SingleMessageConsumer consumer;
+    ChunkRecorder builder(consumer);
+    decoder.decodeMessage(source, builder);
+    BOOST_CHECK_EQUAL(builder.started_, 0);
+    Messages::FieldCPtr field;
+    BOOST_REQUIRE(consumer.message().getField("Data", field));
+    BOOST_CHECK(std::string(field->toByteVector()) == large);
+  }
+
+  // Large values arrive in pieces that match the source's buffers; small ones do not.
+  {
+    Codecs::Decoder decoder(registry);
+    decoder.setByteVectorChunkThreshold(100);
+    SmallBufferSource source(fast, 13);
+    Codecs::SingleMessageConsumer consumer;
+    ChunkRecorder builder(consumer);
+
+    decoder.decodeMessage(source, builder);
+    BOOST_CHECK_EQUAL(builder.started_, 1);
+    BOOST_CHECK_EQUAL(builder.ended_, 1);
+    BOOST_CHECK_EQUAL(builder.announced_, large.size());
+    BOOST_CHECK(builder.chunks_ >= large.size() / 13);
+    BOOST_CHECK(builder.value_ == large);
+    Messages::FieldCPtr field;
+    BOOST_CHECK(!consumer.message().getField("Data", field));
+    BOOST_REQUIRE(consumer.message().getField("Seq", field));
+    BOOST_CHECK_EQUAL(field->toUInt32(), 1);
+
+    decoder.decodeMessage(source, builder);
+    BOOST_CHECK_EQUAL(builder.started_, 1);
+    BOOST_REQUIRE(consumer.message().getField("Data", field));
+    BOOST_CHECK(std::string(field->toByteVector()) == small);
+    BOOST_REQUIRE(consumer.message().getField("Seq", field));
+    BOOST_CHECK_EQUAL(field->toUInt32(), 2);
+  }
+
+  // A builder that declines gets the whole value.
+  {
+    Codecs::Decoder decoder(registry);
+    decoder.setByteVectorChunkThreshold(100);
+    SmallBufferSource source(fast, 13);
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    decoder.decodeMessage(source, builder);
+    Messages::FieldCPtr field;
+    BOOST_REQUIRE(consumer.message().getField("Data", field));
+    BOOST_CHECK(std::string(field->toByteVector()) == large);
+  }
+}
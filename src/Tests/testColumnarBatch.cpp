@@ -0,0 +1,228 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/ColumnarBatchBuilder.h>
+#include <Codecs/FieldInstructionUInt32.h>
+#include <Codecs/FieldInstructionInt64.h>
+#include <Codecs/FieldInstructionAscii.h>
+#include <Codecs/FieldInstructionDecimal.h>
+#include <Codecs/FieldOpNop.h>
+#include <Codecs/FieldOpCopy.h>
+#include <Codecs/FieldOpDelta.h>
+#include <Codecs/FieldOpIncrement.h>
+#include <Codecs/Template.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/Encoder.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/DataDestination.h>
+#include <Codecs/DataSourceString.h>
+
+#include <Messages/Message.h>
+#include <Messages/FieldUInt32.h>
+#include <Messages/FieldInt64.h>
+#include <Messages/FieldAscii.h>
+#include <Messages/FieldDecimal.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  // <template name="Trade" id="2">
+  //   <uInt32 name="Seq"><increment/></uInt32>
+  //   <string name="Symbol" presence="optional"><copy/></string>
+  //   <decimal name="Price"/>
+  //   <int64 name="Quantity"><delta/></int64>
+  // </template>
+  // <template name="Heartbeat" id="3">
+  //   <uInt32 name="Seq"/>
+  // </template>
+  Codecs::TemplateRegistryPtr createRegistry()
+  {
+    Codecs::TemplatePtr trade = createTemplate(2, "Trade");
+    addField(trade, new Codecs::FieldInstructionUInt32("Seq", ""), new Codecs::FieldOpIncrement);
+    addField(trade, new Codecs::FieldInstructionAscii("Symbol", ""), new Codecs::FieldOpCopy, false);
+    addField(trade, new Codecs::FieldInstructionDecimal("Price", ""), new Codecs::FieldOpNop);
+    addField(trade, new Codecs::FieldInstructionInt64("Quantity", ""), new Codecs::FieldOpDelta);
+
+    Codecs::TemplatePtr heartbeat = createTemplate(3, "Heartbeat");
+    addField(heartbeat, new Codecs::FieldInstructionUInt32("Seq", ""), new Codecs::FieldOpNop);
+
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(trade);
+    registry->addTemplate(heartbeat);
+    registry->finalize();
+    return registry;
+  }
+
+  // Five trades, two heartbeats, three trades.
+  const size_t messageCount = 10;
+  bool isTrade(size_t nMessage)
+  {
+    return nMessage < 5 || nMessage >= 7;
+  }
+
+  std::string encodeMessages(Codecs::TemplateRegistryPtr registry)
+  {
+    Messages::FieldIdentityCPtr seqIdentity = new Messages::FieldIdentity("Seq");
+    Messages::FieldIdentityCPtr symbolIdentity = new Messages::FieldIdentity("Symbol");
+    Messages::FieldIdentityCPtr priceIdentity = new Messages::FieldIdentity("Price");
+    Messages::FieldIdentityCPtr quantityIdentity = new Messages::FieldIdentity("Quantity");
+    EncodedMessages fast(registry);
+    for(size_t nMessage = 0; nMessage < messageCount; ++nMessage)
+    {
+      Messages::Message message(registry->maxFieldCount());
+      message.addField(seqIdentity, Messages::FieldUInt32::create(uint32(100 + nMessage)));
+      if(isTrade(nMessage))
+      {
+        if(nMessage % 3 != 1)
+        {
+          message.addField(symbolIdentity, Messages::FieldAscii::create(nMessage % 2 == 0 ? "GE" : "AAPL"));
+        }
+        message.addField(priceIdentity, Messages::FieldDecimal::create(Decimal(int64(2000 + nMessage), -2)));
+        message.addField(quantityIdentity, Messages::FieldInt64::create(int64(nMessage * 10)));
+        fast.add(2, message);
+      }
+      else
+      {
+        fast.add(3, message);
+      }
+    }
+    return fast.str();
+  }
+
+  /// Describe each batch as it arrives.
+  class BatchRecorder : public Codecs::ColumnarBatchConsumer
+  {
+  public:
+    virtual bool consumeBatch(const Codecs::ColumnarBatch & batch)
+    {
+      text_ << batch.templateId() << ':';
+      for(size_t nColumn = 0; nColumn < batch.columnCount(); ++nColumn)
+      {
+        const Codecs::ColumnarBatch::Column & column = batch.column(nColumn);
+        BOOST_CHECK_EQUAL(reinterpret_cast<size_t>(column.values()) % Codecs::ColumnarBatch::alignment, 0);
+        BOOST_CHECK_EQUAL(reinterpret_cast<size_t>(column.validity()) % Codecs::ColumnarBatch::alignment, 0);
+        text_ << column.name() << '=';
+        for(size_t row = 0; row < batch.size(); ++row)
+        {
+          if(!column.isValid(row))
+          {
+            text_ << '-';
+          }
+          else if(column.isVariableWidth())
+          {
+            const uint32 * offsets = column.offsets();
+            text_ << std::string(
+              reinterpret_cast<const char *>(column.bytes() + offsets[row]),
+              offsets[row + 1] - offsets[row]);
+          }
+          else if(column.type() == ValueType::DECIMAL)
+          {
+            text_ << column.valuesAs<mantissa_t>()[row] << 'e' << int(column.exponents()[row]);
+          }
+          else if(column.type() == ValueType::INT64)
+          {
+            text_ << column.valuesAs<int64>()[row];
+          }
+          else
+          {
+            text_ << column.valuesAs<uint32>()[row];
+          }
+          text_ << ',';
+        }
+        text_ << ';';
+      }
+      text_ << '|';
+      return true;
+    }
+
+    virtual bool wantLog(unsigned short /*level*/)
+    {
+      return false;
+    }
+    virtual bool logMessage(unsigned short /*level*/, const std::string & /*logMessage*/)
+    {
+      return true;
+    }
+    virtual bool reportDecodingError(const std::string & /*errorMessage*/)
+    {
+      return true;
+    }
+    virtual bool reportCommunicationError(const std::string & /*errorMessage*/)
+    {
+      return true;
+    }
+
+    std::string text()const
+    {
+      return text_.str();
+    }
+
+  private:
+    std::ostringstream text_;
+  };
+}
+
+BOOST_AUTO_TEST_CASE(testColumnarBatch)
+{
+  Messages::FieldIdentityCPtr symbolIdentity = new Messages::FieldIdentity("Symbol");
+  Codecs::ColumnarBatch batch(2, 10);
+  size_t index = batch.addColumn(symbolIdentity, ValueType::ASCII, sizeof(uint32));
+  Codecs::ColumnarBatch::Column & symbol = batch.mutableColumn(index);
+  symbol.setBytes(0, reinterpret_cast<const uchar *>("IBM"), 3);
+  batch.endRow();
+  batch.endRow();
+  symbol.setBytes(2, reinterpret_cast<const uchar *>("GE"), 2);
+  batch.discardRow();
+  symbol.setBytes(2, reinterpret_cast<const uchar *>("F"), 1);
+  batch.endRow();
+  BOOST_CHECK_EQUAL(batch.size(), 3);
+  BOOST_CHECK_EQUAL(symbol.validCount(batch.size()), 2);
+  BOOST_CHECK_EQUAL(symbol.offsets()[1], 3);
+  BOOST_CHECK_EQUAL(symbol.offsets()[2], 3);
+  BOOST_CHECK_EQUAL(symbol.offsets()[3], 4);
+  BOOST_CHECK_EQUAL(std::string(reinterpret_cast<const char *>(symbol.bytes()), 4), "IBMF");
+  BOOST_CHECK(batch.findColumn("Symbol") == &symbol);
+  BOOST_CHECK(batch.findColumn("Price") == 0);
+
+  batch.clear();
+  BOOST_CHECK(batch.empty());
+  BOOST_CHECK(!symbol.isValid(0));
+  BOOST_CHECK_THROW(Codecs::ColumnarBatch(2, 0), UsageError);
+}
+
+BOOST_AUTO_TEST_CASE(testColumnarBatchBuilder)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast = encodeMessages(registry);
+
+  BatchRecorder recorder;
+  Codecs::ColumnarBatchBuilder builder(recorder, 4);
+  Codecs::Decoder decoder(registry);
+  Codecs::DataSourceString source(fast);
+  BOOST_CHECK_THROW(decoder.decodeMessage(source, builder), UsageError);
+
+  Codecs::DataSourceString restart(fast);
+  Codecs::Decoder restartDecoder(registry);
+  builder.setDecoder(restartDecoder);
+  for(size_t nMessage = 0; nMessage < messageCount; ++nMessage)
+  {
+    restartDecoder.decodeMessage(restart, builder);
+  }
+  BOOST_CHECK_EQUAL(builder.batchCount(), 3);
+  builder.flush();
+  BOOST_CHECK_EQUAL(builder.batchCount(), 4);
+
+  BOOST_CHECK_EQUAL(recorder.text(),
+    "2:Seq=100,101,102,103,;Symbol=GE,-,GE,AAPL,;Price=2000e-2,2001e-2,2002e-2,2003e-2,;Quantity=0,10,20,30,;|"
+    "2:Seq=104,;Symbol=-,;Price=2004e-2,;Quantity=40,;|"
+    "3:Seq=105,106,;|"
+    "2:Seq=107,108,109,;Symbol=-,GE,AAPL,;Price=2007e-2,2008e-2,2009e-2,;Quantity=70,80,90,;|");
+}
@@ -12,6 +12,7 @@
 #include <Common/WorkingBuffer.h>
 #include <Common/Exceptions.h>
 #include <Common/Decimal.h>
+#include <Common/HighBitScan.h>
 
 using namespace QuickFAST;
 BOOST_AUTO_TEST_CASE(TestLinkedBuffer)
@@ -428,6 +429,16 @@ BOOST_AUTO_TEST_CASE(TestWorkingBuffer)
   BOOST_CHECK(abc.capacity() > abcCap); // now we should have grown
   BOOST_CHECK(0 == std::strncmp(abcStr.data(), reinterpret_cast<const char *>(abc.begin()), abcHalf * 4));
 
+  // prefault allocates in advance and empties the buffer
+  abc.prefault(1500);
+  BOOST_CHECK_EQUAL(abc.size(), 0);
+  BOOST_CHECK(abc.capacity() >= 1500);
+  size_t prefaultCap = abc.capacity();
+  for(size_t n = 0; n < 1500; ++n)
+  {
+    abc.push(uchar('a' + n % 26));
+  }
+  BOOST_CHECK_EQUAL(abc.capacity(), prefaultCap); // no grow
 
   // TODO: This is a start, but we could use a lot more testing here.
 }
@@ -504,3 +515,16 @@ BOOST_AUTO_TEST_CASE(TestDecimal)
   BOOST_CHECK_GT(f, g);
 
 }
+
+BOOST_AUTO_TEST_CASE(TestFindHighBit)
+{
+  uchar data[40];
+  memset(data, 0x7F, sizeof(data));
+  BOOST_CHECK_EQUAL(findHighBit(data, sizeof(data)), sizeof(data));
+  data[29] = 0x80;
+  BOOST_CHECK_EQUAL(findHighBit(data, sizeof(data)), 29);
+  BOOST_CHECK_EQUAL(findHighBit(data, sizeof(data), 29), 29);
+  BOOST_CHECK_EQUAL(findHighBit(data, sizeof(data), 30), sizeof(data));
+  data[3] = 0x81;
+  BOOST_CHECK_EQUAL(findHighBit(data, sizeof(data), 1), 3);
+}
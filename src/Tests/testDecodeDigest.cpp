@@ -0,0 +1,209 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/DigestBuilder.h>
+#include <Codecs/DecodeDigest.h>
+#include <Codecs/FieldInstructionUInt32.h>
+#include <Codecs/FieldInstructionAscii.h>
+#include <Codecs/FieldInstructionDecimal.h>
+#include <Codecs/FieldOpCopy.h>
+#include <Codecs/FieldOpDelta.h>
+#include <Codecs/FieldOpIncrement.h>
+#include <Codecs/Template.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/Encoder.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/DataDestination.h>
+#include <Codecs/DataSourceString.h>
+
+#include <Messages/Message.h>
+#include <Messages/FieldUInt32.h>
+#include <Messages/FieldAscii.h>
+#include <Messages/FieldDecimal.h>
+
+#include <Common/Exceptions.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  // <template name="Trade" id="4">
+  //   <uInt32 name="Seq"><increment/></uInt32>
+  //   <string name="Symbol"><copy/></string>
+  //   <decimal name="Price"><delta/></decimal>
+  // </template>
+  Codecs::TemplateRegistryPtr createRegistry()
+  {
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    Codecs::TemplatePtr trade = createTemplate(4, "Trade");
+    addField(trade, new Codecs::FieldInstructionUInt32("Seq", ""), new Codecs::FieldOpIncrement);
+    addField(trade, new Codecs::FieldInstructionAscii("Symbol", ""), new Codecs::FieldOpCopy);
+    addField(trade, new Codecs::FieldInstructionDecimal("Price", ""), new Codecs::FieldOpDelta);
+    registry->addTemplate(trade);
+    registry->finalize();
+    return registry;
+  }
+
+  const size_t messageCount = 10;
+
+  // Encode messageCount trades.  If changed < messageCount, that trade has a different price.
+  std::string encodeTrades(Codecs::TemplateRegistryPtr registry, size_t changed)
+  {
+    EncodedMessages fast(registry);
+    for(size_t nMessage = 0; nMessage < messageCount; ++nMessage)
+    {
+      Messages::Message message(registry->maxFieldCount());
+      message.addField(new Messages::FieldIdentity("Seq"), Messages::FieldUInt32::create(uint32(500 + nMessage)));
+      message.addField(new Messages::FieldIdentity("Symbol"), Messages::FieldAscii::create(nMessage < 5 ? "IBM" : "ORCL"));
+      mantissa_t price = mantissa_t(12000 + nMessage * 3 + (nMessage == changed ? 1 : 0));
+      message.addField(new Messages::FieldIdentity("Price"), Messages::FieldDecimal::create(Decimal(price, -2)));
+      fast.add(4, message);
+    }
+    return fast.str();
+  }
+
+  void digestTrades(
+    Codecs::TemplateRegistryPtr registry,
+    const std::string & fast,
+    size_t count,
+    Codecs::DecodeDigest & digest)
+  {
+    Codecs::DigestBuilder builder(digest);
+    Codecs::Decoder decoder(registry);
+    Codecs::DataSourceString source(fast);
+    for(size_t nMessage = 0; nMessage < count; ++nMessage)
+    {
+      decoder.decodeMessage(source, builder);
+    }
+    BOOST_CHECK_EQUAL(builder.errorCount(), 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testDecodeDigestSame)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast = encodeTrades(registry, messageCount);
+
+  Codecs::DecodeDigest first(4);
+  digestTrades(registry, fast, messageCount, first);
+  Codecs::DecodeDigest second(4);
+  digestTrades(registry, fast, messageCount, second);
+
+  BOOST_CHECK_EQUAL(first.messageCount(), messageCount);
+  BOOST_CHECK_EQUAL(first.checkpointCount(), 2);
+  BOOST_CHECK_EQUAL(first.finalDigest(), second.finalDigest());
+  BOOST_CHECK_EQUAL(first.checkpoint(1), second.checkpoint(1));
+  BOOST_CHECK(first.checkpoint(0) != first.checkpoint(1));
+  size_t begin = 0;
+  size_t end = 0;
+  BOOST_CHECK(!first.findDifference(second, begin, end));
+
+  Codecs::DecodeDigest different(5);
+  digestTrades(registry, fast, messageCount, different);
+  BOOST_CHECK_THROW(first.findDifference(different, begin, end), UsageError);
+  BOOST_CHECK_THROW(Codecs::DecodeDigest(0), UsageError);
+}
+
+BOOST_AUTO_TEST_CASE(testDecodeDigestDifference)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast = encodeTrades(registry, messageCount);
+  std::string changed = encodeTrades(registry, 6);
+
+  Codecs::DecodeDigest good(4);
+  digestTrades(registry, fast, messageCount, good);
+  Codecs::DecodeDigest bad(4);
+  digestTrades(registry, changed, messageCount, bad);
+  BOOST_CHECK(good.finalDigest() != bad.finalDigest());
+  BOOST_CHECK_EQUAL(good.checkpoint(0), bad.checkpoint(0));
+
+  // Without message digests the difference is found to within a checkpoint interval.
+  size_t begin = 0;
+  size_t end = 0;
+  BOOST_REQUIRE(good.findDifference(bad, begin, end));
+  BOOST_CHECK_EQUAL(begin, 4);
+  BOOST_CHECK_EQUAL(end, 8);
+
+  Codecs::DecodeDigest goodMessages(4);
+  goodMessages.setKeepMessages(true);
+  digestTrades(registry, fast, messageCount, goodMessages);
+  Codecs::DecodeDigest badMessages(4);
+  badMessages.setKeepMessages(true);
+  digestTrades(registry, changed, messageCount, badMessages);
+  BOOST_CHECK_EQUAL(goodMessages.finalDigest(), good.finalDigest());
+  BOOST_REQUIRE(goodMessages.findDifference(badMessages, begin, end));
+  BOOST_CHECK_EQUAL(begin, 6);
+  BOOST_CHECK_EQUAL(end, 7);
+
+  // A shorter run.
+  Codecs::DecodeDigest shortMessages(4);
+  shortMessages.setKeepMessages(true);
+  digestTrades(registry, fast, 7, shortMessages);
+  BOOST_REQUIRE(goodMessages.findDifference(shortMessages, begin, end));
+  BOOST_CHECK_EQUAL(begin, 7);
+  BOOST_CHECK_EQUAL(end, 8);
+}
+
+BOOST_AUTO_TEST_CASE(testDecodeDigestFieldIdentity)
+{
+  // As if two optional fields were decoded, each with the other absent.
+  Codecs::DecodeDigest digest(4);
+  Codecs::DigestBuilder builder(digest);
+  Messages::FieldIdentityCPtr bid(new Messages::FieldIdentity("Bid"));
+  Messages::FieldIdentityCPtr ask(new Messages::FieldIdentity("Ask"));
+  const std::string applicationType("Quote");
+
+  builder.endMessage(builder.startMessage(applicationType, "", 2));
+  uint64 empty = builder.messageDigest();
+
+  Messages::ValueMessageBuilder & bidBuilder = builder.startMessage(applicationType, "", 2);
+  bidBuilder.addValue(bid, ValueType::UINT32, uint32(5));
+  builder.endMessage(bidBuilder);
+  uint64 bidOnly = builder.messageDigest();
+
+  Messages::ValueMessageBuilder & askBuilder = builder.startMessage(applicationType, "", 2);
+  askBuilder.addValue(ask, ValueType::UINT32, uint32(5));
+  builder.endMessage(askBuilder);
+  uint64 askOnly = builder.messageDigest();
+
+  BOOST_CHECK(bidOnly != askOnly);
+  BOOST_CHECK(bidOnly != empty);
+  BOOST_CHECK_EQUAL(digest.messageCount(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(testDecodeDigestReadWrite)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast = encodeTrades(registry, messageCount);
+
+  Codecs::DecodeDigest digest(3);
+  digest.setKeepMessages(true);
+  digestTrades(registry, fast, messageCount, digest);
+
+  std::stringstream saved;
+  digest.write(saved);
+  Codecs::DecodeDigest restored;
+  BOOST_REQUIRE(restored.read(saved));
+  BOOST_CHECK_EQUAL(restored.checkpointInterval(), 3);
+  BOOST_CHECK_EQUAL(restored.messageCount(), messageCount);
+  BOOST_CHECK_EQUAL(restored.finalDigest(), digest.finalDigest());
+  BOOST_CHECK(restored.hasMessages());
+  BOOST_CHECK_EQUAL(restored.messageDigest(9), digest.messageDigest(9));
+  size_t begin = 0;
+  size_t end = 0;
+  BOOST_CHECK(!restored.findDifference(digest, begin, end));
+
+  std::string text = saved.str();
+  text[text.find(' ') + 1] = '7';
+  std::stringstream corrupt(text);
+  Codecs::DecodeDigest rejected;
+  BOOST_CHECK(!rejected.read(corrupt));
+  BOOST_CHECK_EQUAL(rejected.messageCount(), 0);
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Application/DecoderConnection.h>
+#include <Application/DecoderConfiguration.h>
+#include <Codecs/XMLTemplateParser.h>
+#include <Communication/Receiver.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+BOOST_AUTO_TEST_CASE(testDecoderConnectionWarmUp)
+{
+  std::string xml(std::getenv("QUICKFAST_ROOT"));
+  xml += "/src/Tests/resources/warm_up.xml";
+
+  Application::DecoderConfiguration configuration;
+  configuration.setTemplateFileName(xml);
+  configuration.setReceiverType(Application::DecoderConfiguration::BUFFER_RECEIVER);
+
+  SequenceConsumer liveConsumer;
+  Codecs::GenericMessageBuilder liveBuilder(liveConsumer);
+  Application::DecoderConnection connection;
+  connection.configure(liveBuilder, configuration);
+
+  Codecs::Encoder encoder(connection.registry());
+  Codecs::DataDestination destination;
+  for(uint32 seq = 1; seq <= 3; ++seq)
+  {
+    encodeQuote(encoder, destination, 5, seq);
+  }
+  std::string fast;
+  destination.toString(fast);
+
+  // The sample messages go to the builder supplied for the warm up, not the live one.
+  SequenceConsumer sampleConsumer;
+  Codecs::GenericMessageBuilder sampleBuilder(sampleConsumer);
+  size_t decoded = connection.warmUp(
+    sampleBuilder,
+    reinterpret_cast<const unsigned char *>(fast.data()),
+    fast.size(),
+    2);
+  BOOST_CHECK_EQUAL(decoded, 6);
+  BOOST_REQUIRE_EQUAL(sampleConsumer.sequence_.size(), 6);
+  BOOST_CHECK_EQUAL(sampleConsumer.sequence_[2], 3);
+  BOOST_CHECK_EQUAL(sampleConsumer.sequence_[3], 1);
+  BOOST_CHECK_EQUAL(sampleConsumer.errors_, 0);
+  BOOST_CHECK(liveConsumer.sequence_.empty());
+
+  // A truncated sample ends the pass without an exception.
+  SequenceConsumer truncatedConsumer;
+  Codecs::GenericMessageBuilder truncatedBuilder(truncatedConsumer);
+  decoded = connection.warmUp(
+    truncatedBuilder,
+    reinterpret_cast<const unsigned char *>(fast.data()),
+    fast.size() - 1,
+    1);
+  BOOST_CHECK_EQUAL(decoded, 2);
+
+  // With no sample only the buffers are prefaulted.
+  BOOST_CHECK_EQUAL(connection.warmUp(sampleBuilder, 0, 0, 1, 4096), 0);
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/SingleMessageConsumer.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  const size_t templateCount = 40;
+  const size_t fieldsPerTemplate = 4;
+
+  std::string fieldName(size_t nTemplate, size_t nField)
+  {
+    return "F" + boost::lexical_cast<std::string>(nTemplate) + "_" + boost::lexical_cast<std::string>(nField);
+  }
+
+  // Templates 1 through templateCount, each with its own copy fields.
+  Codecs::TemplateRegistryPtr createRegistry()
+  {
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    for(size_t nTemplate = 1; nTemplate <= templateCount; ++nTemplate)
+    {
+      Codecs::TemplatePtr target = createTemplate(
+        template_id_t(nTemplate),
+        "T" + boost::lexical_cast<std::string>(nTemplate));
+      for(size_t nField = 0; nField < fieldsPerTemplate; ++nField)
+      {
+        addField(target, new Codecs::FieldInstructionUInt32(fieldName(nTemplate, nField), ""), new Codecs::FieldOpCopy);
+      }
+      registry->addTemplate(target);
+    }
+    registry->finalize();
+    return registry;
+  }
+
+  void encode(EncodedMessages & fast, size_t nTemplate, uint32 value)
+  {
+    Messages::Message message(fieldsPerTemplate);
+    for(size_t nField = 0; nField < fieldsPerTemplate; ++nField)
+    {
+      addNamedField(message, fieldName(nTemplate, nField), Messages::FieldUInt32::create(value));
+    }
+    fast.add(template_id_t(nTemplate), message);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testDictionaryPages)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  BOOST_REQUIRE_EQUAL(registry->dictionarySize(), templateCount * fieldsPerTemplate);
+
+  Codecs::Decoder decoder(registry);
+  BOOST_CHECK_EQUAL(decoder.dictionaryEntriesInUse(), 0);
+
+  // reading an entry does not allocate it
+  uint32 value = 0;
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(5, value), Codecs::Context::UNDEFINED_VALUE);
+  BOOST_CHECK_EQUAL(decoder.dictionaryEntriesInUse(), 0);
+
+  decoder.setDictionaryValue(5, uint32(42));
+  BOOST_CHECK_EQUAL(decoder.dictionaryEntriesInUse(), Codecs::Context::dictionaryPageSize);
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(5, value), Codecs::Context::OK_VALUE);
+  BOOST_CHECK_EQUAL(value, 42);
+  decoder.setDictionaryValueNull(6);
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(6, value), Codecs::Context::NULL_VALUE);
+  BOOST_CHECK_THROW(decoder.setDictionaryValue(registry->dictionarySize(), uint32(1)), TemplateDefinitionError);
+
+  decoder.reset();
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(5, value), Codecs::Context::UNDEFINED_VALUE);
+  BOOST_CHECK_EQUAL(decoder.dictionaryEntriesInUse(), Codecs::Context::dictionaryPageSize);
+
+  // Decode messages that use only the first and the last template.
+  EncodedMessages encoded(registry);
+  encode(encoded, 1, 10);
+  encode(encoded, templateCount, 20);
+  encode(encoded, 1, 10);
+  encode(encoded, templateCount, 21);
+  std::string fast = encoded.str();
+
+  Codecs::DataSourceString source(fast);
+  Codecs::SingleMessageConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  const uint32 expected[] = {10, 20, 10, 21};
+  for(size_t nMessage = 0; nMessage < 4; ++nMessage)
+  {
+    decoder.decodeMessage(source, builder);
+    Messages::FieldCPtr field;
+    size_t nTemplate = (nMessage % 2 == 0) ? 1 : templateCount;
+    BOOST_REQUIRE(consumer.message().getField(fieldName(nTemplate, 3), field));
+    BOOST_CHECK_EQUAL(field->toUInt32(), expected[nMessage]);
+  }
+  BOOST_CHECK_EQUAL(decoder.dictionaryEntriesInUse(), 2 * Codecs::Context::dictionaryPageSize);
+  BOOST_CHECK(decoder.dictionaryEntriesInUse() < registry->dictionarySize());
+
+  decoder.prefault(100);
+  BOOST_CHECK(decoder.dictionaryEntriesInUse() >= registry->dictionarySize());
+}
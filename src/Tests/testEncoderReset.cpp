@@ -0,0 +1,185 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/ResetIndex.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  // <template name="Quote" id="2">
+  //   <uInt32 name="Seq"><increment/></uInt32>
+  //   <string name="Symbol"><copy/></string>
+  // </template>
+  // <template name="Snapshot" id="3" reset="Y">
+  //   (the same fields)
+  // </template>
+  Codecs::TemplateRegistryPtr createRegistry()
+  {
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    addQuoteTemplate(*registry, 2, "Quote");
+    addQuoteTemplate(*registry, 3, "Snapshot")->setReset(true);
+    registry->finalize();
+    return registry;
+  }
+
+  void encode(
+    Codecs::Encoder & encoder,
+    Codecs::DataDestination & destination,
+    size_t nMessage,
+    template_id_t templateId = 2)
+  {
+    encodeQuote(encoder, destination, templateId, uint32(100 + nMessage));
+  }
+
+  // Decode every message in fast; return the Seq values.
+  std::vector<uint32> decodeSequence(Codecs::TemplateRegistryPtr registry, const std::string & fast)
+  {
+    SequenceConsumer consumer;
+    decodeAll(registry, fast, consumer);
+    return consumer.sequence_;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testEncoderAutoReset)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  Codecs::Encoder encoder(registry);
+  Codecs::ResetIndex index;
+  encoder.setAutoReset(3);
+  encoder.setResetIndex(&index);
+
+  Codecs::DataDestination destination;
+  for(size_t nMessage = 0; nMessage < 10; ++nMessage)
+  {
+    encode(encoder, destination, nMessage);
+  }
+  std::string fast;
+  destination.toString(fast);
+
+  BOOST_CHECK_EQUAL(encoder.messagesEncoded(), 10);
+  BOOST_CHECK_EQUAL(encoder.bytesEncoded(), fast.size());
+  BOOST_CHECK_EQUAL(encoder.resetMessages(), 3);
+  BOOST_CHECK_EQUAL(encoder.resetCount(), 3);
+  // A presence map byte and the template ID
+  BOOST_CHECK_EQUAL(encoder.resetBytes(), 6);
+
+  BOOST_REQUIRE_EQUAL(index.size(), 3);
+  for(size_t nEntry = 0; nEntry < index.size(); ++nEntry)
+  {
+    BOOST_CHECK_EQUAL(index[nEntry].message_, 3 * (nEntry + 1));
+    BOOST_CHECK(index[nEntry].inserted_);
+    BOOST_CHECK_EQUAL(uchar(fast[index[nEntry].offset_ + 1]), 0xF8); // template ID 120
+  }
+
+  std::vector<uint32> all = decodeSequence(registry, fast);
+  BOOST_REQUIRE_EQUAL(all.size(), 10);
+  for(size_t nMessage = 0; nMessage < all.size(); ++nMessage)
+  {
+    BOOST_CHECK_EQUAL(all[nMessage], 100 + nMessage);
+  }
+
+  // Start decoding at a reset point, as a late joiner or a parallel decoder would.
+  Codecs::ResetIndex::Entry entry;
+  BOOST_REQUIRE(index.findMessage(7, entry));
+  BOOST_CHECK_EQUAL(entry.message_, 6);
+  BOOST_CHECK(!index.findMessage(2, entry));
+  BOOST_REQUIRE(index.findOffset(fast.size() - 1, entry));
+  BOOST_CHECK_EQUAL(entry.message_, 9);
+  BOOST_REQUIRE(index.findMessage(6, entry));
+  std::vector<uint32> tail = decodeSequence(registry, fast.substr(entry.offset_));
+  BOOST_REQUIRE_EQUAL(tail.size(), 4);
+  BOOST_CHECK_EQUAL(tail[0], 106);
+  BOOST_CHECK_EQUAL(tail[3], 109);
+
+  std::ostringstream text;
+  index.write(text);
+  BOOST_CHECK(text.str().find("3 ") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testEncoderResetByBytes)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  Codecs::Encoder encoder(registry);
+  encoder.setAutoReset(0, 20);
+  Codecs::DataDestination destination;
+  for(size_t nMessage = 0; nMessage < 20; ++nMessage)
+  {
+    encode(encoder, destination, nMessage);
+  }
+  BOOST_CHECK(encoder.resetMessages() > 0);
+  std::string fast;
+  destination.toString(fast);
+  BOOST_CHECK_EQUAL(decodeSequence(registry, fast).size(), 20);
+}
+
+BOOST_AUTO_TEST_CASE(testEncoderResetAlignment)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  Codecs::Encoder encoder(registry);
+  Codecs::ResetIndex index;
+  encoder.setAutoReset(1);
+  encoder.setAlignResets(true);
+  encoder.setResetIndex(&index);
+  Codecs::DataDestination destination;
+  encoder.startPacket();
+  for(size_t nMessage = 0; nMessage < 4; ++nMessage)
+  {
+    encode(encoder, destination, nMessage);
+  }
+  BOOST_CHECK_EQUAL(encoder.resetMessages(), 0);
+
+  encoder.startPacket();
+  encode(encoder, destination, 4);
+  encode(encoder, destination, 5);
+  BOOST_CHECK_EQUAL(encoder.resetMessages(), 1);
+  BOOST_REQUIRE_EQUAL(index.size(), 1);
+  BOOST_CHECK_EQUAL(index[0].message_, 4);
+
+  // A template that resets the dictionaries is a reset point without an extra message.
+  encoder.startPacket();
+  encode(encoder, destination, 6, 3);
+  BOOST_CHECK_EQUAL(encoder.resetMessages(), 1);
+  BOOST_CHECK_EQUAL(encoder.resetCount(), 2);
+  BOOST_REQUIRE_EQUAL(index.size(), 2);
+  BOOST_CHECK_EQUAL(index[1].message_, 6);
+  BOOST_CHECK(!index[1].inserted_);
+
+  std::string fast;
+  destination.toString(fast);
+  std::vector<uint32> tail = decodeSequence(registry, fast.substr(index[1].offset_));
+  BOOST_REQUIRE_EQUAL(tail.size(), 1);
+  BOOST_CHECK_EQUAL(tail[0], 106);
+}
+
+BOOST_AUTO_TEST_CASE(testEncoderResetAlignmentWithoutPackets)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  Codecs::Encoder encoder(registry);
+  Codecs::ResetIndex index;
+  encoder.setAutoReset(2);
+  encoder.setAlignResets(true);
+  encoder.setResetIndex(&index);
+  Codecs::DataDestination destination;
+
+  // Nothing calls startPacket(), so due resets are not held back.
+  for(size_t nMessage = 0; nMessage < 6; ++nMessage)
+  {
+    encode(encoder, destination, nMessage);
+  }
+  BOOST_CHECK_EQUAL(encoder.resetMessages(), 2);
+  BOOST_REQUIRE_EQUAL(index.size(), 2);
+  BOOST_CHECK_EQUAL(index[0].message_, 2);
+  BOOST_CHECK_EQUAL(index[1].message_, 4);
+
+  std::string fast;
+  destination.toString(fast);
+  BOOST_CHECK_EQUAL(decodeSequence(registry, fast).size(), 6);
+}
@@ -0,0 +1,219 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/Template.h>
+#include <Codecs/FieldInstructionGroup.h>
+#include <Codecs/FieldInstructionTemplateRef.h>
+#include <Codecs/FieldInstructionUInt32.h>
+#include <Codecs/FieldInstructionAscii.h>
+#include <Codecs/FieldOpNop.h>
+#include <Codecs/FieldOpCopy.h>
+#include <Codecs/FieldOpDelta.h>
+#include <Codecs/FieldOpIncrement.h>
+#include <Codecs/Encoder.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/DataDestination.h>
+#include <Codecs/DataSourceString.h>
+#include <Codecs/SingleMessageConsumer.h>
+#include <Codecs/GenericMessageBuilder.h>
+
+#include <Messages/Message.h>
+#include <Messages/FieldIdentity.h>
+#include <Messages/FieldUInt32.h>
+#include <Messages/FieldAscii.h>
+#include <Messages/FieldGroup.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  // <template name="Header" id="9">
+  //   <typeRef name="Header"/>
+  //   <uInt32 name="MsgSeqNum"><increment/></uInt32>
+  // </template>
+  // <template name="Order" id="10">
+  //   <typeRef name="Order"/>
+  //   <templateRef name="Header"/>
+  //   <group name="Parties">
+  //     <typeRef name="Parties"/>
+  //     <string name="Sender"><copy/></string>
+  //     <group name="Routing">
+  //       <typeRef name="Routing"/>
+  //       <string name="Venue"><copy/></string>
+  //     </group>
+  //   </group>
+  //   <group name="Extra" presence="optional">
+  //     <typeRef name="Extra"/>
+  //     <uInt32 name="Note"/>
+  //   </group>
+  //   <uInt32 name="Price"><delta/></uInt32>
+  // </template>
+  Codecs::TemplateRegistryPtr createRegistry(bool flatten)
+  {
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->setFlattenGroups(flatten);
+
+    Codecs::TemplatePtr header = createTemplate(9, "Header");
+    header->setApplicationType("Header", "");
+    addField(header, new Codecs::FieldInstructionUInt32("MsgSeqNum", ""), new Codecs::FieldOpIncrement);
+    registry->addTemplate(header);
+
+    Codecs::TemplatePtr order = createTemplate(10, "Order");
+    order->setApplicationType("Order", "");
+    Codecs::FieldInstructionPtr headerRef(new Codecs::FieldInstructionStaticTemplateRef("Header", ""));
+    order->addInstruction(headerRef);
+    Codecs::SegmentBodyPtr parties = addGroup(order, "Parties", true);
+    addField(parties, new Codecs::FieldInstructionAscii("Sender", ""), new Codecs::FieldOpCopy);
+    Codecs::SegmentBodyPtr routing = addGroup(parties, "Routing", true);
+    addField(routing, new Codecs::FieldInstructionAscii("Venue", ""), new Codecs::FieldOpCopy);
+    Codecs::SegmentBodyPtr extra = addGroup(order, "Extra", false);
+    addField(extra, new Codecs::FieldInstructionUInt32("Note", ""), new Codecs::FieldOpNop);
+    addField(order, new Codecs::FieldInstructionUInt32("Price", ""), new Codecs::FieldOpDelta);
+    registry->addTemplate(order);
+
+    registry->finalize();
+    return registry;
+  }
+
+  Messages::FieldCPtr createGroup(Messages::FieldSetPtr & fields)
+  {
+    return Messages::FieldGroup::create(fields);
+  }
+
+  // The message as it appears when groups are nested.
+  void addNestedMessage(Messages::Message & message, size_t nMessage)
+  {
+    Messages::FieldSetPtr header(new Messages::FieldSet(1));
+    header->addField(new Messages::FieldIdentity("MsgSeqNum"), Messages::FieldUInt32::create(uint32(70 + nMessage)));
+    message.addField(new Messages::FieldIdentity("Header"), createGroup(header));
+
+    Messages::FieldSetPtr routing(new Messages::FieldSet(1));
+    routing->addField(new Messages::FieldIdentity("Venue"), Messages::FieldAscii::create(nMessage < 2 ? "XNAS" : "ARCX"));
+    Messages::FieldSetPtr parties(new Messages::FieldSet(2));
+    parties->addField(new Messages::FieldIdentity("Sender"), Messages::FieldAscii::create("OCI"));
+    parties->addField(new Messages::FieldIdentity("Routing"), createGroup(routing));
+    message.addField(new Messages::FieldIdentity("Parties"), createGroup(parties));
+
+    if(nMessage % 2 == 1)
+    {
+      Messages::FieldSetPtr extra(new Messages::FieldSet(1));
+      extra->addField(new Messages::FieldIdentity("Note"), Messages::FieldUInt32::create(uint32(nMessage)));
+      message.addField(new Messages::FieldIdentity("Extra"), createGroup(extra));
+    }
+    message.addField(new Messages::FieldIdentity("Price"), Messages::FieldUInt32::create(uint32(1000 + 5 * nMessage)));
+  }
+
+  // The same message with the mandatory groups flattened.
+  void addFlatMessage(Messages::Message & message, size_t nMessage)
+  {
+    message.addField(new Messages::FieldIdentity("MsgSeqNum"), Messages::FieldUInt32::create(uint32(70 + nMessage)));
+    message.addField(new Messages::FieldIdentity("Parties.Sender"), Messages::FieldAscii::create("OCI"));
+    message.addField(new Messages::FieldIdentity("Parties.Routing.Venue"), Messages::FieldAscii::create(nMessage < 2 ? "XNAS" : "ARCX"));
+    if(nMessage % 2 == 1)
+    {
+      Messages::FieldSetPtr extra(new Messages::FieldSet(1));
+      extra->addField(new Messages::FieldIdentity("Note"), Messages::FieldUInt32::create(uint32(nMessage)));
+      message.addField(new Messages::FieldIdentity("Extra"), createGroup(extra));
+    }
+    message.addField(new Messages::FieldIdentity("Price"), Messages::FieldUInt32::create(uint32(1000 + 5 * nMessage)));
+  }
+
+  const size_t messageCount = 4;
+
+  std::string encodeMessages(bool flatten)
+  {
+    Codecs::TemplateRegistryPtr registry = createRegistry(flatten);
+    EncodedMessages fast(registry);
+    for(size_t nMessage = 0; nMessage < messageCount; ++nMessage)
+    {
+      Messages::Message message(registry->maxFieldCount());
+      if(flatten)
+      {
+        addFlatMessage(message, nMessage);
+      }
+      else
+      {
+        addNestedMessage(message, nMessage);
+      }
+      fast.add(10, message);
+    }
+    return fast.str();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testFlattenGroupsFinalize)
+{
+  Codecs::TemplateRegistryPtr nested = createRegistry(false);
+  Codecs::TemplateRegistryPtr flat = createRegistry(true);
+  BOOST_CHECK(!nested->flattenGroups());
+  BOOST_CHECK(flat->flattenGroups());
+  BOOST_CHECK_EQUAL(flat->dictionarySize(), nested->dictionarySize());
+
+  Codecs::TemplateCPtr order;
+  BOOST_REQUIRE(flat->getTemplate(10, order));
+  // MsgSeqNum, Parties.Sender, Parties.Routing.Venue, Extra and Price
+  BOOST_CHECK_EQUAL(order->fieldCount(), 5);
+  BOOST_CHECK_EQUAL(flat->maxFieldCount(), 5);
+  Codecs::SegmentBodyPtr parties;
+  BOOST_REQUIRE(order->getInstruction(1)->getSegmentBody(parties));
+  BOOST_CHECK_EQUAL(parties->getInstruction(0)->getName(), "Parties.Sender");
+  Codecs::SegmentBodyPtr routing;
+  BOOST_REQUIRE(parties->getInstruction(1)->getSegmentBody(routing));
+  BOOST_CHECK_EQUAL(routing->getInstruction(0)->getName(), "Parties.Routing.Venue");
+  Codecs::SegmentBodyPtr extra;
+  BOOST_REQUIRE(order->getInstruction(2)->getSegmentBody(extra));
+  BOOST_CHECK_EQUAL(extra->getInstruction(0)->getName(), "Note");
+}
+
+BOOST_AUTO_TEST_CASE(testFlattenGroupsRoundTrip)
+{
+  std::string nestedFast = encodeMessages(false);
+  std::string flatFast = encodeMessages(true);
+  // Flattening does not change the encoding.
+  BOOST_CHECK(nestedFast == flatFast);
+
+  Codecs::TemplateRegistryPtr registry = createRegistry(true);
+  Codecs::Decoder decoder(registry);
+  Codecs::Encoder encoder(registry);
+  Codecs::DataDestination destination;
+  Codecs::DataSourceString source(flatFast);
+  for(size_t nMessage = 0; nMessage < messageCount; ++nMessage)
+  {
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    decoder.decodeMessage(source, builder);
+    Messages::Message & message = consumer.message();
+    BOOST_CHECK_EQUAL(message.size(), nMessage % 2 == 1 ? 5 : 4);
+
+    Messages::FieldCPtr value;
+    BOOST_CHECK(!message.getField("Header", value));
+    BOOST_CHECK(!message.getField("Parties", value));
+    BOOST_REQUIRE(message.getField("MsgSeqNum", value));
+    BOOST_CHECK_EQUAL(value->toUInt32(), 70 + nMessage);
+    BOOST_REQUIRE(message.getField("Parties.Sender", value));
+    BOOST_CHECK_EQUAL(value->toAscii(), "OCI");
+    BOOST_REQUIRE(message.getField("Parties.Routing.Venue", value));
+    BOOST_CHECK_EQUAL(value->toAscii(), nMessage < 2 ? "XNAS" : "ARCX");
+    BOOST_REQUIRE(message.getField("Price", value));
+    BOOST_CHECK_EQUAL(value->toUInt32(), 1000 + 5 * nMessage);
+    if(nMessage % 2 == 1)
+    {
+      // optional groups are still nested.
+      BOOST_REQUIRE(message.getField("Extra", value));
+      BOOST_REQUIRE(value->toGroup()->getField("Note", value));
+      BOOST_CHECK_EQUAL(value->toUInt32(), nMessage);
+    }
+    encoder.encodeMessage(destination, 10, message);
+  }
+  std::string reencoded;
+  destination.toString(reencoded);
+  BOOST_CHECK(reencoded == flatFast);
+}
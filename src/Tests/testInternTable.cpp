@@ -0,0 +1,175 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Common/InternTable.h>
+#include <Codecs/SingleMessageConsumer.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  const uchar * bytes(const char * value)
+  {
+    return reinterpret_cast<const uchar *>(value);
+  }
+
+  /// Remember the ids that arrive with interned values.
+  class InternRecorder : public Codecs::GenericMessageBuilder
+  {
+  public:
+    InternRecorder(Codecs::MessageConsumer & consumer)
+      : Codecs::GenericMessageBuilder(consumer)
+    {
+    }
+
+    virtual void addInternedValue(
+      Messages::FieldIdentityCPtr & identity,
+      ValueType::Type type,
+      const unsigned char * value,
+      size_t length,
+      uint32 id)
+    {
+      ids_.push_back(id);
+      addValue(identity, type, value, length);
+    }
+
+    std::vector<uint32> ids_;
+  };
+
+  // <template name="Trade" id="1">
+  //   <string name="Symbol"><copy/></string>
+  //   <uInt32 name="Seq"><copy/></uInt32>
+  // </template>
+  Codecs::TemplateRegistryPtr createRegistry()
+  {
+    Codecs::TemplatePtr trade = createTemplate(1, "Trade");
+    addField(trade, new Codecs::FieldInstructionAscii("Symbol", ""), new Codecs::FieldOpCopy);
+    addField(trade, new Codecs::FieldInstructionUInt32("Seq", ""), new Codecs::FieldOpCopy);
+
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(trade);
+    registry->finalize();
+    return registry;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testInternTable)
+{
+  InternTable table(300);
+  uint32 id = 99;
+  BOOST_CHECK(!table.find(bytes("IBM"), 3, id));
+  BOOST_CHECK(table.intern(bytes("IBM"), 3, id));
+  BOOST_CHECK_EQUAL(id, 0);
+  BOOST_CHECK(table.intern(bytes("MSFT"), 4, id));
+  BOOST_CHECK_EQUAL(id, 1);
+  BOOST_CHECK(table.intern(bytes(""), 0, id));
+  BOOST_CHECK_EQUAL(id, 2);
+  BOOST_CHECK(table.intern(bytes("IBM"), 3, id));
+  BOOST_CHECK_EQUAL(id, 0);
+  BOOST_CHECK(table.matches(1, bytes("MSFT"), 4));
+  BOOST_CHECK(!table.matches(1, bytes("MSF"), 3));
+  BOOST_CHECK(!table.matches(7, bytes("MSFT"), 4));
+
+  // enough to force the table to grow several times
+  for(size_t nValue = 0; nValue < 1000; ++nValue)
+  {
+    std::string value = boost::lexical_cast<std::string>(nValue);
+    bool added = table.intern(bytes(value.c_str()), value.size(), id);
+    BOOST_CHECK_EQUAL(added, nValue < 297);
+  }
+  BOOST_CHECK_EQUAL(table.size(), 300);
+  BOOST_CHECK(table.find(bytes("296"), 3, id));
+  BOOST_CHECK_EQUAL(id, 299);
+  BOOST_CHECK(!table.find(bytes("297"), 3, id));
+  BOOST_CHECK(table.find(bytes("MSFT"), 4, id));
+  BOOST_CHECK_EQUAL(id, 1);
+
+  const uchar * value = 0;
+  size_t length = 0;
+  BOOST_REQUIRE(table.getValue(3, value, length));
+  BOOST_CHECK_EQUAL(std::string(reinterpret_cast<const char *>(value), length), "0");
+  BOOST_CHECK(!table.getValue(300, value, length));
+
+  table.clear();
+  BOOST_CHECK_EQUAL(table.size(), 0);
+  BOOST_CHECK(table.intern(bytes("MSFT"), 4, id));
+  BOOST_CHECK_EQUAL(id, 0);
+}
+
+BOOST_AUTO_TEST_CASE(testDecoderIntern)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  const char * symbols[] = {"IBM", "IBM", "MSFT", "IBM", "ORCL", "MSFT"};
+  const uint32 expected[] = {0, 0, 1, 0, 2, 1};
+  const size_t count = sizeof(symbols) / sizeof(symbols[0]);
+
+  EncodedMessages encoded(registry);
+  for(size_t nMessage = 0; nMessage < count; ++nMessage)
+  {
+    Messages::Message message(registry->maxFieldCount());
+    addNamedField(message, "Symbol", Messages::FieldAscii::create(symbols[nMessage]));
+    addNamedField(message, "Seq", Messages::FieldUInt32::create(uint32(nMessage)));
+    encoded.add(1, message);
+  }
+  std::string fast = encoded.str();
+  Messages::FieldIdentityCPtr symbolIdentity = new Messages::FieldIdentity("Symbol");
+
+  // Not interning: values arrive the usual way.
+  {
+    Codecs::Decoder decoder(registry);
+    BOOST_CHECK(!decoder.isInterning());
+    Codecs::DataSourceString source(fast);
+    Codecs::SingleMessageConsumer consumer;
+    InternRecorder builder(consumer);
+    decoder.decodeMessage(source, builder);
+    BOOST_CHECK(builder.ids_.empty());
+  }
+
+  {
+    Codecs::Decoder decoder(registry);
+    BOOST_CHECK_EQUAL(decoder.internField(Messages::FieldIdentity("Seq")), 0);
+    BOOST_CHECK_EQUAL(decoder.internField(*symbolIdentity), 1);
+    BOOST_CHECK(decoder.isInterning());
+    Codecs::DataSourceString source(fast);
+    Codecs::SingleMessageConsumer consumer;
+    InternRecorder builder(consumer);
+    for(size_t nMessage = 0; nMessage < count; ++nMessage)
+    {
+      decoder.decodeMessage(source, builder);
+      Messages::FieldCPtr field;
+      BOOST_REQUIRE(consumer.message().getField("Symbol", field));
+      BOOST_CHECK_EQUAL(field->toAscii(), symbols[nMessage]);
+    }
+    BOOST_REQUIRE_EQUAL(builder.ids_.size(), count);
+    for(size_t nMessage = 0; nMessage < count; ++nMessage)
+    {
+      BOOST_CHECK_EQUAL(builder.ids_[nMessage], expected[nMessage]);
+    }
+    BOOST_CHECK_EQUAL(decoder.getInternTable().size(), 3);
+  }
+
+  // A full table still delivers the values, just without ids.
+  {
+    Codecs::Decoder decoder(registry);
+    decoder.setInternLimit(1);
+    decoder.internField(*symbolIdentity);
+    Codecs::DataSourceString source(fast);
+    Codecs::SingleMessageConsumer consumer;
+    InternRecorder builder(consumer);
+    for(size_t nMessage = 0; nMessage < count; ++nMessage)
+    {
+      decoder.decodeMessage(source, builder);
+      Messages::FieldCPtr field;
+      BOOST_REQUIRE(consumer.message().getField("Symbol", field));
+      BOOST_CHECK_EQUAL(field->toAscii(), symbols[nMessage]);
+    }
+    BOOST_CHECK_EQUAL(builder.ids_.size(), 3);
+  }
+}
@@ -0,0 +1,376 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/LazyMessageView.h>
+#include <Codecs/FieldInstructionUInt32.h>
+#include <Codecs/FieldInstructionInt64.h>
+#include <Codecs/FieldInstructionAscii.h>
+#include <Codecs/FieldInstructionDecimal.h>
+#include <Codecs/FieldInstructionByteVector.h>
+#include <Codecs/FieldOpNop.h>
+#include <Codecs/FieldOpConstant.h>
+#include <Codecs/FieldOpCopy.h>
+#include <Codecs/Template.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/Encoder.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/DataDestination.h>
+#include <Codecs/DataSourceString.h>
+#include <Codecs/DataSourceBuffer.h>
+#include <Codecs/SingleMessageConsumer.h>
+#include <Codecs/GenericMessageBuilder.h>
+
+#include <Messages/Message.h>
+#include <Messages/FieldUInt32.h>
+#include <Messages/FieldInt64.h>
+#include <Messages/FieldAscii.h>
+#include <Messages/FieldDecimal.h>
+#include <Messages/FieldByteVector.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  // <template name="Security" id="1">
+  //   <uInt32 name="Seq"/>
+  //   <string name="Symbol" presence="optional"/>
+  //   <decimal name="Price" presence="optional"/>
+  //   <uInt32 name="Venue" presence="optional"><constant value="7"/></uInt32>
+  //   <byteVector name="Data" presence="optional"/>
+  //   <int64 name="Qty"/>
+  // </template>
+  // <template name="Trade" id="2">
+  //   <uInt32 name="Seq"><copy/></uInt32>
+  // </template>
+  // If ignoreSecurity, the Security template is ignored.
+  Codecs::TemplateRegistryPtr createRegistry(bool ignoreSecurity = false)
+  {
+    Codecs::TemplatePtr security = createTemplate(1, "Security");
+    security->setIgnore(ignoreSecurity);
+    addField(security, new Codecs::FieldInstructionUInt32("Seq", ""), new Codecs::FieldOpNop);
+    addField(security, new Codecs::FieldInstructionAscii("Symbol", ""), new Codecs::FieldOpNop, false);
+    addField(security, new Codecs::FieldInstructionDecimal("Price", ""), new Codecs::FieldOpNop, false);
+    addField(security, new Codecs::FieldInstructionUInt32("Venue", ""), withValue(new Codecs::FieldOpConstant, "7"), false);
+    addField(security, new Codecs::FieldInstructionByteVector("Data", ""), new Codecs::FieldOpNop, false);
+    addField(security, new Codecs::FieldInstructionInt64("Qty", ""), new Codecs::FieldOpNop);
+
+    Codecs::TemplatePtr trade = createTemplate(2, "Trade");
+    addField(trade, new Codecs::FieldInstructionUInt32("Seq", ""), new Codecs::FieldOpCopy);
+
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(security);
+    registry->addTemplate(trade);
+    registry->finalize();
+    return registry;
+  }
+
+  /// Accept lazy messages and look at a couple of fields.
+  class LazyBuilder : public Codecs::GenericMessageBuilder
+  {
+  public:
+    LazyBuilder(Codecs::MessageConsumer & consumer, bool accepts = true)
+      : Codecs::GenericMessageBuilder(consumer)
+      , accepts_(accepts)
+      , lazyCount_(0)
+      , ignoreCount_(0)
+      , seq_(0)
+      , hasSymbol_(false)
+      , hasVenue_(false)
+      , hasData_(false)
+      , encoded_(0)
+    {
+    }
+
+    virtual bool acceptsLazyMessages()const
+    {
+      return accepts_;
+    }
+
+    virtual bool ignoreMessage(Messages::ValueMessageBuilder & messageBuilder)
+    {
+      ++ignoreCount_;
+      return Codecs::GenericMessageBuilder::ignoreMessage(messageBuilder);
+    }
+
+    virtual bool lazyMessage(const Messages::MessageAccessor & message)
+    {
+      ++lazyCount_;
+      const Codecs::LazyMessageView & view = static_cast<const Codecs::LazyMessageView &>(message);
+      uint64 seq = 0;
+      BOOST_CHECK(view.getUnsignedInteger(0, seq));
+      seq_ = uint32(seq);
+      const StringBuffer * symbol = 0;
+      hasSymbol_ = message.getString(Messages::FieldIdentity("Symbol"), ValueType::ASCII, symbol);
+      if(hasSymbol_)
+      {
+        symbol_ = *symbol;
+      }
+      hasVenue_ = message.isPresent(Messages::FieldIdentity("Venue"));
+      hasData_ = view.isPresent(4);
+      size_t length = 0;
+      view.getEncoded(0, encoded_, length);
+      BOOST_CHECK_EQUAL(view.size(), 6);
+      return true;
+    }
+
+    bool accepts_;
+    size_t lazyCount_;
+    size_t ignoreCount_;
+    uint32 seq_;
+    bool hasSymbol_;
+    std::string symbol_;
+    bool hasVenue_;
+    bool hasData_;
+    const uchar * encoded_;
+  };
+
+  /// A DataSource that delivers its data a few bytes at a time
+  /// so messages span several buffers.
+  class SmallBufferSource : public Codecs::DataSource
+  {
+  public:
+    SmallBufferSource(const std::string & data, size_t bufferSize)
+      : data_(data)
+      , bufferSize_(bufferSize)
+      , position_(0)
+    {
+    }
+
+    virtual bool getBuffer(const uchar *& buffer, size_t & size)
+    {
+      if(position_ >= data_.size())
+      {
+        return false;
+      }
+      buffer = reinterpret_cast<const uchar *>(data_.data()) + position_;
+      size = std::min(bufferSize_, data_.size() - position_);
+      position_ += size;
+      return true;
+    }
+
+  private:
+    std::string data_;
+    size_t bufferSize_;
+    size_t position_;
+  };
+
+  std::string encodeMessages(Codecs::TemplateRegistryPtr registry)
+  {
+    Messages::FieldIdentityCPtr seqIdentity = new Messages::FieldIdentity("Seq");
+    Messages::FieldIdentityCPtr symbolIdentity = new Messages::FieldIdentity("Symbol");
+    Messages::FieldIdentityCPtr priceIdentity = new Messages::FieldIdentity("Price");
+    Messages::FieldIdentityCPtr venueIdentity = new Messages::FieldIdentity("Venue");
+    Messages::FieldIdentityCPtr dataIdentity = new Messages::FieldIdentity("Data");
+    Messages::FieldIdentityCPtr qtyIdentity = new Messages::FieldIdentity("Qty");
+    EncodedMessages fast(registry);
+
+    Messages::Message full(registry->maxFieldCount());
+    full.addField(seqIdentity, Messages::FieldUInt32::create(1));
+    full.addField(symbolIdentity, Messages::FieldAscii::create("IBM"));
+    full.addField(priceIdentity, Messages::FieldDecimal::create(Decimal(12345, -2)));
+    full.addField(venueIdentity, Messages::FieldUInt32::create(7));
+    full.addField(dataIdentity, Messages::FieldByteVector::create(std::string(300, 'x')));
+    full.addField(qtyIdentity, Messages::FieldInt64::create(-500));
+    fast.add(1, full);
+
+    Messages::Message trade(registry->maxFieldCount());
+    trade.addField(seqIdentity, Messages::FieldUInt32::create(2));
+    fast.add(2, trade);
+
+    Messages::Message sparse(registry->maxFieldCount());
+    sparse.addField(seqIdentity, Messages::FieldUInt32::create(3));
+    sparse.addField(qtyIdentity, Messages::FieldInt64::create(0));
+    fast.add(1, sparse);
+
+    return fast.str();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testLazyMessageView)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  Codecs::TemplateCPtr templatePtr;
+  BOOST_REQUIRE(registry->getTemplate(1, templatePtr));
+  BOOST_CHECK(templatePtr->isViewable());
+  BOOST_REQUIRE(registry->getTemplate(2, templatePtr));
+  BOOST_CHECK(!templatePtr->isViewable());
+
+  std::string fast = encodeMessages(registry);
+
+  Codecs::Decoder decoder(registry);
+  BOOST_CHECK(!decoder.getLazyMessages());
+  decoder.setLazyMessages(true);
+  Codecs::DataSourceString source(fast);
+  Codecs::SingleMessageConsumer consumer;
+  LazyBuilder builder(consumer);
+
+  decoder.decodeMessage(source, builder);
+  BOOST_CHECK_EQUAL(builder.lazyCount_, 1);
+  BOOST_CHECK_EQUAL(builder.seq_, 1);
+  BOOST_CHECK(builder.hasSymbol_);
+  BOOST_CHECK_EQUAL(builder.symbol_, "IBM");
+  BOOST_CHECK(builder.hasVenue_);
+  BOOST_CHECK(builder.hasData_);
+
+  // Not viewable: decoded as usual.
+  decoder.decodeMessage(source, builder);
+  BOOST_CHECK_EQUAL(builder.lazyCount_, 1);
+  Messages::FieldCPtr field;
+  BOOST_REQUIRE(consumer.message().getField("Seq", field));
+  BOOST_CHECK_EQUAL(field->toUInt32(), 2);
+
+  decoder.decodeMessage(source, builder);
+  BOOST_CHECK_EQUAL(builder.lazyCount_, 2);
+  BOOST_CHECK_EQUAL(builder.seq_, 3);
+  BOOST_CHECK(!builder.hasSymbol_);
+  BOOST_CHECK(!builder.hasVenue_);
+  BOOST_CHECK(!builder.hasData_);
+}
+
+BOOST_AUTO_TEST_CASE(testLazyMessageViewDeclined)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast = encodeMessages(registry);
+
+  // A builder that declines lazy messages gets the same results either way.
+  Codecs::Decoder decoder(registry);
+  decoder.setLazyMessages(true);
+  Codecs::DataSourceString source(fast);
+  Codecs::Decoder eagerDecoder(registry);
+  Codecs::DataSourceString eagerSource(fast);
+  for(size_t nMessage = 0; nMessage < 3; ++nMessage)
+  {
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    decoder.decodeMessage(source, builder);
+    Codecs::SingleMessageConsumer eagerConsumer;
+    Codecs::GenericMessageBuilder eagerBuilder(eagerConsumer);
+    eagerDecoder.decodeMessage(eagerSource, eagerBuilder);
+    BOOST_CHECK_EQUAL(consumer.message().size(), eagerConsumer.message().size());
+    for(Messages::Message::const_iterator it = eagerConsumer.message().begin();
+      it != eagerConsumer.message().end();
+      ++it)
+    {
+      Messages::FieldCPtr field;
+      BOOST_REQUIRE(consumer.message().getField(it->name(), field));
+      BOOST_CHECK_EQUAL(field->getType(), it->getField()->getType());
+      BOOST_CHECK(field->displayString() == it->getField()->displayString());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testLazyMessageViewNotAccepted)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast = encodeMessages(registry);
+
+  // A builder that does not accept lazy messages is never offered one.
+  Codecs::Decoder decoder(registry);
+  decoder.setLazyMessages(true);
+  Codecs::DataSourceString source(fast);
+  Codecs::SingleMessageConsumer consumer;
+  LazyBuilder builder(consumer, false);
+  decoder.decodeMessage(source, builder);
+  BOOST_CHECK_EQUAL(builder.lazyCount_, 0);
+  Messages::FieldCPtr field;
+  BOOST_REQUIRE(consumer.message().getField("Seq", field));
+  BOOST_CHECK_EQUAL(field->toUInt32(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(testLazyMessageViewIgnored)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry(true);
+  std::string fast = encodeMessages(registry);
+
+  // Ignored templates are not offered as lazy messages; the builder sees them ignored.
+  Codecs::Decoder decoder(registry);
+  decoder.setLazyMessages(true);
+  Codecs::DataSourceString source(fast);
+  Codecs::SingleMessageConsumer consumer;
+  LazyBuilder builder(consumer);
+  for(size_t nMessage = 0; nMessage < 3; ++nMessage)
+  {
+    decoder.decodeMessage(source, builder);
+  }
+  BOOST_CHECK_EQUAL(builder.lazyCount_, 0);
+  BOOST_CHECK_EQUAL(builder.ignoreCount_, 2);
+}
+
+BOOST_AUTO_TEST_CASE(testLazyMessageViewBuilderPerMessage)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast = encodeMessages(registry);
+
+  // Each builder is asked for itself, even one that reuses an earlier builder's address.
+  Codecs::Decoder decoder(registry);
+  decoder.setLazyMessages(true);
+  Codecs::DataSourceString source(fast);
+  for(size_t nMessage = 0; nMessage < 3; ++nMessage)
+  {
+    Codecs::SingleMessageConsumer consumer;
+    LazyBuilder builder(consumer, nMessage == 2);
+    decoder.decodeMessage(source, builder);
+    BOOST_CHECK_EQUAL(builder.lazyCount_, nMessage == 2 ? 1 : 0);
+    BOOST_CHECK_EQUAL(builder.seq_, nMessage == 2 ? 3 : 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testLazyMessageViewSpansBuffers)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast = encodeMessages(registry);
+
+  // When the whole message is in the source's buffer the view refers to it there.
+  const uchar * begin = reinterpret_cast<const uchar *>(fast.data());
+  Codecs::Decoder wholeDecoder(registry);
+  wholeDecoder.setLazyMessages(true);
+  Codecs::DataSourceBuffer wholeSource(begin, fast.size());
+  Codecs::SingleMessageConsumer wholeConsumer;
+  LazyBuilder wholeBuilder(wholeConsumer);
+  wholeDecoder.decodeMessage(wholeSource, wholeBuilder);
+  BOOST_CHECK(wholeBuilder.encoded_ > begin && wholeBuilder.encoded_ < begin + fast.size());
+
+  // Messages that continue into the next buffer are copied and decode the same.
+  Codecs::Decoder decoder(registry);
+  decoder.setLazyMessages(true);
+  SmallBufferSource source(fast, 16);
+  Codecs::SingleMessageConsumer consumer;
+  LazyBuilder builder(consumer);
+
+  decoder.decodeMessage(source, builder);
+  BOOST_CHECK_EQUAL(builder.lazyCount_, 1);
+  BOOST_CHECK_EQUAL(builder.seq_, 1);
+  BOOST_CHECK(builder.hasSymbol_);
+  BOOST_CHECK_EQUAL(builder.symbol_, "IBM");
+  BOOST_CHECK(builder.hasVenue_);
+  BOOST_CHECK(builder.hasData_);
+
+  decoder.decodeMessage(source, builder);
+  BOOST_CHECK_EQUAL(builder.lazyCount_, 1);
+
+  decoder.decodeMessage(source, builder);
+  BOOST_CHECK_EQUAL(builder.lazyCount_, 2);
+  BOOST_CHECK_EQUAL(builder.seq_, 3);
+  BOOST_CHECK(!builder.hasSymbol_);
+  BOOST_CHECK(!builder.hasData_);
+
+  // A declining builder gets every field from the copy.
+  Codecs::Decoder declineDecoder(registry);
+  declineDecoder.setLazyMessages(true);
+  SmallBufferSource declineSource(fast, 16);
+  Codecs::SingleMessageConsumer declineConsumer;
+  Codecs::GenericMessageBuilder declineBuilder(declineConsumer);
+  declineDecoder.decodeMessage(declineSource, declineBuilder);
+  Messages::FieldCPtr field;
+  BOOST_REQUIRE(declineConsumer.message().getField("Data", field));
+  BOOST_CHECK_EQUAL(field->toByteVector(), std::string(300, 'x').c_str());
+  BOOST_REQUIRE(declineConsumer.message().getField("Qty", field));
+  BOOST_CHECK_EQUAL(field->toInt64(), -500);
+}
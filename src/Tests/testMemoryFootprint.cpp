@@ -0,0 +1,192 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Common/MemoryFootprint.h>
+#include <Common/Allocator.h>
+#include <Common/WorkingBuffer.h>
+#include <Codecs/StreamingAssembler.h>
+#include <Codecs/NoHeaderAnalyzer.h>
+#include <Communication/BufferReceiver.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  // <template name="Quote[id]" id="[id]">
+  //   <uInt32 name="Seq"><increment/></uInt32>
+  //   <string name="Symbol"><copy/></string>
+  // </template>
+  void addTemplate(Codecs::TemplateRegistry & registry, template_id_t id)
+  {
+    addQuoteTemplate(registry, id, "Quote" + boost::lexical_cast<std::string>(id));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testMemoryFootprint)
+{
+  MemoryFootprint footprint;
+  BOOST_CHECK_EQUAL(footprint.total(), 0);
+  footprint.add("a", 10);
+  footprint.add("b", 5);
+  footprint.add("a", 2);
+  BOOST_CHECK_EQUAL(footprint.bytes("a"), 12);
+  BOOST_CHECK_EQUAL(footprint.bytes("c"), 0);
+  BOOST_CHECK_EQUAL(footprint.total(), 17);
+
+  footprint.addString("s", "short");
+  BOOST_CHECK_EQUAL(footprint.bytes("s"), 0);
+  std::string longString(1000, 'x');
+  footprint.addString("s", longString);
+  BOOST_CHECK(footprint.bytes("s") > 1000);
+
+  MemoryFootprint sum;
+  sum.add("a", 1);
+  sum.add(footprint);
+  BOOST_CHECK_EQUAL(sum.bytes("a"), 13);
+  BOOST_CHECK_EQUAL(sum.total(), footprint.total() + 1);
+
+  std::ostringstream out;
+  sum.write(out, "conn1.");
+  BOOST_CHECK(out.str().find("conn1.a 13\n") != std::string::npos);
+  BOOST_CHECK(out.str().find("conn1.total ") != std::string::npos);
+
+  sum.clear();
+  BOOST_CHECK_EQUAL(sum.total(), 0);
+  BOOST_CHECK(sum.begin() == sum.end());
+}
+
+BOOST_AUTO_TEST_CASE(testRegistryFootprint)
+{
+  Codecs::TemplateRegistry small;
+  addTemplate(small, 1);
+  small.finalize();
+  MemoryFootprint smallFootprint;
+  small.footprint(smallFootprint);
+  BOOST_CHECK(smallFootprint.bytes("registry.instructions") > 0);
+  BOOST_CHECK(smallFootprint.bytes("registry.identities") > 0);
+
+  Codecs::TemplateRegistry large;
+  for(template_id_t id = 1; id <= 20; ++id)
+  {
+    addTemplate(large, id);
+  }
+  large.finalize();
+  MemoryFootprint largeFootprint;
+  large.footprint(largeFootprint);
+  BOOST_CHECK(largeFootprint.bytes("registry.instructions") > 10 * smallFootprint.bytes("registry.instructions"));
+  BOOST_CHECK(largeFootprint.bytes("registry.identities") >= 20 * smallFootprint.bytes("registry.identities"));
+}
+
+BOOST_AUTO_TEST_CASE(testContextFootprint)
+{
+  Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+  addTemplate(*registry, 1);
+  registry->finalize();
+
+  Codecs::Encoder encoder(registry);
+  MemoryFootprint before;
+  encoder.footprint(before);
+  BOOST_CHECK_EQUAL(before.bytes("dictionary.strings"), 0);
+  BOOST_CHECK(before.bytes("workingBuffer") > 0);
+
+  // The copy operator keeps the long symbol in the dictionary.
+  Codecs::DataDestination destination;
+  encodeQuote(encoder, destination, 1, 1, std::string(500, 'Q'));
+
+  MemoryFootprint after;
+  encoder.footprint(after);
+  BOOST_CHECK(after.bytes("dictionary.entries") > 0);
+  BOOST_CHECK(after.bytes("dictionary.strings") > 500);
+
+  encoder.reset();
+  MemoryFootprint reset;
+  encoder.footprint(reset);
+  BOOST_CHECK_EQUAL(reset.bytes("dictionary.entries"), after.bytes("dictionary.entries"));
+
+  WorkingBuffer working;
+  working.clear(false, 100000);
+  MemoryFootprint inflated;
+  working.footprint(inflated);
+  BOOST_CHECK(inflated.bytes("workingBuffer") >= 100000);
+}
+
+BOOST_AUTO_TEST_CASE(testAllocatorFootprint)
+{
+  {
+    MemoryFootprint footprint;
+    Allocator::defaultAllocator().footprint(footprint);
+    BOOST_CHECK_EQUAL(footprint.total(), 0);
+  }
+  {
+    PoolAllocator pool(64, 4096);
+    void * small = pool.allocate(40);
+    void * large = pool.allocate(1000);
+    MemoryFootprint footprint;
+    pool.footprint(footprint);
+    BOOST_CHECK_EQUAL(footprint.bytes("allocator.reserved"), 4096 + 1000);
+    BOOST_CHECK_EQUAL(footprint.bytes("allocator.inUse"), 48 + 1000);
+    pool.deallocate(small, 40);
+    pool.deallocate(large, 1000);
+    BOOST_CHECK_EQUAL(pool.bytesInUse(), 0);
+  }
+  {
+    ArenaAllocator arena(1024);
+    (void)arena.allocate(10);
+    (void)arena.allocate(2000);
+    MemoryFootprint footprint;
+    arena.footprint(footprint);
+    BOOST_CHECK_EQUAL(footprint.bytes("allocator.reserved"), 1024 + 2000);
+    BOOST_CHECK_EQUAL(footprint.bytes("allocator.inUse"), arena.bytesInUse());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testReceiverFootprint)
+{
+  Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+  addTemplate(*registry, 1);
+  registry->finalize();
+
+  Codecs::Encoder encoder(registry);
+  Codecs::DataDestination destination;
+  for(uint32 seq = 1; seq <= 3; ++seq)
+  {
+    encodeQuote(encoder, destination, 1, seq, std::string(500, 'Q'));
+  }
+  std::string fast;
+  destination.toString(fast);
+
+  SequenceConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  Codecs::NoHeaderAnalyzer analyzer;
+  Codecs::StreamingAssembler assembler(registry, analyzer, builder);
+  PoolAllocator pool(512, 4096);
+  assembler.setAllocator(&pool);
+  Communication::BufferReceiver receiver;
+  BOOST_REQUIRE(receiver.start(assembler, fast.size(), 2));
+
+  // The snapshot taken by start()
+  MemoryFootprint started;
+  receiver.connectionFootprint(started);
+  BOOST_CHECK(started.bytes("receiver.buffers") >= 2 * fast.size());
+  BOOST_CHECK(started.bytes("workingBuffer") > 0);
+  BOOST_CHECK_EQUAL(started.bytes("dictionary.strings"), 0);
+  BOOST_CHECK_EQUAL(started.bytes("allocator.reserved"), 0);
+
+  // Requested above, so the decoding thread takes a new snapshot after this batch.
+  receiver.receiveBuffer(reinterpret_cast<const uchar *>(fast.data()), fast.size());
+  receiver.stop();
+  BOOST_CHECK_EQUAL(consumer.sequence_.size(), 3);
+
+  MemoryFootprint decoded;
+  receiver.connectionFootprint(decoded);
+  BOOST_CHECK(decoded.bytes("dictionary.strings") > 500);
+  BOOST_CHECK(decoded.bytes("allocator.reserved") > 0);
+  BOOST_CHECK_EQUAL(decoded.bytes("receiver.buffers"), started.bytes("receiver.buffers"));
+}
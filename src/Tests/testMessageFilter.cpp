@@ -0,0 +1,363 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/FieldInstructionByteVector.h>
+#include <Codecs/FieldInstructionUtf8.h>
+#include <Codecs/FieldInstructionDecimal.h>
+#include <Codecs/FieldInstructionInt8.h>
+#include <Codecs/FieldOpNop.h>
+#include <Codecs/FieldOpConstant.h>
+#include <Codecs/FieldOpDefault.h>
+#include <Codecs/MessageFilter.h>
+#include <Codecs/SingleMessageConsumer.h>
+
+#include <Messages/FieldByteVector.h>
+#include <Messages/FieldUtf8.h>
+#include <Messages/FieldDecimal.h>
+#include <Messages/FieldInt8.h>
+#include <Messages/NullMessageBuilder.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  // <template name="Trade" id="1">
+  //   <uInt32 name="Id"><increment/></uInt32>
+  //   <string name="Symbol"><copy/></string>
+  // </template>
+  Codecs::TemplateRegistryPtr createRegistry()
+  {
+    Codecs::TemplatePtr trade = createTemplate(1, "Trade");
+    addField(trade, new Codecs::FieldInstructionUInt32("Id", ""), new Codecs::FieldOpIncrement);
+    addField(trade, new Codecs::FieldInstructionAscii("Symbol", ""), new Codecs::FieldOpCopy);
+
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(trade);
+    registry->finalize();
+    return registry;
+  }
+
+  std::string encodeTrades(Codecs::TemplateRegistryPtr registry)
+  {
+    const char * symbols[] = {"IBM", "MSFT", "MSFT", "IBM"};
+    EncodedMessages fast(registry);
+    for(size_t nMsg = 0; nMsg < sizeof(symbols)/sizeof(symbols[0]); ++nMsg)
+    {
+      Messages::Message message(registry->maxFieldCount());
+      addNamedField(message, "Id", Messages::FieldUInt32::create(uint32(nMsg + 1)));
+      addNamedField(message, "Symbol", Messages::FieldAscii::create(symbols[nMsg]));
+      fast.add(1, message);
+    }
+    return fast.str();
+  }
+}
+
+namespace
+{
+  // <template name="Blob" id="2">
+  //   <byteVector name="Data"/>
+  //   <uInt32 name="Note" presence="optional"/>
+  // </template>
+  Codecs::TemplateRegistryPtr createBlobRegistry()
+  {
+    Codecs::TemplatePtr blob = createTemplate(2, "Blob");
+    addField(blob, new Codecs::FieldInstructionByteVector("Data", ""), new Codecs::FieldOpNop);
+    addField(blob, new Codecs::FieldInstructionUInt32("Note", ""), new Codecs::FieldOpNop, false);
+
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(blob);
+    registry->finalize();
+    return registry;
+  }
+
+  // Data is ABC, XYZ, ABC.  Only the first message has a Note.
+  std::string encodeBlobs(Codecs::TemplateRegistryPtr registry)
+  {
+    const char * data[] = {"ABC", "XYZ", "ABC"};
+    EncodedMessages fast(registry);
+    for(size_t nMsg = 0; nMsg < 3; ++nMsg)
+    {
+      Messages::Message message(registry->maxFieldCount());
+      addNamedField(message, "Data", Messages::FieldByteVector::create(data[nMsg]));
+      if(nMsg == 0)
+      {
+        addNamedField(message, "Note", Messages::FieldUInt32::create(7));
+      }
+      fast.add(2, message);
+    }
+    return fast.str();
+  }
+
+  // <template name="Quote" id="3">
+  //   <string name="Symbol"><copy/></string>
+  //   <string name="Note" presence="optional"/>
+  //   <string name="Issuer" charset="unicode"/>
+  //   <byteVector name="Data" presence="optional"/>
+  //   <decimal name="Price" presence="optional"/>
+  //   <uInt32 name="Size"><default value="100"/></uInt32>
+  //   <int8 name="Side" presence="optional"><constant value="-1"/></int8>
+  //   <uInt32 name="Seq"><increment/></uInt32>
+  //   <string name="Venue"/>
+  // </template>
+  Codecs::TemplateRegistryPtr createQuoteRegistry()
+  {
+    Codecs::TemplatePtr quote = createTemplate(3, "Quote");
+    addField(quote, new Codecs::FieldInstructionAscii("Symbol", ""), new Codecs::FieldOpCopy);
+    addField(quote, new Codecs::FieldInstructionAscii("Note", ""), new Codecs::FieldOpNop, false);
+    addField(quote, new Codecs::FieldInstructionUtf8("Issuer", ""), new Codecs::FieldOpNop);
+    addField(quote, new Codecs::FieldInstructionByteVector("Data", ""), new Codecs::FieldOpNop, false);
+    addField(quote, new Codecs::FieldInstructionDecimal("Price", ""), new Codecs::FieldOpNop, false);
+    addField(quote, new Codecs::FieldInstructionUInt32("Size", ""), withValue(new Codecs::FieldOpDefault, "100"));
+    addField(quote, new Codecs::FieldInstructionInt8("Side", ""), withValue(new Codecs::FieldOpConstant, "-1"), false);
+    addField(quote, new Codecs::FieldInstructionUInt32("Seq", ""), new Codecs::FieldOpIncrement);
+    addField(quote, new Codecs::FieldInstructionAscii("Venue", ""), new Codecs::FieldOpNop);
+
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(quote);
+    registry->finalize();
+    return registry;
+  }
+
+  // Only every third quote is for IBM.  The optional fields come and go.
+  std::string encodeQuotes(Codecs::TemplateRegistryPtr registry, size_t count)
+  {
+    EncodedMessages fast(registry);
+    for(size_t nMsg = 0; nMsg < count; ++nMsg)
+    {
+      Messages::Message message(registry->maxFieldCount());
+      addNamedField(message, "Symbol", Messages::FieldAscii::create(nMsg % 3 == 0 ? "IBM" : "MSFT"));
+      if(nMsg % 2 == 0)
+      {
+        addNamedField(message, "Note", Messages::FieldAscii::create("note"));
+      }
+      addNamedField(message, "Issuer", Messages::FieldUtf8::create(nMsg % 4 == 0 ? "" : "Caf\xC3\xA9"));
+      if(nMsg % 5 != 0)
+      {
+        addNamedField(message, "Data", Messages::FieldByteVector::create(std::string("\x00\x80\x01", 3)));
+      }
+      if(nMsg % 4 != 1)
+      {
+        addNamedField(message, "Price", Messages::FieldDecimal::create(mantissa_t(nMsg * 25), exponent_t(-2)));
+      }
+      addNamedField(message, "Size", Messages::FieldUInt32::create(nMsg % 2 == 0 ? 100 : uint32(nMsg * 10)));
+      if(nMsg % 3 != 1)
+      {
+        addNamedField(message, "Side", Messages::FieldInt8::create(-1));
+      }
+      addNamedField(message, "Seq", Messages::FieldUInt32::create(uint32(1000 + nMsg)));
+      addNamedField(message, "Venue", Messages::FieldAscii::create(nMsg % 2 == 0 ? "XNYS" : "XNAS"));
+      fast.add(3, message);
+    }
+    return fast.str();
+  }
+
+  /// Accepts byte vectors in chunks and counts the messages it is given.
+  class CountingBuilder : public Messages::NullMessageBuilder
+  {
+  public:
+    CountingBuilder()
+      : accepted_(0)
+      , ignored_(0)
+    {
+    }
+
+    virtual bool endMessage(Messages::ValueMessageBuilder & /*messageBuilder*/)
+    {
+      ++accepted_;
+      return true;
+    }
+
+    virtual bool ignoreMessage(Messages::ValueMessageBuilder & /*messageBuilder*/)
+    {
+      ++ignored_;
+      return true;
+    }
+
+    size_t accepted_;
+    size_t ignored_;
+  };
+}
+
+BOOST_AUTO_TEST_CASE(testMessageFilterEquals)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast = encodeTrades(registry);
+
+  Codecs::MessageFilterPtr filter(new Codecs::MessageFilter);
+  Value ibm;
+  ibm.setValue("IBM");
+  filter->addEquals(1, "Symbol", ibm);
+
+  Codecs::Decoder decoder(registry);
+  decoder.setFilter(filter);
+  Codecs::DataSourceString source(fast);
+
+  size_t expectedIds[] = {1, 0, 0, 4};
+  for(size_t nMsg = 0; nMsg < 4; ++nMsg)
+  {
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    decoder.decodeMessage(source, builder);
+    Messages::Message & message = consumer.message();
+    if(expectedIds[nMsg] == 0)
+    {
+      BOOST_CHECK_EQUAL(message.size(), 0);
+    }
+    else
+    {
+      // Id uses increment, so message 4 depends on the dictionary
+      // being maintained while messages 2 and 3 were rejected.
+      BOOST_REQUIRE_EQUAL(message.size(), 2);
+      Messages::FieldCPtr value;
+      BOOST_REQUIRE(message.getField("Id", value));
+      BOOST_CHECK_EQUAL(value->toUInt32(), expectedIds[nMsg]);
+      BOOST_REQUIRE(message.getField("Symbol", value));
+      BOOST_CHECK_EQUAL(value->toAscii(), "IBM");
+    }
+  }
+  BOOST_CHECK_EQUAL(filter->accepted(), 2);
+  BOOST_CHECK_EQUAL(filter->rejected(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(testMessageFilterRangeAndIn)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast = encodeTrades(registry);
+
+  Codecs::MessageFilterPtr filter(new Codecs::MessageFilter);
+  Value low;
+  low.setValue(uint32(2));
+  Value high;
+  high.setValue(int32(4));
+  filter->addRange(1, "Id", low, high);
+  std::vector<Value> symbols(2);
+  symbols[0].setValue("IBM");
+  symbols[1].setValue("AAPL");
+  filter->addIn(1, "Symbol", symbols);
+
+  Codecs::Decoder decoder(registry);
+  decoder.setFilter(filter);
+  Codecs::DataSourceString source(fast);
+  for(size_t nMsg = 0; nMsg < 4; ++nMsg)
+  {
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    decoder.decodeMessage(source, builder);
+    BOOST_CHECK_EQUAL(consumer.message().size(), (nMsg == 3) ? 2 : 0);
+  }
+  BOOST_CHECK_EQUAL(filter->accepted(), 1);
+  BOOST_CHECK_EQUAL(filter->rejected(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(testMessageFilterUnknownField)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  Codecs::MessageFilterPtr filter(new Codecs::MessageFilter);
+  Value value;
+  value.setValue(uint32(1));
+  filter->addEquals(1, "NoSuchField", value);
+  Codecs::Decoder decoder(registry);
+  BOOST_CHECK_THROW(decoder.setFilter(filter), TemplateDefinitionError);
+}
+
+BOOST_AUTO_TEST_CASE(testMessageFilterAddedLate)
+{
+  Codecs::TemplateRegistryPtr registry = createBlobRegistry();
+  std::string fast = encodeBlobs(registry);
+
+  Codecs::MessageFilterPtr filter(new Codecs::MessageFilter);
+  Codecs::Decoder decoder(registry);
+  decoder.setFilter(filter);
+  // deliver Data in chunks.
+  decoder.setByteVectorChunkThreshold(1);
+  // added after setFilter()
+  Value abc;
+  abc.setValue("ABC");
+  filter->addEquals(2, "Data", abc);
+
+  Codecs::DataSourceString source(fast);
+  CountingBuilder builder;
+  for(size_t nMsg = 0; nMsg < 3; ++nMsg)
+  {
+    decoder.decodeMessage(source, builder);
+  }
+  BOOST_CHECK(filter->isResolved());
+  BOOST_CHECK_EQUAL(builder.accepted_, 2);
+  BOOST_CHECK_EQUAL(builder.ignored_, 1);
+  BOOST_CHECK_EQUAL(filter->accepted(), 2);
+  BOOST_CHECK_EQUAL(filter->rejected(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(testMessageFilterAbsentField)
+{
+  Codecs::TemplateRegistryPtr registry = createBlobRegistry();
+  std::string fast = encodeBlobs(registry);
+
+  Codecs::MessageFilterPtr filter(new Codecs::MessageFilter);
+  Value low;
+  low.setValue(uint32(0));
+  Value high;
+  high.setValue(uint32(100));
+  filter->addRange(2, "Note", low, high);
+  Codecs::Decoder decoder(registry);
+  decoder.setFilter(filter);
+
+  Codecs::DataSourceString source(fast);
+  CountingBuilder builder;
+  for(size_t nMsg = 0; nMsg < 3; ++nMsg)
+  {
+    decoder.decodeMessage(source, builder);
+  }
+  // Note is absent from the last two messages.
+  BOOST_CHECK_EQUAL(builder.accepted_, 1);
+  BOOST_CHECK_EQUAL(builder.ignored_, 2);
+}
+
+BOOST_AUTO_TEST_CASE(testMessageFilterSkipsRejected)
+{
+  Codecs::TemplateRegistryPtr registry = createQuoteRegistry();
+  const size_t count = 20;
+  std::string fast = encodeQuotes(registry, count);
+
+  Codecs::MessageFilterPtr filter(new Codecs::MessageFilter);
+  Value ibm;
+  ibm.setValue("IBM");
+  filter->addEquals(3, "Symbol", ibm);
+  Codecs::Decoder decoder(registry);
+  decoder.setFilter(filter);
+  Codecs::DataSourceString source(fast);
+
+  Codecs::Decoder unfilteredDecoder(registry);
+  Codecs::DataSourceString unfilteredSource(fast);
+  for(size_t nMsg = 0; nMsg < count; ++nMsg)
+  {
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    decoder.decodeMessage(source, builder);
+    Codecs::SingleMessageConsumer unfilteredConsumer;
+    Codecs::GenericMessageBuilder unfilteredBuilder(unfilteredConsumer);
+    unfilteredDecoder.decodeMessage(unfilteredSource, unfilteredBuilder);
+    if(nMsg % 3 == 0)
+    {
+      // the skipped fields of rejected messages kept the stream and the dictionaries in step.
+      std::ostringstream reason;
+      BOOST_CHECK_MESSAGE(consumer.message().equals(unfilteredConsumer.message(), reason), reason.str());
+      Messages::FieldCPtr value;
+      BOOST_REQUIRE(consumer.message().getField("Seq", value));
+      BOOST_CHECK_EQUAL(value->toUInt32(), 1000 + nMsg);
+    }
+    else
+    {
+      BOOST_CHECK_EQUAL(consumer.message().size(), 0);
+    }
+  }
+  BOOST_CHECK_EQUAL(filter->accepted(), 7);
+  BOOST_CHECK_EQUAL(filter->rejected(), 13);
+}
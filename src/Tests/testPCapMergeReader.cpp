@@ -0,0 +1,160 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Communication/PCapMergeReader.h>
+#include <Communication/PCapReader.h>
+
+using namespace QuickFAST;
+
+namespace
+{
+  void appendUint32(std::string & out, uint32 value)
+  {
+    // native byte order.  The reader detects the byte order from the magic number.
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  void appendUint16(std::string & out, uint16 value)
+  {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  /// Write a PCap file (32 bit headers) containing one UDP packet per time stamp.
+  /// The payload of each packet is 8 bytes: the channel number followed by the time stamp.
+  void writePCap(const std::string & filename, uint32 channel, const uint32 * timestamps, size_t count)
+  {
+    std::string file;
+    appendUint32(file, 0xa1b2c3d4); // magic
+    appendUint16(file, 2);          // version major
+    appendUint16(file, 4);          // version minor
+    appendUint32(file, 0);          // thiszone
+    appendUint32(file, 0);          // sigfigs
+    appendUint32(file, 65535);      // snaplen
+    appendUint32(file, 1);          // linktype: ethernet
+    for(size_t nPacket = 0; nPacket < count; ++nPacket)
+    {
+      std::string payload;
+      appendUint32(payload, channel);
+      appendUint32(payload, timestamps[nPacket]);
+
+      std::string packet(14, '\0');   // ethernet header
+      std::string ip(20, '\0');       // ip header (no options)
+      ip[0] = '\x45';
+      packet += ip;
+      packet += std::string(8, '\0'); // udp header
+      packet += payload;
+      packet += std::string(4, '\0'); // checksum
+
+      appendUint32(file, timestamps[nPacket] / 1000000);  // tv_sec
+      appendUint32(file, timestamps[nPacket] % 1000000);  // tv_usec
+      appendUint32(file, uint32(packet.size()));          // caplen
+      appendUint32(file, uint32(packet.size()));          // len
+      file += packet;
+    }
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    out.write(file.data(), file.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testPCapMergeReader)
+{
+  const uint32 channel0[] = {1000, 1000005, 1000009, 2000000};
+  const uint32 channel1[] = {5, 1000005, 1500000};
+  const uint32 channel2[] = {3000000};
+  const std::string file0("testPCapMerge0.pcap");
+  const std::string file1("testPCapMerge1.pcap");
+  const std::string file2("testPCapMerge2.pcap");
+  writePCap(file0, 0, channel0, sizeof(channel0)/sizeof(channel0[0]));
+  writePCap(file1, 1, channel1, sizeof(channel1)/sizeof(channel1[0]));
+  writePCap(file2, 2, channel2, sizeof(channel2)/sizeof(channel2[0]));
+
+  Communication::PCapMergeReader reader;
+  BOOST_REQUIRE(reader.open(file0, 32));
+  BOOST_REQUIRE(reader.open(file1, 32));
+  BOOST_REQUIRE(reader.open(file2, 32));
+  BOOST_CHECK_EQUAL(reader.channelCount(), 3);
+
+  // equal time stamps are returned in channel order
+  const size_t expectedChannel[] = {1, 0, 0, 1, 0, 1, 0, 2};
+  const uint32 expectedTime[] = {5, 1000, 1000005, 1000005, 1000009, 1500000, 2000000, 3000000};
+  const size_t expectedCount = sizeof(expectedChannel)/sizeof(expectedChannel[0]);
+
+  size_t channel = 0;
+  const unsigned char * buffer = 0;
+  size_t size = 0;
+  size_t count = 0;
+  while(reader.read(channel, buffer, size))
+  {
+    BOOST_REQUIRE(count < expectedCount);
+    BOOST_CHECK_EQUAL(channel, expectedChannel[count]);
+    BOOST_CHECK_EQUAL(reader.timestamp(), expectedTime[count]);
+    BOOST_REQUIRE_EQUAL(size, 8);
+    uint32 payloadChannel;
+    uint32 payloadTime;
+    std::memcpy(&payloadChannel, buffer, sizeof(payloadChannel));
+    std::memcpy(&payloadTime, buffer + sizeof(payloadChannel), sizeof(payloadTime));
+    BOOST_CHECK_EQUAL(payloadChannel, channel);
+    BOOST_CHECK_EQUAL(payloadTime, expectedTime[count]);
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, expectedCount);
+
+  std::remove(file0.c_str());
+  std::remove(file1.c_str());
+  std::remove(file2.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(testPCapReaderReadAhead)
+{
+  const uint32 timestamps[] = {10, 20, 30, 40, 50, 60, 70};
+  const size_t count = sizeof(timestamps)/sizeof(timestamps[0]);
+  const std::string file("testPCapReadAhead.pcap");
+  writePCap(file, 7, timestamps, count);
+  {
+    // A packet that is cut off by the end of the file is skipped.
+    std::ofstream out(file.c_str(), std::ios::binary | std::ios::app);
+    std::string header;
+    appendUint32(header, 0);
+    appendUint32(header, 80);
+    appendUint32(header, 1000);
+    appendUint32(header, 1000);
+    header += std::string(100, '\0');
+    out.write(header.data(), header.size());
+  }
+
+  // A read-ahead window smaller than one packet is grown to fit.
+  const size_t readAheads[] = {16, 100, 64 * 1024};
+  for(size_t nReadAhead = 0; nReadAhead < sizeof(readAheads)/sizeof(readAheads[0]); ++nReadAhead)
+  {
+    Communication::PCapReader reader(readAheads[nReadAhead]);
+    reader.set32bit(true);
+    BOOST_REQUIRE(reader.open(file.c_str()));
+    for(size_t pass = 0; pass < 2; ++pass)
+    {
+      const unsigned char * buffer = 0;
+      size_t size = 0;
+      size_t nPacket = 0;
+      while(reader.read(buffer, size))
+      {
+        BOOST_REQUIRE(nPacket < count);
+        BOOST_REQUIRE_EQUAL(size, 8);
+        uint32 payloadChannel;
+        uint32 payloadTime;
+        std::memcpy(&payloadChannel, buffer, sizeof(payloadChannel));
+        std::memcpy(&payloadTime, buffer + sizeof(payloadChannel), sizeof(payloadTime));
+        BOOST_CHECK_EQUAL(payloadChannel, 7);
+        BOOST_CHECK_EQUAL(payloadTime, timestamps[nPacket]);
+        BOOST_CHECK_EQUAL(reader.timestamp(), timestamps[nPacket]);
+        ++nPacket;
+      }
+      BOOST_CHECK_EQUAL(nPacket, count);
+      BOOST_REQUIRE(reader.rewind());
+    }
+  }
+  std::remove(file.c_str());
+}
@@ -0,0 +1,235 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Communication/PacketJournal.h>
+#include <Communication/PCapReader.h>
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace QuickFAST;
+
+namespace
+{
+  // A directory with the name of a journal file keeps the file from being created.
+  bool makeDirectory(const std::string & name)
+  {
+#if defined(_WIN32)
+    return _mkdir(name.c_str()) == 0;
+#else
+    return mkdir(name.c_str(), 0700) == 0;
+#endif
+  }
+
+  void removeDirectory(const std::string & name)
+  {
+#if defined(_WIN32)
+    _rmdir(name.c_str());
+#else
+    rmdir(name.c_str());
+#endif
+  }
+
+  size_t replayJournal(Communication::PacketJournal & journal, std::vector<std::string> & replayed)
+  {
+    for(size_t nFile = 0; nFile < journal.filesWritten(); ++nFile)
+    {
+      Communication::PCapReader reader;
+      reader.set32bit(true);
+      if(reader.open(journal.fileName(nFile).c_str()))
+      {
+        const unsigned char * buffer = 0;
+        size_t size = 0;
+        while(reader.read(buffer, size))
+        {
+          replayed.push_back(std::string(reinterpret_cast<const char *>(buffer), size));
+        }
+      }
+      std::remove(journal.fileName(nFile).c_str());
+    }
+    return replayed.size();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testPacketJournal)
+{
+  const std::string baseName("testPacketJournal");
+  std::vector<std::string> packets;
+  for(size_t nPacket = 0; nPacket < 7; ++nPacket)
+  {
+    packets.push_back(std::string(10 + nPacket, char('A' + nPacket)));
+  }
+  std::vector<std::string> expected;
+
+  // Small ring, small files to force rotation.
+  Communication::PacketJournal journal(baseName, 4, 32, 200);
+
+  // Before the writer starts the ring fills up, then packets are dropped.
+  for(size_t nPacket = 0; nPacket < 6; ++nPacket)
+  {
+    const std::string & packet = packets[nPacket];
+    if(journal.record(reinterpret_cast<const unsigned char *>(packet.data()), packet.size()))
+    {
+      expected.push_back(packet);
+    }
+  }
+  BOOST_CHECK_EQUAL(journal.recorded(), 4);
+  BOOST_CHECK_EQUAL(journal.dropped(), 2);
+  BOOST_CHECK_EQUAL(expected.size(), 4);
+
+  // too big for a slot
+  std::string big(33, 'Z');
+  BOOST_CHECK(!journal.record(reinterpret_cast<const unsigned char *>(big.data()), big.size()));
+  BOOST_CHECK_EQUAL(journal.oversized(), 1);
+  BOOST_CHECK_EQUAL(journal.dropped(), 3);
+
+  BOOST_REQUIRE(journal.start());
+  for(size_t wait = 0; journal.packetsWritten() < 4 && wait < 5000; ++wait)
+  {
+    boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+  }
+  BOOST_REQUIRE_EQUAL(journal.packetsWritten(), 4);
+
+  const std::string & last = packets[6];
+  BOOST_CHECK(journal.record(reinterpret_cast<const unsigned char *>(last.data()), last.size()));
+  expected.push_back(last);
+
+  // Continue past twice the ring size so the ring positions wrap.
+  for(size_t nPacket = 0; nPacket < 6; ++nPacket)
+  {
+    const std::string & packet = packets[nPacket];
+    BOOST_CHECK(journal.record(reinterpret_cast<const unsigned char *>(packet.data()), packet.size()));
+    expected.push_back(packet);
+    for(size_t wait = 0; journal.packetsWritten() < expected.size() && wait < 5000; ++wait)
+    {
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    }
+  }
+  journal.stop();
+
+  BOOST_CHECK_EQUAL(journal.packetsWritten(), 11);
+  BOOST_CHECK(journal.filesWritten() > 1);
+
+  // Replay the journal
+  std::vector<std::string> replayed;
+  for(size_t nFile = 0; nFile < journal.filesWritten(); ++nFile)
+  {
+    Communication::PCapReader reader;
+    reader.set32bit(true);
+    BOOST_REQUIRE(reader.open(journal.fileName(nFile).c_str()));
+    const unsigned char * buffer = 0;
+    size_t size = 0;
+    while(reader.read(buffer, size))
+    {
+      replayed.push_back(std::string(reinterpret_cast<const char *>(buffer), size));
+      BOOST_CHECK(reader.timestamp() != 0);
+    }
+    std::remove(journal.fileName(nFile).c_str());
+  }
+  BOOST_REQUIRE_EQUAL(replayed.size(), expected.size());
+  for(size_t nPacket = 0; nPacket < expected.size(); ++nPacket)
+  {
+    BOOST_CHECK_EQUAL(replayed[nPacket], expected[nPacket]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testPacketJournalOpenRetry)
+{
+  Communication::PacketJournal journal("testPacketJournalRetry", 8, 32, 100);
+  // Each 20 byte packet takes 82 bytes in the file, so every packet needs a new file.
+  BOOST_REQUIRE(makeDirectory(journal.fileName(1)));
+  BOOST_REQUIRE(journal.start());
+  std::string packet(20, 'R');
+  for(size_t nPacket = 0; nPacket < 4; ++nPacket)
+  {
+    packet[0] = char('0' + nPacket);
+    BOOST_CHECK(journal.record(reinterpret_cast<const unsigned char *>(packet.data()), packet.size()));
+  }
+  for(size_t wait = 0; journal.openFailures() < 3 && wait < 5000; ++wait)
+  {
+    boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+  }
+  // The writer is waiting for the second file.  The other packets are still in the ring.
+  BOOST_CHECK(journal.writeFailing());
+  BOOST_CHECK(journal.openFailures() >= 3);
+  BOOST_CHECK_EQUAL(journal.packetsWritten(), 1);
+  BOOST_CHECK_EQUAL(journal.dropped(), 0);
+
+  removeDirectory(journal.fileName(1));
+  for(size_t wait = 0; journal.packetsWritten() < 4 && wait < 5000; ++wait)
+  {
+    boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+  }
+  journal.stop();
+  BOOST_CHECK(!journal.writeFailing());
+  BOOST_CHECK_EQUAL(journal.packetsWritten(), 4);
+
+  std::vector<std::string> replayed;
+  BOOST_REQUIRE_EQUAL(replayJournal(journal, replayed), 4);
+  for(size_t nPacket = 0; nPacket < 4; ++nPacket)
+  {
+    BOOST_CHECK_EQUAL(replayed[nPacket][0], char('0' + nPacket));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testPacketJournalStopWhileFailing)
+{
+  Communication::PacketJournal journal("testPacketJournalStop", 8, 32, 100);
+  BOOST_REQUIRE(makeDirectory(journal.fileName(0)));
+  // The writer starts anyway and keeps trying.
+  BOOST_CHECK(!journal.start());
+  BOOST_CHECK(journal.writeFailing());
+  std::string packet(20, 'S');
+  BOOST_CHECK(journal.record(reinterpret_cast<const unsigned char *>(packet.data()), packet.size()));
+  BOOST_CHECK(journal.record(reinterpret_cast<const unsigned char *>(packet.data()), packet.size()));
+  journal.stop();
+  BOOST_CHECK_EQUAL(journal.packetsWritten(), 0);
+  BOOST_CHECK_EQUAL(journal.dropped(), 2);
+  removeDirectory(journal.fileName(0));
+}
+
+BOOST_AUTO_TEST_CASE(testPacketJournalFileLimit)
+{
+  // Each 20 byte packet takes 82 bytes in the file, so a file holds three packets.
+  Communication::PacketJournal journal("testPacketJournalLimit", 16, 32, 300);
+  journal.setFileLimit(2);
+  BOOST_REQUIRE(journal.start());
+  std::string packet(20, 'L');
+  for(size_t nPacket = 0; nPacket < 10; ++nPacket)
+  {
+    packet[0] = char('0' + nPacket);
+    BOOST_CHECK(journal.record(reinterpret_cast<const unsigned char *>(packet.data()), packet.size()));
+    for(size_t wait = 0; journal.packetsWritten() <= nPacket && wait < 5000; ++wait)
+    {
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    }
+  }
+  journal.stop();
+  BOOST_CHECK_EQUAL(journal.writeErrors(), 0);
+  BOOST_REQUIRE_EQUAL(journal.filesWritten(), 4);
+
+  // The oldest files were removed.  The others were trimmed to the packets written.
+  BOOST_CHECK(!std::ifstream(journal.fileName(0).c_str()));
+  BOOST_CHECK(!std::ifstream(journal.fileName(1).c_str()));
+  std::ifstream full(journal.fileName(2).c_str(), std::ios::binary | std::ios::ate);
+  BOOST_CHECK_EQUAL(full.tellg(), std::streamoff(24 + 3 * 82));
+  std::ifstream partial(journal.fileName(3).c_str(), std::ios::binary | std::ios::ate);
+  BOOST_CHECK_EQUAL(partial.tellg(), std::streamoff(24 + 82));
+  full.close();
+  partial.close();
+
+  std::vector<std::string> replayed;
+  BOOST_REQUIRE_EQUAL(replayJournal(journal, replayed), 4);
+  for(size_t nPacket = 0; nPacket < 4; ++nPacket)
+  {
+    BOOST_CHECK_EQUAL(replayed[nPacket][0], char('6' + nPacket));
+  }
+}
@@ -0,0 +1,243 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Communication/PacketRingReceiver.h>
+#include <Communication/Assembler.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/SingleMessageConsumer.h>
+#include <boost/asio.hpp>
+
+#if defined(__linux__)
+using namespace QuickFAST;
+
+namespace
+{
+  const char * group = "239.255.21.7";
+  const unsigned short port = 30217;
+  const size_t packetCount = 50;
+
+  /// Collect the payloads of all packets.
+  class TestAssembler : public Communication::Assembler
+  {
+  public:
+    TestAssembler(Common::Logger & logger)
+      : Communication::Assembler(Codecs::TemplateRegistryPtr(new Codecs::TemplateRegistry), logger)
+    {
+    }
+
+    virtual void receiverStarted(Communication::Receiver & /*receiver*/)
+    {
+    }
+
+    virtual void receiverStopped(Communication::Receiver & /*receiver*/)
+    {
+    }
+
+    virtual bool serviceQueue(Communication::Receiver & receiver)
+    {
+      Communication::LinkedBuffer * buffer = receiver.getBuffer(false);
+      while(buffer != 0)
+      {
+        {
+          boost::mutex::scoped_lock lock(mutex_);
+          received_.push_back(std::string(reinterpret_cast<const char *>(buffer->get()), buffer->used()));
+        }
+        receiver.releaseBuffer(buffer);
+        buffer = receiver.getBuffer(false);
+      }
+      return true;
+    }
+
+    size_t count()
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      return received_.size();
+    }
+
+    boost::mutex mutex_;
+    std::vector<std::string> received_;
+  };
+
+  /// Hold on to a burst of buffers now and then so the receiver's pool grows, then
+  /// release them all so it shrinks again.
+  class BurstAssembler : public TestAssembler
+  {
+  public:
+    BurstAssembler(Common::Logger & logger)
+      : TestAssembler(logger)
+    {
+    }
+
+    virtual bool serviceQueue(Communication::Receiver & receiver)
+    {
+      Communication::LinkedBuffer * buffer = receiver.getBuffer(false);
+      while(buffer != 0)
+      {
+        size_t nPacket = 0;
+        {
+          boost::mutex::scoped_lock lock(mutex_);
+          nPacket = received_.size();
+          received_.push_back(std::string(reinterpret_cast<const char *>(buffer->get()), buffer->used()));
+        }
+        if(nPacket % burstInterval < burstSize)
+        {
+          held_.push_back(buffer);
+          if(held_.size() == burstSize)
+          {
+            for(size_t nHeld = 0; nHeld < held_.size(); ++nHeld)
+            {
+              receiver.releaseBuffer(held_[nHeld]);
+            }
+            held_.clear();
+            // end the batch so the receiver can shrink its pool.
+            return true;
+          }
+        }
+        else
+        {
+          receiver.releaseBuffer(buffer);
+        }
+        buffer = receiver.getBuffer(false);
+      }
+      return true;
+    }
+
+    static const size_t burstInterval = 20;
+    static const size_t burstSize = 4;
+    std::vector<Communication::LinkedBuffer *> held_;
+  };
+
+  std::string payload(size_t nPacket)
+  {
+    return "packet " + boost::lexical_cast<std::string>(nPacket);
+  }
+
+  /// Multicast packets to the group on the loopback interface.
+  void sendPackets(size_t packetCount)
+  {
+    boost::asio::io_service ioService;
+    boost::asio::ip::udp::socket socket(ioService, boost::asio::ip::udp::v4());
+    socket.set_option(boost::asio::ip::multicast::outbound_interface(
+      boost::asio::ip::address_v4::from_string("127.0.0.1")));
+    socket.set_option(boost::asio::ip::multicast::enable_loopback(true));
+    boost::asio::ip::udp::endpoint destination(boost::asio::ip::address::from_string(group), port);
+    boost::asio::ip::udp::endpoint other(boost::asio::ip::address::from_string(group), port + 1);
+    // give the receiver time to start
+    boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+    for(size_t nPacket = 0; nPacket < packetCount; ++nPacket)
+    {
+      // traffic for another port is filtered out by the kernel.
+      socket.send_to(boost::asio::buffer(std::string("noise")), other);
+      std::string data = payload(nPacket);
+      socket.send_to(boost::asio::buffer(data), destination);
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testPacketRingReceiver)
+{
+  Codecs::SingleMessageConsumer logger;
+  TestAssembler assembler(logger);
+  Communication::PacketRingReceiver receiver("lo", group, "127.0.0.1", port, 4096 * 4, 16, 5);
+  boost::thread sender(boost::bind(sendPackets, packetCount));
+  try
+  {
+    receiver.start(assembler, 1500, 4);
+  }
+  catch(const CommunicationError & error)
+  {
+    // no privilege to open a packet socket.
+    BOOST_TEST_MESSAGE(std::string("testPacketRingReceiver skipped: ") + error.what());
+    sender.join();
+    return;
+  }
+  receiver.runThreads(0, false);
+  for(size_t nWait = 0; nWait < 500 && assembler.count() < packetCount; ++nWait)
+  {
+    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+  }
+  sender.join();
+  receiver.stop();
+  receiver.joinThreads();
+
+  BOOST_REQUIRE_EQUAL(assembler.count(), packetCount);
+  for(size_t nPacket = 0; nPacket < packetCount; ++nPacket)
+  {
+    BOOST_CHECK_EQUAL(assembler.received_[nPacket], payload(nPacket));
+  }
+  BOOST_CHECK(receiver.blocksReceived() > 0);
+  BOOST_CHECK(receiver.timestamp() != 0);
+  BOOST_CHECK_EQUAL(receiver.packetsWithErrors(), 0);
+  BOOST_CHECK_EQUAL(receiver.kernelDrops(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testPacketRingReceiverAdaptiveBuffers)
+{
+  Codecs::SingleMessageConsumer logger;
+  BurstAssembler assembler(logger);
+  // Few blocks, so a block pinned by a released buffer soon stops the ring.
+  const size_t burstPackets = 300;
+  Communication::PacketRingReceiver receiver("lo", group, "127.0.0.1", port, 4096, 6, 2);
+  receiver.setAdaptiveBuffers(2, 1500 * 8, 1);
+  boost::thread sender(boost::bind(sendPackets, burstPackets));
+  try
+  {
+    receiver.start(assembler, 1500, 1);
+  }
+  catch(const CommunicationError & error)
+  {
+    // no privilege to open a packet socket.
+    BOOST_TEST_MESSAGE(std::string("testPacketRingReceiverAdaptiveBuffers skipped: ") + error.what());
+    sender.join();
+    return;
+  }
+  receiver.runThreads(0, false);
+  for(size_t nWait = 0; nWait < 500 && assembler.count() < burstPackets; ++nWait)
+  {
+    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+  }
+  sender.join();
+  receiver.stop();
+  receiver.joinThreads();
+
+  // Every ring block has been handed over several times.
+  BOOST_CHECK(receiver.blocksReceived() > 6 * 3);
+  BOOST_CHECK(receiver.slabsAdded() > 0);
+  BOOST_CHECK(receiver.slabsReleased() > 0);
+  BOOST_CHECK_EQUAL(receiver.packetsWithErrors(), 0);
+  BOOST_REQUIRE_EQUAL(assembler.count(), burstPackets);
+  for(size_t nPacket = 0; nPacket < burstPackets; ++nPacket)
+  {
+    BOOST_CHECK_EQUAL(assembler.received_[nPacket], payload(nPacket));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testFindUdpPayload)
+{
+  // 20 byte IP header, 8 byte UDP header, 3 bytes of data, 2 bytes of padding
+  const unsigned char packet[] = {
+    0x45, 0, 0, 31, 0, 0, 0x40, 0, 1, 17, 0, 0, 127, 0, 0, 1, 239, 255, 21, 7,
+    0x12, 0x34, 0x76, 0x49, 0, 11, 0, 0,
+    'a', 'b', 'c',
+    0, 0};
+  const unsigned char * data = 0;
+  size_t size = 0;
+  BOOST_REQUIRE(Communication::PCapReader::findUdpPayload(packet, sizeof(packet), data, size));
+  BOOST_CHECK_EQUAL(size, 3);
+  BOOST_CHECK(data == packet + 28);
+  BOOST_CHECK_EQUAL(Communication::PCapReader::udpHeaderLength(packet), 28);
+  // truncated
+  BOOST_CHECK(!Communication::PCapReader::findUdpPayload(packet, 30, data, size));
+  // a fragment
+  unsigned char fragment[sizeof(packet)];
+  std::memcpy(fragment, packet, sizeof(packet));
+  fragment[6] = 0x20;
+  BOOST_CHECK(!Communication::PCapReader::findUdpPayload(fragment, sizeof(fragment), data, size));
+}
+#endif // __linux__
@@ -0,0 +1,362 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/PushEncoder.h>
+#include <Codecs/FieldInstructionUInt32.h>
+#include <Codecs/FieldInstructionInt32.h>
+#include <Codecs/FieldInstructionUInt64.h>
+#include <Codecs/FieldInstructionAscii.h>
+#include <Codecs/FieldInstructionDecimal.h>
+#include <Codecs/FieldInstructionGroup.h>
+#include <Codecs/FieldInstructionSequence.h>
+#include <Codecs/FieldInstructionTemplateRef.h>
+#include <Codecs/FieldOpNop.h>
+#include <Codecs/FieldOpCopy.h>
+#include <Codecs/FieldOpDelta.h>
+#include <Codecs/Template.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/SegmentBody.h>
+#include <Codecs/Encoder.h>
+#include <Codecs/DataDestination.h>
+
+#include <Messages/Message.h>
+#include <Messages/Sequence.h>
+#include <Messages/FieldUInt32.h>
+#include <Messages/FieldInt32.h>
+#include <Messages/FieldUInt64.h>
+#include <Messages/FieldAscii.h>
+#include <Messages/FieldDecimal.h>
+#include <Messages/FieldGroup.h>
+#include <Messages/FieldSequence.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  // <template name="Order" id="1">
+  //   <uInt32 name="Seq"><copy/></uInt32>
+  //   <string name="Symbol" presence="optional"/>
+  //   <decimal name="Price"><copy/></decimal>
+  //   <group name="Extra" presence="optional">
+  //     <int32 name="Qty"><copy/></int32>
+  //   </group>
+  //   <sequence name="Fills">
+  //     <int32 name="FillQty"><delta/></int32>
+  //     <uInt64 name="FillId"><copy/></uInt64>
+  //   </sequence>
+  // </template>
+  Codecs::TemplateRegistryPtr createRegistry()
+  {
+    Codecs::TemplatePtr order = createTemplate(1, "Order");
+    addField(order, new Codecs::FieldInstructionUInt32("Seq", ""), new Codecs::FieldOpCopy);
+    addField(order, new Codecs::FieldInstructionAscii("Symbol", ""), new Codecs::FieldOpNop, false);
+    addField(order, new Codecs::FieldInstructionDecimal("Price", ""), new Codecs::FieldOpCopy);
+
+    Codecs::SegmentBodyPtr extra = addGroup(order, "Extra", false);
+    addField(extra, new Codecs::FieldInstructionInt32("Qty", ""), new Codecs::FieldOpCopy);
+
+    Codecs::SegmentBodyPtr fillBody(new Codecs::SegmentBody);
+    fillBody->setApplicationType("Fill", "");
+    addField(fillBody, new Codecs::FieldInstructionInt32("FillQty", ""), new Codecs::FieldOpDelta);
+    addField(fillBody, new Codecs::FieldInstructionUInt64("FillId", ""), new Codecs::FieldOpCopy);
+    Codecs::FieldInstructionPtr fills(new Codecs::FieldInstructionSequence("Fills", ""));
+    fills->setSegmentBody(fillBody);
+    order->addInstruction(fills);
+
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(order);
+    registry->finalize();
+    return registry;
+  }
+
+  struct Fill
+  {
+    int32 qty_;
+    uint64 id_;
+  };
+
+  struct Order
+  {
+    uint32 seq_;
+    const char * symbol_;
+    Decimal price_;
+    bool hasExtra_;
+    int32 qty_;
+    size_t fillCount_;
+    Fill fills_[2];
+  };
+
+  Messages::FieldIdentityCPtr seqIdentity = new Messages::FieldIdentity("Seq");
+  Messages::FieldIdentityCPtr symbolIdentity = new Messages::FieldIdentity("Symbol");
+  Messages::FieldIdentityCPtr priceIdentity = new Messages::FieldIdentity("Price");
+  Messages::FieldIdentityCPtr extraIdentity = new Messages::FieldIdentity("Extra");
+  Messages::FieldIdentityCPtr qtyIdentity = new Messages::FieldIdentity("Qty");
+  Messages::FieldIdentityCPtr fillsIdentity = new Messages::FieldIdentity("Fills");
+  Messages::FieldIdentityCPtr fillsLengthIdentity = new Messages::FieldIdentity("FillsLength");
+  Messages::FieldIdentityCPtr fillQtyIdentity = new Messages::FieldIdentity("FillQty");
+  Messages::FieldIdentityCPtr fillIdIdentity = new Messages::FieldIdentity("FillId");
+
+  /// Encode the conventional way: build a Message then encode it.
+  void encodeWithMessage(Codecs::Encoder & encoder, Codecs::DataDestination & destination, const Order & order)
+  {
+    Messages::Message message(10);
+    message.addField(seqIdentity, Messages::FieldUInt32::create(order.seq_));
+    if(order.symbol_ != 0)
+    {
+      message.addField(symbolIdentity, Messages::FieldAscii::create(order.symbol_));
+    }
+    message.addField(priceIdentity, Messages::FieldDecimal::create(order.price_));
+    if(order.hasExtra_)
+    {
+      Messages::GroupPtr group(new Messages::Group(1));
+      group->addField(qtyIdentity, Messages::FieldInt32::create(order.qty_));
+      message.addField(extraIdentity, Messages::FieldGroup::create(group));
+    }
+    Messages::SequencePtr sequence(new Messages::Sequence(fillsLengthIdentity, order.fillCount_));
+    for(size_t nFill = 0; nFill < order.fillCount_; ++nFill)
+    {
+      Messages::FieldSetPtr entry(new Messages::FieldSet(2));
+      entry->addField(fillQtyIdentity, Messages::FieldInt32::create(order.fills_[nFill].qty_));
+      entry->addField(fillIdIdentity, Messages::FieldUInt64::create(order.fills_[nFill].id_));
+      sequence->addEntry(entry);
+    }
+    message.addField(fillsIdentity, Messages::FieldSequence::create(sequence));
+    encoder.encodeMessage(destination, 1, message);
+  }
+
+  /// Encode directly from the application's structure.
+  void encodeWithPush(Codecs::PushEncoder & pushEncoder, const Order & order)
+  {
+    pushEncoder.startMessage(1);
+    pushEncoder.addValue(*seqIdentity, order.seq_);
+    if(order.symbol_ != 0)
+    {
+      pushEncoder.addValue(*symbolIdentity, std::string(order.symbol_));
+    }
+    pushEncoder.addValue(*priceIdentity, order.price_);
+    if(order.hasExtra_)
+    {
+      pushEncoder.startGroup(*extraIdentity);
+      pushEncoder.addValue(*qtyIdentity, order.qty_);
+      pushEncoder.endGroup();
+    }
+    pushEncoder.startSequence(*fillsIdentity, order.fillCount_);
+    for(size_t nFill = 0; nFill < order.fillCount_; ++nFill)
+    {
+      pushEncoder.startSequenceEntry();
+      pushEncoder.addValue(*fillQtyIdentity, order.fills_[nFill].qty_);
+      pushEncoder.addValue(*fillIdIdentity, order.fills_[nFill].id_);
+      pushEncoder.endSequenceEntry();
+    }
+    pushEncoder.endSequence();
+    pushEncoder.endMessage();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testPushEncoder)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  const Order orders[] = {
+    {1, "IBM", Decimal(125, -1), true, 100, 2, {{10, 7}, {20, 8}}},
+    {2, 0, Decimal(125, -1), false, 0, 0, {{0, 0}, {0, 0}}},
+    {3, "MSFT", Decimal(126, -1), true, 100, 1, {{5, 9}, {0, 0}}}
+  };
+  const size_t orderCount = sizeof(orders) / sizeof(orders[0]);
+
+  Codecs::Encoder messageEncoder(registry);
+  Codecs::DataDestination messageDestination;
+  Codecs::Encoder encoder(registry);
+  Codecs::DataDestination destination;
+  Codecs::PushEncoder pushEncoder(encoder, destination);
+  for(size_t nOrder = 0; nOrder < orderCount; ++nOrder)
+  {
+    encodeWithMessage(messageEncoder, messageDestination, orders[nOrder]);
+    encodeWithPush(pushEncoder, orders[nOrder]);
+  }
+  std::string expected;
+  messageDestination.toString(expected);
+  std::string pushed;
+  destination.toString(pushed);
+  BOOST_CHECK(!pushed.empty());
+  BOOST_CHECK(pushed == expected);
+}
+
+BOOST_AUTO_TEST_CASE(testPushEncoderAutoReset)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  const Order order = {1, "IBM", Decimal(125, -1), true, 100, 2, {{10, 7}, {20, 8}}};
+  const size_t messageCount = 5;
+
+  Codecs::Encoder messageEncoder(registry);
+  messageEncoder.setAutoReset(2);
+  Codecs::DataDestination messageDestination;
+  Codecs::Encoder encoder(registry);
+  encoder.setAutoReset(2);
+  Codecs::DataDestination destination;
+  Codecs::PushEncoder pushEncoder(encoder, destination);
+  for(size_t nMessage = 0; nMessage < messageCount; ++nMessage)
+  {
+    encodeWithMessage(messageEncoder, messageDestination, order);
+    encodeWithPush(pushEncoder, order);
+  }
+  std::string expected;
+  messageDestination.toString(expected);
+  std::string pushed;
+  destination.toString(pushed);
+  BOOST_CHECK(pushed == expected);
+  BOOST_CHECK_EQUAL(encoder.messagesEncoded(), messageCount);
+  BOOST_CHECK_EQUAL(encoder.bytesEncoded(), pushed.size());
+  BOOST_CHECK_EQUAL(encoder.resetMessages(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(testPushEncoderOrder)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  Codecs::Encoder encoder(registry);
+  Codecs::DataDestination destination;
+  Codecs::PushEncoder pushEncoder(encoder, destination);
+
+  // no message started
+  BOOST_CHECK_THROW(pushEncoder.addValue(*seqIdentity, uint32(1)), UsageError);
+
+  pushEncoder.startMessage(1);
+  pushEncoder.addValue(*seqIdentity, uint32(1));
+  pushEncoder.addValue(*priceIdentity, Decimal(1, 0));
+  // Symbol comes before Price in the template
+  BOOST_CHECK_THROW(pushEncoder.addValue(*symbolIdentity, std::string("IBM")), UsageError);
+  // wrong type of value
+  BOOST_CHECK_THROW(pushEncoder.addValue(*fillsIdentity, uint32(1)), UsageError);
+  pushEncoder.abandonMessage();
+
+  pushEncoder.startMessage(1);
+  pushEncoder.addValue(*seqIdentity, uint32(1));
+  pushEncoder.addValue(*priceIdentity, Decimal(1, 0));
+  pushEncoder.startSequence(*fillsIdentity, 1);
+  BOOST_CHECK_THROW(pushEncoder.endSequence(), UsageError);
+  pushEncoder.startSequenceEntry();
+  pushEncoder.addValue(*fillQtyIdentity, int32(1));
+  pushEncoder.addValue(*fillIdIdentity, uint64(1));
+  pushEncoder.endSequenceEntry();
+  BOOST_CHECK_THROW(pushEncoder.startSequenceEntry(), UsageError);
+  BOOST_CHECK_THROW(pushEncoder.endMessage(), UsageError);
+  pushEncoder.endSequence();
+  pushEncoder.endMessage();
+
+  // a rejected value does not skip the fields ahead of its field.
+  pushEncoder.startMessage(1);
+  pushEncoder.addValue(*seqIdentity, uint32(1));
+  BOOST_CHECK_THROW(pushEncoder.addValue(*priceIdentity, std::string("IBM")), UsageError);
+  BOOST_CHECK_THROW(pushEncoder.startGroup(*priceIdentity), UsageError);
+  BOOST_CHECK_NO_THROW(pushEncoder.addValue(*symbolIdentity, std::string("IBM")));
+  pushEncoder.abandonMessage();
+
+  // a missing mandatory field is an encoding error.
+  pushEncoder.startMessage(1);
+  BOOST_CHECK_THROW(pushEncoder.endMessage(), EncodingError);
+  pushEncoder.abandonMessage();
+}
+
+BOOST_AUTO_TEST_CASE(testPushEncoderAbandon)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  const Order order = {1, "IBM", Decimal(125, -1), true, 100, 2, {{10, 7}, {20, 8}}};
+
+  // The abandoned message changed the Seq and Price dictionary entries.
+  Codecs::Encoder encoder(registry);
+  Codecs::DataDestination abandoned;
+  Codecs::PushEncoder pushEncoder(encoder, abandoned);
+  pushEncoder.startMessage(1);
+  pushEncoder.addValue(*seqIdentity, uint32(1));
+  pushEncoder.addValue(*priceIdentity, Decimal(125, -1));
+  pushEncoder.abandonMessage();
+
+  Codecs::DataDestination destination;
+  Codecs::PushEncoder restarted(encoder, destination);
+  encodeWithPush(restarted, order);
+  std::string pushed;
+  destination.toString(pushed);
+
+  // ... but the next message is encoded as if from a fresh start.
+  Codecs::Encoder messageEncoder(registry);
+  Codecs::DataDestination messageDestination;
+  encodeWithMessage(messageEncoder, messageDestination, order);
+  std::string expected;
+  messageDestination.toString(expected);
+  BOOST_CHECK(pushed == expected);
+}
+
+BOOST_AUTO_TEST_CASE(testPushEncoderIndexAndTemplateRef)
+{
+  // <template name="Header" id="3">
+  //   <uInt32 name="MsgSeqNum"><copy/></uInt32>
+  //   <string name="Sender" presence="optional"/>
+  // </template>
+  // <template name="Trade" id="2">
+  //   <templateRef name="Header"/>
+  //   <decimal name="Price"><copy/></decimal>
+  //   <uInt32 name="Qty"><copy/></uInt32>
+  // </template>
+  Codecs::TemplatePtr header = createTemplate(3, "Header");
+  addField(header, new Codecs::FieldInstructionUInt32("MsgSeqNum", ""), new Codecs::FieldOpCopy);
+  addField(header, new Codecs::FieldInstructionAscii("Sender", ""), new Codecs::FieldOpNop, false);
+  Codecs::TemplatePtr trade = createTemplate(2, "Trade");
+  Codecs::FieldInstructionPtr headerRef(new Codecs::FieldInstructionStaticTemplateRef("Header", ""));
+  trade->addInstruction(headerRef);
+  addField(trade, new Codecs::FieldInstructionDecimal("Price", ""), new Codecs::FieldOpCopy);
+  addField(trade, new Codecs::FieldInstructionUInt32("Qty", ""), new Codecs::FieldOpCopy);
+  Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+  registry->addTemplate(header);
+  registry->addTemplate(trade);
+  registry->finalize();
+
+  Messages::FieldIdentityCPtr msgSeqNumIdentity = new Messages::FieldIdentity("MsgSeqNum");
+  Messages::FieldIdentityCPtr senderIdentity = new Messages::FieldIdentity("Sender");
+  Messages::FieldIdentityCPtr tradeQtyIdentity = new Messages::FieldIdentity("Qty");
+
+  Codecs::Encoder messageEncoder(registry);
+  Codecs::DataDestination messageDestination;
+  for(uint32 nMessage = 0; nMessage < 2; ++nMessage)
+  {
+    Messages::Message message(4);
+    message.addField(msgSeqNumIdentity, Messages::FieldUInt32::create(5 + nMessage));
+    if(nMessage == 1)
+    {
+      message.addField(senderIdentity, Messages::FieldAscii::create("OCI"));
+    }
+    message.addField(priceIdentity, Messages::FieldDecimal::create(Decimal(125, -1)));
+    message.addField(tradeQtyIdentity, Messages::FieldUInt32::create(100));
+    messageEncoder.encodeMessage(messageDestination, 2, message);
+  }
+
+  Codecs::Encoder encoder(registry);
+  Codecs::DataDestination destination;
+  Codecs::PushEncoder pushEncoder(encoder, destination);
+  // Sender is skipped, then the rest of the Trade by identity and by index.
+  pushEncoder.startMessage(2);
+  pushEncoder.addValue(*msgSeqNumIdentity, uint32(5));
+  pushEncoder.addValue(*priceIdentity, Decimal(125, -1));
+  pushEncoder.addValue(size_t(2), uint32(100));
+  pushEncoder.endMessage();
+  // An index ends the templateRef.
+  pushEncoder.startMessage(2);
+  pushEncoder.addValue(*msgSeqNumIdentity, uint32(6));
+  pushEncoder.addValue(*senderIdentity, std::string("OCI"));
+  pushEncoder.addValue(size_t(1), Decimal(125, -1));
+  BOOST_CHECK_THROW(pushEncoder.addValue(size_t(1), Decimal(125, -1)), UsageError);
+  BOOST_CHECK_THROW(pushEncoder.addValue(size_t(3), uint32(100)), UsageError);
+  pushEncoder.addValue(size_t(2), uint32(100));
+  pushEncoder.endMessage();
+
+  std::string expected;
+  messageDestination.toString(expected);
+  std::string pushed;
+  destination.toString(pushed);
+  BOOST_CHECK(pushed == expected);
+}
@@ -0,0 +1,173 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/DataSourceStream.h>
+#include <Codecs/DataSourceBlockedStream.h>
+#include <Common/Constants.h>
+
+using namespace QuickFAST;
+using namespace QuickFAST::Codecs;
+
+namespace
+{
+  // getBuffer is public in the concrete DataSources.
+  template<typename Source>
+  std::string readAll(Source & source)
+  {
+    std::string result;
+    const uchar * buffer = 0;
+    size_t size = 0;
+    while(source.getBuffer(buffer, size))
+    {
+      result.append(reinterpret_cast<const char *>(buffer), size);
+    }
+    return result;
+  }
+
+  template<typename Source>
+  std::vector<std::string> readBlocks(Source & source)
+  {
+    std::vector<std::string> result;
+    const uchar * buffer = 0;
+    size_t size = 0;
+    while(source.getBuffer(buffer, size))
+    {
+      result.push_back(std::string(reinterpret_cast<const char *>(buffer), size));
+    }
+    return result;
+  }
+
+  void appendBlock(std::string & stream, const std::string & block)
+  {
+    size_t length = block.size();
+    std::string header(1, char((length & dataBits) | stopBit));
+    length >>= dataShift;
+    while(length != 0)
+    {
+      header.insert(header.begin(), char(length & dataBits));
+      length >>= dataShift;
+    }
+    stream += header;
+    stream += block;
+  }
+
+  std::string testData(size_t size)
+  {
+    std::string data;
+    for(size_t n = 0; n < size; ++n)
+    {
+      data += char(n * 7 + n / 251);
+    }
+    return data;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testStreamReadAhead)
+{
+  std::string data = testData(10000);
+  for(size_t count = 2; count <= 4; ++count)
+  {
+    std::istringstream stream(data);
+    DataSourceStream source(stream, 333, count);
+    BOOST_CHECK(readAll(source) == data);
+  }
+  // exact multiple of the buffer size
+  std::istringstream stream(data);
+  DataSourceStream source(stream, 1000, 3);
+  BOOST_CHECK(readAll(source) == data);
+
+  std::istringstream empty("");
+  DataSourceStream emptySource(empty, 1000, 3);
+  BOOST_CHECK(readAll(emptySource).empty());
+}
+
+BOOST_AUTO_TEST_CASE(testBlockedStreamReadAhead)
+{
+  std::string data = testData(5000);
+  std::vector<std::string> blocks;
+  std::string stream;
+  size_t offset = 0;
+  for(size_t length = 1; offset + length <= data.size(); length += 37)
+  {
+    blocks.push_back(data.substr(offset, length));
+    appendBlock(stream, blocks.back());
+    offset += length;
+  }
+
+  std::istringstream synchronous(stream);
+  DataSourceBlockedStream synchronousSource(synchronous);
+  BOOST_CHECK(readBlocks(synchronousSource) == blocks);
+
+  // small read-ahead buffers force headers and blocks to span buffers.
+  for(size_t bufferSize = 1; bufferSize < 600; bufferSize += 149)
+  {
+    std::istringstream prefetched(stream);
+    DataSourceBlockedStream prefetchedSource(prefetched, 3, bufferSize);
+    BOOST_CHECK(readBlocks(prefetchedSource) == blocks);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testBlockedStreamErrors)
+{
+  std::string good;
+  appendBlock(good, testData(300));
+  appendBlock(good, testData(200));
+
+  // readAheadBuffers 0 reads synchronously; 3 parses the prefetched bytes.
+  for(size_t readAhead = 0; readAhead <= 3; readAhead += 3)
+  {
+    {
+      // The last block is cut short.
+      std::istringstream stream(good.substr(0, good.size() - 1));
+      DataSourceBlockedStream source(stream, readAhead, 64);
+      const uchar * buffer = 0;
+      size_t size = 0;
+      BOOST_REQUIRE(source.getBuffer(buffer, size));
+      BOOST_CHECK_EQUAL(size, 300);
+      BOOST_CHECK_THROW(source.getBuffer(buffer, size), EncodingError);
+    }
+    {
+      // The stream ends inside a block header.
+      std::istringstream stream(good.substr(0, 302 + 1));
+      DataSourceBlockedStream source(stream, readAhead, 64);
+      BOOST_CHECK_THROW(readBlocks(source), EncodingError);
+    }
+    {
+      // The block is larger than the limit.
+      std::istringstream stream(good);
+      DataSourceBlockedStream source(stream, readAhead, 64);
+      source.setMaxBlockSize(250);
+      BOOST_CHECK_THROW(readBlocks(source), EncodingError);
+    }
+    {
+      // A header that would overflow size_t.
+      std::string huge(20, '\x7F');
+      huge += char(stopBit);
+      std::istringstream stream(huge);
+      DataSourceBlockedStream source(stream, readAhead, 64);
+      BOOST_CHECK_THROW(readBlocks(source), EncodingError);
+    }
+    {
+      std::istringstream stream(good);
+      DataSourceBlockedStream source(stream, readAhead, 64);
+      BOOST_CHECK_EQUAL(readBlocks(source).size(), 2);
+    }
+    {
+      // Empty blocks are skipped, including one at the end of the stream.
+      std::string padded;
+      appendBlock(padded, "");
+      padded += good;
+      appendBlock(padded, "");
+      std::istringstream stream(padded);
+      DataSourceBlockedStream source(stream, readAhead, 64);
+      std::vector<std::string> blocks = readBlocks(source);
+      BOOST_REQUIRE_EQUAL(blocks.size(), 2);
+      BOOST_CHECK_EQUAL(blocks[0].size(), 300);
+    }
+  }
+}
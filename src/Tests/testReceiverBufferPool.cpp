@@ -0,0 +1,167 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Communication/SynchReceiver.h>
+#include <Communication/Assembler.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/SingleMessageConsumer.h>
+
+using namespace QuickFAST;
+
+namespace
+{
+  /// A receiver that behaves like an asynchronous receiver: a read is started
+  /// by fillBuffer() and completes when the test calls deliver().
+  class TestReceiver : public Communication::SynchReceiver
+  {
+  public:
+    TestReceiver()
+      : pending_(0)
+    {
+    }
+
+    /// @brief complete the pending read with a four byte packet.
+    /// @returns true if another read was started.
+    bool deliver(uint32 sequence)
+    {
+      boost::mutex::scoped_lock lock(bufferMutex_);
+      Communication::LinkedBuffer * buffer = pending_;
+      BOOST_REQUIRE(buffer != 0);
+      pending_ = 0;
+      std::memcpy(buffer->get(), &sequence, sizeof(sequence));
+      acceptFullBuffer(buffer, sizeof(sequence), lock);
+      startReceive(lock);
+      return pending_ != 0;
+    }
+
+    /// @brief try to start a read.
+    bool kick()
+    {
+      startReceiveUnlocked();
+      return pending_ != 0;
+    }
+
+    virtual void resetService()
+    {
+    }
+
+  private:
+    virtual bool initializeReceiver()
+    {
+      return true;
+    }
+
+    virtual bool fillBuffer(Communication::LinkedBuffer * buffer, boost::mutex::scoped_lock& /*lock*/)
+    {
+      pending_ = buffer;
+      return true;
+    }
+
+  private:
+    Communication::LinkedBuffer * pending_;
+  };
+
+  /// Collect the sequence numbers of all queued packets.
+  class TestAssembler : public Communication::Assembler
+  {
+  public:
+    TestAssembler(Common::Logger & logger)
+      : Communication::Assembler(Codecs::TemplateRegistryPtr(new Codecs::TemplateRegistry), logger)
+    {
+    }
+
+    virtual void receiverStarted(Communication::Receiver & /*receiver*/)
+    {
+    }
+
+    virtual void receiverStopped(Communication::Receiver & /*receiver*/)
+    {
+    }
+
+    virtual bool serviceQueue(Communication::Receiver & receiver)
+    {
+      Communication::LinkedBuffer * buffer = receiver.getBuffer(false);
+      while(buffer != 0)
+      {
+        uint32 sequence;
+        std::memcpy(&sequence, buffer->get(), sizeof(sequence));
+        received_.push_back(sequence);
+        receiver.releaseBuffer(buffer);
+        buffer = receiver.getBuffer(false);
+      }
+      return true;
+    }
+
+    std::vector<uint32> received_;
+  };
+}
+
+BOOST_AUTO_TEST_CASE(testReceiverBufferPool)
+{
+  Codecs::SingleMessageConsumer logger;
+  TestAssembler assembler(logger);
+  TestReceiver receiver;
+  BOOST_REQUIRE(receiver.start(assembler, 16, 2));
+  BOOST_CHECK_EQUAL(receiver.buffersAllocated(), 2);
+  // grow two buffers at a time up to six buffers.
+  receiver.setAdaptiveBuffers(2, 6 * 16, 1);
+
+  // The assembler is not keeping up.  The pool grows.
+  uint32 sequence = 0;
+  for(; sequence < 5; ++sequence)
+  {
+    BOOST_CHECK(receiver.deliver(sequence));
+  }
+  BOOST_CHECK_EQUAL(receiver.buffersAllocated(), 6);
+  BOOST_CHECK_EQUAL(receiver.slabsAdded(), 2);
+
+  // At the memory limit the default policy stops reading
+  BOOST_CHECK(!receiver.deliver(sequence++));
+  BOOST_CHECK_EQUAL(receiver.blockedReads(), 1);
+  BOOST_CHECK_EQUAL(receiver.buffersAllocated(), 6);
+
+  // Drop newest: keep reading and discard what arrives.
+  receiver.setOverloadPolicy(Communication::Receiver::DROP_NEWEST);
+  BOOST_CHECK(receiver.kick());
+  BOOST_CHECK(receiver.deliver(sequence++)); // 6 is discarded
+  BOOST_CHECK_EQUAL(receiver.droppedNewest(), 1);
+
+  // Drop oldest: discard queued packets 0 and 1 to make room for 8
+  receiver.setOverloadPolicy(Communication::Receiver::DROP_OLDEST);
+  BOOST_CHECK(receiver.deliver(sequence++)); // 7 was read into the discard buffer
+  BOOST_CHECK_EQUAL(receiver.droppedNewest(), 2);
+  BOOST_CHECK_EQUAL(receiver.droppedOldest(), 1);
+  BOOST_CHECK(receiver.deliver(sequence++)); // 8 replaces 0; 1 is dropped for the next read
+  BOOST_CHECK_EQUAL(receiver.droppedOldest(), 2);
+  BOOST_CHECK_EQUAL(receiver.bytesDropped(), 4 * sizeof(uint32));
+  BOOST_CHECK_EQUAL(receiver.blockedReads(), 1);
+
+  // The assembler catches up.  The burst is over so the pool shrinks a slab at a time.
+  receiver.tryServiceQueue();
+  const uint32 expected[] = {2, 3, 4, 5, 8};
+  BOOST_REQUIRE_EQUAL(assembler.received_.size(), sizeof(expected)/sizeof(expected[0]));
+  for(size_t nPacket = 0; nPacket < assembler.received_.size(); ++nPacket)
+  {
+    BOOST_CHECK_EQUAL(assembler.received_[nPacket], expected[nPacket]);
+  }
+  BOOST_CHECK_EQUAL(receiver.buffersAllocated(), 4);
+  BOOST_CHECK_EQUAL(receiver.slabsReleased(), 1);
+
+  BOOST_CHECK(receiver.deliver(sequence++));
+  receiver.tryServiceQueue();
+  BOOST_CHECK_EQUAL(receiver.buffersAllocated(), 2);
+  BOOST_CHECK_EQUAL(receiver.slabsReleased(), 2);
+
+  // Never shrinks below the explicitly allocated buffers
+  BOOST_CHECK(receiver.deliver(sequence++));
+  receiver.tryServiceQueue();
+  BOOST_CHECK_EQUAL(receiver.buffersAllocated(), 2);
+  BOOST_CHECK_EQUAL(assembler.received_.size(), 7);
+  BOOST_CHECK_EQUAL(receiver.kernelDrops(), 0);
+  receiver.stop();
+}
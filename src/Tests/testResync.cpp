@@ -0,0 +1,111 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/ResyncScanner.h>
+#include <Codecs/StreamingAssembler.h>
+#include <Codecs/NoHeaderAnalyzer.h>
+#include <Communication/BufferReceiver.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  // <template name="Quote" id="2">
+  //   <uInt32 name="Seq"><increment/></uInt32>
+  //   <string name="Symbol"><copy/></string>
+  // </template>
+  Codecs::TemplateRegistryPtr createRegistry()
+  {
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    addQuoteTemplate(*registry, 2, "Quote");
+    registry->finalize();
+    return registry;
+  }
+
+  // Encode count messages with a reset every two messages.
+  // Returns the offset at which each message (or the reset preceding it) starts.
+  std::vector<size_t> encodeStream(
+    Codecs::TemplateRegistryPtr registry,
+    size_t count,
+    std::string & fast)
+  {
+    std::vector<size_t> starts;
+    Codecs::Encoder encoder(registry);
+    encoder.setAutoReset(2);
+    Codecs::DataDestination destination;
+    for(size_t nMessage = 0; nMessage < count; ++nMessage)
+    {
+      starts.push_back(encoder.bytesEncoded());
+      encodeQuote(encoder, destination, 2, uint32(100 + nMessage));
+    }
+    destination.toString(fast);
+    return starts;
+  }
+
+  // Junk that stops the decoder: a presence map and an unknown template ID (25),
+  // then bytes with no stop bit, and a stop bit just before the next message.
+  const uchar junk[] = {0xC0, 0x99, 0x01, 0x01, 0x01, 0x01, 0x81};
+}
+
+BOOST_AUTO_TEST_CASE(testResyncScanner)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast;
+  std::vector<size_t> starts = encodeStream(registry, 10, fast);
+
+  Codecs::ResyncScanner scanner(registry);
+  std::string corrupt(reinterpret_cast<const char *>(junk), sizeof(junk));
+  corrupt += fast;
+  size_t offset = 0;
+  BOOST_REQUIRE(scanner.scan(
+    reinterpret_cast<const uchar *>(corrupt.data()), corrupt.size(), offset));
+  BOOST_CHECK_EQUAL(offset, sizeof(junk));
+
+  // Message 3 depends on the dictionary entries set by message 2, so the
+  // scanner moves on to the reset preceding message 4.
+  offset = 0;
+  BOOST_REQUIRE(scanner.scan(
+    reinterpret_cast<const uchar *>(fast.data()) + starts[3], fast.size() - starts[3], offset));
+  BOOST_CHECK_EQUAL(starts[3] + offset, starts[4]);
+
+  std::string noise(200, '\x11');
+  BOOST_CHECK(!scanner.scan(reinterpret_cast<const uchar *>(noise.data()), noise.size(), offset));
+}
+
+BOOST_AUTO_TEST_CASE(testStreamingAssemblerResync)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast;
+  std::vector<size_t> starts = encodeStream(registry, 10, fast);
+  std::string corrupt = fast.substr(0, starts[4]);
+  corrupt.append(reinterpret_cast<const char *>(junk), sizeof(junk));
+  corrupt += fast.substr(starts[4]);
+
+  SequenceConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  Codecs::NoHeaderAnalyzer analyzer;
+  Codecs::StreamingAssembler assembler(registry, analyzer, builder);
+  assembler.setResynchronize(true);
+  Communication::BufferReceiver receiver;
+  BOOST_REQUIRE(receiver.start(assembler, corrupt.size(), 2));
+  receiver.receiveBuffer(reinterpret_cast<const uchar *>(corrupt.data()), corrupt.size());
+  receiver.stop();
+
+  BOOST_CHECK_EQUAL(consumer.errors_, 1);
+  BOOST_CHECK_EQUAL(consumer.warnings_, 1);
+  BOOST_CHECK_EQUAL(assembler.resyncCount(), 1);
+  // The presence map and template ID were consumed by the decoder.
+  BOOST_CHECK_EQUAL(assembler.resyncBytesSkipped(), sizeof(junk) - 2);
+  BOOST_REQUIRE_EQUAL(consumer.sequence_.size(), 10);
+  for(size_t nMessage = 0; nMessage < consumer.sequence_.size(); ++nMessage)
+  {
+    BOOST_CHECK_EQUAL(consumer.sequence_[nMessage], 100 + nMessage);
+  }
+}
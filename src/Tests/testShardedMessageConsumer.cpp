@@ -0,0 +1,151 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/ShardedMessageConsumer.h>
+#include <Codecs/SingleMessageConsumer.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Messages/FieldIdentity.h>
+#include <Messages/FieldUInt32.h>
+#include <Messages/FieldAscii.h>
+
+using namespace QuickFAST;
+
+namespace
+{
+  /// Record the (key, sequence) of each message consumed.
+  class RecordingConsumer : public Codecs::SingleMessageConsumer
+  {
+  public:
+    RecordingConsumer()
+      : started_(0)
+      , stopped_(0)
+      , missing_(0)
+    {
+    }
+
+    virtual bool consumeMessage(Messages::Message & message)
+    {
+      uint64 key = 0;
+      uint64 sequence = 0;
+      // runs on a worker thread: check the results later on the test thread.
+      if(!message.getUnsignedInteger(Messages::FieldIdentity("SecurityID"), ValueType::UINT32, key)
+        || !message.getUnsignedInteger(Messages::FieldIdentity("Sequence"), ValueType::UINT32, sequence))
+      {
+        ++missing_;
+      }
+      received_.push_back(std::make_pair(key, sequence));
+      return true;
+    }
+
+    virtual void decodingStarted()
+    {
+      ++started_;
+    }
+
+    virtual void decodingStopped()
+    {
+      ++stopped_;
+    }
+
+    std::vector<std::pair<uint64, uint64> > received_;
+    size_t started_;
+    size_t stopped_;
+    size_t missing_;
+  };
+}
+
+BOOST_AUTO_TEST_CASE(testShardedMessageConsumer)
+{
+  Messages::FieldIdentityCPtr identitySequence(new Messages::FieldIdentity("Sequence"));
+  Messages::FieldIdentityCPtr identityKey(new Messages::FieldIdentity("SecurityID"));
+  Messages::FieldIdentityCPtr identityText(new Messages::FieldIdentity("Text"));
+
+  Codecs::SingleMessageConsumer logger;
+  // a small queue to force the decoding thread to wait.
+  Codecs::ShardedMessageConsumer sharded("SecurityID", logger, 4);
+  const size_t shardCount = 3;
+  RecordingConsumer consumers[shardCount];
+  for(size_t nShard = 0; nShard < shardCount; ++nShard)
+  {
+    sharded.addShard(consumers[nShard]);
+  }
+  BOOST_CHECK_EQUAL(sharded.shardCount(), shardCount);
+  // the decoder tells the consumer which template each message comes from.
+  Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+  Codecs::Decoder decoder(registry);
+  sharded.setDecoder(decoder);
+
+  sharded.decodingStarted();
+  const size_t keyCount = 17;
+  const size_t messageCount = 1000;
+  for(size_t nMessage = 0; nMessage < messageCount; ++nMessage)
+  {
+    Messages::Message message(3);
+    message.addField(identitySequence, Messages::FieldUInt32::create(uint32(nMessage)));
+    // template 2 puts the key in a different position.
+    // In template 3 an optional field ahead of the key is sometimes missing.
+    decoder.setTemplateId(template_id_t(1 + nMessage % 3));
+    if(nMessage % 3 == 1 || (nMessage % 3 == 2 && nMessage % 4 == 0))
+    {
+      message.addField(identityText, Messages::FieldAscii::create("moved"));
+    }
+    message.addField(identityKey, Messages::FieldUInt32::create(uint32(100 + nMessage % keyCount)));
+    BOOST_CHECK(sharded.consumeMessage(message));
+    // the decoding thread gets back an emptied message.
+    BOOST_CHECK_EQUAL(message.size(), 0);
+  }
+  sharded.decodingStopped();
+
+  size_t total = 0;
+  std::map<uint64, size_t> shardOfKey;
+  for(size_t nShard = 0; nShard < shardCount; ++nShard)
+  {
+    RecordingConsumer & consumer = consumers[nShard];
+    BOOST_CHECK_EQUAL(consumer.started_, 1);
+    BOOST_CHECK_EQUAL(consumer.stopped_, 1);
+    BOOST_CHECK_EQUAL(consumer.missing_, 0);
+    BOOST_CHECK_EQUAL(consumer.received_.size(), sharded.dispatched(nShard));
+    BOOST_CHECK_EQUAL(sharded.queueDepth(nShard), 0);
+    BOOST_CHECK(sharded.maxQueueDepth(nShard) <= 4);
+    total += consumer.received_.size();
+
+    std::map<uint64, uint64> lastSequence;
+    for(size_t nReceived = 0; nReceived < consumer.received_.size(); ++nReceived)
+    {
+      uint64 key = consumer.received_[nReceived].first;
+      uint64 sequence = consumer.received_[nReceived].second;
+      // every message for a key goes to the same shard
+      std::map<uint64, size_t>::iterator shard = shardOfKey.find(key);
+      if(shard == shardOfKey.end())
+      {
+        shardOfKey[key] = nShard;
+      }
+      else
+      {
+        BOOST_CHECK_EQUAL(shard->second, nShard);
+      }
+      // in the order they were decoded.
+      std::map<uint64, uint64>::iterator last = lastSequence.find(key);
+      if(last != lastSequence.end())
+      {
+        BOOST_CHECK(last->second < sequence);
+      }
+      lastSequence[key] = sequence;
+    }
+  }
+  BOOST_CHECK_EQUAL(total, messageCount);
+  BOOST_CHECK_EQUAL(shardOfKey.size(), keyCount);
+  BOOST_CHECK_EQUAL(sharded.unkeyed(), 0);
+
+  // A message without the key goes to shard zero.
+  Messages::Message unkeyed(1);
+  unkeyed.addField(identitySequence, Messages::FieldUInt32::create(0));
+  BOOST_CHECK_EQUAL(sharded.selectShard(unkeyed), 0);
+  BOOST_CHECK_EQUAL(sharded.unkeyed(), 1);
+}
@@ -0,0 +1,228 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/StaticMessageBuilder.h>
+#include <Codecs/FieldInstructionAscii.h>
+#include <Codecs/FieldInstructionUtf8.h>
+#include <Codecs/FieldInstructionByteVector.h>
+#include <Codecs/FieldInstructionDecimal.h>
+#include <Codecs/FieldOpNop.h>
+#include <Codecs/FieldOpConstant.h>
+#include <Codecs/FieldOpCopy.h>
+#include <Codecs/FieldOpDefault.h>
+#include <Codecs/FieldOpDelta.h>
+#include <Codecs/FieldOpIncrement.h>
+#include <Codecs/FieldOpTail.h>
+#include <Codecs/Template.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/Encoder.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/DataDestination.h>
+#include <Codecs/DataSourceString.h>
+
+#include <Messages/Message.h>
+#include <Messages/NullMessageBuilder.h>
+#include <Messages/FieldUInt32.h>
+#include <Messages/FieldInt32.h>
+#include <Messages/FieldUInt64.h>
+#include <Messages/FieldInt64.h>
+#include <Messages/FieldUInt16.h>
+#include <Messages/FieldInt8.h>
+#include <Messages/FieldAscii.h>
+#include <Messages/FieldUtf8.h>
+#include <Messages/FieldByteVector.h>
+#include <Messages/FieldDecimal.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  // <template name="Quote" id="1">
+  //   <uInt32 name="Seq"><increment/></uInt32>
+  //   <string name="Symbol"><copy/></string>
+  //   <int32 name="Price"><delta/></int32>
+  //   <uInt64 name="Size"><copy/></uInt64>
+  //   <int64 name="Change" presence="optional"><default value="0"/></int64>
+  //   <uInt16 name="Flags" presence="optional"/>
+  //   <int8 name="Side"><constant value="-1"/></int8>
+  //   <decimal name="Yield" presence="optional"><copy/></decimal>
+  //   <string name="Venue"><tail/></string>
+  //   <string name="Issuer" charset="unicode"><delta/></string>
+  //   <byteVector name="Note" presence="optional"/>
+  // </template>
+  Codecs::TemplateRegistryPtr createRegistry()
+  {
+    Codecs::TemplatePtr quote = createTemplate(1, "Quote");
+    addField(quote, new Codecs::FieldInstructionUInt32("Seq", ""), new Codecs::FieldOpIncrement);
+    addField(quote, new Codecs::FieldInstructionAscii("Symbol", ""), new Codecs::FieldOpCopy);
+    addField(quote, new Codecs::FieldInstructionInt32("Price", ""), new Codecs::FieldOpDelta);
+    addField(quote, new Codecs::FieldInstructionUInt64("Size", ""), new Codecs::FieldOpCopy);
+    addField(quote, new Codecs::FieldInstructionInt64("Change", ""), withValue(new Codecs::FieldOpDefault, "0"), false);
+    addField(quote, new Codecs::FieldInstructionUInt16("Flags", ""), new Codecs::FieldOpNop, false);
+    addField(quote, new Codecs::FieldInstructionInt8("Side", ""), withValue(new Codecs::FieldOpConstant, "-1"));
+    addField(quote, new Codecs::FieldInstructionDecimal("Yield", ""), new Codecs::FieldOpCopy, false);
+    addField(quote, new Codecs::FieldInstructionAscii("Venue", ""), new Codecs::FieldOpTail);
+    addField(quote, new Codecs::FieldInstructionUtf8("Issuer", ""), new Codecs::FieldOpDelta);
+    addField(quote, new Codecs::FieldInstructionByteVector("Note", ""), new Codecs::FieldOpNop, false);
+
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(quote);
+    registry->finalize();
+    return registry;
+  }
+
+  /// Record every value as text so the two decoding paths can be compared.
+  class RecordingBuilder : public Messages::NullMessageBuilder
+  {
+  public:
+    RecordingBuilder()
+      : messageCount_(0)
+    {
+    }
+
+    virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type /*type*/, const int64 value)
+    {
+      record(identity, value);
+    }
+    virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type /*type*/, const uint64 value)
+    {
+      record(identity, value);
+    }
+    virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type /*type*/, const int32 value)
+    {
+      record(identity, value);
+    }
+    virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type /*type*/, const uint32 value)
+    {
+      record(identity, value);
+    }
+    virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type /*type*/, const int16 value)
+    {
+      record(identity, value);
+    }
+    virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type /*type*/, const uint16 value)
+    {
+      record(identity, value);
+    }
+    virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type /*type*/, const int8 value)
+    {
+      record(identity, int(value));
+    }
+    virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type /*type*/, const uchar value)
+    {
+      record(identity, unsigned(value));
+    }
+    virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type /*type*/, const unsigned char * value, size_t length)
+    {
+      record(identity, std::string(reinterpret_cast<const char *>(value), length));
+    }
+    virtual void addValue(Messages::FieldIdentityCPtr & identity, ValueType::Type /*type*/, const Decimal& value)
+    {
+      std::string text;
+      value.toString(text);
+      record(identity, text);
+    }
+    virtual bool endMessage(Messages::ValueMessageBuilder & /*messageBuilder*/)
+    {
+      ++messageCount_;
+      text_ << '|';
+      return true;
+    }
+
+    std::string text()const
+    {
+      return text_.str();
+    }
+
+    size_t messageCount_;
+
+  private:
+    template<typename VALUE>
+    void record(Messages::FieldIdentityCPtr & identity, const VALUE & value)
+    {
+      text_ << identity->name() << '=' << value << ';';
+    }
+
+    std::ostringstream text_;
+  };
+
+  std::string encodeMessages(Codecs::TemplateRegistryPtr registry, size_t count)
+  {
+    Messages::FieldIdentityCPtr seqIdentity = new Messages::FieldIdentity("Seq");
+    Messages::FieldIdentityCPtr symbolIdentity = new Messages::FieldIdentity("Symbol");
+    Messages::FieldIdentityCPtr priceIdentity = new Messages::FieldIdentity("Price");
+    Messages::FieldIdentityCPtr sizeIdentity = new Messages::FieldIdentity("Size");
+    Messages::FieldIdentityCPtr changeIdentity = new Messages::FieldIdentity("Change");
+    Messages::FieldIdentityCPtr flagsIdentity = new Messages::FieldIdentity("Flags");
+    Messages::FieldIdentityCPtr sideIdentity = new Messages::FieldIdentity("Side");
+    Messages::FieldIdentityCPtr yieldIdentity = new Messages::FieldIdentity("Yield");
+    Messages::FieldIdentityCPtr venueIdentity = new Messages::FieldIdentity("Venue");
+    Messages::FieldIdentityCPtr issuerIdentity = new Messages::FieldIdentity("Issuer");
+    Messages::FieldIdentityCPtr noteIdentity = new Messages::FieldIdentity("Note");
+    EncodedMessages fast(registry);
+    for(size_t nMessage = 0; nMessage < count; ++nMessage)
+    {
+      Messages::Message message(registry->maxFieldCount());
+      message.addField(seqIdentity, Messages::FieldUInt32::create(uint32(100 + nMessage)));
+      message.addField(symbolIdentity, Messages::FieldAscii::create(nMessage % 3 == 0 ? "IBM" : "MSFT"));
+      message.addField(priceIdentity, Messages::FieldInt32::create(int32(12500 - 7 * nMessage)));
+      message.addField(sizeIdentity, Messages::FieldUInt64::create(uint64(nMessage / 2) * 100));
+      if(nMessage % 4 != 1)
+      {
+        message.addField(changeIdentity, Messages::FieldInt64::create(nMessage % 2 == 0 ? 0 : -int64(nMessage)));
+      }
+      if(nMessage % 5 == 0)
+      {
+        message.addField(flagsIdentity, Messages::FieldUInt16::create(uint16(nMessage)));
+      }
+      message.addField(sideIdentity, Messages::FieldInt8::create(-1));
+      if(nMessage % 3 != 2)
+      {
+        message.addField(yieldIdentity, Messages::FieldDecimal::create(mantissa_t(425 + nMessage / 4), -2));
+      }
+      message.addField(venueIdentity, Messages::FieldAscii::create(nMessage % 2 == 0 ? "XNYS" : "XNAS"));
+      message.addField(issuerIdentity, Messages::FieldUtf8::create(nMessage % 4 < 2 ? "Caf\xC3\xA9 Corp" : "Caf\xC3\xA9 Inc"));
+      if(nMessage % 2 == 0)
+      {
+        message.addField(noteIdentity, Messages::FieldByteVector::create(std::string("\x01\x02note", 6)));
+      }
+      fast.add(1, message);
+    }
+    return fast.str();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testStaticBuilder)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  const size_t count = 20;
+  std::string fast = encodeMessages(registry, count);
+
+  RecordingBuilder virtualBuilder;
+  Codecs::Decoder virtualDecoder(registry);
+  Codecs::DataSourceString virtualSource(fast);
+  for(size_t nMessage = 0; nMessage < count; ++nMessage)
+  {
+    virtualDecoder.decodeMessage(virtualSource, virtualBuilder);
+  }
+
+  RecordingBuilder staticBuilder;
+  Codecs::Decoder staticDecoder(registry);
+  Codecs::DataSourceString staticSource(fast);
+  for(size_t nMessage = 0; nMessage < count; ++nMessage)
+  {
+    staticDecoder.decodeMessage<RecordingBuilder>(staticSource, staticBuilder);
+  }
+
+  BOOST_CHECK_EQUAL(virtualBuilder.messageCount_, count);
+  BOOST_CHECK_EQUAL(staticBuilder.messageCount_, count);
+  BOOST_CHECK_EQUAL(staticBuilder.text(), virtualBuilder.text());
+  BOOST_CHECK(staticBuilder.text().find("Seq=100;Symbol=IBM;Price=12500;Size=0;Change=0;Flags=0;Side=-1;Yield=4.25;Venue=XNYS;Issuer=Caf\xC3\xA9 Corp;Note=\x01\x02note;|") == 0);
+}
@@ -0,0 +1,276 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/StaticTemplate.h>
+#include <Codecs/XMLTemplateParser.h>
+#include <Codecs/DataSourceString.h>
+#include <Codecs/SingleMessageConsumer.h>
+#include <Codecs/GenericMessageBuilder.h>
+
+#include <Messages/Message.h>
+#include <Messages/Sequence.h>
+#include <Messages/FieldSequence.h>
+#include <Messages/FieldUInt32.h>
+#include <Messages/FieldInt32.h>
+#include <Messages/FieldInt8.h>
+#include <Messages/FieldAscii.h>
+
+using namespace QuickFAST;
+using namespace QuickFAST::Codecs::Static;
+
+namespace
+{
+  QUICKFAST_STATIC_NAME(Book);
+  QUICKFAST_STATIC_NAME(Seq);
+  QUICKFAST_STATIC_NAME(Symbol);
+  QUICKFAST_STATIC_NAME_VALUE(Side, "-1");
+  QUICKFAST_STATIC_NAME(Levels);
+  QUICKFAST_STATIC_NAME(NoLevels);
+  QUICKFAST_STATIC_NAME(Price);
+  QUICKFAST_STATIC_NAME(Size);
+
+  // <template name="Book" id="7">
+  //   <uInt32 name="Seq"><increment/></uInt32>
+  //   <string name="Symbol" presence="optional"><copy/></string>
+  //   <int8 name="Side"><constant value="-1"/></int8>
+  //   <sequence name="Levels">
+  //     <length name="NoLevels"/>
+  //     <int32 name="Price"><delta/></int32>
+  //     <uInt32 name="Size"><copy/></uInt32>
+  //   </sequence>
+  // </template>
+  typedef StaticTemplate<7, Book, Fields<
+    Field<Seq, UInt32, Increment>,
+    Field<Symbol, Ascii, Copy, Optional>,
+    Field<Side, Int8, Constant>,
+    Sequence<Levels, Fields<
+      Field<Price, Int32, Delta>,
+      Field<Size, UInt32, Copy> >,
+      Mandatory,
+      Length<NoLevels> > > > BookTemplate;
+
+  // The same template with one difference: Size uses the delta operator.
+  typedef StaticTemplate<7, Book, Fields<
+    Field<Seq, UInt32, Increment>,
+    Field<Symbol, Ascii, Copy, Optional>,
+    Field<Side, Int8, Constant>,
+    Sequence<Levels, Fields<
+      Field<Price, Int32, Delta>,
+      Field<Size, UInt32, Delta> >,
+      Mandatory,
+      Length<NoLevels> > > > DifferentBookTemplate;
+
+  // The template without its sequence.
+  typedef StaticTemplate<7, Book, Fields<
+    Field<Seq, UInt32, Increment>,
+    Field<Symbol, Ascii, Copy, Optional>,
+    Field<Side, Int8, Constant> > > ShortBookTemplate;
+
+  const char bookXML[] =
+    "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+    "<templates xmlns=\"http://www.fixprotocol.org/ns/fast/td/1.1\">\n"
+    "  <template name=\"Book\" id=\"7\">\n"
+    "    <uInt32 name=\"Seq\"><increment/></uInt32>\n"
+    "    <string name=\"Symbol\" presence=\"optional\"><copy/></string>\n"
+    "    <int8 name=\"Side\"><constant value=\"-1\"/></int8>\n"
+    "    <sequence name=\"Levels\">\n"
+    "      <length name=\"NoLevels\"/>\n"
+    "      <int32 name=\"Price\"><delta/></int32>\n"
+    "      <uInt32 name=\"Size\"><copy/></uInt32>\n"
+    "    </sequence>\n"
+    "  </template>\n"
+    "</templates>\n";
+
+  Codecs::TemplateRegistryPtr createRegistry()
+  {
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(BookTemplate::createTemplate());
+    registry->finalize();
+    return registry;
+  }
+
+  void addMessage(Messages::Message & message, size_t nMessage)
+  {
+    Messages::FieldIdentityCPtr seqIdentity = new Messages::FieldIdentity("Seq");
+    Messages::FieldIdentityCPtr symbolIdentity = new Messages::FieldIdentity("Symbol");
+    Messages::FieldIdentityCPtr sideIdentity = new Messages::FieldIdentity("Side");
+    Messages::FieldIdentityCPtr levelsIdentity = new Messages::FieldIdentity("Levels");
+    Messages::FieldIdentityCPtr lengthIdentity = new Messages::FieldIdentity("NoLevels");
+    Messages::FieldIdentityCPtr priceIdentity = new Messages::FieldIdentity("Price");
+    Messages::FieldIdentityCPtr sizeIdentity = new Messages::FieldIdentity("Size");
+
+    message.addField(seqIdentity, Messages::FieldUInt32::create(uint32(40 + nMessage)));
+    if(nMessage % 3 != 1)
+    {
+      message.addField(symbolIdentity, Messages::FieldAscii::create(nMessage % 2 == 0 ? "XOM" : "CVX"));
+    }
+    message.addField(sideIdentity, Messages::FieldInt8::create(-1));
+    Messages::SequencePtr levels(new Messages::Sequence(lengthIdentity, 2));
+    for(size_t nLevel = 0; nLevel < nMessage % 3 + 1; ++nLevel)
+    {
+      Messages::FieldSetPtr entry(new Messages::FieldSet(2));
+      entry->addField(priceIdentity, Messages::FieldInt32::create(int32(8000 - 25 * nLevel + nMessage)));
+      entry->addField(sizeIdentity, Messages::FieldUInt32::create(uint32(100 * (nLevel + 1))));
+      levels->addEntry(entry);
+    }
+    message.addField(levelsIdentity, Messages::FieldSequence::create(levels));
+  }
+
+  void display(std::ostream & out, const Messages::FieldSet & fields)
+  {
+    for(Messages::FieldSet::const_iterator it = fields.begin(); it != fields.end(); ++it)
+    {
+      const Messages::FieldCPtr & field = it->getField();
+      out << it->name() << '=';
+      if(field->getType() == ValueType::SEQUENCE)
+      {
+        const Messages::Sequence & sequence = *field->toSequence();
+        for(size_t nEntry = 0; nEntry < sequence.size(); ++nEntry)
+        {
+          out << '[';
+          display(out, *sequence[nEntry]);
+          out << ']';
+        }
+      }
+      else
+      {
+        out << field->displayString();
+      }
+      out << ';';
+    }
+  }
+
+  template<typename Description>
+  std::string decodeMessages(
+    Codecs::TemplateRegistryPtr registry,
+    const Description * description,
+    const std::string & fast,
+    size_t count)
+  {
+    std::ostringstream text;
+    Codecs::Decoder decoder(registry);
+    Codecs::DataSourceString source(fast);
+    for(size_t nMessage = 0; nMessage < count; ++nMessage)
+    {
+      Codecs::SingleMessageConsumer consumer;
+      Codecs::GenericMessageBuilder builder(consumer);
+      if(description != 0)
+      {
+        decoder.decodeStaticMessage(source, *description, builder);
+      }
+      else
+      {
+        decoder.decodeMessage(source, builder);
+      }
+      display(text, consumer.message());
+      text << '|';
+    }
+    return text.str();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testStaticTemplateCreate)
+{
+  Codecs::TemplatePtr book = BookTemplate::createTemplate();
+  BOOST_CHECK_EQUAL(book->getId(), 7);
+  BOOST_CHECK_EQUAL(book->getTemplateName(), "Book");
+  BOOST_REQUIRE_EQUAL(book->size(), 4);
+  BOOST_CHECK_EQUAL(book->getInstruction(0)->getName(), "Seq");
+  BOOST_CHECK_EQUAL(book->getInstruction(1)->isMandatory(), false);
+  BOOST_CHECK_EQUAL(book->getInstruction(2)->getFieldOp()->getValue(), "-1");
+  Codecs::SegmentBodyPtr levels;
+  BOOST_REQUIRE(book->getInstruction(3)->getSegmentBody(levels));
+  BOOST_CHECK_EQUAL(levels->size(), 2);
+  Codecs::FieldInstructionCPtr length;
+  BOOST_REQUIRE(levels->getLengthInstruction(length));
+  BOOST_CHECK_EQUAL(length->getName(), "NoLevels");
+}
+
+BOOST_AUTO_TEST_CASE(testStaticTemplateBind)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  BookTemplate book;
+  BOOST_CHECK(!book.isBound());
+  book.bind(*registry);
+  BOOST_CHECK(book.isBound());
+
+  DifferentBookTemplate different;
+  BOOST_CHECK_THROW(different.bind(*registry), TemplateDefinitionError);
+  BOOST_CHECK(!different.isBound());
+
+  ShortBookTemplate shortBook;
+  BOOST_CHECK_THROW(shortBook.bind(*registry), TemplateDefinitionError);
+
+  Codecs::TemplateRegistry empty;
+  BookTemplate unbound;
+  BOOST_CHECK_THROW(unbound.bind(empty), TemplateDefinitionError);
+}
+
+BOOST_AUTO_TEST_CASE(testStaticTemplateBindParsed)
+{
+  Codecs::XMLTemplateParser parser;
+  std::stringstream templateSource(bookXML);
+  Codecs::TemplateRegistryPtr registry = parser.parse(templateSource);
+  BOOST_REQUIRE(registry);
+
+  BookTemplate book;
+  book.bind(*registry);
+  BOOST_CHECK(book.isBound());
+
+  DifferentBookTemplate different;
+  BOOST_CHECK_THROW(different.bind(*registry), TemplateDefinitionError);
+
+  // The parsed template and the description encode and decode alike.
+  Messages::Message message(registry->maxFieldCount());
+  addMessage(message, 5);
+  Codecs::Encoder staticEncoder(registry);
+  Codecs::DataDestination staticDestination;
+  staticEncoder.encodeStaticMessage(staticDestination, book, message);
+  Codecs::Encoder encoder(registry);
+  Codecs::DataDestination destination;
+  encoder.encodeMessage(destination, 7, message);
+  std::string staticFast;
+  staticDestination.toString(staticFast);
+  std::string fast;
+  destination.toString(fast);
+  BOOST_CHECK(staticFast == fast);
+  BOOST_CHECK_EQUAL(
+    decodeMessages(registry, &book, fast, 1),
+    decodeMessages<BookTemplate>(registry, 0, fast, 1));
+}
+
+BOOST_AUTO_TEST_CASE(testStaticTemplateRoundTrip)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  BookTemplate book;
+  book.bind(*registry);
+
+  const size_t count = 9;
+  Codecs::Encoder staticEncoder(registry);
+  Codecs::DataDestination staticDestination;
+  Codecs::Encoder encoder(registry);
+  Codecs::DataDestination destination;
+  for(size_t nMessage = 0; nMessage < count; ++nMessage)
+  {
+    Messages::Message message(registry->maxFieldCount());
+    addMessage(message, nMessage);
+    staticEncoder.encodeStaticMessage(staticDestination, book, message);
+    encoder.encodeMessage(destination, 7, message);
+  }
+  std::string staticFast;
+  staticDestination.toString(staticFast);
+  std::string fast;
+  destination.toString(fast);
+  BOOST_CHECK(staticFast == fast);
+
+  std::string described = decodeMessages(registry, &book, fast, count);
+  std::string interpreted = decodeMessages<BookTemplate>(registry, 0, fast, count);
+  BOOST_CHECK_EQUAL(described, interpreted);
+  BOOST_CHECK(described.find("Seq=45;Symbol=CVX;Side=-1;Levels=[Price=8005;Size=100;][Price=7980;Size=200;][Price=7955;Size=300;];|")
+    != std::string::npos);
+}
@@ -0,0 +1,177 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Common/Utf8.h>
+#include <Codecs/FieldInstructionUtf8.h>
+#include <Codecs/SingleMessageConsumer.h>
+
+#include <Messages/FieldUtf8.h>
+#include "TemplateBuilder.h"
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  size_t validate(const std::string & value)
+  {
+    return Utf8::validate(reinterpret_cast<const uchar *>(value.data()), value.size());
+  }
+
+  std::string replace(const std::string & value)
+  {
+    std::string result;
+    Utf8::replaceInvalid(reinterpret_cast<const uchar *>(value.data()), value.size(), result);
+    return result;
+  }
+
+  /// Remember which fields were flagged as invalid.
+  class FlagRecorder : public Codecs::GenericMessageBuilder
+  {
+  public:
+    FlagRecorder(Codecs::MessageConsumer & consumer)
+      : Codecs::GenericMessageBuilder(consumer)
+    {
+    }
+
+    virtual void invalidUtf8(Messages::FieldIdentityCPtr & identity, size_t errorOffset)
+    {
+      flagged_.push_back(std::make_pair(identity->name(), errorOffset));
+    }
+
+    std::vector<std::pair<std::string, size_t> > flagged_;
+  };
+
+  // <template name="Text" id="1">
+  //   <string name="Text" charset="unicode"><copy/></string>
+  // </template>
+  Codecs::TemplateRegistryPtr createRegistry()
+  {
+    Codecs::TemplatePtr text = createTemplate(1, "Text");
+    addField(text, new Codecs::FieldInstructionUtf8("Text", ""), new Codecs::FieldOpCopy);
+
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(text);
+    registry->finalize();
+    return registry;
+  }
+
+  const char * texts[] = {"plain", "caf\xC3\xA9", "bad\xC3(", "bad\xC3(", "ok"};
+  const size_t textCount = sizeof(texts)/sizeof(texts[0]);
+
+  std::string encodeTexts(Codecs::TemplateRegistryPtr registry)
+  {
+    EncodedMessages fast(registry);
+    for(size_t nMsg = 0; nMsg < textCount; ++nMsg)
+    {
+      Messages::Message message(registry->maxFieldCount());
+      addNamedField(message, "Text", Messages::FieldUtf8::create(texts[nMsg]));
+      fast.add(1, message);
+    }
+    return fast.str();
+  }
+
+  std::string decodedText(Codecs::SingleMessageConsumer & consumer)
+  {
+    Messages::FieldCPtr field;
+    BOOST_REQUIRE(consumer.message().getField("Text", field));
+    return field->toUtf8();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testUtf8Validate)
+{
+  BOOST_CHECK_EQUAL(validate(""), 0);
+  BOOST_CHECK_EQUAL(validate("A plain ASCII string longer than a word."), 40);
+  BOOST_CHECK_EQUAL(validate("caf\xC3\xA9"), 5);
+  BOOST_CHECK_EQUAL(validate("\xE2\x82\xAC 100"), 7);            // euro sign
+  BOOST_CHECK_EQUAL(validate("\xF0\x9F\x98\x80"), 4);            // U+1F600
+  BOOST_CHECK_EQUAL(validate("abcdefgh\xC3"), 8);                // truncated
+  BOOST_CHECK_EQUAL(validate("ab\xC0\xAF"), 2);                  // overlong
+  BOOST_CHECK_EQUAL(validate("\xE0\x80\xAF"), 0);                // overlong
+  BOOST_CHECK_EQUAL(validate("\xED\xA0\x80"), 0);                // surrogate
+  BOOST_CHECK_EQUAL(validate("\xF4\x90\x80\x80"), 0);            // > U+10FFFF
+  BOOST_CHECK_EQUAL(validate("0123456789\x80"), 10);             // stray continuation
+  BOOST_CHECK(Utf8::isValid(reinterpret_cast<const uchar *>("\xC3\xA9"), 2));
+
+  BOOST_CHECK_EQUAL(replace("caf\xC3\xA9"), "caf\xC3\xA9");
+  BOOST_CHECK_EQUAL(replace("a\xC3(b"), "a\xEF\xBF\xBD(b");
+  // a truncated sequence is replaced by one character
+  BOOST_CHECK_EQUAL(replace("a\xE2\x82"), "a\xEF\xBF\xBD");
+  // each invalid byte is replaced
+  BOOST_CHECK_EQUAL(replace("\xC0\xAF"), "\xEF\xBF\xBD\xEF\xBF\xBD");
+}
+
+BOOST_AUTO_TEST_CASE(testUtf8Policy)
+{
+  Codecs::TemplateRegistryPtr registry = createRegistry();
+  std::string fast = encodeTexts(registry);
+
+  // Accept (the default): no checking
+  {
+    Codecs::Decoder decoder(registry);
+    BOOST_CHECK_EQUAL(decoder.getUtf8Policy(), Codecs::Decoder::UTF8_ACCEPT);
+    Codecs::DataSourceString source(fast);
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    for(size_t nMsg = 0; nMsg < textCount; ++nMsg)
+    {
+      decoder.decodeMessage(source, builder);
+      BOOST_CHECK_EQUAL(decodedText(consumer), texts[nMsg]);
+    }
+    BOOST_CHECK_EQUAL(decoder.invalidUtf8Count(), 0);
+  }
+
+  // Flag: the value is delivered unchanged and the builder is told.
+  {
+    Codecs::Decoder decoder(registry);
+    decoder.setUtf8Policy(Codecs::Decoder::UTF8_FLAG);
+    Codecs::DataSourceString source(fast);
+    Codecs::SingleMessageConsumer consumer;
+    FlagRecorder builder(consumer);
+    for(size_t nMsg = 0; nMsg < textCount; ++nMsg)
+    {
+      decoder.decodeMessage(source, builder);
+      BOOST_CHECK_EQUAL(decodedText(consumer), texts[nMsg]);
+    }
+    // The fourth message comes from the dictionary and is flagged, too.
+    BOOST_REQUIRE_EQUAL(builder.flagged_.size(), 2);
+    BOOST_CHECK_EQUAL(builder.flagged_[0].first, "Text");
+    BOOST_CHECK_EQUAL(builder.flagged_[0].second, 3);
+    BOOST_CHECK_EQUAL(decoder.invalidUtf8Count(), 2);
+  }
+
+  // Replace: the builder sees the corrected value; the dictionary keeps the original.
+  {
+    Codecs::Decoder decoder(registry);
+    decoder.setUtf8Policy(Codecs::Decoder::UTF8_REPLACE);
+    Codecs::DataSourceString source(fast);
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    const char * expected[] = {"plain", "caf\xC3\xA9", "bad\xEF\xBF\xBD(", "bad\xEF\xBF\xBD(", "ok"};
+    for(size_t nMsg = 0; nMsg < textCount; ++nMsg)
+    {
+      decoder.decodeMessage(source, builder);
+      BOOST_CHECK_EQUAL(decodedText(consumer), expected[nMsg]);
+    }
+    BOOST_CHECK_EQUAL(decoder.invalidUtf8Count(), 2);
+  }
+
+  // Reject: decoding the message fails
+  {
+    Codecs::Decoder decoder(registry);
+    decoder.setUtf8Policy(Codecs::Decoder::UTF8_REJECT);
+    Codecs::DataSourceString source(fast);
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    decoder.decodeMessage(source, builder);
+    decoder.decodeMessage(source, builder);
+    BOOST_CHECK_THROW(decoder.decodeMessage(source, builder), EncodingError);
+    BOOST_CHECK_EQUAL(decoder.invalidUtf8Count(), 1);
+  }
+}